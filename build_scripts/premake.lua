@@ -21,9 +21,11 @@ CPP_VERSION			     = "C++20"
 SOLUTION_NAME            = "spartan"
 EDITOR_PROJECT_NAME      = "editor"
 RUNTIME_PROJECT_NAME     = "runtime"
+HEADLESS_PROJECT_NAME    = "headless"
 EXECUTABLE_NAME          = "spartan"
 EDITOR_DIR               = "../" .. EDITOR_PROJECT_NAME
 RUNTIME_DIR              = "../" .. RUNTIME_PROJECT_NAME
+HEADLESS_DIR             = "../" .. HEADLESS_PROJECT_NAME
 LIBRARY_DIR              = "../third_party/libraries"
 OBJ_DIR                  = "../binaries/obj"
 TARGET_DIR               = "../binaries"
@@ -39,16 +41,19 @@ if API_GRAPHICS == "d3d11" then
 	EXECUTABLE_NAME = EXECUTABLE_NAME .. "_d3d11"
 	IGNORE_FILES[0]	= RUNTIME_DIR .. "/RHI/D3D12/**"
 	IGNORE_FILES[1]	= RUNTIME_DIR .. "/RHI/Vulkan/**"
+	IGNORE_FILES[2]	= RUNTIME_DIR .. "/RHI/Null/**"
 elseif API_GRAPHICS == "d3d12" then
 	API_GRAPHICS    = "API_GRAPHICS_D3D12"
 	EXECUTABLE_NAME = EXECUTABLE_NAME .. "_d3d12"
 	IGNORE_FILES[0] = RUNTIME_DIR .. "/RHI/D3D11/**"
 	IGNORE_FILES[1] = RUNTIME_DIR .. "/RHI/Vulkan/**"
+	IGNORE_FILES[2] = RUNTIME_DIR .. "/RHI/Null/**"
 elseif API_GRAPHICS == "vulkan" then
 	API_GRAPHICS    = "API_GRAPHICS_VULKAN"
 	EXECUTABLE_NAME = EXECUTABLE_NAME .. "_vulkan"
 	IGNORE_FILES[0] = RUNTIME_DIR .. "/RHI/D3D11/**"
 	IGNORE_FILES[1] = RUNTIME_DIR .. "/RHI/D3D12/**"
+	IGNORE_FILES[2] = RUNTIME_DIR .. "/RHI/Null/**"
 
 	ADDITIONAL_INCLUDES[0] = "../third_party/spirv_cross";
 	ADDITIONAL_INCLUDES[1] = "../third_party/vulkan";
@@ -71,6 +76,29 @@ elseif API_GRAPHICS == "vulkan" then
 	ADDITIONAL_LIBRARIES_DBG[5] = "spirv-cross-reflect_debug";
 	ADDITIONAL_LIBRARIES_DBG[6] = "ffx_fsr2_api_x64_debug";
 	ADDITIONAL_LIBRARIES_DBG[7] = "ffx_fsr2_api_vk_x64_debug";
+elseif API_GRAPHICS == "null" then
+	API_GRAPHICS    = "API_GRAPHICS_NULL"
+	EXECUTABLE_NAME = EXECUTABLE_NAME .. "_null"
+	IGNORE_FILES[0] = RUNTIME_DIR .. "/RHI/D3D11/**"
+	IGNORE_FILES[1] = RUNTIME_DIR .. "/RHI/D3D12/**"
+	IGNORE_FILES[2] = RUNTIME_DIR .. "/RHI/Vulkan/**"
+
+	-- Shaders are still compiled and reflected, so that descriptors match the real backends
+	ADDITIONAL_INCLUDES[0] = "../third_party/spirv_cross";
+
+	ADDITIONAL_LIBRARIES[0] = "spirv-cross-c";
+	ADDITIONAL_LIBRARIES[1] = "spirv-cross-core";
+	ADDITIONAL_LIBRARIES[2] = "spirv-cross-cpp";
+	ADDITIONAL_LIBRARIES[3] = "spirv-cross-glsl";
+	ADDITIONAL_LIBRARIES[4] = "spirv-cross-hlsl";
+	ADDITIONAL_LIBRARIES[5] = "spirv-cross-reflect";
+
+	ADDITIONAL_LIBRARIES_DBG[0] = "spirv-cross-c_debug";
+	ADDITIONAL_LIBRARIES_DBG[1] = "spirv-cross-core_debug";
+	ADDITIONAL_LIBRARIES_DBG[2] = "spirv-cross-cpp_debug";
+	ADDITIONAL_LIBRARIES_DBG[3] = "spirv-cross-glsl_debug";
+	ADDITIONAL_LIBRARIES_DBG[4] = "spirv-cross-hlsl_debug";
+	ADDITIONAL_LIBRARIES_DBG[5] = "spirv-cross-reflect_debug";
 end
 
 -- Solution -------------------------------------------------------------------------------------------------------
@@ -135,7 +163,7 @@ project (RUNTIME_PROJECT_NAME)
 	}
 
 	-- Source to ignore
-	removefiles { IGNORE_FILES[0], IGNORE_FILES[1] }
+	removefiles { IGNORE_FILES[0], IGNORE_FILES[1], IGNORE_FILES[2] }
 
 	-- Procompiled header
 	pchheader "pch.h" 		 			-- Specifies the #include form of the precompiled header file name, not the actual file path (https://premake.github.io/docs/pchheader/)
@@ -233,3 +261,47 @@ project (EDITOR_PROJECT_NAME)
 		debugdir (TARGET_DIR)
 		links { "freetype_debug" }
 		links { "SDL2_debug" }
+
+-- Headless -----------------------------------------------------------------------------------------------
+-- Runs the renderer without a GPU and reports CPU time per pass, only meaningful with the null backend
+if API_GRAPHICS == "API_GRAPHICS_NULL" then
+project (HEADLESS_PROJECT_NAME)
+	location (HEADLESS_DIR)
+	links (RUNTIME_PROJECT_NAME)
+	dependson (RUNTIME_PROJECT_NAME)
+	objdir (OBJ_DIR)
+    cppdialect (CPP_VERSION)
+	kind "ConsoleApp"
+	staticruntime "On"
+	defines{ API_GRAPHICS }
+
+	-- Files
+	files
+	{
+		HEADLESS_DIR .. "/**.h",
+		HEADLESS_DIR .. "/**.cpp"
+	}
+
+	-- Includes
+	includedirs { RUNTIME_DIR }
+	includedirs { RUNTIME_DIR .. "/Core" } -- This is here because the runtime uses it
+	includedirs { "../third_party" }
+	includedirs { "../third_party/bullet" } -- Used to compare collision shapes
+
+	-- Libraries
+	libdirs (LIBRARY_DIR)
+
+	-- "Release"
+	filter "configurations:release"
+		targetname ( EXECUTABLE_NAME .. "_headless" )
+		targetdir (TARGET_DIR)
+		debugdir (TARGET_DIR)
+		links { "SDL2" }
+
+	-- "Debug"
+	filter "configurations:debug"
+		targetname ( EXECUTABLE_NAME .. "_headless_debug" )
+		targetdir (TARGET_DIR)
+		debugdir (TARGET_DIR)
+		links { "SDL2_debug" }
+end
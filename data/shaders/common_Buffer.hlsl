@@ -103,7 +103,9 @@ cbuffer BufferUber : register(b1)
     uint g_work_group_count;
 
     uint g_reflection_probe_available;
-    float3 g_padding2;
+    uint g_is_instanced;
+    uint g_instance_offset;
+    float g_padding2;
 };
 
 // High frequency - Updates per light
@@ -73,3 +73,11 @@ RWTexture2D<float4> tex_uav2                               : register(u1);
 RWTexture2D<float4> tex_uav3                               : register(u2);
 globallycoherent RWStructuredBuffer<uint> g_atomic_counter : register(u3);
 globallycoherent RWTexture2D<float4> tex_uav_mips[12]      : register(u4);
+
+// Instancing
+struct Instance
+{
+    matrix transform;
+    matrix transform_previous;
+};
+StructuredBuffer<Instance> g_instances : register(t37);
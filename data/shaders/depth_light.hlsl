@@ -23,13 +23,21 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common.hlsl"
 //====================
 
-Pixel_PosUv mainVS(Vertex_PosUv input)
+Pixel_PosUv mainVS(Vertex_PosUv input, uint instance_id : SV_InstanceID)
 {
     Pixel_PosUv output;
 
     input.position.w = 1.0f;
-    output.position  = mul(input.position, g_transform);
-    output.uv        = input.uv;
+    output.position  = input.position;
+
+    // when instanced, g_transform only holds the light's view projection
+    if (g_is_instanced)
+    {
+        output.position = mul(output.position, g_instances[g_instance_offset + instance_id].transform);
+    }
+
+    output.position = mul(output.position, g_transform);
+    output.uv       = input.uv;
 
     return output;
 }
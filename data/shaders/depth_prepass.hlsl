@@ -23,13 +23,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common.hlsl"
 //====================
 
-Pixel_PosUv mainVS(Vertex_PosUv input)
+Pixel_PosUv mainVS(Vertex_PosUv input, uint instance_id : SV_InstanceID)
 {
     Pixel_PosUv output;
 
+    matrix transform = g_is_instanced ? g_instances[g_instance_offset + instance_id].transform : g_transform;
+
     // position computation has to be an exact match to gbuffer.hlsl
     input.position.w    = 1.0f; 
-    output.position     = mul(input.position, g_transform);
+    output.position     = mul(input.position, transform);
     output.position     = mul(output.position, g_view_projection);
 
     output.uv = input.uv;
@@ -39,20 +39,29 @@ struct PixelOutputType
     float2 velocity : SV_Target3;
 };
 
-PixelInputType mainVS(Vertex_PosUvNorTan input)
+PixelInputType mainVS(Vertex_PosUvNorTan input, uint instance_id : SV_InstanceID)
 {
     PixelInputType output;
 
+    matrix transform          = g_transform;
+    matrix transform_previous = g_transform_previous;
+    if (g_is_instanced)
+    {
+        Instance instance  = g_instances[g_instance_offset + instance_id];
+        transform          = instance.transform;
+        transform_previous = instance.transform_previous;
+    }
+
     // position computation has to be an exact match to depth_prepass.hlsl
     input.position.w = 1.0f;
-    output.position  = mul(input.position, g_transform);
+    output.position  = mul(input.position, transform);
     output.position  = mul(output.position, g_view_projection);
     
     output.position_ss_current  = output.position;
-    output.position_ss_previous = mul(input.position, g_transform_previous);
+    output.position_ss_previous = mul(input.position, transform_previous);
     output.position_ss_previous = mul(output.position_ss_previous, g_view_projection_previous);
-    output.normal               = normalize(mul(input.normal,  (float3x3)g_transform)).xyz;
-    output.tangent              = normalize(mul(input.tangent, (float3x3)g_transform)).xyz;
+    output.normal               = normalize(mul(input.normal,  (float3x3)transform)).xyz;
+    output.tangent              = normalize(mul(input.tangent, (float3x3)transform)).xyz;
     output.uv                   = input.uv;
     
     return output;
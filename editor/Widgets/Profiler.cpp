@@ -83,6 +83,11 @@ void Profiler::TickVisible()
     float interval = m_profiler->GetUpdateInterval();
     ImGui::DragFloat("Update interval (The smaller the interval the higher the performance impact)", &interval, 0.001f, 0.0f, 0.5f);
     m_profiler->SetUpdateInterval(interval);
+    ImGui::SameLine();
+    if (ImGui_SP::button(m_profiler->IsCapturing() ? "Capturing..." : "Capture") && !m_profiler->IsCapturing())
+    {
+        m_profiler->CaptureStart("profiler_capture.json", 120);
+    }
     ImGui::Separator();
 
     Spartan::TimeBlockType type                        = m_item_type == 0 ? Spartan::TimeBlockType::Cpu : Spartan::TimeBlockType::Gpu;
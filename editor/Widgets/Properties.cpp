@@ -525,7 +525,8 @@ void Properties::ShowCollider(Collider* collider) const
             "Cylinder",
             "Capsule",
             "Cone",
-            "Mesh"
+            "Mesh",
+            "Terrain"
         };
         bool optimize                   = collider->GetOptimize();
         Vector3 collider_center         = collider->GetCenter();
@@ -945,8 +946,9 @@ void Properties::ShowTerrain(Terrain* terrain) const
         ImGui::SetCursorPosY(cursor_y);
         ImGui::BeginGroup();
         {
-            ImGui::InputFloat("Min Y", &min_y);
-            ImGui::InputFloat("Max Y", &max_y);
+            // Every change moves all the terrain's vertices, so a value applies once it's entered, not on every keystroke
+            ImGui::InputFloat("Min Y", &min_y, 0.0f, 0.0f, "%.3f", ImGuiInputTextFlags_EnterReturnsTrue);
+            ImGui::InputFloat("Max Y", &max_y, 0.0f, 0.0f, "%.3f", ImGuiInputTextFlags_EnterReturnsTrue);
         }
         ImGui::EndGroup();
 
@@ -956,6 +958,8 @@ void Properties::ShowTerrain(Terrain* terrain) const
             ImGui::Text("Height samples: %d", terrain->GetHeightsamples());
             ImGui::Text("Vertices: %d",  terrain->GetVertexCount());
             ImGui::Text("Indices:  %d ", terrain->GetIndexCount());
+            ImGui::Text("Chunks: %d", terrain->GetChunkCount());
+            ImGui::Text("Triangles (lod): %d", terrain->GetTriangleCount());
         }
         ImGui::EndGroup();
 
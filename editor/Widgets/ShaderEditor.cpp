@@ -116,7 +116,7 @@ void ShaderEditor::ShowShaderList()
         // Title
         ImGui::Text("Shaders");
 
-        for (RHI_Shader* shader : m_shaders)
+        for (const shared_ptr<RHI_Shader>& shader : m_shaders)
         {
             // Get name
             string name = shader->GetName();
@@ -148,6 +148,13 @@ void ShaderEditor::ShowShaderList()
                 }
             }
     
+            // The renderer replaces shaders when their source changes, so follow the selected one to its replacement
+            if (m_shader && shader != m_shader && name == m_shader_name)
+            {
+                m_shader          = shader;
+                m_index_displayed = -1;
+            }
+
             if (ImGui_SP::button(name.c_str()) || m_first_run)
             {
                 m_shader          = shader;
@@ -172,21 +179,23 @@ void ShaderEditor::ShowControls()
         {
             if (m_index_displayed != -1)
             {
-                static const std::vector<std::string>& file_paths = m_shader->GetFilePaths();
-                static const std::vector<std::string>& sources = m_shader->GetSources();
+                const std::vector<std::string>& file_paths = m_shader->GetFilePaths();
+                const std::vector<std::string>& sources    = m_shader->GetSources();
 
-                // Save all files
+                // Save the files which were modified, the renderer detects the change and
+                // recompiles every shader which includes them (not just the selected one)
                 for (uint32_t i = 0; i < static_cast<uint32_t>(file_paths.size()); i++)
                 {
+                    stringstream source_on_disk;
+                    source_on_disk << ifstream(file_paths[i]).rdbuf();
+                    if (source_on_disk.str() == sources[i])
+                        continue;
+
                     ofstream out(file_paths[i]);
                     out << sources[i];
                     out.flush();
                     out.close();
                 }
-
-                // Compile synchronously to make it obvious when the first rendered frame (with your changes) shows up
-                bool async = false;
-                m_shader->Compile(m_shader->GetShaderStage(), m_shader->GetFilePath(), async);
             }
         }
 
@@ -208,10 +217,10 @@ void ShaderEditor::GetShaderInstances()
     {
         if (shader && shader->IsCompiled())
         {
-            m_shaders.emplace_back(shader.get());
+            m_shaders.emplace_back(shader);
         }
     }
 
     // Order them alphabetically
-    sort(m_shaders.begin(), m_shaders.end(), [](RHI_Shader* a, RHI_Shader* b) { return a->GetName() < b->GetName(); });
+    sort(m_shaders.begin(), m_shaders.end(), [](const shared_ptr<RHI_Shader>& a, const shared_ptr<RHI_Shader>& b) { return a->GetName() < b->GetName(); });
 }
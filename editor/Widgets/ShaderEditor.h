@@ -46,11 +46,11 @@ private:
     void ShowControls();
     void GetShaderInstances();
 
-    Spartan::RHI_Shader* m_shader = nullptr;
+    std::shared_ptr<Spartan::RHI_Shader> m_shader;
     std::string m_shader_name     = "N/A";
     Spartan::Renderer* m_renderer = nullptr;
     int32_t m_index_displayed     = -1;
     bool m_first_run              = true;
     std::unique_ptr<TextEditor> m_text_editor;
-    std::vector<Spartan::RHI_Shader*> m_shaders;
+    std::vector<std::shared_ptr<Spartan::RHI_Shader>> m_shaders;
 };
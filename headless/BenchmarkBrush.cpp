@@ -0,0 +1,120 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "World/Entity.h"
+#include "World/Components/Terrain.h"
+#include "World/World.h"
+#include "RHI/RHI_Texture2D.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Generates a terrain and reports how long brush edits of its heights take, and a change of its height range for comparison.
+// Usage: spartan_null_headless brush [size] [brush_size] [edit_count]
+int benchmark_brush(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t size       = get_argument(argc, argv, 0, 4096);
+    const uint32_t brush_size = get_argument(argc, argv, 1, 64);
+    const uint32_t edit_count = get_argument(argc, argv, 2, 100);
+
+    Context* context = engine.GetContext();
+    World* world     = context->GetSystem<World>();
+
+    // Rolling hills, in the first channel of the texels, which is what the terrain reads
+    vector<RHI_Texture_Slice> data(1);
+    vector<std::byte>& bytes = data[0].mips.emplace_back().bytes;
+    bytes.resize(static_cast<size_t>(size) * size * 4);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const float height = 0.5f + 0.25f * sinf(x * 0.05f) * cosf(y * 0.07f) + 0.25f * sinf((x + y) * 0.013f);
+            bytes[(static_cast<size_t>(y) * size + x) * 4] = static_cast<std::byte>(height * 255.0f);
+        }
+    }
+    shared_ptr<RHI_Texture2D> height_map = make_shared<RHI_Texture2D>(context, size, size, RHI_Format_R8G8B8A8_Unorm, RHI_Texture_Srv, data, "height_map");
+
+    // Resolve the terrain's entity, so that its component ticks
+    shared_ptr<Entity> entity = world->CreateEntity();
+    Terrain* terrain          = entity->AddComponent<Terrain>();
+    terrain->SetHeightMap(height_map);
+    world->OnTick(0.0);
+
+    Stopwatch timer;
+    terrain->GenerateAsync();
+    while (terrain->IsGenerating())
+    {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    printf("%u^2 terrain, %u chunks, generated in %.1f ms\n", size, terrain->GetChunkCount(), timer.GetElapsedTimeMs());
+
+    // The terrain's tick creates the chunk entities, the next one resolves them
+    world->OnTick(0.0);
+    world->OnTick(0.0);
+
+    // A round brush which raises the heights under it, at random places
+    vector<float> heights(brush_size * brush_size);
+    const float radius = brush_size * 0.5f;
+    srand(0);
+    float time_total = 0.0f;
+    float time_max   = 0.0f;
+    for (uint32_t i = 0; i < edit_count; i++)
+    {
+        const uint32_t x = static_cast<uint32_t>(rand()) % (size - brush_size);
+        const uint32_t y = static_cast<uint32_t>(rand()) % (size - brush_size);
+        for (uint32_t j = 0; j < brush_size; j++)
+        {
+            for (uint32_t k = 0; k < brush_size; k++)
+            {
+                const float distance        = sqrtf((k - radius) * (k - radius) + (j - radius) * (j - radius));
+                heights[j * brush_size + k] = 0.5f + 0.5f * max(0.0f, 1.0f - distance / radius);
+            }
+        }
+
+        timer.Start();
+        terrain->SetHeights(x, y, brush_size, brush_size, heights.data());
+        const float time = timer.GetElapsedTimeMs();
+        time_total      += time;
+        time_max         = max(time_max, time);
+    }
+    printf("%u brush edits of %ux%u, %.3f ms average, %.3f ms max\n", edit_count, brush_size, brush_size, time_total / edit_count, time_max);
+
+    // A change of the height range moves every vertex, which is why the editor applies it once it's entered
+    timer.Start();
+    terrain->SetMaxY(terrain->GetMaxY() + 1.0f);
+    printf("height range change, %.1f ms\n", timer.GetElapsedTimeMs());
+
+    return 0;
+}
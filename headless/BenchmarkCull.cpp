@@ -0,0 +1,122 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Stopwatch.h"
+#include "Rendering/Culler.h"
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Culls random boxes against a ring of views and compares with testing them one by one.
+// Usage: spartan_null_headless cull [box_count] [view_count]
+int benchmark_cull(Engine&, const int argc, char** argv)
+{
+    const uint32_t box_count  = get_argument(argc, argv, 0, 100000);
+    const uint32_t view_count = get_argument(argc, argv, 1, 20);
+
+    const uint32_t iteration_count = 100;
+    const float world_size         = 1000.0f;
+
+    // Boxes scattered through the world
+    srand(0);
+    auto random = [](float min, float max) { return min + (max - min) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)); };
+    vector<Math::BoundingBox> boxes;
+    boxes.reserve(box_count);
+    for (uint32_t i = 0; i < box_count; i++)
+    {
+        const Math::Vector3 center = Math::Vector3(random(-world_size, world_size), random(-world_size, world_size), random(-world_size, world_size));
+        const Math::Vector3 extent = Math::Vector3(random(0.5f, 5.0f), random(0.5f, 5.0f), random(0.5f, 5.0f));
+        boxes.emplace_back(center - extent, center + extent);
+    }
+
+    // Views looking outwards from the origin, in a ring
+    vector<Math::Frustum> frustums;
+    vector<Math::Matrix> views;
+    const Math::Matrix projection = Math::Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 16.0f / 9.0f, 0.1f, world_size);
+    for (uint32_t i = 0; i < view_count; i++)
+    {
+        const float angle             = Math::Helper::PI_2 * static_cast<float>(i) / static_cast<float>(view_count);
+        const Math::Vector3 direction = Math::Vector3(Math::Helper::Cos(angle), 0.0f, Math::Helper::Sin(angle));
+        const Math::Matrix view       = Math::Matrix::CreateLookAtLH(Math::Vector3::Zero, direction, Math::Vector3::Up);
+        frustums.emplace_back(view, projection, world_size);
+        views.emplace_back(view);
+    }
+
+    Culler culler;
+    double time_fill = 0.0;
+    double time_cull = 0.0;
+    Stopwatch timer;
+    for (uint32_t iteration = 0; iteration < iteration_count; iteration++)
+    {
+        timer.Start();
+        culler.ClearBoxes();
+        culler.ClearViews();
+        culler.ReserveBoxes(box_count);
+        for (const Math::BoundingBox& box : boxes)
+        {
+            culler.AddBox(box);
+        }
+        for (uint32_t i = 0; i < view_count; i++)
+        {
+            culler.AddView(frustums[i], views[i]);
+        }
+        time_fill += timer.GetElapsedTimeMs();
+
+        timer.Start();
+        culler.Cull();
+        time_cull += timer.GetElapsedTimeMs();
+    }
+
+    uint32_t visible_count = 0;
+    for (uint32_t i = 0; i < view_count; i++)
+    {
+        visible_count += static_cast<uint32_t>(culler.GetVisible(i).size());
+    }
+
+    // What the passes used to do, one box and one view at a time
+    uint32_t visible_count_serial = 0;
+    timer.Start();
+    for (const Math::Frustum& frustum : frustums)
+    {
+        for (const Math::BoundingBox& box : boxes)
+        {
+            visible_count_serial += frustum.IsVisible(box.GetCenter(), box.GetExtents()) ? 1 : 0;
+        }
+    }
+    const float time_serial = timer.GetElapsedTimeMs();
+
+    // Report
+    printf("%u boxes, %u views, %u visible (%u with the serial test), ms\n", box_count, view_count, visible_count, visible_count_serial);
+    printf("%-48s %10.3f\n", "fill (average)", time_fill / iteration_count);
+    printf("%-48s %10.3f\n", "cull (average)", time_cull / iteration_count);
+    printf("%-48s %10.3f\n", "serial", time_serial);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================================================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Stopwatch.h"
+#include "btBulletCollisionCommon.h"
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+//====================================================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Compares the terrain's heightfield collision shape with building a shape from the terrain's mesh.
+// Usage: spartan_null_headless heightfield [size] [query_count]
+int benchmark_heightfield(Engine&, const int argc, char** argv)
+{
+    const uint32_t size        = get_argument(argc, argv, 0, 1024);
+    const uint32_t query_count = get_argument(argc, argv, 1, 10000);
+
+    const float range_y = 30.0f;
+    const float half    = size * 0.5f;
+
+    // Rolling hills in a [0, 1] range, like Terrain's heights
+    vector<float> heights(size * size);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            heights[y * size + x] = 0.5f + 0.25f * sinf(x * 0.05f) * cosf(y * 0.07f) + 0.25f * sinf((x + y) * 0.013f);
+        }
+    }
+
+    // The same grid as a mesh, as Terrain generates it (the copy a mesh collider makes of the renderable's geometry)
+    vector<float> vertices(size * size * 3);
+    vector<int> indices;
+    indices.reserve((size - 1) * (size - 1) * 6);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            float* vertex = &vertices[(y * size + x) * 3];
+            vertex[0]     = x - half;
+            vertex[1]     = heights[y * size + x] * range_y;
+            vertex[2]     = y - half;
+
+            if (x < size - 1 && y < size - 1)
+            {
+                const int bottom_left  = y * size + x;
+                const int bottom_right = bottom_left + 1;
+                const int top_left     = bottom_left + size;
+                const int top_right    = top_left + 1;
+                indices.insert(indices.end(), { bottom_right, bottom_left, top_left, bottom_right, top_left, top_right });
+            }
+        }
+    }
+
+    // Queries, slanted rays from above and spheres resting on the surface
+    srand(0);
+    auto random = [](float min, float max) { return min + (max - min) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)); };
+    vector<pair<btVector3, btVector3>> rays;
+    vector<btVector3> spheres;
+    for (uint32_t i = 0; i < query_count; i++)
+    {
+        const float x = random(-half, half - 1.0f);
+        const float z = random(-half, half - 1.0f);
+        rays.emplace_back(btVector3(x, range_y + 10.0f, z), btVector3(x + random(-half, half) * 0.25f, -10.0f, z + random(-half, half) * 0.25f));
+
+        const uint32_t sample = static_cast<uint32_t>(z + half) * size + static_cast<uint32_t>(x + half);
+        spheres.emplace_back(x, heights[sample] * range_y, z);
+    }
+
+    struct ContactCounter : public btCollisionWorld::ContactResultCallback
+    {
+        btScalar addSingleResult(btManifoldPoint&, const btCollisionObjectWrapper*, int, int, const btCollisionObjectWrapper*, int, int) override
+        {
+            count++;
+            return 0.0f;
+        }
+
+        uint32_t count = 0;
+    };
+
+    printf("%ux%u heights, %u rays, %u sphere contact tests\n", size, size, query_count, query_count);
+    printf("%-32s %12s %12s %12s %12s %8s %10s\n", "shape", "build ms", "memory KB", "rays ms", "contacts ms", "hits", "contacts");
+
+    auto measure = [&](const char* name, btCollisionShape* shape, const btVector3& origin, const float time_build, const uint64_t memory)
+    {
+        btDefaultCollisionConfiguration configuration;
+        btCollisionDispatcher dispatcher(&configuration);
+        btDbvtBroadphase broadphase;
+        btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+
+        btCollisionObject object;
+        object.setCollisionShape(shape);
+        object.setWorldTransform(btTransform(btQuaternion::getIdentity(), origin));
+        world.addCollisionObject(&object);
+        world.updateAabbs();
+
+        uint32_t hits = 0;
+        Stopwatch timer;
+        for (const auto& [from, to] : rays)
+        {
+            btCollisionWorld::ClosestRayResultCallback callback(from, to);
+            world.rayTest(from, to, callback);
+            hits += callback.hasHit() ? 1 : 0;
+        }
+        const float time_rays = timer.GetElapsedTimeMs();
+
+        btSphereShape sphere(2.0f);
+        btCollisionObject probe;
+        probe.setCollisionShape(&sphere);
+        ContactCounter contacts;
+        timer.Start();
+        for (const btVector3& position : spheres)
+        {
+            probe.setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+            world.contactTest(&probe, contacts);
+        }
+        const float time_contacts = timer.GetElapsedTimeMs();
+
+        world.removeCollisionObject(&object);
+
+        printf("%-32s %12.3f %12.1f %12.3f %12.3f %8u %10u\n", name, time_build, memory / 1024.0, time_rays, time_contacts, hits, contacts.count);
+    };
+
+    // Heightfield, what ColliderShape::Terrain builds, reads the heights in place
+    {
+        Stopwatch timer;
+        btHeightfieldTerrainShape shape(static_cast<int>(size), static_cast<int>(size), heights.data(), 0.0f, 1.0f, 1, false);
+        shape.setLocalScaling(btVector3(1.0f, range_y, 1.0f));
+        shape.buildAccelerator();
+        const uint32_t chunks  = (size + 15) / 16;
+        const float time_build = timer.GetElapsedTimeMs();
+
+        measure("heightfield (terrain)", &shape, btVector3(-0.5f, range_y * 0.5f, -0.5f), time_build, sizeof(btHeightfieldTerrainShape) + chunks * chunks * sizeof(btHeightfieldTerrainShape::Range));
+    }
+
+    // Triangle mesh with a bvh, what a correct mesh collider would have to build.
+    // The quantized bvh can only index 2^21 triangles, so it can't represent large terrains at all.
+    if (indices.size() / 3 > (1 << 21))
+    {
+        printf("%-32s %12s\n", "triangle mesh bvh", "too many triangles");
+    }
+    else
+    {
+        Stopwatch timer;
+        btTriangleIndexVertexArray mesh(static_cast<int>(indices.size() / 3), indices.data(), 3 * sizeof(int), static_cast<int>(size * size), vertices.data(), 3 * sizeof(float));
+        btBvhTriangleMeshShape shape(&mesh, true);
+        const float time_build = timer.GetElapsedTimeMs();
+
+        const uint64_t memory = vertices.size() * sizeof(float) + indices.size() * sizeof(int) + shape.getOptimizedBvh()->calculateSerializeBufferSize();
+        measure("triangle mesh bvh", &shape, btVector3(0.0f, 0.0f, 0.0f), time_build, memory);
+    }
+
+    // Convex hull, what ColliderShape::Mesh builds, which can't represent a terrain
+    {
+        Stopwatch timer;
+        btConvexHullShape shape(vertices.data(), static_cast<int>(size * size), 3 * sizeof(float));
+        shape.optimizeConvexHull();
+        shape.initializePolyhedralFeatures();
+        const float time_build = timer.GetElapsedTimeMs();
+
+        measure("convex hull (mesh)", &shape, btVector3(0.0f, 0.0f, 0.0f), time_build, shape.getNumPoints() * sizeof(btVector3));
+    }
+
+    return 0;
+}
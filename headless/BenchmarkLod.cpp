@@ -0,0 +1,101 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "World/Entity.h"
+#include "World/Components/Renderable.h"
+#include "World/World.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/Geometry.h"
+#include "RHI/RHI_Vertex.h"
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Builds the levels of detail of a dense sphere and reports the triangles drawn as it moves away from the camera.
+// Usage: spartan_null_headless lod [segment_count]
+int benchmark_lod(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t segment_count = get_argument(argc, argv, 0, 400);
+
+    Context* context = engine.GetContext();
+    World* world     = context->GetSystem<World>();
+
+    vector<RHI_Vertex_PosTexNorTan> vertices;
+    vector<uint32_t> indices;
+    Geometry::CreateSphere(&vertices, &indices, 1.0f, static_cast<int>(segment_count), static_cast<int>(segment_count));
+
+    // Build
+    Stopwatch timer;
+    vector<uint32_t> lod_indices;
+    vector<MeshLod> lods;
+    Mesh::ComputeLods(indices, vertices, &lod_indices, &lods);
+    const float time_build = timer.GetElapsedTimeMs();
+
+    printf("%u triangles, %u levels built in %.1f ms\n", static_cast<uint32_t>(indices.size() / 3), static_cast<uint32_t>(lods.size()), time_build);
+    printf("%-8s %12s %12s\n", "level", "triangles", "error");
+    printf("%-8u %12u %12.5f\n", 0, static_cast<uint32_t>(indices.size() / 3), 0.0f);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(lods.size()); i++)
+    {
+        printf("%-8u %12u %12.5f\n", i + 1, lods[i].index_count / 3, lods[i].error);
+    }
+
+    // A renderable which draws the sphere
+    shared_ptr<Mesh> mesh = make_shared<Mesh>(context);
+    uint32_t index_offset = 0;
+    mesh->AddIndices(indices, &index_offset);
+    mesh->AddVertices(vertices);
+    mesh->AddLods(lods, lod_indices, index_offset);
+
+    shared_ptr<Entity> entity = world->CreateEntity();
+    Renderable* renderable    = entity->AddComponent<Renderable>();
+    renderable->SetGeometry("sphere", index_offset, static_cast<uint32_t>(indices.size()), 0, static_cast<uint32_t>(vertices.size()), Math::BoundingBox(vertices.data(), static_cast<uint32_t>(vertices.size())), mesh.get());
+
+    // A 1080p camera with a 90 degree vertical field of view, moving away from the sphere
+    const float projection_scale = 1080.0f / (2.0f * Math::Helper::Tan(Math::Helper::PI_DIV_4));
+    printf("\n%-12s %8s %12s %10s\n", "distance", "level", "triangles", "ratio");
+    for (float distance = 2.0f; distance <= 1024.0f; distance *= 2.0f)
+    {
+        renderable->UpdateLod(Math::Vector3(0.0f, 0.0f, -distance), projection_scale);
+        printf("%-12.0f %8u %12u %10.3f\n", distance, renderable->GetLod(), renderable->GetLodIndexCount() / 3, static_cast<float>(renderable->GetLodIndexCount()) / static_cast<float>(indices.size()));
+    }
+
+    // Selection cost
+    const uint32_t iteration_count = 1000000;
+    timer.Start();
+    for (uint32_t i = 0; i < iteration_count; i++)
+    {
+        renderable->UpdateLod(Math::Vector3(0.0f, 0.0f, -static_cast<float>(2 + i % 1000)), projection_scale);
+    }
+    printf("\nselection: %.1f ns per renderable\n", timer.GetElapsedTimeMs() * 1000000.0 / iteration_count);
+
+    renderable->Clear();
+    return 0;
+}
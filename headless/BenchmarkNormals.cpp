@@ -0,0 +1,100 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include "Core/Engine.h"
+#include "Core/Stopwatch.h"
+#include "Core/ProgressTracker.h"
+#include "World/Components/Terrain.h"
+#include "RHI/RHI_Vertex.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Generates the terrain's normals and tangents for grids from 256x256 vertices up to the given size and reports the cost per vertex.
+// Usage: spartan_null_headless normals [size_max]
+int benchmark_normals(Engine&, const int argc, char** argv)
+{
+    const uint32_t size_max = get_argument(argc, argv, 0, 8192);
+
+    printf("%-12s %12s %12s %12s\n", "size", "ms", "ns/vertex", "growth");
+
+    // With a linear cost the time per vertex stays flat (cache misses aside), a quadratic one would grow as much as the vertex count
+    float ns_per_vertex_smallest = 0.0f;
+    float growth_max             = 0.0f;
+    for (uint32_t size = 256; size <= size_max; size *= 2)
+    {
+        // The grid Terrain::GenerateAsync() builds, rolling hills with two triangles per quad and one row of quads after the other
+        vector<RHI_Vertex_PosTexNorTan> vertices(size * size);
+        vector<uint32_t> indices((size - 1) * (size - 1) * 6);
+        for (uint32_t y = 0; y < size; y++)
+        {
+            for (uint32_t x = 0; x < size; x++)
+            {
+                const float height = 15.0f + 7.5f * sinf(x * 0.05f) * cosf(y * 0.07f) + 7.5f * sinf((x + y) * 0.013f);
+                vertices[y * size + x] = RHI_Vertex_PosTexNorTan(Math::Vector3(x - size * 0.5f, height, y - size * 0.5f), Math::Vector2(static_cast<float>(x), static_cast<float>(y < size - 1 ? y + 1 : y - 1)));
+
+                if (x < size - 1 && y < size - 1)
+                {
+                    const uint32_t bottom_left  = y * size + x;
+                    const uint32_t bottom_right = bottom_left + 1;
+                    const uint32_t top_left     = bottom_left + size;
+                    const uint32_t top_right    = top_left + 1;
+                    uint32_t* quad              = &indices[(y * (size - 1) + x) * 6];
+                    quad[0] = bottom_right; quad[1] = bottom_left; quad[2] = top_left;
+                    quad[3] = bottom_right; quad[4] = top_left;    quad[5] = top_right;
+                }
+            }
+        }
+
+        // One job per row of vertices
+        ProgressTracker::GetProgress(ProgressType::Terrain).Start(size, "Generating normals and tangents...");
+
+        Stopwatch timer;
+        Terrain::GenerateNormalsAndTangents(indices, vertices, size, size);
+        const float time = timer.GetElapsedTimeMs();
+
+        const float ns_per_vertex = time * 1000000.0f / static_cast<float>(size * size);
+        if (ns_per_vertex_smallest == 0.0f)
+        {
+            ns_per_vertex_smallest = ns_per_vertex;
+        }
+        const float growth = ns_per_vertex / ns_per_vertex_smallest;
+        growth_max         = max(growth_max, growth);
+
+        printf("%-12s %12.1f %12.1f %12.2f\n", (to_string(size) + "^2").c_str(), time, ns_per_vertex, growth);
+    }
+
+    // From 256^2 to 8192^2 the vertex count grows 1024 times, a few times more per vertex is memory, not complexity
+    const bool is_linear = growth_max < 4.0f;
+    printf("\n%s, the time per vertex grew at most %.2f times\n", is_linear ? "linear" : "not linear", growth_max);
+
+    return is_linear ? 0 : 1;
+}
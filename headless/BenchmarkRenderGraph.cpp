@@ -0,0 +1,258 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <algorithm>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/RenderGraph.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+namespace
+{
+    uint64_t texture_size(const RenderGraphTextureDesc& desc)
+    {
+        uint64_t bits_per_pixel = 32;
+        switch (desc.format)
+        {
+            case RHI_Format_R8_Unorm:
+            case RHI_Format_R8_Uint:            bits_per_pixel = 8;   break;
+            case RHI_Format_R8G8_Unorm:
+            case RHI_Format_R16_Unorm:
+            case RHI_Format_R16_Uint:
+            case RHI_Format_R16_Float:
+            case RHI_Format_D16_Unorm:          bits_per_pixel = 16;  break;
+            case RHI_Format_R16G16B16A16_Unorm:
+            case RHI_Format_R16G16B16A16_Snorm:
+            case RHI_Format_R16G16B16A16_Float:
+            case RHI_Format_R32G32_Float:
+            case RHI_Format_D32_Float_S8X24_Uint: bits_per_pixel = 64;  break;
+            case RHI_Format_R32G32B32_Float:    bits_per_pixel = 96;  break;
+            case RHI_Format_R32G32B32A32_Float: bits_per_pixel = 128; break;
+            default: break;
+        }
+
+        uint64_t size   = 0;
+        uint32_t width  = desc.width;
+        uint32_t height = desc.height;
+        for (uint32_t mip = 0; mip < desc.mips; mip++)
+        {
+            size  += static_cast<uint64_t>(width) * height * bits_per_pixel / 8;
+            width  = max(width / 2, 1u);
+            height = max(height / 2, 1u);
+        }
+
+        return size;
+    }
+
+    void report_render_graph(const RenderGraph& graph)
+    {
+        uint32_t passes_culled = 0;
+        uint32_t barriers      = 0;
+        for (uint32_t pass = 0; pass < graph.GetPassCount(); pass++)
+        {
+            passes_culled += graph.IsPassCulled(pass) ? 1 : 0;
+            barriers      += static_cast<uint32_t>(graph.GetTransitions(pass).size());
+        }
+
+        // Without aliasing every used texture would need its own memory
+        uint64_t size_textures = 0;
+        uint32_t used_count    = 0;
+        for (uint32_t texture = 0; texture < graph.GetTextureCount(); texture++)
+        {
+            if (graph.IsTextureUsed(texture))
+            {
+                size_textures += texture_size(graph.GetTextureDesc(texture));
+                used_count++;
+            }
+        }
+
+        uint64_t size_physical = 0;
+        for (uint32_t physical = 0; physical < graph.GetPhysicalCount(); physical++)
+        {
+            size_physical += texture_size(graph.GetPhysicalDesc(physical));
+        }
+
+        const double mb = 1024.0 * 1024.0;
+        printf("%-32s %u (%u culled)\n", "passes", graph.GetPassCount(), passes_culled);
+        printf("%-32s %u -> %u physical\n", "textures", used_count, graph.GetPhysicalCount());
+        printf("%-32s %.1f MB -> %.1f MB (%.1f MB saved)\n", "memory", size_textures / mb, size_physical / mb, (size_textures - size_physical) / mb);
+        printf("%-32s %u\n", "barriers", barriers);
+    }
+}
+
+// Checks the render graph's pass culling, aliasing and layout transitions on small graphs, then reports the renderer's own graph.
+// Usage: spartan_null_headless rendergraph
+int benchmark_render_graph(Engine& engine, const int argc, char** argv)
+{
+    uint32_t failure_count = 0;
+    auto check = [&failure_count](const bool condition, const char* name)
+    {
+        printf("%-64s %s\n", name, condition ? "ok" : "FAILED");
+        failure_count += condition ? 0 : 1;
+    };
+
+    auto describe = [](const char* name, const RHI_Format format, const bool persistent = false)
+    {
+        RenderGraphTextureDesc desc;
+        desc.name       = name;
+        desc.width      = 1920;
+        desc.height     = 1080;
+        desc.format     = format;
+        desc.persistent = persistent;
+        return desc;
+    };
+
+    // Culling
+    {
+        RenderGraph graph;
+        const uint32_t output    = graph.AddTexture(describe("output", RHI_Format_R16G16B16A16_Float, true));
+        const uint32_t used      = graph.AddTexture(describe("used", RHI_Format_R16G16B16A16_Float));
+        const uint32_t unused    = graph.AddTexture(describe("unused", RHI_Format_R16G16B16A16_Float));
+        const uint32_t feeds     = graph.AddTexture(describe("feeds_unused", RHI_Format_R16G16B16A16_Float));
+        const uint32_t overwrite = graph.AddTexture(describe("overwritten", RHI_Format_R16G16B16A16_Float));
+
+        const uint32_t pass_used = graph.AddPass("writes_used");
+        graph.Write(pass_used, used);
+        const uint32_t pass_feeds = graph.AddPass("writes_what_only_a_culled_pass_reads");
+        graph.Write(pass_feeds, feeds);
+        const uint32_t pass_unused = graph.AddPass("writes_unused");
+        graph.Read(pass_unused, feeds);
+        graph.Write(pass_unused, unused);
+        const uint32_t pass_overwritten = graph.AddPass("writes_what_is_overwritten");
+        graph.Write(pass_overwritten, overwrite);
+        const uint32_t pass_overwrite = graph.AddPass("overwrites");
+        graph.Write(pass_overwrite, overwrite);
+        const uint32_t pass_disabled = graph.AddPass("disabled", false);
+        graph.Write(pass_disabled, output);
+        const uint32_t pass_side = graph.AddPass("side_effects", true, true);
+        graph.Write(pass_side, unused);
+        const uint32_t pass_output = graph.AddPass("writes_output");
+        graph.Read(pass_output, used);
+        graph.Read(pass_output, overwrite);
+        graph.Write(pass_output, output);
+        graph.Compile();
+
+        check(!graph.IsPassCulled(pass_used),       "culling: a pass whose output is read is kept");
+        check(graph.IsPassCulled(pass_unused),      "culling: a pass whose output is never read is culled");
+        check(graph.IsPassCulled(pass_feeds),       "culling: a pass only feeding a culled pass is culled");
+        check(graph.IsPassCulled(pass_overwritten), "culling: a pass whose output is overwritten is culled");
+        check(!graph.IsPassCulled(pass_overwrite),  "culling: the pass which overwrites it is kept");
+        check(graph.IsPassCulled(pass_disabled),    "culling: a disabled pass is culled");
+        check(!graph.IsPassCulled(pass_side),       "culling: a pass with side effects is kept");
+        check(!graph.IsPassCulled(pass_output),     "culling: a pass writing a persistent texture is kept");
+        check(!graph.IsTextureUsed(feeds),          "culling: a texture only culled passes touch gets no memory");
+    }
+
+    // Aliasing
+    {
+        RenderGraph graph;
+        const uint32_t output  = graph.AddTexture(describe("output", RHI_Format_R16G16B16A16_Float, true));
+        const uint32_t a       = graph.AddTexture(describe("a", RHI_Format_R16G16B16A16_Float));
+        const uint32_t b       = graph.AddTexture(describe("b", RHI_Format_R16G16B16A16_Float));
+        const uint32_t c       = graph.AddTexture(describe("c", RHI_Format_R16G16B16A16_Float));
+        const uint32_t overlap = graph.AddTexture(describe("overlaps_b", RHI_Format_R16G16B16A16_Float));
+        const uint32_t format  = graph.AddTexture(describe("other_format", RHI_Format_R8G8B8A8_Unorm));
+        const uint32_t history = graph.AddTexture(describe("history", RHI_Format_R16G16B16A16_Float, true));
+
+        // a lives in passes 0-1, b and overlaps_b in passes 1-2, c, other_format and history in passes 2-3
+        uint32_t pass = graph.AddPass("0");
+        graph.Write(pass, a);
+        pass = graph.AddPass("1");
+        graph.Read(pass, a);
+        graph.Write(pass, b);
+        graph.Write(pass, overlap);
+        pass = graph.AddPass("2");
+        graph.Read(pass, b);
+        graph.Read(pass, overlap);
+        graph.Write(pass, c);
+        graph.Write(pass, format);
+        graph.Write(pass, history);
+        pass = graph.AddPass("3");
+        graph.Read(pass, c);
+        graph.Read(pass, format);
+        graph.Read(pass, history);
+        graph.Write(pass, output);
+        graph.Compile();
+
+        auto shares = [&graph](const uint32_t x, const uint32_t y) { return graph.GetPhysicalIndex(x) == graph.GetPhysicalIndex(y); };
+        check(shares(a, c),                                        "aliasing: a texture reuses the memory of one which is done");
+        check(!shares(a, b) && !shares(b, overlap),                "aliasing: overlapping lifetimes don't share memory");
+        check(!shares(format, a) && !shares(format, b),            "aliasing: different descriptions don't share memory");
+        check(!shares(history, a) && !shares(history, b) && !shares(history, output), "aliasing: a persistent texture never shares memory");
+        check(graph.GetPhysicalCount() == 6,                       "aliasing: 7 textures fit in 6 physical textures");
+    }
+
+    // Barriers
+    {
+        RenderGraph graph;
+        const uint32_t output = graph.AddTexture(describe("output", RHI_Format_R16G16B16A16_Float, true));
+        const uint32_t color  = graph.AddTexture(describe("color", RHI_Format_R16G16B16A16_Float));
+        const uint32_t depth  = graph.AddTexture(describe("depth", RHI_Format_D32_Float));
+
+        const uint32_t pass_draw = graph.AddPass("draw");
+        graph.Write(pass_draw, color, RenderGraphAccess::ColorTarget);
+        graph.Write(pass_draw, depth, RenderGraphAccess::DepthTarget);
+        const uint32_t pass_sample = graph.AddPass("sample");
+        graph.Read(pass_sample, color);
+        graph.Read(pass_sample, depth);
+        graph.Write(pass_sample, output);
+        const uint32_t pass_sample_again = graph.AddPass("sample_again");
+        graph.Read(pass_sample_again, color);
+        graph.Read(pass_sample_again, depth);
+        graph.ReadWrite(pass_sample_again, output);
+        graph.Compile();
+
+        auto has_transition = [&graph](const uint32_t pass, const uint32_t texture, const RHI_Image_Layout layout)
+        {
+            for (const RenderGraphTransition& transition : graph.GetTransitions(pass))
+            {
+                if (transition.physical == graph.GetPhysicalIndex(texture) && transition.layout == layout)
+                    return true;
+            }
+            return false;
+        };
+
+        check(has_transition(pass_draw, color, RHI_Image_Layout::Color_Attachment_Optimal),          "barriers: a color target is transitioned before it's drawn to");
+        check(has_transition(pass_draw, depth, RHI_Image_Layout::Depth_Attachment_Optimal),          "barriers: a depth target is transitioned before it's drawn to");
+        check(has_transition(pass_sample, color, RHI_Image_Layout::Shader_Read_Only_Optimal),        "barriers: a color target is transitioned before it's sampled");
+        check(has_transition(pass_sample, depth, RHI_Image_Layout::Depth_Stencil_Read_Only_Optimal), "barriers: a depth target is transitioned to read only before it's sampled");
+        check(graph.GetTransitions(pass_sample_again).empty(),                                       "barriers: nothing is transitioned when the layouts already match");
+    }
+
+    // The renderer's own graph, as compiled for the current options and resolution
+    {
+        const RenderGraph& graph = engine.GetContext()->GetSystem<Renderer>()->GetRenderGraph();
+        printf("\nrenderer graph\n");
+        report_render_graph(graph);
+    }
+
+    printf("\n%u checks failed\n", failure_count);
+    return failure_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "World/World.h"
+#include "Rendering/Renderer.h"
+#include "Profiling/Profiler.h"
+//=============================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+namespace
+{
+    struct PassTiming
+    {
+        string name;
+        uint32_t depth = 0;
+        double total   = 0.0;
+        uint32_t count = 0;
+    };
+
+    // Time blocks deeper than this are too fine grained for a summary
+    const uint32_t max_depth = 1;
+
+    void accumulate(const vector<TimeBlock>& time_blocks, vector<PassTiming>& timings)
+    {
+        for (const TimeBlock& time_block : time_blocks)
+        {
+            if (!time_block.IsComplete() || time_block.GetType() != TimeBlockType::Cpu || time_block.GetTreeDepth() > max_depth)
+                continue;
+
+            // Linear search keeps the first seen order, which is the order the passes execute in
+            PassTiming* timing = nullptr;
+            for (PassTiming& t : timings)
+            {
+                if (t.depth == time_block.GetTreeDepth() && t.name == time_block.GetName())
+                {
+                    timing = &t;
+                    break;
+                }
+            }
+
+            if (!timing)
+            {
+                timing        = &timings.emplace_back();
+                timing->name  = time_block.GetName();
+                timing->depth = time_block.GetTreeDepth();
+            }
+
+            timing->total += time_block.GetDuration();
+            timing->count++;
+        }
+    }
+}
+
+// Runs the renderer against the null RHI backend and reports the average CPU time of each pass.
+// Usage: spartan_null_headless [frame_count] [warmup_frame_count]
+int benchmark_renderer(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t frame_count        = get_argument(argc, argv, 0, 1000);
+    const uint32_t warmup_frame_count = get_argument(argc, argv, 1, 100);
+
+    Context* context   = engine.GetContext();
+    Renderer* renderer = context->GetSystem<Renderer>();
+    Profiler* profiler = context->GetSystem<Profiler>();
+    World* world       = context->GetSystem<World>();
+
+    // Load the world, this is synchronous
+    world->New();
+
+    // Poll the profiler every frame
+    profiler->SetEnabled(true);
+    profiler->SetUpdateInterval(0.0f);
+
+    vector<PassTiming> timings;
+    double frame_time_total          = 0.0;
+    double cpu_time_total            = 0.0;
+    uint64_t draws                   = 0;
+    uint64_t bindings_index          = 0;
+    uint64_t bindings_vertex         = 0;
+    uint64_t bindings_descriptor_set = 0;
+    uint64_t bindings_pipeline       = 0;
+    uint64_t bytes_uploaded          = 0;
+    uint64_t triangles               = 0;
+    uint64_t triangles_culled        = 0;
+
+    for (uint32_t i = 0; i < warmup_frame_count + frame_count; i++)
+    {
+        engine.Tick();
+        renderer->Present();
+
+        // The first frames create pipelines and descriptor sets, don't let them skew the results
+        if (i < warmup_frame_count)
+            continue;
+
+        accumulate(profiler->GetTimeBlocks(), timings);
+        frame_time_total += profiler->GetTimeFrameLast();
+        cpu_time_total   += profiler->GetTimeCpuLast();
+
+        // Fewer bindings per draw means the sorting groups state well
+        draws                   += profiler->m_rhi_draw;
+        bindings_index          += profiler->m_rhi_bindings_buffer_index;
+        bindings_vertex         += profiler->m_rhi_bindings_buffer_vertex;
+        bindings_descriptor_set += profiler->m_rhi_bindings_descriptor_set;
+        bindings_pipeline       += profiler->m_rhi_bindings_pipeline;
+        bytes_uploaded          += profiler->m_renderer_bytes_uploaded;
+        triangles               += profiler->m_renderer_triangles;
+        triangles_culled        += profiler->m_renderer_triangles_culled;
+    }
+
+    // Report
+    printf("%u frames (%u warmup), average ms\n", frame_count, warmup_frame_count);
+    printf("%-48s %10s %10s\n", "pass", "per frame", "per call");
+    for (const PassTiming& timing : timings)
+    {
+        string name = string(timing.depth * 2, ' ') + timing.name;
+        printf("%-48s %10.3f %10.3f\n", name.c_str(), timing.total / frame_count, timing.total / timing.count);
+    }
+    printf("%-48s %10.3f\n", "cpu", cpu_time_total / frame_count);
+    printf("%-48s %10.3f\n", "frame", frame_time_total / frame_count);
+
+    printf("\naverage per frame\n");
+    printf("%-48s %10.1f\n", "draws", static_cast<double>(draws) / frame_count);
+    printf("%-48s %10.1f\n", "index buffer bindings", static_cast<double>(bindings_index) / frame_count);
+    printf("%-48s %10.1f\n", "vertex buffer bindings", static_cast<double>(bindings_vertex) / frame_count);
+    printf("%-48s %10.1f\n", "descriptor set bindings", static_cast<double>(bindings_descriptor_set) / frame_count);
+    printf("%-48s %10.1f\n", "pipeline bindings", static_cast<double>(bindings_pipeline) / frame_count);
+    printf("%-48s %10.1f\n", "bytes uploaded (KB)", static_cast<double>(bytes_uploaded) / 1024.0 / frame_count);
+    printf("%-48s %10.1f\n", "camera opaque triangles", static_cast<double>(triangles) / frame_count);
+    printf("%-48s %10.3f\n", "  culled by clusters (ratio)", triangles != 0 ? static_cast<double>(triangles_culled) / triangles : 0.0);
+
+    return 0;
+}
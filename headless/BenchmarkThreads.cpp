@@ -0,0 +1,257 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include "Core/Engine.h"
+#include "Core/Stopwatch.h"
+#include "Core/ThreadPool.h"
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+namespace
+{
+    // The baseline, what a pool looks like without local queues or stealing: every thread goes through one mutex
+    class GlobalQueuePool
+    {
+    public:
+        GlobalQueuePool(const uint32_t worker_count)
+        {
+            for (uint32_t i = 0; i < worker_count; i++)
+            {
+                m_threads.emplace_back([this]() { thread_loop(); });
+            }
+        }
+
+        ~GlobalQueuePool()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_condition.notify_all();
+
+            for (thread& thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        void AddTask(function<void()>&& task)
+        {
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_tasks.emplace_back(move(task));
+                m_queued_count++;
+            }
+            m_condition.notify_one();
+        }
+
+        // Runs queued tasks on the calling thread, like the pool's waits do, until everything added has completed
+        void Wait()
+        {
+            while (m_completed_count.load() != m_queued_count.load())
+            {
+                if (!run_one())
+                {
+                    this_thread::yield();
+                }
+            }
+        }
+
+        // Only spins, so that the workers pick everything up
+        void Spin() const
+        {
+            while (m_completed_count.load() != m_queued_count.load())
+            {
+                this_thread::yield();
+            }
+        }
+
+    private:
+        bool run_one()
+        {
+            function<void()> task;
+            {
+                lock_guard<mutex> lock(m_mutex);
+                if (m_tasks.empty())
+                    return false;
+
+                task = move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+            m_completed_count++;
+
+            return true;
+        }
+
+        void thread_loop()
+        {
+            while (true)
+            {
+                function<void()> task;
+                {
+                    unique_lock<mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+
+                    task = move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+
+                task();
+                m_completed_count++;
+            }
+        }
+
+        vector<thread> m_threads;
+        deque<function<void()>> m_tasks;
+        mutex m_mutex;
+        condition_variable m_condition;
+        bool m_stopping = false;
+        atomic<uint64_t> m_queued_count    = 0;
+        atomic<uint64_t> m_completed_count = 0;
+    };
+}
+
+// Measures the thread pool's task throughput and the latency from adding a task to it starting, from 1 to 64 workers,
+// next to a baseline pool with a single global queue behind a mutex.
+// Usage: spartan_null_headless threads [task_count]
+int benchmark_threads(Engine&, const int argc, char** argv)
+{
+    const uint32_t task_count = get_argument(argc, argv, 0, 100000);
+
+    const uint32_t latency_task_count = min(task_count, 10000u);
+
+    // Let the engine's startup work finish, then rebuild the pool at every size
+    ThreadPool::Flush();
+    ThreadPool::Shutdown();
+
+    auto print = [](const char* pool, const uint32_t worker_count, const double tasks_per_second, vector<double>& latencies)
+    {
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](const double p) { return latencies[min(static_cast<size_t>(p * latencies.size()), latencies.size() - 1)]; };
+        printf("%-8u %-10s %14.0f %12.1f %12.1f %12.1f\n", worker_count, pool, tasks_per_second, percentile(0.5), percentile(0.99), percentile(0.999));
+    };
+
+    printf("%-8s %-10s %14s %12s %12s %12s\n", "workers", "pool", "tasks/sec", "p50 us", "p99 us", "p99.9 us");
+    for (uint32_t worker_count = 1; worker_count <= 64; worker_count *= 2)
+    {
+        const uint32_t burst_size = worker_count * 4;
+
+        // Baseline
+        {
+            GlobalQueuePool pool(worker_count);
+
+            atomic<uint64_t> sum = 0;
+            Stopwatch timer;
+            for (uint32_t i = 0; i < task_count; i++)
+            {
+                pool.AddTask([&sum, i]() { sum += i; });
+            }
+            pool.Wait();
+            const double tasks_per_second = task_count / (timer.GetElapsedTimeMs() / 1000.0);
+
+            vector<double> latencies(latency_task_count);
+            for (uint32_t burst_start = 0; burst_start < latency_task_count; burst_start += burst_size)
+            {
+                const uint32_t burst_end = min(burst_start + burst_size, latency_task_count);
+                for (uint32_t i = burst_start; i < burst_end; i++)
+                {
+                    const chrono::steady_clock::time_point added = chrono::steady_clock::now();
+                    pool.AddTask([&latencies, i, added]()
+                    {
+                        latencies[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - added).count();
+                    });
+                }
+
+                pool.Spin();
+            }
+
+            print("global", worker_count, tasks_per_second, latencies);
+        }
+
+        ThreadPool::Initialize(worker_count);
+
+        // Throughput, tiny tasks added from this thread, which helps out while waiting
+        atomic<uint64_t> sum = 0;
+        vector<TaskHandle> handles;
+        handles.reserve(task_count);
+        Stopwatch timer;
+        for (uint32_t i = 0; i < task_count; i++)
+        {
+            handles.emplace_back(ThreadPool::AddTask([&sum, i]() { sum += i; }));
+        }
+        ThreadPool::Wait(handles);
+        const double tasks_per_second = task_count / (timer.GetElapsedTimeMs() / 1000.0);
+        handles.clear();
+
+        // Latency, in bursts of a few tasks per worker, this thread only spins so that the workers pick everything up
+        vector<double> latencies(latency_task_count);
+        for (uint32_t burst_start = 0; burst_start < latency_task_count; burst_start += burst_size)
+        {
+            const uint32_t burst_end = min(burst_start + burst_size, latency_task_count);
+            for (uint32_t i = burst_start; i < burst_end; i++)
+            {
+                const chrono::steady_clock::time_point added = chrono::steady_clock::now();
+                handles.emplace_back(ThreadPool::AddTask([&latencies, i, added]()
+                {
+                    latencies[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - added).count();
+                }));
+            }
+
+            for (const TaskHandle& handle : handles)
+            {
+                while (!handle.IsDone())
+                {
+                    this_thread::yield();
+                }
+            }
+            handles.clear();
+        }
+
+        print("stealing", worker_count, tasks_per_second, latencies);
+
+        ThreadPool::Shutdown();
+    }
+
+    // The engine shuts the pool down on exit
+    ThreadPool::Initialize();
+
+    return 0;
+}
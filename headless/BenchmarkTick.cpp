@@ -0,0 +1,75 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "World/Entity.h"
+#include "World/Components/Renderable.h"
+#include "World/World.h"
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Reports how the cost of a world tick grows with the entity count.
+// Usage: spartan_null_headless tick [entity_count_max] [frame_count]
+int benchmark_tick(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t entity_count_max = get_argument(argc, argv, 0, 100000);
+    const uint32_t frame_count      = get_argument(argc, argv, 1, 100);
+
+    World* world = engine.GetContext()->GetSystem<World>();
+
+    printf("%u frames per entity count, average ms\n", frame_count);
+    printf("%-48s %10s\n", "entities", "world tick");
+
+    // Every tenth entity is renderable, neither transforms nor renderables tick
+    uint32_t entity_count = 0;
+    for (uint32_t entity_count_target = 1000; entity_count_target <= entity_count_max; entity_count_target *= 10)
+    {
+        for (; entity_count < entity_count_target; entity_count++)
+        {
+            shared_ptr<Entity> entity = world->CreateEntity();
+            if (entity_count % 10 == 0)
+            {
+                entity->AddComponent<Renderable>();
+            }
+        }
+
+        // Resolve the new entities
+        world->OnTick(0.0);
+
+        Stopwatch timer;
+        for (uint32_t frame = 0; frame < frame_count; frame++)
+        {
+            world->OnTick(1.0 / 60.0);
+        }
+        printf("%-48u %10.3f\n", entity_count, timer.GetElapsedTimeMs() / frame_count);
+    }
+
+    return 0;
+}
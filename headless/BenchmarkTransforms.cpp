@@ -0,0 +1,99 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "World/Entity.h"
+#include "World/Components/Transform.h"
+#include "World/World.h"
+#include "World/TransformStore.h"
+//=====================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Animates a transform hierarchy and reports how long the world matrix update takes.
+// Usage: spartan_null_headless transforms [transform_count] [frame_count]
+int benchmark_transforms(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t transform_count = get_argument(argc, argv, 0, 100000);
+    const uint32_t frame_count     = get_argument(argc, argv, 1, 100);
+
+    World* world                            = engine.GetContext()->GetSystem<World>();
+    const shared_ptr<TransformStore>& store = world->GetTransformStore();
+
+    // Chains of four, the roots and every other level are animated
+    vector<shared_ptr<Entity>> entities;
+    vector<Transform*> transforms_animated;
+    for (uint32_t i = 0; i < transform_count; i++)
+    {
+        shared_ptr<Entity> entity = entities.emplace_back(world->CreateEntity());
+        Transform* transform      = entity->GetTransform();
+        transform->SetPositionLocal(Math::Vector3(1.0f, 0.0f, 0.0f));
+
+        const uint32_t depth = i % 4;
+        if (depth != 0)
+        {
+            transform->SetParent(entities[i - 1]->GetTransform());
+        }
+
+        if (depth % 2 == 0)
+        {
+            transforms_animated.emplace_back(transform);
+        }
+    }
+
+    // Resolve the entities, which hands their transforms over to the store's update
+    world->OnTick(0.0);
+
+    double time_set    = 0.0;
+    double time_update = 0.0;
+    Stopwatch timer;
+    for (uint32_t frame = 0; frame < frame_count; frame++)
+    {
+        const Math::Quaternion rotation = Math::Quaternion::FromEulerAngles(0.0f, static_cast<float>(frame), 0.0f);
+
+        timer.Start();
+        for (Transform* transform : transforms_animated)
+        {
+            transform->SetRotationLocal(rotation);
+        }
+        time_set += timer.GetElapsedTimeMs();
+
+        timer.Start();
+        store->Update();
+        time_update += timer.GetElapsedTimeMs();
+    }
+
+    // Report
+    printf("%u transforms (%u animated), %u frames, average ms\n", store->GetCount(), static_cast<uint32_t>(transforms_animated.size()), frame_count);
+    printf("%-48s %10.3f\n", "set rotation", time_set / frame_count);
+    printf("%-48s %10.3f\n", "update", time_update / frame_count);
+
+    return 0;
+}
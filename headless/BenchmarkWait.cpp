@@ -0,0 +1,108 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===============
+#include "Benchmarks.h"
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Core/Engine.h"
+#include "Core/Stopwatch.h"
+#include "Core/ThreadPool.h"
+//==========================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Measures how long after a batch of jobs completes the waiting thread resumes, polling with a sleep versus waiting on the task handles.
+// Usage: spartan_null_headless wait [job_count] [iteration_count]
+int benchmark_wait(Engine&, const int argc, char** argv)
+{
+    const uint32_t job_count       = get_argument(argc, argv, 0, 64);
+    const uint32_t iteration_count = get_argument(argc, argv, 1, 50);
+
+    // Each job stands in for converting one mesh of an imported model
+    auto job = []()
+    {
+        Stopwatch timer;
+        while (timer.GetElapsedTimeMs() < 0.5f) {}
+    };
+
+    // The time from the last job finishing to the waiting thread resuming
+    auto measure = [&](const char* name, const bool use_handles)
+    {
+        vector<double> latencies;
+        double total = 0.0;
+        for (uint32_t iteration = 0; iteration < iteration_count; iteration++)
+        {
+            atomic<uint32_t> done_count = 0;
+            atomic<int64_t> done_time   = 0;
+            vector<TaskHandle> handles;
+
+            Stopwatch timer;
+            for (uint32_t i = 0; i < job_count; i++)
+            {
+                handles.emplace_back(ThreadPool::AddTask([&]()
+                {
+                    job();
+                    const int64_t now = chrono::steady_clock::now().time_since_epoch().count();
+                    if (++done_count == job_count)
+                    {
+                        done_time = now;
+                    }
+                }));
+            }
+
+            if (use_handles)
+            {
+                ThreadPool::Wait(handles);
+            }
+            else
+            {
+                // What the model importer used to do
+                while (done_count != job_count)
+                {
+                    this_thread::sleep_for(chrono::milliseconds(16));
+                }
+                ThreadPool::Wait(handles);
+            }
+
+            const int64_t resumed = chrono::steady_clock::now().time_since_epoch().count();
+            total += timer.GetElapsedTimeMs();
+            latencies.emplace_back(chrono::duration<double, micro>(chrono::steady_clock::duration(resumed - done_time.load())).count());
+        }
+
+        sort(latencies.begin(), latencies.end());
+        printf("%-10s %12.1f %12.1f %12.2f\n", name, latencies[latencies.size() / 2], latencies.back(), total / iteration_count);
+    };
+
+    printf("%u jobs of 0.5 ms, %u iterations\n", job_count, iteration_count);
+    printf("%-10s %12s %12s %12s\n", "wait", "p50 us", "max us", "total ms");
+    measure("sleep 16ms", false);
+    measure("handles", true);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Benchmarks.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Stopwatch.h"
+#include "World/Entity.h"
+#include "World/Components/Transform.h"
+#include "World/World.h"
+#include "Rendering/Renderer.h"
+//=====================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Builds, saves and loads a world and reports how long that, and entity lookups, take.
+// Usage: spartan_null_headless world [entity_count]
+int benchmark_world(Engine& engine, const int argc, char** argv)
+{
+    const uint32_t entity_count = get_argument(argc, argv, 0, 100000);
+
+    Context* context   = engine.GetContext();
+    Renderer* renderer = context->GetSystem<Renderer>();
+    World* world       = context->GetSystem<World>();
+
+    // The world resolves its entities when it ticks
+    auto tick = [&engine, renderer]()
+    {
+        engine.Tick();
+        renderer->Present();
+    };
+
+    // Build, every tenth entity is a root and the rest are its children
+    Stopwatch timer;
+    {
+        shared_ptr<Entity> root;
+        for (uint32_t i = 0; i < entity_count; i++)
+        {
+            shared_ptr<Entity> entity = world->CreateEntity();
+            entity->SetName("entity_" + to_string(i));
+
+            if (i % 10 == 0)
+            {
+                root = entity;
+            }
+            else
+            {
+                entity->GetTransform()->SetParent(root->GetTransform());
+            }
+        }
+        tick();
+    }
+    const float time_build = timer.GetElapsedTimeMs();
+
+    timer.Start();
+    if (!world->SaveToFile("headless_benchmark"))
+        return 1;
+    const float time_save = timer.GetElapsedTimeMs();
+
+    timer.Start();
+    if (!world->LoadFromFile(world->GetFilePath()))
+        return 1;
+    tick();
+    const float time_load = timer.GetElapsedTimeMs();
+
+    // Look up every entity, by id and by name
+    vector<uint64_t> ids;
+    vector<string> names;
+    for (const shared_ptr<Entity>& entity : world->GetAllEntities())
+    {
+        ids.emplace_back(entity->GetObjectId());
+        names.emplace_back(entity->GetName());
+    }
+
+    uint32_t found = 0;
+    timer.Start();
+    for (const uint64_t id : ids)
+    {
+        found += world->GetEntityById(id) ? 1 : 0;
+    }
+    const float time_lookup_id = timer.GetElapsedTimeMs();
+
+    timer.Start();
+    for (const string& name : names)
+    {
+        found += world->GetEntityByName(name) ? 1 : 0;
+    }
+    const float time_lookup_name = timer.GetElapsedTimeMs();
+
+    // Report
+    printf("%u entities (%u loaded, %u found), ms\n", entity_count, static_cast<uint32_t>(ids.size()), found);
+    printf("%-48s %10.3f\n", "build", time_build);
+    printf("%-48s %10.3f\n", "save", time_save);
+    printf("%-48s %10.3f\n", "load", time_load);
+    printf("%-48s %10.3f\n", "lookup by id (all)", time_lookup_id);
+    printf("%-48s %10.3f\n", "lookup by name (all)", time_lookup_name);
+
+    return 0;
+}
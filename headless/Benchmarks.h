@@ -0,0 +1,53 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==
+#include <cstdint>
+#include <cstdlib>
+//=============
+
+namespace Spartan
+{
+    class Engine;
+}
+
+// Every mode of the headless benchmark, argv holds the arguments which follow the mode's name
+using Benchmark = int (*)(Spartan::Engine& engine, int argc, char** argv);
+
+int benchmark_renderer(Spartan::Engine& engine, int argc, char** argv); // when no mode is given
+int benchmark_world(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_transforms(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_tick(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_cull(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_heightfield(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_threads(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_render_graph(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_wait(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_lod(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_normals(Spartan::Engine& engine, int argc, char** argv);
+int benchmark_brush(Spartan::Engine& engine, int argc, char** argv);
+
+inline uint32_t get_argument(const int argc, char** argv, const int index, const uint32_t default_value)
+{
+    return index < argc ? static_cast<uint32_t>(atoi(argv[index])) : default_value;
+}
@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========
+#include "Benchmarks.h"
+#include <string>
+#include "Core/Engine.h"
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace Spartan;
+//==================
+
+// Runs the renderer, or one of the modes below, against the null RHI backend and reports what they measure.
+// Usage: spartan_null_headless [mode] [arguments]
+// Each mode lives in its own Benchmark*.cpp file, which describes it and its arguments.
+
+namespace
+{
+    struct Mode
+    {
+        const char* name;
+        Benchmark run;
+    };
+
+    const Mode modes[] =
+    {
+        { "world",       benchmark_world        },
+        { "transforms",  benchmark_transforms   },
+        { "tick",        benchmark_tick         },
+        { "cull",        benchmark_cull         },
+        { "heightfield", benchmark_heightfield  },
+        { "threads",     benchmark_threads      },
+        { "rendergraph", benchmark_render_graph },
+        { "wait",        benchmark_wait         },
+        { "lod",         benchmark_lod          },
+        { "normals",     benchmark_normals      },
+        { "brush",       benchmark_brush        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    Engine engine;
+
+    if (argc > 1)
+    {
+        for (const Mode& mode : modes)
+        {
+            if (string(argv[1]) == mode.name)
+                return mode.run(engine, argc - 2, argv + 2);
+        }
+    }
+
+    // No mode, the arguments are the renderer's
+    return benchmark_renderer(engine, argc - 1, argv + 1);
+}
@@ -65,8 +65,10 @@ enum class EventType
     WorldLoadStart,               // The world is about to be loaded from a file
     WorldLoadEnd,                 // The world finished loading from file
     WorldClear,                   // The world is about to clear everything
-    WorldResolve,                 // The world is resolving
-    WorldResolved,                // The world has finished resolving
+    WorldResolve,                 // The world should resolve, an entity can pass itself so that only it is resolved
+    WorldResolved,                // The world has finished resolving everything, carries all the entities
+    WorldEntitiesAdded,           // The world has finished resolving, carries the entities which were added or changed
+    WorldEntitiesRemoved,         // The world has finished resolving, carries the entities which were removed
     // SDL                        
     EventSDL,                     // An SDL event
     // Window
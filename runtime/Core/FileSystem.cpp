@@ -198,6 +198,16 @@ namespace Spartan
         return false;
     }
 
+    uint64_t FileSystem::GetLastWriteTime(const string& path)
+    {
+        error_code error;
+        const filesystem::file_time_type time = filesystem::last_write_time(path, error);
+        if (error)
+            return 0;
+
+        return static_cast<uint64_t>(time.time_since_epoch().count());
+    }
+
     string FileSystem::GetFileNameFromFilePath(const string& path)
     {
         return filesystem::path(path).filename().generic_string();
@@ -648,4 +658,18 @@ namespace Spartan
         }
     }
 
+    bool FileSystem::Rename(const string& source, const string& destination)
+    {
+        try
+        {
+            filesystem::rename(source, destination);
+            return true;
+        }
+        catch (filesystem::filesystem_error& e)
+        {
+            SP_LOG_ERROR("%s", e.what());
+        }
+
+        return false;
+    }
 }
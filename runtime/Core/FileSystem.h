@@ -82,10 +82,12 @@ namespace Spartan
         static bool Exists(const std::string& path);
         static bool IsDirectory(const std::string& path);
         static bool IsFile(const std::string& path);
+        static uint64_t GetLastWriteTime(const std::string& path); // 0 if the file doesn't exist
         static void OpenUrl(const std::string& url);
         static bool Delete(const std::string& path);
         static bool CreateDirectory(const std::string& path);
         static bool CopyFileFromTo(const std::string& source, const std::string& destination);
+        static bool Rename(const std::string& source, const std::string& destination); // replaces the destination, if it exists
     };
 
     static const char* EXTENSION_WORLD    = ".world";
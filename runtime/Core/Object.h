@@ -39,15 +39,16 @@ namespace Spartan
     {
     public:
         Object(Context* context = nullptr);
+        virtual ~Object() = default;
         
-        // Name
-        const std::string& GetName()    const { return m_name; }
-        void SetName(const std::string& name) { m_name = name; }
+        // Name, virtual so that objects which are indexed by name can keep their index valid
+        const std::string& GetName()            const { return m_name; }
+        virtual void SetName(const std::string& name) { m_name = name; }
 
-        // Id
-        const uint64_t GetObjectId()        const { return m_object_id; }
-        void SetObjectId(const uint64_t id)       { m_object_id = id; }
-        static uint64_t GenerateObjectId()        { return ++g_id; }
+        // Id, virtual so that objects which are indexed by id can keep their index valid
+        const uint64_t GetObjectId()                const { return m_object_id; }
+        virtual void SetObjectId(const uint64_t id)       { m_object_id = id; }
+        static uint64_t GenerateObjectId()                { return ++g_id; }
 
         // CPU & GPU sizes
         const uint64_t GetObjectSizeCpu() const { return m_object_size_cpu; }
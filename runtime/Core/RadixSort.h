@@ -0,0 +1,124 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "ThreadPool.h"
+//======================
+
+namespace Spartan
+{
+    // Sorts items by their 64-bit key member, in ascending order. The sort is stable, one byte is sorted per pass
+    // (least significant first) and bytes which are the same for all the keys are skipped. Large inputs are split
+    // into chunks which are histogrammed and scattered in parallel. The scratch vector is reused between calls.
+    template<typename T>
+    void RadixSort(std::vector<T>& items, std::vector<T>& scratch)
+    {
+        using Histogram = std::array<uint32_t, 256>;
+
+        const uint32_t count = static_cast<uint32_t>(items.size());
+        if (count < 2)
+            return;
+
+        // Chunks are large enough to amortise a histogram each
+        const uint32_t chunk_size_min = 16384;
+        const uint32_t participants   = ThreadPool::GetThreadCount() + 1;
+        const uint32_t chunk_size     = std::max(chunk_size_min, (count + participants - 1) / participants);
+        const uint32_t chunk_count    = (count + chunk_size - 1) / chunk_size;
+
+        scratch.resize(count);
+        std::vector<Histogram> histograms(chunk_count);
+
+        T* source      = items.data();
+        T* destination = scratch.data();
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            // Count
+            ThreadPool::ParallelLoop([&histograms, source, shift, chunk_size, count](uint32_t chunk_start, uint32_t chunk_end)
+            {
+                for (uint32_t chunk = chunk_start; chunk < chunk_end; chunk++)
+                {
+                    Histogram& histogram = histograms[chunk];
+                    histogram.fill(0);
+
+                    const uint32_t index_end = std::min(chunk * chunk_size + chunk_size, count);
+                    for (uint32_t i = chunk * chunk_size; i < index_end; i++)
+                    {
+                        histogram[(source[i].key >> shift) & 0xFF]++;
+                    }
+                }
+            }, chunk_count, 1);
+
+            // Turn the counts into offsets, bucket major so that chunks keep their relative order
+            uint32_t offset = 0;
+            bool skip       = false;
+            for (uint32_t bucket = 0; bucket < 256; bucket++)
+            {
+                uint32_t bucket_count = 0;
+                for (Histogram& histogram : histograms)
+                {
+                    const uint32_t chunk_bucket_count = histogram[bucket];
+                    histogram[bucket]                 = offset + bucket_count;
+                    bucket_count                     += chunk_bucket_count;
+                }
+
+                // Every key has the same byte, nothing to do
+                if (bucket_count == count)
+                {
+                    skip = true;
+                    break;
+                }
+
+                offset += bucket_count;
+            }
+
+            if (skip)
+                continue;
+
+            // Scatter
+            ThreadPool::ParallelLoop([&histograms, source, destination, shift, chunk_size, count](uint32_t chunk_start, uint32_t chunk_end)
+            {
+                for (uint32_t chunk = chunk_start; chunk < chunk_end; chunk++)
+                {
+                    Histogram& histogram = histograms[chunk];
+
+                    const uint32_t index_end = std::min(chunk * chunk_size + chunk_size, count);
+                    for (uint32_t i = chunk * chunk_size; i < index_end; i++)
+                    {
+                        destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+                    }
+                }
+            }, chunk_count, 1);
+
+            std::swap(source, destination);
+        }
+
+        // An odd number of passes leaves the result in the scratch
+        if (source != items.data())
+        {
+            items.swap(scratch);
+        }
+    }
+}
@@ -30,63 +30,313 @@ using namespace std;
 
 namespace Spartan
 {
+    struct TaskNode
+    {
+        Task task;
+
+        // Dependencies which haven't completed yet, the task is queued once this reaches zero
+        atomic<uint32_t> dependency_count = 0;
+
+        // Tasks which depend on this one
+        mutex mutex_dependents;
+        vector<shared_ptr<TaskNode>> dependents;
+
+        atomic<bool> done             = false;
+        atomic<uint32_t> waiter_count = 0;
+
+        // Keeps the node alive while it's pending or queued, released once it's done
+        shared_ptr<TaskNode> self;
+    };
+
+    // A Chase-Lev work stealing deque (see "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013).
+    // The owning worker pushes and pops from the bottom, any other thread can steal from the top.
+    class WorkStealingQueue
+    {
+    public:
+        // Owner only, returns false if the queue is full.
+        bool Push(TaskNode* task)
+        {
+            int64_t bottom = m_bottom.load(memory_order_relaxed);
+            int64_t top    = m_top.load(memory_order_acquire);
+
+            if (bottom - top >= static_cast<int64_t>(capacity))
+                return false;
+
+            m_tasks[bottom & mask].store(task, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+            m_bottom.store(bottom + 1, memory_order_relaxed);
+
+            return true;
+        }
+
+        // Owner only, LIFO.
+        TaskNode* Pop()
+        {
+            int64_t bottom = m_bottom.load(memory_order_relaxed) - 1;
+            m_bottom.store(bottom, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            int64_t top = m_top.load(memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // Empty
+                m_bottom.store(bottom + 1, memory_order_relaxed);
+                return nullptr;
+            }
+
+            TaskNode* task = m_tasks[bottom & mask].load(memory_order_relaxed);
+
+            // Last task, race against thieves
+            if (top == bottom)
+            {
+                if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+                {
+                    task = nullptr;
+                }
+
+                m_bottom.store(bottom + 1, memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        // Any thread, FIFO.
+        TaskNode* Steal()
+        {
+            int64_t top = m_top.load(memory_order_acquire);
+            atomic_thread_fence(memory_order_seq_cst);
+            int64_t bottom = m_bottom.load(memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            TaskNode* task = m_tasks[top & mask].load(memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+                return nullptr; // lost the race to the owner or another thief
+
+            return task;
+        }
+
+    private:
+        static constexpr uint32_t capacity = 4096; // must be a power of two
+        static constexpr uint32_t mask     = capacity - 1;
+
+        // Keep the indices on separate cache lines, the owner hammers the bottom while thieves hammer the top
+        alignas(64) atomic<int64_t> m_top    = 0;
+        alignas(64) atomic<int64_t> m_bottom = 0;
+        array<atomic<TaskNode*>, capacity> m_tasks;
+    };
+
     // Stats
     static uint32_t thread_count                 = 0;
     static uint32_t thread_count_support         = 0;
     static atomic<uint32_t> working_thread_count = 0;
+    static atomic<uint32_t> queued_task_count    = 0;
 
     // Sync objects
-    static mutex mutex_tasks;
+    static mutex mutex_sleep;
     static condition_variable condition_var;
+    static atomic<uint32_t> sleeping_thread_count = 0;
 
     // Threads
     static vector<thread> threads;
+    static thread_local int32_t thread_index = -1; // -1 for any thread which is not a worker
 
     // Tasks
-    static deque<Task> tasks;
+    static vector<unique_ptr<WorkStealingQueue>> queues_local; // one per worker
+    static deque<TaskNode*> queue_global;                         // injection queue, fed by non-worker threads (or full local queues)
+    static mutex mutex_queue_global;
 
     // Misc
-    static bool is_stopping;
+    static atomic<bool> is_stopping = false;
+    static const uint32_t spin_count = 64;
 
-    static void thread_loop()
+    static uint32_t random_victim()
     {
-        while (true)
+        // xorshift, it only has to be cheap and different per thread
+        static thread_local uint32_t state = 0x9E3779B9u ^ static_cast<uint32_t>(hash<thread::id>()(this_thread::get_id()));
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    static void push_task(TaskNode* task)
+    {
+        // Count it before it becomes visible, so that a fast consumer can't bring the count below zero
+        queued_task_count++;
+
+        // Workers keep the tasks they spawn local, everyone else goes through the global queue
+        if (thread_index < 0 || !queues_local[thread_index]->Push(task))
         {
-            // Lock tasks mutex
-            unique_lock<mutex> lock(mutex_tasks);
+            lock_guard<mutex> lock(mutex_queue_global);
+            queue_global.emplace_back(task);
+        }
 
-            // Check condition on notification
-            condition_var.wait(lock, [] { return !tasks.empty() || is_stopping; });
+        // Wake up a thread, but only pay for the mutex if someone is actually sleeping
+        if (sleeping_thread_count.load() != 0)
+        {
+            {
+                lock_guard<mutex> lock(mutex_sleep);
+            }
 
-            // If m_stopping is true, it's time to shut everything down
-            if (is_stopping && tasks.empty())
-                return;
+            condition_var.notify_one();
+        }
+    }
 
-            // Get next task in the queue.
-            Task task = tasks.front();
+    static TaskNode* pop_task()
+    {
+        TaskNode* task = nullptr;
 
-            // Remove it from the queue.
-            tasks.pop_front();
+        // 1. Own queue
+        if (thread_index >= 0)
+        {
+            task = queues_local[thread_index]->Pop();
+        }
 
-            // Unlock the mutex
-            lock.unlock();
+        // 2. Global queue
+        if (!task)
+        {
+            lock_guard<mutex> lock(mutex_queue_global);
+            if (!queue_global.empty())
+            {
+                task = queue_global.front();
+                queue_global.pop_front();
+            }
+        }
 
-            // Execute the task.
+        // 3. Steal from another worker, starting at a random one
+        if (!task && thread_count != 0)
+        {
+            uint32_t offset = random_victim();
+            for (uint32_t i = 0; i < thread_count && !task; i++)
+            {
+                uint32_t victim = (offset + i) % thread_count;
+                if (static_cast<int32_t>(victim) != thread_index)
+                {
+                    task = queues_local[victim]->Steal();
+                }
+            }
+        }
+
+        // Count it as working before it stops counting as queued, so that Flush() never sees both at zero in between
+        if (task)
+        {
             working_thread_count++;
-            task();
-            working_thread_count--;
+            queued_task_count--;
         }
+
+        return task;
     }
 
-    void ThreadPool::Initialize()
+    static void schedule_task(TaskNode* task);
+
+    // The caller must have counted the task as working, it stops counting once its dependents are queued
+    static void finish_task(TaskNode* task, bool execute)
+    {
+        if (execute)
+        {
+            task->task();
+        }
+
+        // Release anything the task captured
+        task->task = nullptr;
+
+        // Mark as done and take ownership of the dependents
+        vector<shared_ptr<TaskNode>> dependents;
+        {
+            lock_guard<mutex> lock(task->mutex_dependents);
+            task->done = true;
+            dependents.swap(task->dependents);
+        }
+
+        // Wake up anyone waiting on this task
+        if (task->waiter_count.load() != 0)
+        {
+            {
+                lock_guard<mutex> lock(mutex_sleep);
+            }
+
+            condition_var.notify_all();
+        }
+
+        // Queue any dependents which were only waiting on this task
+        for (shared_ptr<TaskNode>& dependent : dependents)
+        {
+            if (--dependent->dependency_count == 0)
+            {
+                schedule_task(dependent.get());
+            }
+        }
+
+        working_thread_count--;
+
+        // Drop the in-flight reference last, this can destroy the task
+        shared_ptr<TaskNode> self = move(task->self);
+    }
+
+    static void schedule_task(TaskNode* task)
+    {
+        // Nobody to hand the task to (single core machine)
+        if (thread_count == 0)
+        {
+            working_thread_count++;
+            finish_task(task, true);
+            return;
+        }
+
+        push_task(task);
+    }
+
+    static void thread_loop(int32_t index)
+    {
+        thread_index = index;
+
+        while (true)
+        {
+            // Look for work, spin for a little while before going to sleep
+            TaskNode* task = nullptr;
+            for (uint32_t i = 0; i < spin_count && !task; i++)
+            {
+                task = pop_task();
+
+                if (!task)
+                {
+                    this_thread::yield();
+                }
+            }
+
+            if (task)
+            {
+                finish_task(task, true);
+                continue;
+            }
+
+            // Sleep until there is something to do (or it's time to shut down)
+            unique_lock<mutex> lock(mutex_sleep);
+            sleeping_thread_count++;
+            condition_var.wait(lock, [] { return queued_task_count.load() != 0 || is_stopping; });
+            sleeping_thread_count--;
+
+            if (is_stopping && queued_task_count.load() == 0)
+                return;
+        }
+    }
+
+    void ThreadPool::Initialize(const uint32_t worker_count /*= 0*/)
     {
         is_stopping          = false;
         thread_count_support = thread::hardware_concurrency();
-        thread_count         = thread_count_support - 1; // exclude the calling thread
+        thread_count         = worker_count != 0 ? worker_count : thread_count_support - 1; // exclude the calling thread
 
         for (uint32_t i = 0; i < thread_count; i++)
         {
-            threads.emplace_back(thread(&thread_loop));
+            queues_local.emplace_back(make_unique<WorkStealingQueue>());
+        }
+
+        for (uint32_t i = 0; i < thread_count; i++)
+        {
+            threads.emplace_back(thread(&thread_loop, static_cast<int32_t>(i)));
         }
 
         SP_LOG_INFO("%d threads have been created", thread_count);
@@ -96,14 +346,11 @@ namespace Spartan
     {
         Flush(true);
 
-        // Put unique lock on task mutex.
-        unique_lock<mutex> lock(mutex_tasks);
-
         // Set termination flag to true.
-        is_stopping = true;
-
-        // Unlock the mutex
-        lock.unlock();
+        {
+            lock_guard<mutex> lock(mutex_sleep);
+            is_stopping = true;
+        }
 
         // Wake up all threads.
         condition_var.notify_all();
@@ -116,91 +363,182 @@ namespace Spartan
 
         // Empty worker threads.
         threads.clear();
+        queues_local.clear();
     }
 
-    void ThreadPool::AddTask(Task&& task)
+    TaskHandle ThreadPool::AddTask(Task&& task, const vector<TaskHandle>& dependencies /*= {}*/)
     {
-        if (GetIdleThreadCount() == 0)
+        shared_ptr<TaskNode> node = make_shared<TaskNode>();
+        node->task                = move(task);
+        node->self                = node;
+
+        // Register with any incomplete dependencies.
+        // The extra count prevents the task from being queued while registration is still in progress.
+        node->dependency_count = 1;
+        for (const TaskHandle& dependency : dependencies)
         {
-            SP_LOG_WARNING("No available threads, function will execute in the calling thread");
-            task();
-            return;
+            if (!dependency.m_node)
+                continue;
+
+            lock_guard<mutex> lock(dependency.m_node->mutex_dependents);
+            if (!dependency.m_node->done)
+            {
+                node->dependency_count++;
+                dependency.m_node->dependents.emplace_back(node);
+            }
         }
 
-        // Lock tasks mutex
-        unique_lock<mutex> lock(mutex_tasks);
+        TaskHandle handle;
+        handle.m_node = node;
 
-        // Save the task
-        tasks.emplace_back(bind(forward<Task>(task)));
+        if (--node->dependency_count == 0)
+        {
+            schedule_task(node.get());
+        }
 
-        // Unlock the mutex
-        lock.unlock();
+        return handle;
+    }
 
-        // Wake up a thread
-        condition_var.notify_one();
+    void ThreadPool::Wait(const vector<TaskHandle>& handles)
+    {
+        for (const TaskHandle& handle : handles)
+        {
+            handle.Wait();
+        }
     }
 
-    void ThreadPool::ParallelLoop(function<void(uint32_t work_index_start, uint32_t work_index_end)>&& function, uint32_t loop_range)
+    void ThreadPool::ParallelLoop(function<void(uint32_t work_index_start, uint32_t work_index_end)>&& function, uint32_t work_count, uint32_t grain_size /*= 0*/)
     {
-        SP_ASSERT_MSG(loop_range > 1, "A parallel loop can't have a range of 1 or smaller");
+        if (work_count == 0)
+            return;
 
-        uint32_t available_threads = GetIdleThreadCount();
-        uint32_t work_total        = loop_range;
-        uint32_t work_per_thread   = work_total / available_threads;
-        uint32_t work_remainder    = work_total % available_threads;
-        uint32_t work_index        = 0;
-        atomic<uint32_t> work_done = 0;
+        grain_size                 = grain_size != 0 ? grain_size : GetGrainSize(work_count);
+        const uint32_t chunk_count = (work_count + grain_size - 1) / grain_size;
 
-        // Split work into multiple tasks
-        while(work_index < work_total)
+        // Not worth distributing
+        if (chunk_count == 1 || thread_count == 0)
         {
-            uint32_t work_to_do = work_per_thread;
+            function(0, work_count);
+            return;
+        }
 
-            // If the work doesn't divide evenly across threads, add the remainder work to the first thread.
-            if (work_remainder != 0)
+        // Every participant keeps grabbing the next chunk until there are none left, so faster threads simply do more chunks
+        atomic<uint32_t> chunk_next = 0;
+        auto participate = [&function, &chunk_next, chunk_count, grain_size, work_count]()
+        {
+            for (uint32_t chunk = chunk_next++; chunk < chunk_count; chunk = chunk_next++)
             {
-                work_to_do     += work_remainder;
-                work_remainder = 0;
+                const uint32_t work_index_start = chunk * grain_size;
+                const uint32_t work_index_end   = Math::Helper::Min(work_index_start + grain_size, work_count);
+                function(work_index_start, work_index_end);
             }
+        };
 
-            AddTask([&function, &work_done, work_index, work_to_do]()
-            {
-                function(work_index, work_index + work_to_do);
-                work_done += work_to_do;
-            });
-
-            work_index += work_to_do;
+        // Enlist helpers, the calling thread is a participant too
+        const uint32_t helper_count = Math::Helper::Min(thread_count, chunk_count - 1);
+        vector<TaskHandle> helpers;
+        helpers.reserve(helper_count);
+        for (uint32_t i = 0; i < helper_count; i++)
+        {
+            helpers.emplace_back(AddTask(participate));
         }
 
-        SP_ASSERT_MSG(work_index == work_total, "Some work wasn't assigned to any thread");
+        participate();
 
-        // Wait for threads to finish work
-        while (work_done != work_total)
-        {
-            this_thread::sleep_for(chrono::microseconds(16));
-        }
+        // Helpers which didn't get a chance to start will find no chunks left and return immediately.
+        // Waiting executes queued tasks, so nested loops can't deadlock.
+        Wait(helpers);
+    }
 
-        SP_ASSERT_MSG(work_done == work_total, "One or more threads, didn't finish their work");
+    uint32_t ThreadPool::GetGrainSize(uint32_t work_count)
+    {
+        // Aim for a few chunks per participant, that's enough to balance uneven work without too much overhead
+        const uint32_t chunks_per_thread = 4;
+        return Math::Helper::Max(1u, work_count / ((thread_count + 1) * chunks_per_thread));
     }
 
     void ThreadPool::Flush(bool remove_queued /*= false*/)
     {
-        // Clear any queued tasks
+        // Clear any queued tasks, they count as done so that nobody waits on them forever.
+        // Removing a task can queue its dependents, so keep going until nothing is left.
         if (remove_queued)
         {
-            tasks.clear();
+            bool removed = true;
+            while (removed)
+            {
+                removed = false;
+
+                // Stealing is safe from any thread, so drain the local queues that way
+                for (unique_ptr<WorkStealingQueue>& queue : queues_local)
+                {
+                    while (TaskNode* task = queue->Steal())
+                    {
+                        working_thread_count++;
+                        queued_task_count--;
+                        finish_task(task, false);
+                        removed = true;
+                    }
+                }
+
+                deque<TaskNode*> tasks;
+                {
+                    lock_guard<mutex> lock(mutex_queue_global);
+                    tasks.swap(queue_global);
+                }
+
+                for (TaskNode* task : tasks)
+                {
+                    working_thread_count++;
+                    queued_task_count--;
+                    finish_task(task, false);
+                    removed = true;
+                }
+            }
         }
 
-        // If so, wait for them
-        while (AreTasksRunning())
+        // Wait for any queued or running tasks
+        while (queued_task_count.load() != 0 || AreTasksRunning())
         {
             this_thread::sleep_for(chrono::milliseconds(16));
         }
     }
 
+    bool TaskHandle::IsDone() const
+    {
+        return !m_node || m_node->done.load();
+    }
+
+    void TaskHandle::Wait() const
+    {
+        if (!m_node)
+            return;
+
+        while (!m_node->done.load())
+        {
+            // Help out instead of idling
+            if (TaskNode* task = pop_task())
+            {
+                finish_task(task, true);
+                continue;
+            }
+
+            // Nothing to help with, sleep until the task is done or new work shows up
+            m_node->waiter_count++;
+            {
+                unique_lock<mutex> lock(mutex_sleep);
+                sleeping_thread_count++;
+                condition_var.wait(lock, [this] { return m_node->done.load() || queued_task_count.load() != 0; });
+                sleeping_thread_count--;
+            }
+            m_node->waiter_count--;
+        }
+    }
+
     uint32_t ThreadPool::GetThreadCount()          { return thread_count; }
     uint32_t ThreadPool::GetSupportedThreadCount() { return thread_count_support; }
-    uint32_t ThreadPool::GetWorkingThreadCount()   { return working_thread_count; }
-    uint32_t ThreadPool::GetIdleThreadCount()      { return thread_count - working_thread_count; }
-    bool ThreadPool::AreTasksRunning()             { return GetIdleThreadCount() != GetThreadCount(); }
+    bool ThreadPool::AreTasksRunning()             { return working_thread_count.load() != 0; }
+
+    // Threads which help out while waiting (or while flushing) count as working too, so the count can exceed the workers
+    uint32_t ThreadPool::GetWorkingThreadCount()   { return Math::Helper::Min(working_thread_count.load(), thread_count); }
+    uint32_t ThreadPool::GetIdleThreadCount()      { return thread_count - GetWorkingThreadCount(); }
 }
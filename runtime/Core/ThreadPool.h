@@ -24,23 +24,81 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===========
 #include "Definitions.h"
 #include <functional>
+#include <memory>
+#include <vector>
 //======================
 
 namespace Spartan
 {
     using Task = std::function<void()>;
+    struct TaskNode;
+
+    // A handle to a task which was added to the pool, it can be waited on or used as a dependency of other tasks.
+    class SP_CLASS TaskHandle
+    {
+    public:
+        bool IsValid() const { return m_node != nullptr; }
+        bool IsDone() const;
+
+        // Blocks until the task is done, executing other queued tasks in the meantime.
+        void Wait() const;
+
+    private:
+        friend class ThreadPool;
+        std::shared_ptr<TaskNode> m_node;
+    };
 
     class SP_CLASS ThreadPool
     {
     public:
-        static void Initialize();
+        // Creates worker_count threads, 0 creates one per hardware thread besides the calling one
+        static void Initialize(uint32_t worker_count = 0);
         static void Shutdown();
 
-        // Add a task.
-        static void AddTask(Task&& task);
+        // Add a task, it will be queued once all of its dependencies are done.
+        static TaskHandle AddTask(Task&& task, const std::vector<TaskHandle>& dependencies = {});
+
+        // Wait for the given tasks to finish, the calling thread helps execute queued tasks in the meantime.
+        static void Wait(const std::vector<TaskHandle>& handles);
+
+        // Splits the range into chunks of grain_size (0 picks one automatically) which are processed by the available threads and the calling thread.
+        // The function is called with [work_index_start, work_index_end) ranges and it's safe to nest loops.
+        static void ParallelLoop(std::function<void(uint32_t work_index_start, uint32_t work_index_end)>&& function, uint32_t work_count, uint32_t grain_size = 0);
+
+        // Like ParallelLoop, but each chunk returns a value and the values are combined with reduce (e.g. merging bounding boxes).
+        template<typename T>
+        static T ParallelReduce(std::function<T(uint32_t work_index_start, uint32_t work_index_end)>&& function, std::function<T(const T& a, const T& b)>&& reduce, const T& identity, uint32_t work_count, uint32_t grain_size = 0)
+        {
+            if (work_count == 0)
+                return identity;
+
+            grain_size                 = grain_size != 0 ? grain_size : GetGrainSize(work_count);
+            const uint32_t chunk_count = (work_count + grain_size - 1) / grain_size;
+
+            // Reduce each chunk into its own slot
+            std::vector<T> results(chunk_count, identity);
+            ParallelLoop([&function, &results, grain_size, work_count](uint32_t chunk_start, uint32_t chunk_end)
+            {
+                for (uint32_t chunk = chunk_start; chunk < chunk_end; chunk++)
+                {
+                    const uint32_t work_index_start = chunk * grain_size;
+                    const uint32_t work_index_end   = work_count - work_index_start > grain_size ? work_index_start + grain_size : work_count;
+                    results[chunk]                  = function(work_index_start, work_index_end);
+                }
+            }, chunk_count, 1);
+
+            // Combine the chunks, in order
+            T result = identity;
+            for (const T& value : results)
+            {
+                result = reduce(result, value);
+            }
+
+            return result;
+        }
 
-        // Adds multiple tasks to spread execution of a given function across all available threads.
-        static void ParallelLoop(std::function<void(uint32_t work_index_start, uint32_t work_index_end)>&& function, uint32_t work_count);
+        // The chunk size ParallelLoop uses when none is specified.
+        static uint32_t GetGrainSize(uint32_t work_count);
 
         // Wait for all threads to finish work
         static void Flush(bool remove_queued = false);
@@ -46,6 +46,11 @@ namespace Spartan
 {
     Window::Window(Context* context) : ISystem(context)
     {
+        // The null backend never presents, so don't require a display
+        #if defined(API_GRAPHICS_NULL)
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        #endif
+
         // Initialise video subsystem (if needed)
         if (SDL_WasInit(SDL_INIT_VIDEO) != 1)
         {
@@ -66,14 +71,16 @@ namespace Spartan
             }
         }
 
-        // Show a splash screen
-        CreateAndShowSplashScreen();
-
         // Set window flags
         uint32_t flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_MAXIMIZED;
 
+        #if !defined(API_GRAPHICS_NULL)
+        // Show a splash screen
+        CreateAndShowSplashScreen();
+
         // If the swapchain surface is created using SDL_Vulkan_CreateSurface(), then the window needs this flag.
         flags |= SDL_WINDOW_VULKAN;
+        #endif
 
         // Create window
         m_title        = "Spartan " + to_string(sp_version_major) + "." + to_string(sp_version_minor) + "." + to_string(sp_version_revision);
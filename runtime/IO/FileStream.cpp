@@ -68,6 +68,28 @@ namespace Spartan
         Close();
     }
 
+    uint64_t FileStream::GetRemainingSize()
+    {
+        if (!(m_flags & FileStream_Read) || in.fail())
+            return 0;
+
+        const streampos position = in.tellg();
+        in.seekg(0, ios::end);
+        const streampos end = in.tellg();
+        in.seekg(position);
+
+        return end > position ? static_cast<uint64_t>(end - position) : 0;
+    }
+
+    bool FileStream::CanRead(const uint64_t size)
+    {
+        if (size <= GetRemainingSize())
+            return true;
+
+        in.setstate(ios::failbit);
+        return false;
+    }
+
     void FileStream::Close()
     {
         if (m_flags & FileStream_Write)
@@ -152,6 +174,12 @@ namespace Spartan
         uint32_t length = 0;
         Read(&length);
 
+        if (!CanRead(length))
+        {
+            value->clear();
+            return;
+        }
+
         value->resize(length);
         in.read(const_cast<char*>(value->c_str()), length);
     }
@@ -166,6 +194,10 @@ namespace Spartan
         uint32_t size = 0;
         Read(&size);
 
+        // Every string has at least its length
+        if (!CanRead(sizeof(uint32_t) * static_cast<uint64_t>(size)))
+            return;
+
         string str;
         for (uint32_t i = 0; i < size; i++)
         {
@@ -182,6 +214,8 @@ namespace Spartan
         vec->clear();
 
         const auto length = ReadAs<uint32_t>();
+        if (!CanRead(sizeof(RHI_Vertex_PosTexNorTan) * static_cast<uint64_t>(length)))
+            return;
 
         vec->reserve(length);
         vec->resize(length);
@@ -197,6 +231,8 @@ namespace Spartan
         vec->clear();
 
         const auto length = ReadAs<uint32_t>();
+        if (!CanRead(sizeof(uint32_t) * static_cast<uint64_t>(length)))
+            return;
 
         vec->reserve(length);
         vec->resize(length);
@@ -212,6 +248,8 @@ namespace Spartan
         vec->clear();
 
         const auto length = ReadAs<uint32_t>();
+        if (!CanRead(sizeof(unsigned char) * static_cast<uint64_t>(length)))
+            return;
 
         vec->reserve(length);
         vec->resize(length);
@@ -227,6 +265,8 @@ namespace Spartan
         vec->clear();
 
         const auto length = ReadAs<uint32_t>();
+        if (!CanRead(sizeof(std::byte) * static_cast<uint64_t>(length)))
+            return;
 
         vec->reserve(length);
         vec->resize(length);
@@ -52,6 +52,10 @@ namespace Spartan
         auto IsOpen() const { return m_is_open; }
         void Close();
 
+        // False once a read went past the end of the file (or a write failed), reads after that return zeros
+        bool IsGood() const { return (m_flags & FileStream_Write) ? !out.fail() : !in.fail(); }
+        uint64_t GetRemainingSize();
+
         //= WRITING ==================================================
         template <class T, class = typename std::enable_if<
             std::is_same<T, bool>::value                ||
@@ -150,13 +154,16 @@ namespace Spartan
         >::type> 
         T ReadAs()
         {
-            T value;
+            T value = {};
             Read(&value);
             return value;
         }
         //=====================================================
 
     private:
+        // Fails the stream, instead of allocating, when a count read from the file asks for more than what's left of it
+        bool CanRead(uint64_t size);
+
         std::ofstream out;
         std::ifstream in;
         uint32_t m_flags;
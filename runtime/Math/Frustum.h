@@ -38,6 +38,9 @@ namespace Spartan::Math
 
         bool IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane = false) const;
 
+        // Planes are ordered as near, far, left, right, top, bottom
+        const Plane& GetPlane(const uint32_t index) const { return m_planes[index]; }
+
     private:
         Intersection CheckCube(const Vector3& center, const Vector3& extent) const;
         Intersection CheckSphere(const Vector3& center, float radius) const;
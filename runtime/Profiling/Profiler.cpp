@@ -39,6 +39,117 @@ namespace Spartan
 {
     static const int initial_capacity = 256;
 
+    // A CPU time block which was ended on some thread
+    struct CpuTimeBlockEvent
+    {
+        const char* name = nullptr;
+        chrono::high_resolution_clock::time_point start;
+        chrono::high_resolution_clock::time_point end;
+    };
+
+    // Time block state of a single thread
+    struct ThreadTimeBlocks
+    {
+        // Blocks which have started but not ended, only touched by the owning thread
+        struct OpenTimeBlock
+        {
+            const char* name = nullptr;
+            chrono::high_resolution_clock::time_point start;
+            TimeBlockType type = TimeBlockType::Undefined;
+            bool is_recorded   = false;
+        };
+        static const uint32_t open_capacity = 64;
+        array<OpenTimeBlock, open_capacity> open;
+        uint32_t open_count = 0;
+
+        // Ended CPU blocks, a lock-free single producer (the owning thread) single consumer (the profiler) ring buffer
+        static const uint32_t event_capacity = 4096; // must be a power of two
+        array<CpuTimeBlockEvent, event_capacity> events;
+        atomic<uint32_t> event_write = 0;
+        atomic<uint32_t> event_read  = 0;
+
+        uint32_t index = 0;
+    };
+
+    static mutex mutex_threads;
+    static vector<unique_ptr<ThreadTimeBlocks>> threads;
+    static vector<ThreadTimeBlocks*> threads_free; // left behind by threads which exited, reused by new ones
+    static atomic<bool> is_recording = false;
+
+    // Chrome trace track for GPU blocks, CPU blocks use their thread index
+    static const uint32_t capture_thread_id_gpu = 1000;
+
+    // Gives the thread's time blocks back when the thread exits, so that threads which come and go (the thread pool re-initializing) don't pile them up.
+    // They stay in the list, so any blocks that the profiler hasn't merged yet still are, and the next thread that asks for time blocks continues with them.
+    struct ThreadTimeBlocksOwner
+    {
+        ThreadTimeBlocks* thread_time_blocks = nullptr;
+
+        ~ThreadTimeBlocksOwner()
+        {
+            if (!thread_time_blocks)
+                return;
+
+            lock_guard<mutex> lock(mutex_threads);
+            thread_time_blocks->open_count = 0;
+            threads_free.emplace_back(thread_time_blocks);
+        }
+    };
+
+    static ThreadTimeBlocks& get_thread_time_blocks()
+    {
+        static thread_local ThreadTimeBlocksOwner owner;
+
+        if (!owner.thread_time_blocks)
+        {
+            lock_guard<mutex> lock(mutex_threads);
+
+            if (!threads_free.empty())
+            {
+                owner.thread_time_blocks = threads_free.back();
+                threads_free.pop_back();
+            }
+            else
+            {
+                threads.emplace_back(make_unique<ThreadTimeBlocks>());
+                owner.thread_time_blocks        = threads.back().get();
+                owner.thread_time_blocks->index = static_cast<uint32_t>(threads.size() - 1);
+            }
+        }
+
+        return *owner.thread_time_blocks;
+    }
+
+    // Writes a string as a JSON string literal, escaping what would break the capture file
+    static void write_json_string(ofstream& file, const char* text)
+    {
+        file << '"';
+        for (const char* c = text; *c != '\0'; c++)
+        {
+            switch (*c)
+            {
+                case '"':  file << "\\\""; break;
+                case '\\': file << "\\\\"; break;
+                case '\n': file << "\\n"; break;
+                case '\r': file << "\\r"; break;
+                case '\t': file << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20)
+                    {
+                        char escaped[7];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+                        file << escaped;
+                    }
+                    else
+                    {
+                        file << *c;
+                    }
+                    break;
+            }
+        }
+        file << '"';
+    }
+
     Profiler::Profiler(Context* context) : ISystem(context)
     {
         m_time_blocks_read.reserve(initial_capacity);
@@ -67,6 +178,8 @@ namespace Spartan
             SwapBuffers();
         }
 
+        CaptureEnd();
+
         m_renderer->GetRhiDevice()->QueryRelease(m_query_disjoint);
 
         ClearRhiMetrics();
@@ -74,6 +187,9 @@ namespace Spartan
 
     void Profiler::OnPreTick()
     {
+        // The counters are per frame, regardless of gpu profiling
+        ClearRhiMetrics();
+
         RHI_Device* rhi_device = m_renderer->GetRhiDevice().get();
         if (!rhi_device || !rhi_device->GetRhiContext()->gpu_profiling)
             return;
@@ -102,12 +218,12 @@ namespace Spartan
 
             SP_LOG_WARNING("Time block list has grown to %d. Consider making the default capacity as large by default, to avoid re-allocating.", size_new);
         }
-
-        ClearRhiMetrics();
     }
 
     void Profiler::OnPostTick()
     {
+        m_thread_index_main = get_thread_time_blocks().index;
+
         // Compute timings
         {
             // Detect stutters
@@ -126,7 +242,7 @@ namespace Spartan
                 if (!time_block.IsComplete())
                     continue;
 
-                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu)
+                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu && time_block.GetThreadIndex() == m_thread_index_main)
                 {
                     m_time_cpu_last += time_block.GetDuration();
                 }
@@ -169,6 +285,10 @@ namespace Spartan
             m_poll = false;
         }
 
+        // Captures need every frame
+        const bool is_profiling = m_profile || IsCapturing();
+        m_poll                  = m_poll || IsCapturing();
+
         // Updating every m_profiling_interval_sec
         if (m_poll)
         {
@@ -183,10 +303,13 @@ namespace Spartan
             }
         }
 
-        if (m_profile && m_poll)
+        if (is_profiling && m_poll)
         {
             SwapBuffers();
         }
+
+        // Let every thread know whether it should record
+        is_recording = (m_profile || IsCapturing()) && m_poll;
     }
 
     void Profiler::OnPostPresent()
@@ -200,6 +323,8 @@ namespace Spartan
 
     void Profiler::SwapBuffers()
     {
+        MergeCpuTimeBlocks();
+
         // Copy completed time blocks write to time blocks read vector (double buffering)
         {
             uint32_t pass_index_gpu = 0;
@@ -234,35 +359,90 @@ namespace Spartan
                 time_block.Reset();
             }
         }
-        
+
         m_time_block_index = -1;
+
+        if (IsCapturing())
+        {
+            CaptureFrame();
+        }
     }
 
     void Profiler::TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list /*= nullptr*/)
     {
-        if (!m_profile || !m_poll)
-            return;
+        ThreadTimeBlocks& thread_time_blocks = get_thread_time_blocks();
 
         const bool can_profile_cpu = (type == TimeBlockType::Cpu) && m_profile_cpu;
         const bool can_profile_gpu = (type == TimeBlockType::Gpu) && m_profile_gpu;
+        bool is_recorded           = is_recording.load(memory_order_relaxed) && (can_profile_cpu || can_profile_gpu);
 
-        if (!can_profile_cpu && !can_profile_gpu)
-            return;
+        // GPU blocks still live in the time block list directly, they can only be started from the thread which ticks the profiler
+        if (is_recorded && type == TimeBlockType::Gpu)
+        {
+            // Last incomplete block of the same type, is the parent
+            TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
 
-        // Last incomplete block of the same type, is the parent
-        TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
+            if (TimeBlock* time_block = GetNewTimeBlock())
+            {
+                time_block->Begin(++m_rhi_timeblock_count, func_name, type, time_block_parent, cmd_list);
+            }
+            else
+            {
+                is_recorded = false;
+            }
+        }
 
-        if (TimeBlock* time_block = GetNewTimeBlock())
+        // The block is always pushed, even if it's not recorded, so that TimeBlockEnd() knows what it's ending
+        if (thread_time_blocks.open_count < ThreadTimeBlocks::open_capacity)
         {
-            time_block->Begin(++m_rhi_timeblock_count, func_name, type, time_block_parent, cmd_list);
+            ThreadTimeBlocks::OpenTimeBlock& open_block = thread_time_blocks.open[thread_time_blocks.open_count];
+            open_block.name        = func_name;
+            open_block.type        = type;
+            open_block.is_recorded = is_recorded;
+
+            if (is_recorded && type == TimeBlockType::Cpu)
+            {
+                open_block.start = chrono::high_resolution_clock::now();
+            }
         }
+
+        thread_time_blocks.open_count++;
     }
 
     void Profiler::TimeBlockEnd()
     {
-        if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
+        ThreadTimeBlocks& thread_time_blocks = get_thread_time_blocks();
+
+        if (thread_time_blocks.open_count == 0)
+            return;
+
+        // Deeper than we can track
+        if (--thread_time_blocks.open_count >= ThreadTimeBlocks::open_capacity)
+            return;
+
+        const ThreadTimeBlocks::OpenTimeBlock& open_block = thread_time_blocks.open[thread_time_blocks.open_count];
+        if (!open_block.is_recorded)
+            return;
+
+        if (open_block.type == TimeBlockType::Gpu)
         {
-            time_block->End();
+            if (TimeBlock* time_block = GetLastIncompleteTimeBlock(TimeBlockType::Gpu))
+            {
+                time_block->End();
+            }
+
+            return;
+        }
+
+        // Publish the ended block, if the profiler fell behind the block is dropped
+        const uint32_t write = thread_time_blocks.event_write.load(memory_order_relaxed);
+        if (write - thread_time_blocks.event_read.load(memory_order_acquire) < ThreadTimeBlocks::event_capacity)
+        {
+            CpuTimeBlockEvent& event = thread_time_blocks.events[write & (ThreadTimeBlocks::event_capacity - 1)];
+            event.name               = open_block.name;
+            event.start              = open_block.start;
+            event.end                = chrono::high_resolution_clock::now();
+            thread_time_blocks.event_write.store(write + 1, memory_order_release);
         }
     }
 
@@ -282,6 +462,207 @@ namespace Spartan
         m_time_gpu_last   = 0.0f;
     }
 
+    void Profiler::CaptureStart(const string& file_path, uint32_t frame_count)
+    {
+        CaptureEnd();
+
+        if (frame_count == 0)
+            return;
+
+        m_capture_file.open(file_path, ios::out | ios::trunc);
+        if (!m_capture_file.is_open())
+        {
+            SP_LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+            return;
+        }
+
+        // Microseconds since the start of the capture, keep sub-microsecond precision
+        m_capture_file.setf(ios::fixed);
+        m_capture_file.precision(3);
+
+        m_capture_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        m_capture_first_event = true;
+        m_capture_frames_left = frame_count;
+        m_capture_start       = chrono::high_resolution_clock::now();
+
+        SP_LOG_INFO("Capturing %d frames to \"%s\"...", frame_count, file_path.c_str());
+    }
+
+    void Profiler::CaptureEnd()
+    {
+        if (!m_capture_file.is_open())
+            return;
+
+        // Name the tracks
+        const auto write_thread_name = [this](uint32_t thread_id, const string& name)
+        {
+            m_capture_file << (m_capture_first_event ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_id << ",\"args\":{\"name\":";
+            write_json_string(m_capture_file, name.c_str());
+            m_capture_file << "}}";
+            m_capture_first_event = false;
+        };
+
+        {
+            lock_guard<mutex> lock(mutex_threads);
+            for (const unique_ptr<ThreadTimeBlocks>& thread_time_blocks : threads)
+            {
+                write_thread_name(thread_time_blocks->index, thread_time_blocks->index == m_thread_index_main ? "Main" : "Thread " + to_string(thread_time_blocks->index));
+            }
+        }
+        write_thread_name(capture_thread_id_gpu, "GPU");
+
+        m_capture_file << "\n]}\n";
+        m_capture_file.close();
+        m_capture_frames_left = 0;
+
+        SP_LOG_INFO("Capture complete");
+    }
+
+    void Profiler::CaptureFrame()
+    {
+        const auto to_us = [this](const chrono::high_resolution_clock::time_point& time_point)
+        {
+            return chrono::duration<double, micro>(time_point - m_capture_start).count();
+        };
+
+        const auto write_separator = [this]()
+        {
+            m_capture_file << (m_capture_first_event ? "" : ",\n");
+            m_capture_first_event = false;
+        };
+
+        // GPU blocks only have durations, so they are laid out back to back (children within their parent) starting with the frame's first CPU block
+        double frame_start_us = to_us(chrono::high_resolution_clock::now());
+        for (const TimeBlock& time_block : m_time_blocks_read)
+        {
+            if (time_block.IsComplete() && time_block.GetType() == TimeBlockType::Cpu)
+            {
+                frame_start_us = Math::Helper::Min(frame_start_us, to_us(time_block.GetStart()));
+            }
+        }
+
+        const uint32_t time_block_count = static_cast<uint32_t>(m_time_blocks_read.size());
+        vector<double> gpu_cursor_us(time_block_count, 0.0); // where the next child of each block starts
+        double gpu_cursor_root_us = frame_start_us;
+
+        for (uint32_t i = 0; i < time_block_count; i++)
+        {
+            const TimeBlock& time_block = m_time_blocks_read[i];
+            if (!time_block.IsComplete())
+                continue;
+
+            const double duration_us = static_cast<double>(time_block.GetDuration()) * 1000.0;
+            double start_us          = 0.0;
+            uint32_t thread_id       = 0;
+
+            if (time_block.GetType() == TimeBlockType::Cpu)
+            {
+                start_us  = to_us(time_block.GetStart());
+                thread_id = time_block.GetThreadIndex();
+            }
+            else
+            {
+                // Parents point into the write buffer, which has the same layout
+                if (const TimeBlock* parent = time_block.GetParent())
+                {
+                    const uint32_t parent_index = static_cast<uint32_t>(parent - m_time_blocks_write.data());
+                    start_us                    = gpu_cursor_us[parent_index];
+                    gpu_cursor_us[parent_index] += duration_us;
+                }
+                else
+                {
+                    start_us           = gpu_cursor_root_us;
+                    gpu_cursor_root_us += duration_us;
+                }
+
+                gpu_cursor_us[i] = start_us;
+                thread_id        = capture_thread_id_gpu;
+            }
+
+            write_separator();
+            m_capture_file << "{\"name\":";
+            write_json_string(m_capture_file, time_block.GetName() ? time_block.GetName() : "N/A");
+            m_capture_file << ",\"cat\":\"" << (time_block.GetType() == TimeBlockType::Cpu ? "cpu" : "gpu")
+                           << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_id << ",\"ts\":" << start_us << ",\"dur\":" << duration_us << "}";
+        }
+
+        // RHI metrics, as counters
+        write_separator();
+        m_capture_file << "{\"name\":\"RHI\",\"ph\":\"C\",\"pid\":0,\"ts\":" << frame_start_us << ",\"args\":{"
+                       << "\"draw\":"                       << m_rhi_draw
+                       << ",\"dispatch\":"                  << m_rhi_dispatch
+                       << ",\"bindings_buffer_index\":"     << m_rhi_bindings_buffer_index
+                       << ",\"bindings_buffer_vertex\":"    << m_rhi_bindings_buffer_vertex
+                       << ",\"bindings_buffer_constant\":"  << m_rhi_bindings_buffer_constant
+                       << ",\"bindings_buffer_structured\":" << m_rhi_bindings_buffer_structured
+                       << ",\"bindings_sampler\":"          << m_rhi_bindings_sampler
+                       << ",\"bindings_texture_sampled\":"  << m_rhi_bindings_texture_sampled
+                       << ",\"bindings_texture_storage\":"  << m_rhi_bindings_texture_storage
+                       << ",\"bindings_render_target\":"    << m_rhi_bindings_render_target
+                       << ",\"bindings_descriptor_set\":"   << m_rhi_bindings_descriptor_set
+                       << ",\"bindings_pipeline\":"         << m_rhi_bindings_pipeline
+                       << ",\"pipeline_barriers\":"         << m_rhi_pipeline_barriers
+                       << ",\"bytes_uploaded\":"            << m_renderer_bytes_uploaded
+                       << ",\"triangles\":"                 << m_renderer_triangles
+                       << ",\"triangles_culled\":"          << m_renderer_triangles_culled
+                       << "}}";
+
+        if (--m_capture_frames_left == 0)
+        {
+            CaptureEnd();
+        }
+    }
+
+    void Profiler::MergeCpuTimeBlocks()
+    {
+        lock_guard<mutex> lock(mutex_threads);
+
+        // The profiler's thread goes first, so that its blocks come first
+        vector<ThreadTimeBlocks*> threads_ordered;
+        for (unique_ptr<ThreadTimeBlocks>& thread_time_blocks : threads)
+        {
+            threads_ordered.emplace(thread_time_blocks->index == m_thread_index_main ? threads_ordered.begin() : threads_ordered.end(), thread_time_blocks.get());
+        }
+
+        vector<CpuTimeBlockEvent> events;
+        vector<pair<TimeBlock*, chrono::high_resolution_clock::time_point>> stack; // open parents and their end time
+        for (ThreadTimeBlocks* thread_time_blocks : threads_ordered)
+        {
+            // Consume the thread's ended blocks
+            events.clear();
+            const uint32_t read  = thread_time_blocks->event_read.load(memory_order_relaxed);
+            const uint32_t write = thread_time_blocks->event_write.load(memory_order_acquire);
+            for (uint32_t i = read; i != write; i++)
+            {
+                events.emplace_back(thread_time_blocks->events[i & (ThreadTimeBlocks::event_capacity - 1)]);
+            }
+            thread_time_blocks->event_read.store(write, memory_order_release);
+
+            // Blocks end children first, sort them so that parents come first (longer blocks first when starting at the same time)
+            sort(events.begin(), events.end(), [](const CpuTimeBlockEvent& a, const CpuTimeBlockEvent& b)
+            {
+                return a.start != b.start ? a.start < b.start : a.end > b.end;
+            });
+
+            // Blocks on the same thread nest properly, so the parent is the closest block which contains this one
+            stack.clear();
+            for (const CpuTimeBlockEvent& event : events)
+            {
+                while (!stack.empty() && stack.back().second < event.end)
+                {
+                    stack.pop_back();
+                }
+
+                TimeBlock* time_block = GetNewTimeBlock();
+                if (!time_block)
+                    return;
+
+                time_block->SetCpu(++m_rhi_timeblock_count, event.name, stack.empty() ? nullptr : stack.back().first, thread_time_blocks->index, event.start, event.end);
+                stack.emplace_back(time_block, event.end);
+            }
+        }
+    }
+
     TimeBlock* Profiler::GetNewTimeBlock()
     {
         // Increase capacity if needed
@@ -378,6 +759,8 @@ namespace Spartan
             "\n"
             "Resources\n"
             "Meshes rendered:\t\t\t%d\n"
+            "Triangles culled:\t\t\t%d/%d\n"
+            "Data uploaded:\t\t\t%.1f KB\n"
             "Textures:\t\t\t\t%d\n"
             "Materials:\t\t\t\t%d\n"
             "Descriptor set capacity:\t%d/%d";
@@ -413,16 +796,18 @@ namespace Spartan
             static_cast<int>(m_renderer->GetViewport().width),     static_cast<int>(m_renderer->GetViewport().height),
 
             // API Calls
-            m_rhi_draw,
-            m_rhi_dispatch,
-            m_rhi_bindings_buffer_index,
-            m_rhi_bindings_buffer_vertex,
-            m_rhi_bindings_descriptor_set,
-            m_rhi_bindings_pipeline,
-            m_rhi_pipeline_barriers,
+            m_rhi_draw.load(),
+            m_rhi_dispatch.load(),
+            m_rhi_bindings_buffer_index.load(),
+            m_rhi_bindings_buffer_vertex.load(),
+            m_rhi_bindings_descriptor_set.load(),
+            m_rhi_bindings_pipeline.load(),
+            m_rhi_pipeline_barriers.load(),
 
             // Resources
-            m_renderer_meshes_rendered,
+            m_renderer_meshes_rendered.load(),
+            m_renderer_triangles_culled.load(), m_renderer_triangles.load(),
+            m_renderer_bytes_uploaded / 1024.0f,
             texture_count,
             material_count,
             m_descriptor_set_count,
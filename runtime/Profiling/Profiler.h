@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <string>
 #include <vector>
+#include <fstream>
+#include <atomic>
 #include "TimeBlock.h"
 #include "../Core/ISystem.h"
 #include "../Core/Stopwatch.h"
@@ -32,7 +34,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define SP_TIME_BLOCK_START_NAMED(profiler, name) profiler->TimeBlockStart(name, Spartan::TimeBlockType::Cpu, nullptr);
 #define SP_TIME_BLOCK_END(profiler)               profiler->TimeBlockEnd();
-#define SP_SCOPED_TIME_BLOCK(profiler)            if (profiler) { ScopedTimeBlock time_block = ScopedTimeBlock(profiler, __FUNCTION__); }
+#define SP_TIME_BLOCK_CONCAT_INNER(a, b)          a##b
+#define SP_TIME_BLOCK_CONCAT(a, b)                SP_TIME_BLOCK_CONCAT_INNER(a, b)
+#define SP_SCOPED_TIME_BLOCK(profiler)            Spartan::ScopedTimeBlock SP_TIME_BLOCK_CONCAT(time_block_, __LINE__)(profiler, __FUNCTION__);
 
 namespace Spartan
 {
@@ -56,9 +60,16 @@ namespace Spartan
         void OnPostTick() override;
         //===========================
 
+        // Time blocks can be started and ended from any thread, each thread has its own block stack.
+        // CPU blocks are recorded into a per-thread buffer and merged into the time block tree when the buffers are swapped.
         void TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list = nullptr);
         void TimeBlockEnd();
         void ResetMetrics();
+
+        // Streams the time blocks and RHI metrics of the next frame_count frames to a Chrome trace event file (chrome://tracing, ui.perfetto.dev)
+        void CaptureStart(const std::string& file_path, uint32_t frame_count);
+        void CaptureEnd();
+        bool IsCapturing() const { return m_capture_frames_left != 0; }
         
         // Properties
         bool GetEnabled()                             const { return m_profile; }
@@ -77,27 +88,30 @@ namespace Spartan
         bool IsCpuStuttering()                        const { return m_is_stuttering_cpu; }
         bool IsGpuStuttering()                        const { return m_is_stuttering_gpu; }
         
-        // Metrics - RHI
-        uint32_t m_rhi_draw                       = 0;
-        uint32_t m_rhi_dispatch                   = 0;
-        uint32_t m_rhi_bindings_buffer_index      = 0;
-        uint32_t m_rhi_bindings_buffer_vertex     = 0;
-        uint32_t m_rhi_bindings_buffer_constant   = 0;
-        uint32_t m_rhi_bindings_buffer_structured = 0;
-        uint32_t m_rhi_bindings_sampler           = 0;
-        uint32_t m_rhi_bindings_texture_sampled   = 0;
-        uint32_t m_rhi_bindings_shader_vertex     = 0;
-        uint32_t m_rhi_bindings_shader_pixel      = 0;
-        uint32_t m_rhi_bindings_shader_compute    = 0;
-        uint32_t m_rhi_bindings_render_target     = 0;
-        uint32_t m_rhi_bindings_texture_storage   = 0;
-        uint32_t m_rhi_bindings_descriptor_set    = 0;
-        uint32_t m_rhi_bindings_pipeline          = 0;
-        uint32_t m_rhi_pipeline_barriers          = 0;
-        uint32_t m_rhi_timeblock_count            = 0;
+        // Metrics - RHI (atomic since command lists can be recorded from different threads)
+        std::atomic<uint32_t> m_rhi_draw                       = 0;
+        std::atomic<uint32_t> m_rhi_dispatch                   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_index      = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_vertex     = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_constant   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_buffer_structured = 0;
+        std::atomic<uint32_t> m_rhi_bindings_sampler           = 0;
+        std::atomic<uint32_t> m_rhi_bindings_texture_sampled   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_vertex     = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_pixel      = 0;
+        std::atomic<uint32_t> m_rhi_bindings_shader_compute    = 0;
+        std::atomic<uint32_t> m_rhi_bindings_render_target     = 0;
+        std::atomic<uint32_t> m_rhi_bindings_texture_storage   = 0;
+        std::atomic<uint32_t> m_rhi_bindings_descriptor_set    = 0;
+        std::atomic<uint32_t> m_rhi_bindings_pipeline          = 0;
+        std::atomic<uint32_t> m_rhi_pipeline_barriers          = 0;
+        std::atomic<uint32_t> m_rhi_timeblock_count            = 0;
 
         // Metrics - Renderer
-        uint32_t m_renderer_meshes_rendered = 0;
+        std::atomic<uint32_t> m_renderer_meshes_rendered  = 0;
+        std::atomic<uint32_t> m_renderer_bytes_uploaded   = 0; // cpu to gpu buffer writes (constants, instances)
+        std::atomic<uint32_t> m_renderer_triangles        = 0; // in the camera's opaque draws, before cluster culling
+        std::atomic<uint32_t> m_renderer_triangles_culled = 0; // of those, in clusters that were off-screen or back-facing
 
         // Metrics - Time
         float m_time_frame_avg  = 0.0f;
@@ -128,6 +142,9 @@ namespace Spartan
             m_rhi_draw                       = 0;
             m_rhi_dispatch                   = 0;
             m_renderer_meshes_rendered       = 0;
+            m_renderer_bytes_uploaded        = 0;
+            m_renderer_triangles             = 0;
+            m_renderer_triangles_culled      = 0;
             m_rhi_bindings_buffer_index      = 0;
             m_rhi_bindings_buffer_vertex     = 0;
             m_rhi_bindings_buffer_constant   = 0;
@@ -145,6 +162,8 @@ namespace Spartan
             m_rhi_timeblock_count            = 0;
         }
 
+        void MergeCpuTimeBlocks();
+        void CaptureFrame();
         TimeBlock* GetNewTimeBlock();
         void AcquireGpuData();
         void UpdateRhiMetricsString();
@@ -158,13 +177,20 @@ namespace Spartan
         float m_time_since_profiling_sec = m_profiling_interval_sec;
 
         // Time blocks (double buffered)
-        int m_time_block_index = -1;
+        int m_time_block_index      = -1;
+        uint32_t m_thread_index_main = 0; // the thread which ticks the profiler, only its blocks count towards the CPU time
         std::vector<TimeBlock> m_time_blocks_write;
         std::vector<TimeBlock> m_time_blocks_read;
 
         // FPS
         float m_fps = 0.0f;
 
+        // Capture
+        std::ofstream m_capture_file;
+        uint32_t m_capture_frames_left = 0;
+        bool m_capture_first_event     = true;
+        std::chrono::high_resolution_clock::time_point m_capture_start;
+
         // Hardware - GPU
         std::string m_gpu_name          = "N/A";
         std::string m_gpu_driver        = "N/A";
@@ -195,12 +221,19 @@ namespace Spartan
         ScopedTimeBlock(Profiler* profiler, const char* name = nullptr)
         {
             this->profiler = profiler;
-            profiler->TimeBlockStart(name, Spartan::TimeBlockType::Cpu);
+
+            if (profiler)
+            {
+                profiler->TimeBlockStart(name, Spartan::TimeBlockType::Cpu);
+            }
         }
 
         ~ScopedTimeBlock()
         {
-            profiler->TimeBlockEnd();
+            if (profiler)
+            {
+                profiler->TimeBlockEnd();
+            }
         }
 
     private:
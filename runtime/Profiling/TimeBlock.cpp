@@ -85,6 +85,20 @@ namespace Spartan
         m_is_complete = true;
     }
 
+    void TimeBlock::SetCpu(const uint32_t id, const char* name, const TimeBlock* parent, uint32_t thread_index, const chrono::high_resolution_clock::time_point& start, const chrono::high_resolution_clock::time_point& end)
+    {
+        m_id             = id;
+        m_name           = name;
+        m_parent         = parent;
+        m_tree_depth     = FindTreeDepth(this);
+        m_type           = TimeBlockType::Cpu;
+        m_max_tree_depth = Math::Helper::Max(m_max_tree_depth, m_tree_depth);
+        m_thread_index   = thread_index;
+        m_start          = start;
+        m_end            = end;
+        m_is_complete    = true;
+    }
+
     void TimeBlock::ComputeDuration(const uint32_t pass_index)
     {
         // Ensure this time block has completed.
@@ -110,6 +124,7 @@ namespace Spartan
         m_max_tree_depth = 0;
         m_type           = TimeBlockType::Undefined;
         m_is_complete    = false;
+        m_thread_index   = 0;
 
         if (m_query_start != nullptr && m_query_end != nullptr)
         {
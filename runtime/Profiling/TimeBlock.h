@@ -46,6 +46,8 @@ namespace Spartan
 
         void Begin(const uint32_t id, const char* name, TimeBlockType type, const TimeBlock* parent = nullptr, RHI_CommandList* cmd_list = nullptr);
         void End();
+        // Initializes a complete CPU time block from timings which were recorded elsewhere (e.g. on another thread)
+        void SetCpu(const uint32_t id, const char* name, const TimeBlock* parent, uint32_t thread_index, const std::chrono::high_resolution_clock::time_point& start, const std::chrono::high_resolution_clock::time_point& end);
         void ComputeDuration(const uint32_t pass_index);
         void Reset();
         TimeBlockType GetType()      const { return m_type; }
@@ -56,6 +58,8 @@ namespace Spartan
         float GetDuration()          const { return m_duration; }
         bool IsComplete()            const { return m_is_complete; }
         uint32_t GetId()             const { return m_id; }
+        uint32_t GetThreadIndex()    const { return m_thread_index; }
+        const auto& GetStart()       const { return m_start; }
         void ClearGpuObjects();
 
     private:    
@@ -69,6 +73,7 @@ namespace Spartan
         uint32_t m_tree_depth     = 0;
         bool m_is_complete        = false;
         uint32_t m_id             = 0;
+        uint32_t m_thread_index   = 0;
 
         // Dependencies
         RHI_Device* m_rhi_device    = nullptr;
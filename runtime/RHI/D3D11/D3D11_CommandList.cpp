@@ -50,13 +50,14 @@ namespace Spartan
 {
     bool RHI_CommandList::m_memory_query_support = true;
 
-    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name) : Object(context)
+    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name, const bool is_secondary) : Object(context)
     {
-        m_queue_type = queue_type;
-        m_renderer   = context->GetSystem<Renderer>();
-        m_profiler   = context->GetSystem<Profiler>();
-        m_rhi_device = m_renderer->GetRhiDevice().get();
-        m_name       = name;
+        m_queue_type   = queue_type;
+        m_renderer     = context->GetSystem<Renderer>();
+        m_profiler     = context->GetSystem<Profiler>();
+        m_rhi_device   = m_renderer->GetRhiDevice().get();
+        m_name         = name;
+        m_is_secondary = is_secondary;
 
         m_timestamps.fill(0);
     }
@@ -68,6 +69,11 @@ namespace Spartan
         m_state = RHI_CommandListState::Recording;
     }
 
+    void RHI_CommandList::Begin(RHI_PipelineState& pso)
+    {
+        SP_ASSERT_MSG(false, "Secondary command lists are not supported by D3D11");
+    }
+
     void RHI_CommandList::End()
     {
         m_state = RHI_CommandListState::Ended;
@@ -330,7 +336,7 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::BeginRenderPass()
+    void RHI_CommandList::BeginRenderPass(const bool secondary_contents /*= false*/)
     {
 
     }
@@ -340,6 +346,11 @@ namespace Spartan
 
     }
 
+    void RHI_CommandList::ExecuteSecondary(const vector<RHI_CommandList*>& cmd_lists)
+    {
+        SP_ASSERT_MSG(false, "Secondary command lists are not supported by D3D11");
+    }
+
     void RHI_CommandList::ClearPipelineStateRenderTargets(RHI_PipelineState& m_pso)
     {
         // Color
@@ -454,13 +465,15 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
     {
-        m_rhi_device->GetRhiContext()->device_context->DrawIndexed
+        m_rhi_device->GetRhiContext()->device_context->DrawIndexedInstanced
         (
             static_cast<UINT>(index_count),
+            static_cast<UINT>(instance_count),
             static_cast<UINT>(index_offset),
-            static_cast<INT>(vertex_offset)
+            static_cast<INT>(vertex_offset),
+            0
         );
 
         if (m_profiler)
@@ -587,8 +600,11 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer, const uint32_t offset) const
     {
+        // The whole buffer is bound, it's re-mapped on every update so there are no offsets
+        SP_ASSERT(offset == 0);
+
         void* buffer                        = static_cast<ID3D11Buffer*>(constant_buffer ? constant_buffer->GetRhiResource() : nullptr);
         const void* buffer_array[1]         = { buffer };
         const UINT range                    = 1;
@@ -792,8 +808,10 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav) const
     {
+        SP_ASSERT_MSG(uav, "Only compute structured buffers (UAVs) are supported");
+
         array<void*, 1> view_array          = { structured_buffer ? structured_buffer->GetRhiUav() : nullptr };
         const UINT range                    = 1;
         ID3D11DeviceContext* device_context = m_rhi_device->GetRhiContext()->device_context;
@@ -72,10 +72,21 @@ namespace Spartan
             "Failed to map constant buffer");
 
         // Copy
-        memcpy(reinterpret_cast<std::byte*>(mapped_resource.pData), reinterpret_cast<std::byte*>(data_cpu), m_stride);
+        memcpy(reinterpret_cast<std::byte*>(mapped_resource.pData), reinterpret_cast<std::byte*>(data_cpu), m_element_size);
 
         // Unmap
         SP_ASSERT(m_rhi_resource != nullptr);
         m_rhi_device->GetRhiContext()->device_context->Unmap(static_cast<ID3D11Buffer*>(m_rhi_resource), 0);
     }
+
+    bool RHI_ConstantBuffer::Allocate(const uint32_t count, uint32_t& offset)
+    {
+        // The buffer only holds a single element and binding at an offset needs D3D11.1
+        return false;
+    }
+
+    void RHI_ConstantBuffer::Write(const uint32_t offset, const void* data, const uint32_t count)
+    {
+        SP_ASSERT_MSG(false, "Not supported");
+    }
 }
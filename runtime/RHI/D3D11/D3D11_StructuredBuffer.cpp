@@ -75,8 +75,11 @@ namespace Spartan
         d3d11_utility::release<ID3D11UnorderedAccessView>(m_rhi_uav);
     }
 
-    void RHI_StructuredBuffer::Update(void* data_cpu)
+    void RHI_StructuredBuffer::Update(void* data_cpu, const uint32_t size)
     {
+        const uint32_t size_copy = size != 0 ? size : m_stride;
+        SP_ASSERT_MSG(size_copy <= m_stride, "Size exceeds the stride");
+
         // Map
         D3D11_MAPPED_SUBRESOURCE mapped_resource;
         if (FAILED(m_rhi_device->GetRhiContext()->device_context->Map(static_cast<ID3D11Buffer*>(m_rhi_resource), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource)))
@@ -85,7 +88,7 @@ namespace Spartan
         }
 
         // Copy
-        memcpy(reinterpret_cast<std::byte*>(mapped_resource.pData), reinterpret_cast<std::byte*>(data_cpu), m_stride);
+        memcpy(reinterpret_cast<std::byte*>(mapped_resource.pData), reinterpret_cast<std::byte*>(data_cpu), size_copy);
 
         // Unmap
         m_rhi_device->GetRhiContext()->device_context->Unmap(static_cast<ID3D11Buffer*>(m_rhi_resource), 0);
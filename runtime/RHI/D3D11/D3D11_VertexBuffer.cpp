@@ -43,6 +43,7 @@ namespace Spartan
         SP_ASSERT(m_rhi_device->GetRhiContext()->device_context != nullptr);
 
         const bool is_dynamic = vertices == nullptr;
+        m_is_mappable         = is_dynamic;
 
         // Destroy previous buffer
         _destroy();
@@ -50,7 +51,7 @@ namespace Spartan
         // fill in a buffer description.
         D3D11_BUFFER_DESC buffer_desc   = {};
         buffer_desc.ByteWidth           = static_cast<UINT>(m_object_size_gpu);
-        buffer_desc.Usage               = is_dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
+        buffer_desc.Usage               = is_dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT; // default so that ranges can be updated
         buffer_desc.CPUAccessFlags      = is_dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
         buffer_desc.BindFlags           = D3D11_BIND_VERTEX_BUFFER;
         buffer_desc.MiscFlags           = 0;
@@ -66,6 +67,35 @@ namespace Spartan
         SP_ASSERT(d3d11_utility::error_check(m_rhi_device->GetRhiContext()->device->CreateBuffer(&buffer_desc, is_dynamic ? nullptr : &init_data, ptr)));
     }
 
+    void RHI_VertexBuffer::_update(const void* vertices, const vector<pair<uint32_t, uint32_t>>& ranges)
+    {
+        SP_ASSERT(m_rhi_resource != nullptr);
+
+        // A dynamic buffer can only be mapped with discard, so all of it is re-written
+        if (m_is_mappable)
+        {
+            if (void* data = Map())
+            {
+                memcpy(data, vertices, m_object_size_gpu);
+                Unmap();
+            }
+
+            return;
+        }
+
+        const std::byte* source = static_cast<const std::byte*>(vertices);
+        for (const auto& [vertex_offset, vertex_count] : ranges)
+        {
+            D3D11_BOX box = {};
+            box.left      = vertex_offset * m_stride;
+            box.right     = (vertex_offset + vertex_count) * m_stride;
+            box.bottom    = 1;
+            box.back      = 1;
+
+            m_rhi_device->GetRhiContext()->device_context->UpdateSubresource(static_cast<ID3D11Resource*>(m_rhi_resource), 0, &box, source + box.left, 0, 0);
+        }
+    }
+
     void* RHI_VertexBuffer::Map()
     {
         SP_ASSERT(m_rhi_resource != nullptr);
@@ -89,4 +119,14 @@ namespace Spartan
         // Re-enable GPU access to the vertex buffer data.
         m_rhi_device->GetRhiContext()->device_context->Unmap(static_cast<ID3D11Resource*>(m_rhi_resource), 0);
     }
+
+    void RHI_VertexBuffer::RecordStagedCopies(RHI_CommandList* cmd_list)
+    {
+        // Updates are written by the context, which orders them with the draws
+    }
+
+    void RHI_VertexBuffer::ResetStaging()
+    {
+
+    }
 }
@@ -48,7 +48,7 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
-    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name)
+    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name, const bool is_secondary)
     {
         SP_ASSERT(cmd_pool != nullptr);
 
@@ -58,6 +58,7 @@ namespace Spartan
         m_rhi_device            = m_renderer->GetRhiDevice().get();
         m_name                  = name;
         m_rhi_cmd_pool_resource = cmd_pool;
+        m_is_secondary          = is_secondary;
         m_timestamps.fill(0);
 
         // Created command list
@@ -104,6 +105,11 @@ namespace Spartan
         m_state = RHI_CommandListState::Recording;
     }
 
+    void RHI_CommandList::Begin(RHI_PipelineState& pso)
+    {
+        SP_ASSERT_MSG(false, "Function is not implemented");
+    }
+
     void RHI_CommandList::End()
     {
         // Verify a few things
@@ -128,7 +134,7 @@ namespace Spartan
         SP_ASSERT_MSG(false, "Function is not implemented");
     }
 
-    void RHI_CommandList::BeginRenderPass()
+    void RHI_CommandList::BeginRenderPass(const bool secondary_contents /*= false*/)
     {
         SP_ASSERT_MSG(false, "Function is not implemented");
     }
@@ -138,6 +144,11 @@ namespace Spartan
         SP_ASSERT_MSG(false, "Function is not implemented");
     }
 
+    void RHI_CommandList::ExecuteSecondary(const vector<RHI_CommandList*>& cmd_lists)
+    {
+        SP_ASSERT_MSG(false, "Function is not implemented");
+    }
+
     void RHI_CommandList::ClearPipelineStateRenderTargets(RHI_PipelineState& pipeline_state)
     {
         SP_ASSERT_MSG(false, "Function is not implemented");
@@ -175,7 +186,7 @@ namespace Spartan
         m_profiler->m_rhi_draw++;
     }
     
-    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
     {
         // Validate command list state
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
@@ -185,11 +196,11 @@ namespace Spartan
 
         // Draw
         static_cast<ID3D12GraphicsCommandList*>(m_rhi_resource)->DrawIndexedInstanced(
-            index_count,   // IndexCountPerInstance
-            1,             // InstanceCount
-            index_offset,  // StartIndexLocation
-            vertex_offset, // BaseVertexLocation
-            0              // StartInstanceLocation
+            index_count,    // IndexCountPerInstance
+            instance_count, // InstanceCount
+            index_offset,   // StartIndexLocation
+            vertex_offset,  // BaseVertexLocation
+            0               // StartInstanceLocation
         );
 
         // Profile
@@ -302,12 +313,12 @@ namespace Spartan
         }
     }
     
-    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer, const uint32_t offset) const
     {
         SP_ASSERT_MSG(false, "Function is not implemented");
     }
 
-    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav) const
     {
         SP_ASSERT_MSG(false, "Function is not implemented");
     }
@@ -49,9 +49,9 @@ namespace Spartan
 
     }
 
-    void RHI_CommandPool::CreateCommandPool(const RHI_Queue_Type queue_type)
+    void* RHI_CommandPool::CreateCommandPool(const RHI_Queue_Type queue_type)
     {
-
+        return nullptr;
     }
 
     void RHI_CommandPool::Reset(const uint32_t pool_index)
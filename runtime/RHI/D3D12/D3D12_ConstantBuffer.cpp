@@ -51,4 +51,14 @@ namespace Spartan
     {
         SP_ASSERT_MSG(false, "Not implemented");
     }
+
+    bool RHI_ConstantBuffer::Allocate(const uint32_t count, uint32_t& offset)
+    {
+        return false;
+    }
+
+    void RHI_ConstantBuffer::Write(const uint32_t offset, const void* data, const uint32_t count)
+    {
+        SP_ASSERT_MSG(false, "Not implemented");
+    }
 }
@@ -39,6 +39,11 @@ namespace Spartan
 
     }
 
+    void RHI_Texture::RHI_SetLayouts(const vector<RHI_Texture*>& textures, const vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list)
+    {
+
+    }
+
     bool RHI_Texture::RHI_CreateResource()
     {
         return false;
@@ -73,6 +73,11 @@ namespace Spartan
         //m_vertexBufferView.SizeInBytes = SampleAssets::VertexDataSize;
     }
     
+    void RHI_VertexBuffer::_update(const void* vertices, const vector<pair<uint32_t, uint32_t>>& ranges)
+    {
+
+    }
+    
     void* RHI_VertexBuffer::Map()
     {
         return nullptr;
@@ -82,4 +87,14 @@ namespace Spartan
     {
 
     }
+
+    void RHI_VertexBuffer::RecordStagedCopies(RHI_CommandList* cmd_list)
+    {
+
+    }
+
+    void RHI_VertexBuffer::ResetStaging()
+    {
+
+    }
 }
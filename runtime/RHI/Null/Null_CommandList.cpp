@@ -0,0 +1,668 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_CommandList.h"
+#include "../RHI_Pipeline.h"
+#include "../RHI_VertexBuffer.h"
+#include "../RHI_IndexBuffer.h"
+#include "../RHI_ConstantBuffer.h"
+#include "../RHI_StructuredBuffer.h"
+#include "../RHI_Sampler.h"
+#include "../RHI_DescriptorSet.h"
+#include "../RHI_DescriptorSetLayout.h"
+#include "../RHI_Semaphore.h"
+#include "../RHI_Fence.h"
+#include "../RHI_Shader.h"
+#include "../RHI_CommandPool.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Rendering/Renderer.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name, const bool is_secondary) : Object(context)
+    {
+        m_queue_type   = queue_type;
+        m_renderer     = context->GetSystem<Renderer>();
+        m_profiler     = context->GetSystem<Profiler>();
+        m_rhi_device   = m_renderer->GetRhiDevice().get();
+        m_name         = name;
+        m_index        = index;
+        m_is_secondary = is_secondary;
+
+        // Command buffer
+        SP_ASSERT(cmd_pool != nullptr);
+        m_rhi_resource = null_utility::handle::create();
+
+        // Secondary command lists are executed by primary ones, so they don't need sync objects
+        if (is_secondary)
+            return;
+
+        // Sync objects
+        m_proccessed_fence     = make_shared<RHI_Fence>(m_rhi_device, name);
+        m_proccessed_semaphore = make_shared<RHI_Semaphore>(m_rhi_device, false, name);
+    }
+
+    RHI_CommandList::~RHI_CommandList()
+    {
+        null_utility::handle::destroy(m_rhi_resource);
+    }
+
+    void RHI_CommandList::Begin()
+    {
+        m_discard = false;
+
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Idle);
+
+        m_timestamp_index = 0;
+
+        // Update states
+        m_state          = RHI_CommandListState::Recording;
+        m_pipeline_dirty = true;
+    }
+
+    void RHI_CommandList::Begin(RHI_PipelineState& pso)
+    {
+        SP_ASSERT_MSG(m_is_secondary, "Only secondary command lists can continue a render pass");
+        SP_ASSERT(m_state == RHI_CommandListState::Idle);
+        SP_ASSERT_MSG(pso.IsGraphics(), "Secondary command lists can only continue graphics render passes");
+
+        // Update states
+        m_state          = RHI_CommandListState::Recording;
+        m_pipeline_dirty = true;
+        m_is_rendering   = true;
+
+        // Nothing is inherited from the primary command list, so bind the pipeline
+        SetPipelineState(pso);
+    }
+
+    void RHI_CommandList::End()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        m_state = RHI_CommandListState::Ended;
+
+        // Secondary command lists continue a render pass which they don't end themselves
+        if (m_is_secondary)
+        {
+            m_is_rendering = false;
+        }
+    }
+
+    void RHI_CommandList::Submit()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Ended);
+
+        if (!m_discard)
+        {
+            m_rhi_device->QueueSubmit(
+                m_queue_type,                 // queue
+                0,                            // wait flags
+                m_rhi_resource,               // cmd buffer
+                nullptr,                      // wait semaphore
+                m_proccessed_semaphore.get(), // signal semaphore
+                m_proccessed_fence.get()      // signal fence
+            );
+        }
+
+        m_state = RHI_CommandListState::Submitted;
+    }
+
+    void RHI_CommandList::SetPipelineState(RHI_PipelineState& pso)
+    {
+        SP_ASSERT_MSG(pso.IsValid(), "Invalide pipeline state");
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Update the descriptor cache with the pipeline state
+        GetDescriptorSetLayoutFromPipelineState(pso);
+
+        // If no pipeline exists for this state, create one
+        const uint64_t hash = pso.ComputeHash();
+        m_pipeline          = GetOrCreatePipeline(m_rhi_device, pso, m_descriptor_layout_current);
+
+        // Determine if the pipeline is dirty.
+        // Begin() always dirties it, so the previous state is only hashed when it's from this recording, as
+        // by the next one, the shaders and render targets it points to might have been hot reloaded or resized.
+        if (!m_pipeline_dirty)
+        {
+            m_pipeline_dirty = m_pso.ComputeHash() != hash;
+        }
+        m_pso = pso;
+
+        // Bind pipeline
+        if (m_pipeline_dirty)
+        {
+            SP_ASSERT(m_pipeline);
+            SP_ASSERT(m_pipeline->GetResource_Pipeline() != nullptr);
+
+            // Profile
+            if (m_profiler)
+            {
+                m_profiler->m_rhi_bindings_pipeline++;
+            }
+
+            m_pipeline_dirty = false;
+
+            // Also, If the pipeline changed, resources have to be set again
+            m_vertex_buffer_id = 0;
+            m_index_buffer_id  = 0;
+        }
+
+        // The descriptor data was cleared, so bind the global resources (anything bound after this overrides them)
+        m_renderer->SetGlobalShaderResources(this);
+    }
+
+    void RHI_CommandList::BeginRenderPass(const bool secondary_contents /*= false*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT_MSG(m_pso.IsGraphics(), "You can't use a render pass with a compute pipeline");
+        SP_ASSERT_MSG(!m_is_rendering, "The command list is already rendering");
+        SP_ASSERT_MSG(!m_is_secondary, "Secondary command lists continue the render pass of a primary one");
+
+        if (!m_pso.IsGraphics())
+            return;
+
+        // Color attachments
+        if (RHI_SwapChain* swapchain = m_pso.render_target_swapchain)
+        {
+            if (swapchain->GetLayout() != RHI_Image_Layout::Color_Attachment_Optimal)
+            {
+                swapchain->SetLayout(RHI_Image_Layout::Color_Attachment_Optimal, this);
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                RHI_Texture* rt = m_pso.render_target_color_textures[i];
+
+                if (rt == nullptr)
+                    break;
+
+                SP_ASSERT(rt->IsRenderTargetColor());
+                SP_ASSERT(rt->GetRhiRtv(m_pso.render_target_color_texture_array_index) != nullptr);
+
+                if (rt->GetLayout(0) != RHI_Image_Layout::Color_Attachment_Optimal)
+                {
+                    rt->SetLayout(RHI_Image_Layout::Color_Attachment_Optimal, this);
+                }
+            }
+        }
+
+        // Depth-stencil attachment
+        if (RHI_Texture* rt = m_pso.render_target_depth_texture)
+        {
+            SP_ASSERT_MSG(rt->GetWidth() == m_pso.GetWidth(), "The depth buffer doesn't match the output resolution");
+            SP_ASSERT(rt->IsRenderTargetDepthStencil());
+
+            RHI_Image_Layout layout = rt->IsStencilFormat() ? RHI_Image_Layout::Depth_Stencil_Attachment_Optimal : RHI_Image_Layout::Depth_Attachment_Optimal;
+            if (m_pso.render_target_depth_texture_read_only)
+            {
+                layout = RHI_Image_Layout::Depth_Stencil_Read_Only_Optimal;
+            }
+            rt->SetLayout(layout, this);
+        }
+
+        m_is_rendering = true;
+    }
+
+    void RHI_CommandList::EndRenderPass()
+    {
+        m_is_rendering = false;
+    }
+
+    void RHI_CommandList::ExecuteSecondary(const vector<RHI_CommandList*>& cmd_lists)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT_MSG(!m_is_secondary, "Only primary command lists can execute secondary ones");
+        SP_ASSERT_MSG(m_is_rendering, "Secondary command lists continue a render pass, begin one first");
+
+        for (RHI_CommandList* cmd_list : cmd_lists)
+        {
+            SP_ASSERT(cmd_list->IsSecondary() && cmd_list->GetState() == RHI_CommandListState::Ended);
+
+            // From here on, the secondary command list lives as long as this one does on the gpu
+            cmd_list->m_state = RHI_CommandListState::Idle;
+        }
+    }
+
+    void RHI_CommandList::ClearPipelineStateRenderTargets(RHI_PipelineState& pipeline_state)
+    {
+        // Validate state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::ClearRenderTarget(RHI_Texture* texture,
+        const uint32_t color_index          /*= 0*/,
+        const uint32_t depth_stencil_index  /*= 0*/,
+        const bool storage                  /*= false*/,
+        const Color& clear_color            /*= rhi_color_load*/,
+        const float clear_depth             /*= rhi_depth_load*/,
+        const uint32_t clear_stencil        /*= rhi_stencil_load*/
+    )
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT_MSG((texture->GetFlags() & RHI_Texture_ClearOrBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+
+        if (!texture || !texture->GetRhiSrv())
+        {
+            SP_LOG_ERROR("Texture is null.");
+            return;
+        }
+
+        // One of the required layouts for clear functions
+        texture->SetLayout(RHI_Image_Layout::Transfer_Dst_Optimal, this);
+    }
+
+    void RHI_CommandList::Draw(const uint32_t vertex_count, uint32_t vertex_start_index /*= 0*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Ensure correct state before attempting to draw
+        OnDraw();
+
+        if (m_profiler)
+        {
+            m_profiler->m_rhi_draw++;
+        }
+    }
+
+    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Ensure correct state before attempting to draw
+        OnDraw();
+
+        if (m_profiler)
+        {
+            m_profiler->m_rhi_draw++;
+        }
+    }
+
+    void RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z /*= 1*/, bool async /*= false*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Ensure correct state before attempting to dispatch
+        OnDraw();
+
+        if (m_profiler)
+        {
+            m_profiler->m_rhi_dispatch++;
+        }
+    }
+
+    void RHI_CommandList::Blit(RHI_Texture* source, RHI_Texture* destination, const bool blit_mips)
+    {
+        SP_ASSERT(source != nullptr);
+        SP_ASSERT(destination != nullptr);
+        SP_ASSERT(source->GetRhiResource() != destination->GetRhiResource());
+        SP_ASSERT(source->GetFormat() == destination->GetFormat());
+        SP_ASSERT(source->GetWidth() == destination->GetWidth());
+        SP_ASSERT(source->GetHeight() == destination->GetHeight());
+        SP_ASSERT(source->GetArrayLength() == destination->GetArrayLength());
+        SP_ASSERT(source->GetMipCount() == destination->GetMipCount());
+
+        // Validate transfer bits
+        SP_ASSERT_MSG((source->GetFlags() & RHI_Texture_ClearOrBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT_MSG((destination->GetFlags() & RHI_Texture_ClearOrBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+
+        // Save the initial layouts
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_source      = source->GetLayouts();
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_destination = destination->GetLayouts();
+
+        // Transition to blit appropriate layouts
+        source->SetLayout(RHI_Image_Layout::Transfer_Src_Optimal,      this);
+        destination->SetLayout(RHI_Image_Layout::Transfer_Dst_Optimal, this);
+
+        // Transition to the initial layouts
+        if (source->GetMipCount() > 1)
+        {
+            for (uint32_t i = 0; i < source->GetMipCount(); i++)
+            {
+                source->SetLayout(layouts_initial_source[i], this, i, 1);
+                destination->SetLayout(layouts_initial_destination[i], this, i, 1);
+            }
+        }
+        else
+        {
+            source->SetLayout(layouts_initial_source[0], this);
+            destination->SetLayout(layouts_initial_destination[0], this);
+        }
+    }
+
+    void RHI_CommandList::SetViewport(const RHI_Viewport& viewport) const
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::SetScissorRectangle(const Math::Rectangle& scissor_rectangle) const
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::SetBufferVertex(const RHI_VertexBuffer* buffer)
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Skip if already set
+        if (m_vertex_buffer_id == buffer->GetObjectId())
+            return;
+
+        m_vertex_buffer_id = buffer->GetObjectId();
+
+        if (m_profiler)
+        {
+            m_profiler->m_rhi_bindings_buffer_vertex++;
+        }
+    }
+
+    void RHI_CommandList::SetBufferIndex(const RHI_IndexBuffer* buffer)
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (m_index_buffer_id == buffer->GetObjectId())
+            return;
+
+        m_index_buffer_id = buffer->GetObjectId();
+
+        if (m_profiler)
+        {
+            m_profiler->m_rhi_bindings_buffer_index++;
+        }
+    }
+
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer, const uint32_t offset) const
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (!m_descriptor_layout_current)
+        {
+            SP_LOG_WARNING("Descriptor layout not set, try setting constant buffer \"%s\" within a render pass", constant_buffer->GetName().c_str());
+            return;
+        }
+
+        // Set (will only happen if it's not already set)
+        m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer, offset);
+    }
+
+    void RHI_CommandList::SetSampler(const uint32_t slot, RHI_Sampler* sampler) const
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (!m_descriptor_layout_current)
+        {
+            SP_LOG_WARNING("Descriptor layout not set, try setting sampler \"%s\" within a render pass", sampler->GetName().c_str());
+            return;
+        }
+
+        // Set (will only happen if it's not already set)
+        m_descriptor_layout_current->SetSampler(slot, sampler);
+    }
+
+    void RHI_CommandList::SetTexture(const uint32_t slot, RHI_Texture* texture, const uint32_t mip_index /*= all_mips*/, uint32_t mip_range /*= 0*/, const bool uav /*= false*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (mip_index != rhi_all_mips)
+        {
+            SP_ASSERT_MSG(mip_range != 0, "If a mip was specified, then mip_range can't be 0");
+        }
+
+        if (!m_descriptor_layout_current)
+        {
+            SP_LOG_WARNING("Descriptor layout not set, try setting texture \"%s\" within a render pass", texture->GetName().c_str());
+            return;
+        }
+
+        // If the texture is null or it's still loading, ignore it.
+        if (!texture || !texture->IsReadyForUse())
+            return;
+
+        // Get some texture info
+        const uint32_t mip_count        = texture->GetMipCount();
+        const bool mip_specified        = mip_index != rhi_all_mips;
+        const uint32_t mip_start        = mip_specified ? mip_index : 0;
+        RHI_Image_Layout current_layout = texture->GetLayout(mip_start);
+
+        SP_ASSERT_MSG(texture->GetRhiSrv() != nullptr, "The texture has no srv"); // Vulkan only has SRVs
+        SP_ASSERT_MSG(current_layout != RHI_Image_Layout::Undefined && current_layout != RHI_Image_Layout::Preinitialized, "Invalid layout");
+
+        // Transition to appropriate layout (if needed)
+        {
+            RHI_Image_Layout target_layout = RHI_Image_Layout::Undefined;
+
+            if (uav)
+            {
+                SP_ASSERT(texture->IsUav());
+                
+                // According to section 13.1 of the Vulkan spec, storage textures have to be in a general layout.
+                // https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#descriptorsets-storageimage
+                target_layout = RHI_Image_Layout::General;
+            }
+            else
+            {
+                SP_ASSERT(texture->IsSrv());
+
+                // Color
+                if (texture->IsColorFormat())
+                {
+                    target_layout = RHI_Image_Layout::Shader_Read_Only_Optimal;
+                }
+
+                // Depth
+                if (texture->IsDepthFormat())
+                {
+                    target_layout = RHI_Image_Layout::Depth_Stencil_Read_Only_Optimal;
+                }
+            }
+
+            // Verify that an appropriate layout has been deduced
+            SP_ASSERT(target_layout != RHI_Image_Layout::Undefined);
+
+            // Determine if a layout transition is needed
+            bool transition_required = current_layout != target_layout;
+            {
+                bool rest_mips_have_same_layout = true;
+                array<RHI_Image_Layout, rhi_max_mip_count> layouts = texture->GetLayouts();
+                for (uint32_t i = mip_start; i < mip_start + mip_count; i++)
+                {
+                    if (target_layout != layouts[i])
+                    {
+                        rest_mips_have_same_layout = false;
+                        break;
+                    }
+                }
+
+                transition_required = !rest_mips_have_same_layout ? true : transition_required;
+            }
+
+            // Transition
+            if (transition_required)
+            {
+                SP_ASSERT(!m_is_rendering && "Can't transition to a different layout while rendering");
+                texture->SetLayout(target_layout, this, mip_index, mip_range);
+            }
+        }
+
+        // Set (will only happen if it's not already set)
+        m_descriptor_layout_current->SetTexture(slot, texture, mip_index, mip_range);
+    }
+
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav) const
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (!m_descriptor_layout_current)
+        {
+            SP_LOG_WARNING("Descriptor layout not set, try setting structured buffer \"%s\" within a render pass", structured_buffer->GetName().c_str());
+            return;
+        }
+
+        m_descriptor_layout_current->SetStructuredBuffer(slot, structured_buffer, uav);
+    }
+
+    uint32_t RHI_CommandList::GetGpuMemoryUsed(RHI_Device* rhi_device)
+    {
+        return 0;
+    }
+
+    void RHI_CommandList::BeginMarker(const char* name)
+    {
+
+    }
+
+    void RHI_CommandList::EndMarker()
+    {
+
+    }
+
+    void RHI_CommandList::BeginTimestamp(void* query)
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::EndTimestamp(void* query)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    float RHI_CommandList::GetTimestampDuration(void* query_start, void* query_end, const uint32_t pass_index)
+    {
+        return 0.0f;
+    }
+
+    void RHI_CommandList::BeginTimeblock(const char* name, const bool gpu_marker, const bool gpu_timing)
+    {
+        SP_ASSERT_MSG(!m_timeblock_is_active, "The previous time block is still active");
+        SP_ASSERT(name != nullptr);
+
+        // Allowed profiler ?
+        if (m_rhi_device->GetRhiContext()->gpu_profiling && gpu_timing && m_profiler)
+        {
+            m_profiler->TimeBlockStart(name, TimeBlockType::Cpu, this);
+            m_profiler->TimeBlockStart(name, TimeBlockType::Gpu, this);
+        }
+
+        m_timeblock_is_active = true;
+    }
+
+    void RHI_CommandList::EndTimeblock()
+    {
+        SP_ASSERT_MSG(m_timeblock_is_active, "A time block wasn't started");
+
+        // Allowed profiler ?
+        if (m_rhi_device->GetRhiContext()->gpu_profiling && m_profiler)
+        {
+            m_profiler->TimeBlockEnd(); // cpu
+            m_profiler->TimeBlockEnd(); // gpu
+        }
+
+        m_timeblock_is_active = false;
+    }
+
+    void RHI_CommandList::OnDraw()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Bind descriptor sets
+        {
+            // If the descriptor set is null, it means we don't need to bind anything.
+            if (RHI_DescriptorSet* descriptor_set = m_descriptor_layout_current->GetDescriptorSet())
+            {
+                SP_ASSERT(descriptor_set->GetResource() != nullptr);
+
+                // Get dynamic offsets
+                m_descriptor_layout_current->GetDynamicOffsets(&m_dynamic_offsets);
+
+                if (m_profiler)
+                {
+                    m_profiler->m_rhi_bindings_descriptor_set++;
+                }
+            }
+        }
+    }
+
+    void RHI_CommandList::UnbindOutputTextures()
+    {
+
+    }
+
+    void RHI_CommandList::GetDescriptorSetLayoutFromPipelineState(RHI_PipelineState& pipeline_state)
+    {
+        // Get pipeline
+        vector<RHI_Descriptor> descriptors;
+        GetDescriptorsFromPipelineState(pipeline_state, descriptors);
+
+        // Compute a hash for the descriptors
+        uint64_t hash = 0;
+        for (const RHI_Descriptor& descriptor : descriptors)
+        {
+            hash = rhi_hash_combine(hash, descriptor.ComputeHash());
+        }
+
+        // Search for a descriptor set layout which matches this hash
+        auto it     = m_descriptor_set_layouts.find(hash);
+        bool cached = it != m_descriptor_set_layouts.end();
+
+        // If there is no descriptor set layout for this particular hash, create one
+        if (!cached)
+        {
+            // Create a name for the descriptor set layout, very useful for Vulkan debugging
+            string name  = "CS:" + (pipeline_state.shader_compute ? pipeline_state.shader_compute->GetName() : "null");
+            name        += "-VS:" + (pipeline_state.shader_vertex ? pipeline_state.shader_vertex->GetName()  : "null");
+            name        += "-PS:" + (pipeline_state.shader_pixel  ? pipeline_state.shader_pixel->GetName()   : "null");
+
+            // Emplace a new descriptor set layout
+            it = m_descriptor_set_layouts.emplace(make_pair(hash, make_shared<RHI_DescriptorSetLayout>(m_rhi_device, descriptors, name.c_str()))).first;
+        }
+
+        // Get the descriptor set layout we will be using
+        m_descriptor_layout_current = it->second.get();
+
+        // Clear any data data the the descriptors might contain from previous uses (and hence can possibly be invalid by now)
+        if (cached)
+        {
+            m_descriptor_layout_current->ClearDescriptorData();
+        }
+
+        // Make it bind
+        m_descriptor_layout_current->NeedsToBind();
+    }
+}
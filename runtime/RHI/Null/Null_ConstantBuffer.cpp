@@ -0,0 +1,111 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_ConstantBuffer.h"
+#include "../RHI_Device.h"
+#include <cstring>
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    void RHI_ConstantBuffer::_destroy()
+    {
+        m_rhi_device->DestroyBuffer(m_rhi_resource);
+        m_mapped_data = nullptr;
+    }
+
+    RHI_ConstantBuffer::RHI_ConstantBuffer(RHI_Device* rhi_device, const string& name)
+    {
+        m_rhi_device = rhi_device;
+        m_name       = name;
+    }
+
+    void RHI_ConstantBuffer::_create()
+    {
+        // Destroy previous buffer
+        _destroy();
+
+        // Calculate required alignment based on minimum device offset alignment
+        size_t min_alignment = m_rhi_device->GetMinUniformBufferOffsetAllignment();
+        if (min_alignment > 0)
+        {
+            m_stride = static_cast<uint64_t>((m_stride + min_alignment - 1) & ~(min_alignment - 1));
+        }
+        m_object_size_gpu = m_stride * m_element_count;
+
+        // Create buffer
+        m_rhi_device->CreateBuffer(m_rhi_resource, m_object_size_gpu, 0, 0);
+
+        // Get mapped data pointer
+        m_mapped_data = m_rhi_device->get_mapped_data_from_buffer(m_rhi_resource);
+    }
+
+    bool RHI_ConstantBuffer::Allocate(const uint32_t count, uint32_t& offset)
+    {
+        if (m_reset_offset)
+        {
+            m_offset_free  = 0;
+            m_reset_offset = false;
+        }
+
+        if (m_offset_free + static_cast<uint64_t>(count) * m_stride > m_object_size_gpu)
+            return false;
+
+        offset         = m_offset_free;
+        m_offset_free += count * m_stride;
+
+        return true;
+    }
+
+    void RHI_ConstantBuffer::Update(void* data_cpu)
+    {
+        SP_ASSERT_MSG(data_cpu != nullptr,      "Invalid update data");
+        SP_ASSERT_MSG(m_mapped_data != nullptr, "Invalid mapped data");
+
+        // Advance offset
+        const bool allocated = Allocate(1, m_offset);
+        SP_ASSERT_MSG(allocated, "Out of memory");
+
+        // Copy, just like a persistently mapped buffer would
+        memcpy(reinterpret_cast<std::byte*>(m_mapped_data) + m_offset, reinterpret_cast<std::byte*>(data_cpu), m_element_size);
+    }
+
+    void RHI_ConstantBuffer::Write(const uint32_t offset, const void* data, const uint32_t count)
+    {
+        SP_ASSERT_MSG(data != nullptr,                                "Invalid data");
+        SP_ASSERT_MSG(m_mapped_data != nullptr,                       "Invalid mapped data");
+        SP_ASSERT_MSG(offset + count * m_stride <= m_object_size_gpu, "Out of memory");
+
+        const std::byte* src = reinterpret_cast<const std::byte*>(data);
+        std::byte* dst       = reinterpret_cast<std::byte*>(m_mapped_data) + offset;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            memcpy(dst + i * m_stride, src + i * m_element_size, m_element_size);
+        }
+    }
+}
@@ -0,0 +1,310 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Semaphore.h"
+#include "../RHI_Fence.h"
+#include "../../Profiling/Profiler.h"
+#include <cstring>
+//===================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    RHI_Device::RHI_Device(Context* context, shared_ptr<RHI_Context> rhi_context)
+    {
+        m_context     = context;
+        m_rhi_context = rhi_context;
+
+        // Pass pointer to the widely used utility namespace
+        null_utility::globals::rhi_device  = this;
+        null_utility::globals::rhi_context = rhi_context.get();
+
+        // There is nothing to capture, gpu time blocks stay enabled and simply read back zero
+        m_rhi_context->gpu_markers = false;
+        m_rhi_context->renderdoc   = false;
+
+        // Create device
+        m_rhi_context->device          = null_utility::handle::create();
+        m_rhi_context->api_version_str = "1.0";
+
+        // Detect and select physical device
+        SP_ASSERT_MSG(DetectPhysicalDevices(),      "Failed to detect any devices");
+        SP_ASSERT_MSG(SelectPrimaryPhysicalDevice(), "Failed to find a suitable device");
+
+        // Device properties, picked to match a typical desktop gpu so that buffer layouts stay realistic
+        m_max_texture_1d_dimension            = 16384;
+        m_max_texture_2d_dimension            = 16384;
+        m_max_texture_3d_dimension            = 2048;
+        m_max_texture_cube_dimension          = 16384;
+        m_max_texture_array_layers            = 2048;
+        m_min_uniform_buffer_offset_alignment = 256;
+        m_min_storage_buffer_offset_alignment = 256;
+        m_timestamp_period                    = 1.0f;
+        m_wide_lines                          = true;
+
+        // Get a graphics, compute and a copy queue.
+        m_queue_graphics = null_utility::handle::create();
+        m_queue_compute  = null_utility::handle::create();
+        m_queue_copy     = null_utility::handle::create();
+
+        // Set the descriptor set capacity to an initial value
+        SetDescriptorSetCapacity(2048);
+
+        SP_LOG_INFO("Null %s", m_rhi_context->api_version_str.c_str());
+    }
+
+    RHI_Device::~RHI_Device()
+    {
+        SP_ASSERT(m_rhi_context != nullptr);
+        SP_ASSERT(m_queue_graphics != nullptr);
+
+        QueueWaitAll();
+
+        // Destroy command pools
+        m_cmd_pools.clear();
+        m_cmd_pools_immediate.fill(nullptr);
+
+        // Descriptor pool
+        null_utility::handle::destroy(m_descriptor_pool);
+
+        // Allocations
+        SP_ASSERT_MSG(m_allocations.empty(), "There are still allocations");
+
+        // Queues
+        null_utility::handle::destroy(m_queue_graphics);
+        null_utility::handle::destroy(m_queue_compute);
+        null_utility::handle::destroy(m_queue_copy);
+
+        // Device
+        null_utility::handle::destroy(m_rhi_context->device);
+    }
+
+    bool RHI_Device::DetectPhysicalDevices()
+    {
+        RegisterPhysicalDevice(PhysicalDevice
+        (
+            0,                                // api version
+            0,                                // driver version
+            0,                                // vendor id
+            RHI_PhysicalDevice_Type::Cpu,     // type
+            "Null",                           // name
+            0,                                // memory
+            null_utility::handle::create()    // data
+        ));
+
+        return true;
+    }
+
+    bool RHI_Device::SelectPrimaryPhysicalDevice()
+    {
+        // A single queue family does everything
+        SetQueueIndex(RHI_Queue_Type::Graphics, 0);
+        SetQueueIndex(RHI_Queue_Type::Compute,  0);
+        SetQueueIndex(RHI_Queue_Type::Copy,     0);
+        SetPrimaryPhysicalDevice(0);
+
+        return DetectDisplayModes(GetPrimaryPhysicalDevice(), RHI_Format_R8G8B8A8_Unorm);
+    }
+
+    bool RHI_Device::DetectDisplayModes(const PhysicalDevice* physical_device, const RHI_Format format)
+    {
+        // Add some display modes manually
+        const uint32_t hz = Display::GetRefreshRate();
+        const bool update_fps_limit_to_highest_hz = true;
+        Display::RegisterDisplayMode(DisplayMode(640, 480, hz, 1), update_fps_limit_to_highest_hz, m_context);
+        Display::RegisterDisplayMode(DisplayMode(720, 576, hz, 1), update_fps_limit_to_highest_hz, m_context);
+        Display::RegisterDisplayMode(DisplayMode(1280, 720, hz, 1), update_fps_limit_to_highest_hz, m_context);
+        Display::RegisterDisplayMode(DisplayMode(1920, 1080, hz, 1), update_fps_limit_to_highest_hz, m_context);
+        Display::RegisterDisplayMode(DisplayMode(2560, 1440, hz, 1), update_fps_limit_to_highest_hz, m_context);
+
+        return true;
+    }
+
+    void RHI_Device::QueuePresent(void* swapchain, uint32_t* image_index, vector<RHI_Semaphore*>& wait_semaphores)
+    {
+        SP_ASSERT_MSG(swapchain != nullptr, "Invalid swapchain");
+
+        for (RHI_Semaphore* semaphore : wait_semaphores)
+        {
+            SP_ASSERT_MSG(semaphore->GetCpuState() == RHI_Sync_State::Submitted, "The wait semaphore hasn't been signaled");
+            semaphore->SetCpuState(RHI_Sync_State::Idle);
+        }
+    }
+
+    void RHI_Device::QueueSubmit(const RHI_Queue_Type type, const uint32_t wait_flags, void* cmd_buffer, RHI_Semaphore* wait_semaphore /*= nullptr*/, RHI_Semaphore* signal_semaphore /*= nullptr*/, RHI_Fence* signal_fence /*= nullptr*/)
+    {
+        SP_ASSERT_MSG(cmd_buffer != nullptr, "Invalid command buffer");
+
+        // Validate semaphores
+        if (wait_semaphore)   SP_ASSERT_MSG(wait_semaphore->GetCpuState()   != RHI_Sync_State::Idle,      "Wait semaphore is in an idle state and will never be signaled");
+        if (signal_semaphore) SP_ASSERT_MSG(signal_semaphore->GetCpuState() != RHI_Sync_State::Submitted, "Signal semaphore is already in a signaled state.");
+        if (signal_fence)     SP_ASSERT_MSG(signal_fence->GetCpuState()     != RHI_Sync_State::Submitted, "Signal fence is already in a signaled state.");
+
+        // Nothing to execute, the work is done as soon as it's submitted
+        lock_guard<mutex> lock(m_mutex_queue);
+
+        // Update semaphore states
+        if (wait_semaphore)   wait_semaphore->SetCpuState(RHI_Sync_State::Idle);
+        if (signal_semaphore) signal_semaphore->SetCpuState(RHI_Sync_State::Submitted);
+        if (signal_fence)     signal_fence->SetCpuState(RHI_Sync_State::Submitted);
+    }
+
+    void RHI_Device::QueueWait(const RHI_Queue_Type type)
+    {
+        lock_guard<mutex> lock(m_mutex_queue);
+    }
+
+    void RHI_Device::QueryCreate(void** query, const RHI_Query_Type type)
+    {
+
+    }
+
+    void RHI_Device::QueryRelease(void*& query)
+    {
+
+    }
+
+    void RHI_Device::QueryBegin(void* query)
+    {
+
+    }
+
+    void RHI_Device::QueryEnd(void* query)
+    {
+
+    }
+
+    void RHI_Device::QueryGetData(void* query)
+    {
+
+    }
+
+    void RHI_Device::SetDescriptorSetCapacity(uint32_t descriptor_set_capacity)
+    {
+        // If the requested capacity is zero, then only recreate the descriptor pool
+        if (descriptor_set_capacity == 0)
+        {
+            descriptor_set_capacity = m_descriptor_set_capacity;
+        }
+
+        // Create pool
+        null_utility::handle::destroy(m_descriptor_pool);
+        m_descriptor_pool = null_utility::handle::create();
+
+        SP_LOG_INFO("Capacity has been set to %d elements", descriptor_set_capacity);
+        m_descriptor_set_capacity = descriptor_set_capacity;
+
+        if (Profiler* profiler = m_context->GetSystem<Profiler>())
+        {
+            profiler->m_descriptor_set_count    = 0;
+            profiler->m_descriptor_set_capacity = m_descriptor_set_capacity;
+        }
+    }
+
+    uint64_t get_allocation_id_from_resource(void* resource)
+    {
+        return reinterpret_cast<uint64_t>(resource);
+    }
+
+    void* RHI_Device::get_allocation_from_resource(void* resource)
+    {
+        auto it = m_allocations.find(get_allocation_id_from_resource(resource));
+        return it != m_allocations.end() ? it->second : nullptr;
+    }
+
+    void* RHI_Device::get_mapped_data_from_buffer(void* resource)
+    {
+        // Buffers live in host memory, so the allocation is the mapped data
+        return get_allocation_from_resource(resource);
+    }
+
+    void RHI_Device::CreateBuffer(void*& resource, const uint64_t size, uint32_t usage, uint32_t memory_property_flags, const void* data_initial /* = nullptr */)
+    {
+        SP_ASSERT_MSG(size != 0, "Invalid size");
+
+        // Back every buffer with host memory, so that updates and uploads cost what a memcpy costs
+        std::byte* allocation = new std::byte[size];
+        if (data_initial != nullptr)
+        {
+            memcpy(allocation, data_initial, size);
+        }
+
+        // The allocation address doubles as the resource handle
+        resource = static_cast<void*>(allocation);
+
+        // Keep allocation reference
+        lock_guard<mutex> lock(m_mutex_allocation);
+        m_allocations[get_allocation_id_from_resource(resource)] = allocation;
+    }
+
+    void RHI_Device::DestroyBuffer(void*& resource)
+    {
+        if (!resource)
+            return;
+
+        lock_guard<mutex> lock(m_mutex_allocation);
+
+        if (std::byte* allocation = static_cast<std::byte*>(get_allocation_from_resource(resource)))
+        {
+            delete[] allocation;
+
+            m_allocations.erase(get_allocation_id_from_resource(resource));
+            resource = nullptr;
+        }
+    }
+
+    void RHI_Device::CreateTexture(void* image_create_info, void*& resource)
+    {
+        // Texture memory is never read back, a handle is enough
+        resource = null_utility::handle::create();
+    }
+
+    void RHI_Device::DestroyTexture(void*& resource)
+    {
+        SP_ASSERT_MSG(resource != nullptr, "Resource is null");
+
+        null_utility::handle::destroy(resource);
+    }
+
+    void RHI_Device::MapMemory(void* resource, void*& mapped_data)
+    {
+        mapped_data = get_mapped_data_from_buffer(resource);
+    }
+
+    void RHI_Device::UnmapMemory(void* resource, void*& mapped_data)
+    {
+        SP_ASSERT_MSG(mapped_data, "Memory is already unmapped");
+
+        mapped_data = nullptr;
+    }
+
+    void RHI_Device::FlushAllocation(void* resource, uint64_t offset, uint64_t size)
+    {
+        // Host memory is always coherent
+    }
+}
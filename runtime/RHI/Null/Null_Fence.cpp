@@ -0,0 +1,62 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Fence.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+//================================
+
+namespace Spartan
+{
+    RHI_Fence::RHI_Fence(RHI_Device* rhi_device, const char* name /*= nullptr*/)
+    {
+        m_rhi_device = rhi_device;
+        m_resource   = null_utility::handle::create();
+
+        if (name)
+        {
+            m_name = name;
+        }
+    }
+
+    RHI_Fence::~RHI_Fence()
+    {
+        null_utility::handle::destroy(m_resource);
+    }
+
+    bool RHI_Fence::IsSignaled()
+    {
+        // Submitted work completes immediately
+        return m_cpu_state == RHI_Sync_State::Submitted;
+    }
+
+    bool RHI_Fence::Wait(uint64_t timeout_nanoseconds /*= 1000000000*/)
+    {
+        return true;
+    }
+
+    void RHI_Fence::Reset()
+    {
+        m_cpu_state = RHI_Sync_State::Idle;
+    }
+}
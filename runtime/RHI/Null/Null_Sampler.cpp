@@ -0,0 +1,52 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Sampler.h"
+#include "../RHI_Device.h"
+#include "../../Rendering/Renderer.h"
+#include "../RHI_CommandList.h"
+//===================================
+
+namespace Spartan
+{
+    void RHI_Sampler::CreateResource()
+    {
+        m_rhi_resource = null_utility::handle::create();
+    }
+
+    RHI_Sampler::~RHI_Sampler()
+    {
+        // Discard the current command list in case it's referencing the sampler.
+        if (Renderer* renderer = m_rhi_device->GetContext()->GetSystem<Renderer>())
+        {
+            if (RHI_CommandList* cmd_list = renderer->GetCmdList())
+            {
+                cmd_list->Discard();
+            }
+        }
+
+        // Destroy
+        null_utility::handle::destroy(m_rhi_resource);
+    }
+}
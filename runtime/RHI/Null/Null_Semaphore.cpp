@@ -0,0 +1,69 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Semaphore.h"
+#include "../RHI_Implementation.h"
+//================================
+
+namespace Spartan
+{
+    RHI_Semaphore::RHI_Semaphore(RHI_Device* rhi_device, bool is_timeline /*= false*/, const char* name /*= nullptr*/)
+    {
+        m_is_timeline = is_timeline;
+        m_rhi_device  = rhi_device;
+        m_resource    = null_utility::handle::create();
+
+        if (name)
+        {
+            m_name = name;
+        }
+    }
+
+    RHI_Semaphore::~RHI_Semaphore()
+    {
+        null_utility::handle::destroy(m_resource);
+    }
+
+    void RHI_Semaphore::Reset()
+    {
+        m_cpu_state = RHI_Sync_State::Idle;
+    }
+
+    void RHI_Semaphore::Wait(const uint64_t value, uint64_t timeout /*= std::numeric_limits<uint64_t>::max()*/)
+    {
+        SP_ASSERT(m_is_timeline);
+    }
+
+    void RHI_Semaphore::Signal(const uint64_t value)
+    {
+        SP_ASSERT(m_is_timeline);
+    }
+
+    uint64_t RHI_Semaphore::GetValue()
+    {
+        SP_ASSERT(m_is_timeline);
+
+        // Timeline values are not tracked, waits return immediately
+        return 0;
+    }
+}
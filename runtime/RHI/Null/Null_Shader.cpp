@@ -0,0 +1,64 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_Shader.h"
+#include "../RHI_InputLayout.h"
+//==================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    RHI_Shader::~RHI_Shader()
+    {
+        null_utility::handle::destroy(m_rhi_resource);
+    }
+
+    void* RHI_Shader::GetRhiResource() const
+    {
+        return m_rhi_resource;
+    }
+
+    void* RHI_Shader::Compile2()
+    {
+        // Load the bytecode and reflection from the cache, or compile and cache them
+        vector<uint32_t> bytecode;
+        if (!LoadOrCompile(bytecode))
+            return nullptr;
+
+        // There is no driver to hand the bytecode to, but compiling and reflecting keeps the descriptors real
+        void* shader_module = null_utility::handle::create();
+
+        // Create input layout
+        if (m_input_layout)
+        {
+            m_input_layout->Create(m_vertex_type, nullptr);
+        }
+
+        return shader_module;
+    }
+}
@@ -0,0 +1,230 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_SwapChain.h"
+#include "../RHI_Device.h"
+#include "../RHI_CommandList.h"
+#include "../RHI_Semaphore.h"
+#include "../RHI_CommandPool.h"
+//===================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    static void create(
+        RHI_Device* rhi_device,
+        const uint32_t buffer_count,
+        array<RHI_Image_Layout, max_buffer_count>& layouts,
+        void*& swap_chain,
+        array<void*, max_buffer_count>& backbuffer_textures,
+        array<void*, max_buffer_count>& backbuffer_texture_views,
+        array<shared_ptr<RHI_Semaphore>, max_buffer_count>& image_acquired_semaphore
+    )
+    {
+        swap_chain = null_utility::handle::create();
+
+        for (uint32_t i = 0; i < buffer_count; i++)
+        {
+            // Images and views
+            backbuffer_textures[i]      = null_utility::handle::create();
+            backbuffer_texture_views[i] = null_utility::handle::create();
+            layouts[i]                  = RHI_Image_Layout::Undefined;
+
+            // Semaphores
+            string name = (string("swapchain_image_acquired_") + to_string(i));
+            image_acquired_semaphore[i] = make_shared<RHI_Semaphore>(rhi_device, false, name.c_str());
+        }
+    }
+
+    static void destroy(
+        const uint32_t buffer_count,
+        void*& swap_chain,
+        array<void*, max_buffer_count>& backbuffer_textures,
+        array<void*, max_buffer_count>& backbuffer_texture_views,
+        array<shared_ptr<RHI_Semaphore>, max_buffer_count>& image_acquired_semaphore
+    )
+    {
+        // Sync objects
+        image_acquired_semaphore.fill(nullptr);
+
+        // Images and views
+        for (uint32_t i = 0; i < buffer_count; i++)
+        {
+            null_utility::handle::destroy(backbuffer_textures[i]);
+            null_utility::handle::destroy(backbuffer_texture_views[i]);
+        }
+
+        // Swap chain
+        null_utility::handle::destroy(swap_chain);
+    }
+
+    RHI_SwapChain::RHI_SwapChain(
+        void* window_handle,
+        RHI_Device* rhi_device,
+        const uint32_t width,
+        const uint32_t height,
+        const RHI_Format format,
+        const uint32_t buffer_count,
+        const uint32_t flags,
+        const char* name
+    )
+    {
+        // Verify resolution
+        if (!rhi_device->IsValidResolution(width, height))
+        {
+            SP_LOG_WARNING("%dx%d is an invalid resolution", width, height);
+            return;
+        }
+
+        m_acquire_semaphore.fill(nullptr);
+        m_rhi_backbuffer_resource.fill(nullptr);
+        m_rhi_backbuffer_srv.fill(nullptr);
+        m_layouts.fill(RHI_Image_Layout::Undefined);
+
+        // Copy parameters
+        m_format        = format;
+        m_rhi_device    = rhi_device;
+        m_buffer_count  = buffer_count;
+        m_width         = width;
+        m_height        = height;
+        m_window_handle = window_handle;
+        m_flags         = flags;
+        m_name          = name;
+
+        create(m_rhi_device, m_buffer_count, m_layouts, m_rhi_resource, m_rhi_backbuffer_resource, m_rhi_backbuffer_srv, m_acquire_semaphore);
+
+        AcquireNextImage();
+    }
+
+    RHI_SwapChain::~RHI_SwapChain()
+    {
+        m_rhi_device->QueueWaitAll();
+
+        destroy(m_buffer_count, m_rhi_resource, m_rhi_backbuffer_resource, m_rhi_backbuffer_srv, m_acquire_semaphore);
+    }
+
+    bool RHI_SwapChain::Resize(const uint32_t width, const uint32_t height, const bool force /*= false*/)
+    {
+        // Validate resolution
+        m_present_enabled = m_rhi_device->IsValidResolution(width, height);
+
+        if (!m_present_enabled)
+            return false;
+
+        // Only resize if needed
+        if (!force)
+        {
+            if (m_width == width && m_height == height)
+                return false;
+        }
+
+        m_rhi_device->QueueWaitAll();
+
+        // Save new dimensions
+        m_width  = width;
+        m_height = height;
+
+        // Recreate
+        destroy(m_buffer_count, m_rhi_resource, m_rhi_backbuffer_resource, m_rhi_backbuffer_srv, m_acquire_semaphore);
+        create(m_rhi_device, m_buffer_count, m_layouts, m_rhi_resource, m_rhi_backbuffer_resource, m_rhi_backbuffer_srv, m_acquire_semaphore);
+
+        // Reset image index
+        m_image_index          = numeric_limits<uint32_t>::max();
+        m_image_index_previous = m_image_index;
+
+        AcquireNextImage();
+
+        return true;
+    }
+
+    void RHI_SwapChain::AcquireNextImage()
+    {
+        SP_ASSERT(m_present_enabled && "No need to acquire next image when presenting is disabled");
+
+        // Return if the swapchain has a single buffer and it has already been acquired
+        if (m_buffer_count == 1 && m_image_index != numeric_limits<uint32_t>::max())
+            return;
+
+        // Get signal semaphore
+        m_sync_index = (m_sync_index + 1) % m_buffer_count;
+        RHI_Semaphore* signal_semaphore = m_acquire_semaphore[m_sync_index].get();
+
+        // Ensure semaphore state
+        SP_ASSERT_MSG(signal_semaphore->GetCpuState() != RHI_Sync_State::Submitted, "The semaphore is already signaled");
+
+        // Acquire next image, images are handed out in order
+        m_image_index_previous = m_image_index;
+        m_image_index          = (m_image_index + 1) % m_buffer_count;
+
+        // Update semaphore state
+        signal_semaphore->SetCpuState(RHI_Sync_State::Submitted);
+    }
+
+    void RHI_SwapChain::Present()
+    {
+        SP_ASSERT_MSG(m_rhi_resource != nullptr,               "The swapchain has not been initialised");
+        SP_ASSERT_MSG(m_present_enabled,                       "Presenting is disabled");
+        SP_ASSERT_MSG(m_image_index != m_image_index_previous, "No image was acquired");
+
+        // Get the semaphores that present should wait for
+        static vector<RHI_Semaphore*> wait_semaphores;
+        {
+            wait_semaphores.clear();
+
+            // The first is simply the image acquired semaphore
+            wait_semaphores.emplace_back(m_acquire_semaphore[m_sync_index].get());
+
+            // The others are all the command lists that present to this swapchain
+            const vector<shared_ptr<RHI_CommandPool>>& cmd_pools = m_rhi_device->GetCommandPools();
+            for (const shared_ptr<RHI_CommandPool>& cmd_pool : cmd_pools)
+            {
+                if (m_object_id == cmd_pool->GetSwapchainId())
+                {
+                    RHI_Semaphore* semaphore = cmd_pool->GetCurrentCommandList()->GetSemaphoreProccessed();
+
+                    // Discarded command lists are not submitted, so their semaphore won't be signaled
+                    if (semaphore->GetCpuState() == RHI_Sync_State::Submitted)
+                    {
+                        wait_semaphores.emplace_back(semaphore);
+                    }
+                }
+            }
+        }
+
+        // Present
+        m_rhi_device->QueuePresent(m_rhi_resource, &m_image_index, wait_semaphores);
+
+        // Acquire next image
+        AcquireNextImage();
+    }
+
+    void RHI_SwapChain::SetLayout(const RHI_Image_Layout& layout, RHI_CommandList* cmd_list)
+    {
+        m_layouts[m_image_index] = layout;
+    }
+}
@@ -0,0 +1,156 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_Texture2D.h"
+#include "../RHI_TextureCube.h"
+#include "../RHI_CommandList.h"
+#include "../../Rendering/Renderer.h"
+//===================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    inline RHI_Image_Layout GetAppropriateLayout(RHI_Texture* texture)
+    {
+        RHI_Image_Layout target_layout = RHI_Image_Layout::Preinitialized;
+
+        if (texture->IsRenderTargetColor())
+        {
+            target_layout = RHI_Image_Layout::Color_Attachment_Optimal;
+        }
+        else if (texture->IsRenderTargetDepthStencil())
+        {
+            target_layout = RHI_Image_Layout::Depth_Stencil_Attachment_Optimal;
+        }
+
+        if (texture->IsUav())
+            target_layout = RHI_Image_Layout::General;
+
+        if (texture->IsSrv())
+            target_layout = RHI_Image_Layout::Shader_Read_Only_Optimal;
+
+        return target_layout;
+    }
+
+    void RHI_Texture::RHI_SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* cmd_list, const uint32_t mip_start, const uint32_t mip_range)
+    {
+        // Layouts are tracked by RHI_Texture::SetLayout(), there is no barrier to record
+    }
+
+    void RHI_Texture::RHI_SetLayouts(const vector<RHI_Texture*>& textures, const vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list)
+    {
+        // Layouts are tracked by RHI_Texture::SetLayouts(), there is no barrier to record
+    }
+
+    bool RHI_Texture::RHI_CreateResource()
+    {
+        SP_ASSERT(m_rhi_device != nullptr);
+        SP_ASSERT(m_rhi_device->GetRhiContext()->device != nullptr);
+
+        m_rhi_device->CreateTexture(nullptr, m_rhi_resource);
+
+        // Transition to target layout
+        RHI_Image_Layout target_layout = GetAppropriateLayout(this);
+        for (uint32_t i = 0; i < m_mip_count; i++)
+        {
+            m_layout[i] = target_layout;
+        }
+
+        // Shader resource views
+        if (IsSrv())
+        {
+            m_rhi_srv = null_utility::handle::create();
+
+            if (HasPerMipViews())
+            {
+                for (uint32_t i = 0; i < m_mip_count; i++)
+                {
+                    m_rhi_srv_mips[i] = null_utility::handle::create();
+                }
+            }
+        }
+
+        // Render target views
+        for (uint32_t i = 0; i < m_array_length; i++)
+        {
+            if (IsRenderTargetColor())
+            {
+                m_rhi_rtv[i] = null_utility::handle::create();
+            }
+
+            if (IsRenderTargetDepthStencil())
+            {
+                m_rhi_dsv[i] = null_utility::handle::create();
+            }
+        }
+
+        return true;
+    }
+
+    void RHI_Texture::RHI_DestroyResource(const bool destroy_main, const bool destroy_per_view)
+    {
+        SP_ASSERT(m_rhi_device != nullptr);
+
+        // Destruction can happen during engine shutdown, in which case, the renderer might not exist, so, if statement.
+        if (Context* context = m_rhi_device->GetContext())
+        {
+            if (Renderer* renderer = context->GetSystem<Renderer>())
+            {
+                if (RHI_CommandList* cmd_list = renderer->GetCmdList())
+                {
+                    cmd_list->Discard();
+                }
+            }
+        }
+
+        if (destroy_main)
+        {
+            null_utility::handle::destroy(m_rhi_srv);
+
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                null_utility::handle::destroy(m_rhi_dsv[i]);
+                null_utility::handle::destroy(m_rhi_rtv[i]);
+            }
+        }
+
+        if (destroy_per_view)
+        {
+            for (uint32_t i = 0; i < m_mip_count; i++)
+            {
+                null_utility::handle::destroy(m_rhi_srv_mips[i]);
+            }
+        }
+
+        if (destroy_main && m_rhi_resource)
+        {
+            m_rhi_device->DestroyTexture(m_rhi_resource);
+        }
+    }
+}
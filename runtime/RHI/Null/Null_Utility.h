@@ -0,0 +1,57 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <atomic>
+#include "../RHI_Device.h"
+#include "../RHI_Texture.h"
+#include "../RHI_SwapChain.h"
+#include "../../Logging/Log.h"
+#include "../../Display/Display.h"
+//================================
+
+namespace Spartan::null_utility
+{
+    struct globals
+    {
+        static inline RHI_Device* rhi_device;
+        static inline RHI_Context* rhi_context;
+    };
+
+    // The null backend never talks to a GPU, but the rest of the engine treats
+    // RHI resources as opaque handles (null checks, hashing, descriptor caching).
+    // So every resource gets a unique non-null handle which is never dereferenced.
+    namespace handle
+    {
+        inline void* create()
+        {
+            static std::atomic<uint64_t> id = 0;
+            return reinterpret_cast<void*>(++id);
+        }
+
+        inline void destroy(void*& handle)
+        {
+            handle = nullptr;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_VertexBuffer.h"
+#include <cstring>
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    void RHI_VertexBuffer::_destroy()
+    {
+        m_rhi_device->DestroyBuffer(m_rhi_resource);
+        m_mapped_data = nullptr;
+    }
+
+    void RHI_VertexBuffer::_create(const void* vertices)
+    {
+        // Destroy previous buffer
+        if (m_rhi_resource)
+        {
+            _destroy();
+        }
+
+        m_is_mappable = vertices == nullptr;
+
+        // Both paths end up in host memory, the static path pays for the copy a staging upload would do
+        m_rhi_device->CreateBuffer(m_rhi_resource, m_object_size_gpu, 0, 0, vertices);
+
+        if (m_is_mappable)
+        {
+            m_mapped_data = m_rhi_device->get_mapped_data_from_buffer(m_rhi_resource);
+        }
+    }
+
+    void RHI_VertexBuffer::_update(const void* vertices, const vector<pair<uint32_t, uint32_t>>& ranges)
+    {
+        // Host memory, so it's just copies
+        std::byte* destination  = static_cast<std::byte*>(m_rhi_device->get_mapped_data_from_buffer(m_rhi_resource));
+        const std::byte* source = static_cast<const std::byte*>(vertices);
+        for (const auto& [vertex_offset, vertex_count] : ranges)
+        {
+            const uint64_t offset = static_cast<uint64_t>(vertex_offset) * m_stride;
+            memcpy(destination + offset, source + offset, static_cast<uint64_t>(vertex_count) * m_stride);
+        }
+    }
+
+    void* RHI_VertexBuffer::Map()
+    {
+        return m_mapped_data;
+    }
+
+    void RHI_VertexBuffer::Unmap()
+    {
+        // buffer is mapped on creation and unmapped during destruction
+    }
+
+    void RHI_VertexBuffer::RecordStagedCopies(RHI_CommandList* cmd_list)
+    {
+        // Host memory, updates are copied in place
+    }
+
+    void RHI_VertexBuffer::ResetStaging()
+    {
+
+    }
+}
@@ -29,6 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Shader.h"
 #include "RHI_Pipeline.h"
 #include "RHI_CommandPool.h"
+#include "RHI_ConstantBuffer.h"
+#include "../Core/ThreadPool.h"
 //==================================
 
 //= NAMESPACES =====
@@ -37,6 +39,14 @@ using namespace std;
 
 namespace Spartan
 {
+    unordered_map<uint64_t, shared_ptr<RHI_Pipeline>> RHI_CommandList::m_pipelines;
+    mutex RHI_CommandList::m_mutex_pipelines;
+    condition_variable RHI_CommandList::m_pipelines_condition;
+    unordered_set<uint64_t> RHI_CommandList::m_pipelines_pending;
+    atomic<uint32_t> RHI_CommandList::m_pipeline_creation_count   = 0;
+    atomic<uint64_t> RHI_CommandList::m_pipeline_creation_time_us = 0;
+    unordered_map<uint64_t, shared_ptr<RHI_DescriptorSetLayout>> RHI_CommandList::m_descriptor_set_layouts_prewarm;
+
     void RHI_CommandList::Wait(const bool log_on_wait /*= true*/)
     {
         SP_ASSERT_MSG(m_state == RHI_CommandListState::Submitted, "The command list hasn't been submitted, can't wait for it.");
@@ -65,6 +75,11 @@ namespace Spartan
         m_state = RHI_CommandListState::Idle;
     }
 
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
+    {
+        SetConstantBuffer(slot, scope, constant_buffer, constant_buffer ? constant_buffer->GetOffset() : 0);
+    }
+
     void RHI_CommandList::Discard()
     {
         m_discard = true;
@@ -88,6 +103,151 @@ namespace Spartan
             !m_discard;                                   // It hasn't been discarded, in which case Submit() early exited.
     }
 
+    RHI_Pipeline* RHI_CommandList::GetOrCreatePipeline(RHI_Device* rhi_device, RHI_PipelineState& pso, RHI_DescriptorSetLayout* descriptor_set_layout)
+    {
+        const uint64_t hash = pso.ComputeHash();
+
+        unique_lock<mutex> lock(m_mutex_pipelines);
+
+        // If another thread is creating this pipeline, wait for it instead of creating a duplicate
+        m_pipelines_condition.wait(lock, [hash]() { return m_pipelines_pending.find(hash) == m_pipelines_pending.end(); });
+
+        auto it = m_pipelines.find(hash);
+        if (it == m_pipelines.end())
+        {
+            // Create a new pipeline, without holding the lock, so that command lists
+            // which are recorded on other threads can create their pipelines concurrently
+            m_pipelines_pending.insert(hash);
+            lock.unlock();
+
+            // Whichever way this scope is left (creation can throw), the waiters have to be released, or they would block forever
+            struct PendingGuard
+            {
+                unique_lock<mutex>& lock;
+                uint64_t hash;
+
+                ~PendingGuard()
+                {
+                    if (!lock.owns_lock())
+                    {
+                        lock.lock();
+                    }
+
+                    m_pipelines_pending.erase(hash);
+                    m_pipelines_condition.notify_all();
+                }
+            } pending_guard = { lock, hash };
+
+            const Stopwatch timer;
+            shared_ptr<RHI_Pipeline> pipeline = make_shared<RHI_Pipeline>(rhi_device, pso, descriptor_set_layout);
+            m_pipeline_creation_time_us      += static_cast<uint64_t>(timer.GetElapsedTimeMs() * 1000.0f);
+            m_pipeline_creation_count++;
+
+            lock.lock();
+            it = m_pipelines.emplace(make_pair(hash, move(pipeline))).first;
+            SP_LOG_INFO("A new pipeline has been created.");
+        }
+
+        return it->second.get();
+    }
+
+    vector<RHI_PipelineState> RHI_CommandList::GetPipelineStates()
+    {
+        lock_guard<mutex> lock(m_mutex_pipelines);
+
+        vector<RHI_PipelineState> pipeline_states;
+        pipeline_states.reserve(m_pipelines.size());
+        for (const auto& it : m_pipelines)
+        {
+            pipeline_states.emplace_back(*it.second->GetPipelineState());
+        }
+
+        return pipeline_states;
+    }
+
+    void RHI_CommandList::PrewarmPipelines(RHI_Device* rhi_device, vector<RHI_PipelineState>& pipeline_states)
+    {
+        // The descriptor set layouts are created here, and they are kept alive as the pipeline layouts are created from them.
+        // They are identical to the ones the command lists create, so descriptor sets from either can be bound with these pipelines.
+        vector<RHI_DescriptorSetLayout*> descriptor_set_layouts(pipeline_states.size(), nullptr);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(pipeline_states.size()); i++)
+        {
+            RHI_PipelineState& pso = pipeline_states[i];
+            if (!pso.IsValid())
+                continue;
+
+            vector<RHI_Descriptor> descriptors;
+            GetDescriptorsFromPipelineState(pso, descriptors);
+
+            uint64_t hash = 0;
+            for (const RHI_Descriptor& descriptor : descriptors)
+            {
+                hash = rhi_hash_combine(hash, descriptor.ComputeHash());
+            }
+
+            auto it = m_descriptor_set_layouts_prewarm.find(hash);
+            if (it == m_descriptor_set_layouts_prewarm.end())
+            {
+                it = m_descriptor_set_layouts_prewarm.emplace(make_pair(hash, make_shared<RHI_DescriptorSetLayout>(rhi_device, descriptors, "prewarm"))).first;
+            }
+
+            descriptor_set_layouts[i] = it->second.get();
+        }
+
+        // Pipeline creation is where the driver compiles the shaders, so it's spread over the worker threads
+        ThreadPool::ParallelLoop([rhi_device, &pipeline_states, &descriptor_set_layouts](uint32_t work_index_start, uint32_t work_index_end)
+        {
+            for (uint32_t i = work_index_start; i < work_index_end; i++)
+            {
+                if (descriptor_set_layouts[i])
+                {
+                    GetOrCreatePipeline(rhi_device, pipeline_states[i], descriptor_set_layouts[i]);
+                }
+            }
+        }, static_cast<uint32_t>(pipeline_states.size()), 1);
+    }
+
+    void RHI_CommandList::RemovePipelines(const RHI_Shader* shader)
+    {
+        // The pipelines are destroyed after the lock is released, as their destruction waits for the GPU
+        vector<shared_ptr<RHI_Pipeline>> pipelines_removed;
+        {
+            lock_guard<mutex> lock(m_mutex_pipelines);
+
+            for (auto it = m_pipelines.begin(); it != m_pipelines.end();)
+            {
+                const RHI_PipelineState* pso = it->second->GetPipelineState();
+                if (pso->shader_compute == shader || pso->shader_vertex == shader || pso->shader_pixel == shader)
+                {
+                    pipelines_removed.emplace_back(move(it->second));
+                    it = m_pipelines.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        if (!pipelines_removed.empty())
+        {
+            SP_LOG_INFO("Removed %d pipeline(s) which used \"%s\"", static_cast<uint32_t>(pipelines_removed.size()), shader->GetName().c_str());
+        }
+    }
+
+    void RHI_CommandList::DestroyPipelines()
+    {
+        // The pipelines and layouts are destroyed after the lock is released, as their destruction waits for the GPU
+        unordered_map<uint64_t, shared_ptr<RHI_Pipeline>> pipelines;
+        unordered_map<uint64_t, shared_ptr<RHI_DescriptorSetLayout>> descriptor_set_layouts;
+        {
+            lock_guard<mutex> lock(m_mutex_pipelines);
+
+            pipelines.swap(m_pipelines);
+            descriptor_set_layouts.swap(m_descriptor_set_layouts_prewarm);
+        }
+    }
+
     void RHI_CommandList::GetDescriptorsFromPipelineState(RHI_PipelineState& pipeline_state, vector<RHI_Descriptor>& descriptors)
     {
         if (!pipeline_state.IsValid())
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =================================
 #include <array>
 #include <atomic>
+#include <unordered_set>
 #include "RHI_Definition.h"
 #include "RHI_PipelineState.h"
 #include "RHI_Descriptor.h"
@@ -44,10 +45,13 @@ namespace Spartan
     class SP_CLASS RHI_CommandList : public Object
     {
     public:
-        RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool_resource, const char* name);
+        RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool_resource, const char* name, const bool is_secondary = false);
         ~RHI_CommandList();
 
         void Begin();
+        // Secondary command lists only, begins recording draws for a render pass with the given pipeline state.
+        // The render pass itself is begun by a primary command list, which then executes the secondary ones.
+        void Begin(RHI_PipelineState& pso);
         void End();
         void Submit();
         // Waits for the command list to finish being processed.
@@ -57,9 +61,13 @@ namespace Spartan
 
         // Render pass
         void SetPipelineState(RHI_PipelineState& pso);
-        void BeginRenderPass();
+        // When secondary_contents is true, the render pass can only execute secondary command lists.
+        void BeginRenderPass(const bool secondary_contents = false);
         void EndRenderPass();
 
+        // Secondary command lists
+        void ExecuteSecondary(const std::vector<RHI_CommandList*>& cmd_lists);
+
         // Clear
         void ClearPipelineStateRenderTargets(RHI_PipelineState& pipeline_state);
         void ClearRenderTarget(
@@ -74,7 +82,7 @@ namespace Spartan
 
         // Draw
         void Draw(uint32_t vertex_count, uint32_t vertex_start_index = 0);
-        void DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0);
+        void DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0, uint32_t instance_count = 1);
 
         // Dispatch
         void Dispatch(uint32_t x, uint32_t y, uint32_t z = 1, bool async = false);
@@ -96,6 +104,8 @@ namespace Spartan
 
         // Constant buffer
         void SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const;
+        // Binds the buffer at the given offset, instead of the offset of its last update.
+        void SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer, const uint32_t offset) const;
         inline void SetConstantBuffer(const RendererBindingsCb slot, const uint8_t scope, const std::shared_ptr<RHI_ConstantBuffer>& constant_buffer) const { SetConstantBuffer(static_cast<uint32_t>(slot), scope, constant_buffer.get()); }
 
         // Sampler
@@ -110,8 +120,9 @@ namespace Spartan
         inline void SetTexture(const RendererBindingsSrv slot, const std::shared_ptr<RHI_Texture>& texture, const uint32_t mip_index = rhi_all_mips, uint32_t mip_range = 0) { SetTexture(static_cast<uint32_t>(slot), texture.get(), mip_index, mip_range, false); }
 
         // Structured buffer
-        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const;
-        inline void SetStructuredBuffer(const RendererBindingsUav slot, const std::shared_ptr<RHI_StructuredBuffer>& structured_buffer) const { SetStructuredBuffer(static_cast<uint32_t>(slot), structured_buffer.get()); }
+        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav = true) const;
+        inline void SetStructuredBuffer(const RendererBindingsUav slot, const std::shared_ptr<RHI_StructuredBuffer>& structured_buffer) const { SetStructuredBuffer(static_cast<uint32_t>(slot), structured_buffer.get(), true); }
+        inline void SetStructuredBuffer(const RendererBindingsSrv slot, const std::shared_ptr<RHI_StructuredBuffer>& structured_buffer) const { SetStructuredBuffer(static_cast<uint32_t>(slot), structured_buffer.get(), false); }
 
         // Markers
         void BeginMarker(const char* name);
@@ -130,6 +141,18 @@ namespace Spartan
         static uint32_t GetGpuMemory(RHI_Device* rhi_device);
         static uint32_t GetGpuMemoryUsed(RHI_Device* rhi_device);
 
+        // Pipelines (creation statistics since startup)
+        static uint32_t GetPipelineCreationCount() { return m_pipeline_creation_count; }
+        static float GetPipelineCreationTimeMs()   { return static_cast<float>(m_pipeline_creation_time_us) / 1000.0f; }
+        // The states of every pipeline which has been created so far (the pointers they hold might no longer be valid)
+        static std::vector<RHI_PipelineState> GetPipelineStates();
+        // Creates the pipelines for the given states on the worker threads, so that they are ready when they are first bound
+        static void PrewarmPipelines(RHI_Device* rhi_device, std::vector<RHI_PipelineState>& pipeline_states);
+        // Removes the pipelines which use the given shader, for when it's about to be replaced or destroyed
+        static void RemovePipelines(const RHI_Shader* shader);
+        // Destroys all pipelines (and the layouts of the prewarmed ones), they are static so this has to happen before the device is released
+        static void DestroyPipelines();
+
         // State
         const RHI_CommandListState GetState() const { return m_state; }
         bool IsExecuting();
@@ -140,6 +163,7 @@ namespace Spartan
         // Misc
         void* GetRhiResource() const { return m_rhi_resource; }
         uint32_t GetIndex()    const { return m_index; }
+        bool IsSecondary()     const { return m_is_secondary; }
 
     private:
         void OnDraw();
@@ -147,7 +171,10 @@ namespace Spartan
 
         // Descriptors
         void GetDescriptorSetLayoutFromPipelineState(RHI_PipelineState& pipeline_state);
-        void GetDescriptorsFromPipelineState(RHI_PipelineState& pipeline_state, std::vector<RHI_Descriptor>& descriptors);
+        static void GetDescriptorsFromPipelineState(RHI_PipelineState& pipeline_state, std::vector<RHI_Descriptor>& descriptors);
+
+        // Pipelines
+        static RHI_Pipeline* GetOrCreatePipeline(RHI_Device* rhi_device, RHI_PipelineState& pso, RHI_DescriptorSetLayout* descriptor_set_layout);
 
         RHI_Pipeline* m_pipeline                         = nullptr;
         Renderer* m_renderer                             = nullptr;
@@ -160,7 +187,8 @@ namespace Spartan
         static const uint8_t m_resource_array_length_max = 16;
         static bool m_memory_query_support;
         std::mutex m_mutex_reset;
-        uint32_t m_index = 0;
+        uint32_t m_index    = 0;
+        bool m_is_secondary = false;
 
         // Sync
         std::shared_ptr<RHI_Fence> m_proccessed_fence;
@@ -169,11 +197,18 @@ namespace Spartan
         // Descriptors
         std::unordered_map<uint64_t, std::shared_ptr<RHI_DescriptorSetLayout>> m_descriptor_set_layouts;
         RHI_DescriptorSetLayout* m_descriptor_layout_current = nullptr;
+        std::vector<uint32_t> m_dynamic_offsets;
 
         // Pipelines
         RHI_PipelineState m_pso;
         // <hash of pipeline state, pipeline state object>
         static std::unordered_map<uint64_t, std::shared_ptr<RHI_Pipeline>> m_pipelines;
+        static std::mutex m_mutex_pipelines; // command lists can be recorded from different threads
+        static std::condition_variable m_pipelines_condition;    // signaled when a pipeline has been created
+        static std::unordered_set<uint64_t> m_pipelines_pending; // pipelines which are being created by some thread
+        static std::atomic<uint32_t> m_pipeline_creation_count;
+        static std::atomic<uint64_t> m_pipeline_creation_time_us;
+        static std::unordered_map<uint64_t, std::shared_ptr<RHI_DescriptorSetLayout>> m_descriptor_set_layouts_prewarm; // layouts of prewarmed pipelines
 
         // Keep track of output textures so that we can unbind them and prevent
         // D3D11 warnings when trying to bind them as SRVs in following passes
@@ -39,11 +39,30 @@ namespace Spartan
         {
             for (uint32_t index_cmd_list = 0; index_cmd_list < cmd_list_count; index_cmd_list++)
             {
-                CreateCommandPool(queue_type);
+                m_rhi_resources.emplace_back(CreateCommandPool(queue_type));
                 string cmd_list_name = m_name + "_cmd_pool_" + to_string(index_cmd_pool) + "_cmd_list_" + to_string(index_cmd_list);
                 m_cmd_lists.push_back(make_shared<RHI_CommandList>(m_context, queue_type, index_cmd_list, m_rhi_resources[index_cmd_pool], cmd_list_name.c_str()));
             }
         }
+
+        m_cmd_lists_secondary.resize(m_cmd_lists.size());
+    }
+
+    RHI_CommandList* RHI_CommandPool::GetSecondaryCommandList(const uint32_t index)
+    {
+        const uint32_t index_cmd_list = m_cmd_pool_index + m_cmd_list_index;
+        vector<shared_ptr<RHI_CommandList>>& cmd_lists = m_cmd_lists_secondary[index_cmd_list];
+
+        // Create them on demand, they are kept around for the following frames
+        while (cmd_lists.size() <= index)
+        {
+            m_rhi_resources_secondary.emplace_back(CreateCommandPool(m_queue_type));
+            const uint32_t index_secondary = static_cast<uint32_t>(cmd_lists.size());
+            string cmd_list_name           = m_name + "_cmd_list_" + to_string(index_cmd_list) + "_secondary_" + to_string(index_secondary);
+            cmd_lists.push_back(make_shared<RHI_CommandList>(m_context, m_queue_type, index_secondary, m_rhi_resources_secondary.back(), cmd_list_name.c_str(), true));
+        }
+
+        return cmd_lists[index].get();
     }
 
     bool RHI_CommandPool::Step()
@@ -40,12 +40,15 @@ namespace Spartan
         bool Step();
 
         RHI_CommandList* GetCurrentCommandList()       { return m_cmd_lists[m_cmd_pool_index + m_cmd_list_index].get(); }
+        // Secondary command lists belong to the current command list, as they can only be reused once it has finished executing.
+        // Each one has a pool of its own, so they can be recorded from different threads (but they have to be acquired from the thread which steps).
+        RHI_CommandList* GetSecondaryCommandList(const uint32_t index);
         uint32_t GetCommandListIndex()           const { return m_cmd_list_index; }
         void*& GetResource()                           { return m_rhi_resources[m_cmd_pool_index]; }
         uint64_t GetSwapchainId()                const { return m_swap_chain_id; }
 
     private:
-        void CreateCommandPool(const RHI_Queue_Type queue_type);
+        void* CreateCommandPool(const RHI_Queue_Type queue_type);
         void Reset(const uint32_t pool_index);
 
         // Command lists
@@ -53,6 +56,10 @@ namespace Spartan
         uint32_t m_cmd_list_index = 0;
         uint32_t m_cmd_list_count = 0;
 
+        // Secondary command lists, per command list
+        std::vector<std::vector<std::shared_ptr<RHI_CommandList>>> m_cmd_lists_secondary;
+        std::vector<void*> m_rhi_resources_secondary;
+
         // Command pools
         std::vector<void*> m_rhi_resources;
         uint32_t m_cmd_pool_index = 0;
@@ -39,7 +39,8 @@ namespace Spartan
         void Create(const uint32_t element_count = 1)
         {
             m_element_count   = element_count;
-            m_stride          = static_cast<uint32_t>(sizeof(T));
+            m_element_size    = static_cast<uint32_t>(sizeof(T));
+            m_stride          = m_element_size;
             m_object_size_gpu = static_cast<uint64_t>(m_stride * m_element_count);
 
             _create();
@@ -47,7 +48,13 @@ namespace Spartan
 
         void Update(void* data);
         void ResetOffset() { m_reset_offset = true; }
-        
+
+        // Linear sub-allocation, for data which is prepared before recording and only bound while recording.
+        // Allocate() reserves count elements after the ones in use (returns false if they don't fit or the api can't bind offsets),
+        // Write() copies count tightly packed elements into them, which are bound by passing their offset to RHI_CommandList::SetConstantBuffer().
+        bool Allocate(const uint32_t count, uint32_t& offset);
+        void Write(const uint32_t offset, const void* data, const uint32_t count);
+
         uint32_t GetStride()      const { return m_stride; }
         uint32_t GetOffset()      const { return m_offset; }
         uint32_t GetStrideCount() const { return m_element_count; }
@@ -59,7 +66,9 @@ namespace Spartan
 
         uint32_t m_stride        = 0;
         uint32_t m_offset        = 0;
+        uint32_t m_offset_free   = 0; // bump pointer, everything before it is in use
         uint32_t m_element_count = 0;
+        uint32_t m_element_size  = 0; // size of the cpu side struct, the stride can be larger due to alignment
         bool m_reset_offset      = true;
         void* m_mapped_data      = nullptr;
         void* m_rhi_resource     = nullptr;
@@ -78,7 +78,8 @@ namespace Spartan
     {
         D3d11,
         D3d12,
-        Vulkan
+        Vulkan,
+        Null
     };
 
     enum RHI_Present_Mode : uint32_t
@@ -50,7 +50,7 @@ namespace Spartan
         }
     }
 
-    void RHI_DescriptorSetLayout::SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer)
+    void RHI_DescriptorSetLayout::SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer, const uint32_t offset)
     {
         for (RHI_Descriptor& descriptor : m_descriptors)
         {
@@ -58,11 +58,11 @@ namespace Spartan
             {
                 // Determine if the descriptor set needs to bind (affects vkUpdateDescriptorSets)
                 m_needs_to_bind = descriptor.data           != constant_buffer              ? true : m_needs_to_bind;
-                m_needs_to_bind = descriptor.dynamic_offset != constant_buffer->GetOffset() ? true : m_needs_to_bind;
+                m_needs_to_bind = descriptor.dynamic_offset != offset                       ? true : m_needs_to_bind;
                 m_needs_to_bind = descriptor.range          != constant_buffer->GetStride() ? true : m_needs_to_bind;
 
                 descriptor.data           = static_cast<void*>(constant_buffer);
-                descriptor.dynamic_offset = constant_buffer->GetOffset();
+                descriptor.dynamic_offset = offset;
                 descriptor.range          = constant_buffer->GetStride();
 
                 return;
@@ -70,11 +70,13 @@ namespace Spartan
         }
     }
 
-    void RHI_DescriptorSetLayout::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer)
+    void RHI_DescriptorSetLayout::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav)
     {
+        const uint32_t slot_shifted = slot + (uav ? rhi_shader_shift_register_u : rhi_shader_shift_register_t);
+
         for (RHI_Descriptor& descriptor : m_descriptors)
         {
-            if ((descriptor.type == RHI_Descriptor_Type::StructuredBuffer) && descriptor.slot == slot + rhi_shader_shift_register_u)
+            if ((descriptor.type == RHI_Descriptor_Type::StructuredBuffer) && descriptor.slot == slot_shifted)
             {
                 // Determine if the descriptor set needs to bind (affects vkUpdateDescriptorSets)
                 m_needs_to_bind = descriptor.data           != structured_buffer              ? true : m_needs_to_bind;
@@ -167,6 +169,7 @@ namespace Spartan
         }
 
         // If we don't have a descriptor set to match that state, create one
+        lock_guard<mutex> lock(m_rhi_device->GetDescriptorSetMutex());
         unordered_map<uint64_t, RHI_DescriptorSet>& descriptor_sets = m_rhi_device->GetDescriptorSets();
         const auto it = descriptor_sets.find(hash);
         if (it == descriptor_sets.end())
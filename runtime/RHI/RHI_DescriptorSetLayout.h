@@ -47,8 +47,8 @@ namespace Spartan
         ~RHI_DescriptorSetLayout();
 
         // Set
-        void SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer);
-        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer);
+        void SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer, const uint32_t offset);
+        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav);
         void SetSampler(const uint32_t slot, RHI_Sampler* sampler);
         void SetTexture(const uint32_t slot, RHI_Texture* texture, const uint32_t mip_index, const uint32_t mip_range);
 
@@ -70,6 +70,7 @@ namespace Spartan
         // Descriptors
         void* GetDescriptorPool()                                            { return m_descriptor_pool; }
         std::unordered_map<uint64_t, RHI_DescriptorSet>& GetDescriptorSets() { return m_descriptor_sets; }
+        std::mutex& GetDescriptorSetMutex()                                  { return m_mutex_descriptor_sets; }
         bool HasDescriptorSetCapacity();
         void SetDescriptorSetCapacity(uint32_t descriptor_set_capacity);
 
@@ -145,6 +146,7 @@ namespace Spartan
         std::mutex m_mutex_queue;
         std::mutex m_mutex_allocation;
         std::mutex m_mutex_immediate;
+        std::mutex m_mutex_descriptor_sets;
 
         // Misc
         uint32_t m_physical_device_index          = 0;
@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES =======
+#include <mutex>
 SP_WARNINGS_OFF
 #include <dxc/dxcapi.h>
 SP_WARNINGS_ON
@@ -253,14 +254,7 @@ namespace Spartan
     public:
         static IDxcResult* Compile(const std::string& source, std::vector<std::string>& arguments)
         {
-            // Initialise (only happens once)
-            static IDxcUtils* m_utils        = nullptr;
-            static IDxcCompiler3* m_compiler = nullptr;
-            if (!m_compiler)
-            {
-                DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&m_compiler));
-                DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_utils));
-            }
+            Initialize();
 
             // Get shader source
             DxcBuffer dxc_buffer = {};
@@ -326,5 +320,54 @@ namespace Spartan
 
             return dxc_result;
         }
+
+        // Version and commit count of the loaded compiler, shader caches have to be invalidated when it changes
+        static const std::string& GetVersion()
+        {
+            static std::string version;
+            static std::once_flag flag;
+            std::call_once(flag, []()
+            {
+                Initialize();
+
+                uint32_t major = 0;
+                uint32_t minor = 0;
+                IDxcVersionInfo* version_info = nullptr;
+                if (SUCCEEDED(m_compiler->QueryInterface(IID_PPV_ARGS(&version_info))))
+                {
+                    version_info->GetVersion(&major, &minor);
+                    version_info->Release();
+                }
+
+                uint32_t commit_count = 0;
+                IDxcVersionInfo2* version_info2 = nullptr;
+                if (SUCCEEDED(m_compiler->QueryInterface(IID_PPV_ARGS(&version_info2))))
+                {
+                    char* commit_hash = nullptr;
+                    version_info2->GetCommitInfo(&commit_count, &commit_hash);
+                    CoTaskMemFree(commit_hash);
+                    version_info2->Release();
+                }
+
+                version = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(commit_count);
+            });
+
+            return version;
+        }
+
+    private:
+        // Initialise (only happens once)
+        static void Initialize()
+        {
+            static std::once_flag flag;
+            std::call_once(flag, []()
+            {
+                DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&m_compiler));
+                DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_utils));
+            });
+        }
+
+        static inline IDxcUtils* m_utils        = nullptr;
+        static inline IDxcCompiler3* m_compiler = nullptr;
     };
 }
@@ -480,6 +480,7 @@ namespace Spartan
             VkInstance instance                = nullptr;
             VkPhysicalDevice device_physical   = nullptr;
             VkDevice device                    = nullptr;
+            VkPipelineCache pipeline_cache     = nullptr;
 
             std::vector<VkValidationFeatureEnableEXT> validation_extensions = { };
             std::vector<const char*> extensions_instance                    = { "VK_KHR_surface", "VK_KHR_win32_surface" };
@@ -498,6 +499,12 @@ namespace Spartan
             // Note: Would like to enable VK_KHR_synchronization2, but only 17.3% of the devices out there support it.
         #endif
 
+        #if defined(API_GRAPHICS_NULL)
+            static const RHI_Api_Type api_type = RHI_Api_Type::Null;
+            std::string api_type_str           = "Null";
+            void* device                       = nullptr;
+        #endif
+
         // Validation\profiling\markers and so on
         #ifdef DEBUG
             bool validation    = true;
@@ -520,6 +527,8 @@ namespace Spartan
     #include "D3D12/D3D12_Utility.h"
 #elif defined (API_GRAPHICS_VULKAN)
     #include "Vulkan/Vulkan_Utility.h"
+#elif defined (API_GRAPHICS_NULL)
+    #include "Null/Null_Utility.h"
 #endif
 
 #endif // RUNTIME
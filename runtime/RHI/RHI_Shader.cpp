@@ -19,13 +19,22 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====================
+//= INCLUDES ============================
 #include "pch.h"
 #include "RHI_Shader.h"
 #include "RHI_InputLayout.h"
 #include "../Core/ThreadPool.h"
 #include "../Rendering/Renderer.h"
-//================================
+#include "../IO/FileStream.h"
+#include "../Resource/ResourceCache.h"
+#if defined(API_GRAPHICS_VULKAN) || defined(API_GRAPHICS_NULL)
+#include "RHI_DirectXShaderCompiler.h"
+SP_WARNINGS_OFF
+#include <spirv_cross/spirv_hlsl.hpp>
+SP_WARNINGS_ON
+#endif
+#include <cstring>
+//=======================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -33,6 +42,17 @@ using namespace std;
 
 namespace Spartan
 {
+    // Bump when the cache file layout changes (or when anything else that isn't part of the key affects the output)
+    static const uint32_t shader_cache_version = 1;
+    static const uint32_t shader_cache_magic   = 0x53504348; // "SPCH"
+
+    // Anything above this is a corrupt file, not a shader
+    static const uint32_t shader_cache_descriptors_max = 256;
+    static const uint32_t shader_cache_descriptor_size = 6 * sizeof(uint32_t); // name length, type, layout, slot, array size, stage
+
+    static atomic<uint32_t> shader_cache_hits   = 0;
+    static atomic<uint32_t> shader_cache_misses = 0;
+
     RHI_Shader::RHI_Shader(Context* context) : Object(context)
     {
         m_rhi_device = context->GetSystem<Renderer>()->GetRhiDevice();
@@ -45,6 +65,7 @@ namespace Spartan
         const unordered_map<string, string>& defines,
         string& object_name,
         void*& resource,
+        const bool& loaded_from_cache,
         function<void*()> compile2
     )
     {
@@ -58,6 +79,7 @@ namespace Spartan
         // Log compilation result
         {
             string prefix_str = (compilation_state == Shader_Compilation_State::Succeeded) ? "Successfully compiled" : "Failed to compile";
+            prefix_str        = (compilation_state == Shader_Compilation_State::Succeeded && loaded_from_cache) ? "Loaded cached" : prefix_str;
 
             string type_str = "unknown";
             type_str = shader_type == RHI_Shader_Vertex  ? "vertex"  : type_str;
@@ -109,13 +131,13 @@ namespace Spartan
 
             if (!async)
             {
-                CompileShader(m_compilation_state, m_shader_type, m_defines, m_name, m_rhi_resource, bind(&RHI_Shader::Compile2, this));
+                CompileShader(m_compilation_state, m_shader_type, m_defines, m_name, m_rhi_resource, m_loaded_from_cache, bind(&RHI_Shader::Compile2, this));
             }
             else
             {
                 ThreadPool::AddTask([this]()
                 {
-                    CompileShader(m_compilation_state, m_shader_type, m_defines, m_name, m_rhi_resource, std::bind(&RHI_Shader::Compile2, this));
+                    CompileShader(m_compilation_state, m_shader_type, m_defines, m_name, m_rhi_resource, m_loaded_from_cache, std::bind(&RHI_Shader::Compile2, this));
                 });
             }
         }
@@ -223,6 +245,345 @@ namespace Spartan
         return m_input_layout->GetVertexSize();
     }
 
+    uint64_t RHI_Shader::ComputeCacheKey(const vector<string>& arguments, const string& compiler_version) const
+    {
+        // The arguments contain the entry point, the target profile, the defines and any code generation flags
+        hash<string> hasher;
+        uint64_t key = static_cast<uint64_t>(hasher(m_preprocessed_source));
+        for (const string& argument : arguments)
+        {
+            key = rhi_hash_combine(key, static_cast<uint64_t>(hasher(argument)));
+        }
+        key = rhi_hash_combine(key, static_cast<uint64_t>(hasher(compiler_version)));
+        key = rhi_hash_combine(key, static_cast<uint64_t>(shader_cache_version));
+
+        return key;
+    }
+
+    static string get_cache_file_path(const string& name, const uint64_t key)
+    {
+        return ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache) + "\\" + name + "_" + to_string(key) + ".cache";
+    }
+
+    bool RHI_Shader::LoadFromCache(const uint64_t key, vector<uint32_t>& bytecode)
+    {
+        m_loaded_from_cache = false;
+
+        const string file_path = get_cache_file_path(m_name, key);
+        if (!FileSystem::IsFile(file_path))
+        {
+            shader_cache_misses++;
+            return false;
+        }
+
+        FileStream file(file_path, FileStream_Read);
+        if (!file.IsOpen())
+        {
+            shader_cache_misses++;
+            return false;
+        }
+
+        // Any failure from here on means that the shader gets compiled
+        auto miss = [&bytecode]()
+        {
+            bytecode.clear();
+            shader_cache_misses++;
+            return false;
+        };
+
+        // Header
+        if (file.ReadAs<uint32_t>() != shader_cache_magic || file.ReadAs<uint32_t>() != shader_cache_version || file.ReadAs<uint64_t>() != key || !file.IsGood())
+            return miss();
+
+        // Bytecode (the length is checked against the remaining size of the file before anything is allocated)
+        file.Read(&bytecode);
+        if (bytecode.empty() || !file.IsGood())
+            return miss();
+
+        // Reflection
+        const uint32_t descriptor_count = file.ReadAs<uint32_t>();
+        if (!file.IsGood() || descriptor_count > shader_cache_descriptors_max || static_cast<uint64_t>(descriptor_count) * shader_cache_descriptor_size > file.GetRemainingSize())
+            return miss();
+
+        vector<RHI_Descriptor> descriptors(descriptor_count);
+        for (RHI_Descriptor& descriptor : descriptors)
+        {
+            file.Read(&descriptor.name);
+            descriptor.type       = static_cast<RHI_Descriptor_Type>(file.ReadAs<uint32_t>());
+            descriptor.layout     = static_cast<RHI_Image_Layout>(file.ReadAs<uint32_t>());
+            descriptor.slot       = file.ReadAs<uint32_t>();
+            descriptor.array_size = file.ReadAs<uint32_t>();
+            descriptor.stage      = file.ReadAs<uint32_t>();
+
+            if (!file.IsGood())
+                return miss();
+        }
+
+        // A file which was cut short won't end with the magic
+        if (file.ReadAs<uint32_t>() != shader_cache_magic || !file.IsGood())
+            return miss();
+
+        m_descriptors       = move(descriptors);
+        m_loaded_from_cache = true;
+        shader_cache_hits++;
+
+        return true;
+    }
+
+    void RHI_Shader::SaveToCache(const uint64_t key, const vector<uint32_t>& bytecode) const
+    {
+        const string directory = ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache);
+        if (!FileSystem::Exists(directory))
+        {
+            FileSystem::CreateDirectory(directory);
+        }
+
+        // Written next to the final file and renamed once complete, so a crash while saving can't leave a torn cache behind
+        const string file_path      = get_cache_file_path(m_name, key);
+        const string file_path_temp = file_path + ".tmp";
+
+        FileStream file(file_path_temp, FileStream_Write);
+        if (!file.IsOpen())
+            return;
+
+        // Header
+        file.Write(shader_cache_magic);
+        file.Write(shader_cache_version);
+        file.Write(key);
+
+        // Bytecode
+        file.Write(bytecode);
+
+        // Reflection
+        file.Write(static_cast<uint32_t>(m_descriptors.size()));
+        for (const RHI_Descriptor& descriptor : m_descriptors)
+        {
+            file.Write(descriptor.name);
+            file.Write(static_cast<uint32_t>(descriptor.type));
+            file.Write(static_cast<uint32_t>(descriptor.layout));
+            file.Write(descriptor.slot);
+            file.Write(descriptor.array_size);
+            file.Write(descriptor.stage);
+        }
+
+        file.Write(shader_cache_magic);
+
+        const bool written = file.IsGood();
+        file.Close();
+
+        if (written)
+        {
+            FileSystem::Rename(file_path_temp, file_path);
+        }
+        else
+        {
+            FileSystem::Delete(file_path_temp);
+        }
+    }
+
+#if defined(API_GRAPHICS_VULKAN) || defined(API_GRAPHICS_NULL)
+    // The SPIR-V backends (Vulkan and Null) compile with the same arguments, so that they reflect the same descriptors
+    vector<string> RHI_Shader::GetCompileArguments() const
+    {
+        vector<string> arguments;
+
+        // Arguments
+        {
+            // arguments.emplace_back("-fspv-reflect"); // Emit additional SPIR-V instructions to aid reflection
+            // Can this be helpful in some way ? It forces the use of "SPV_GOOGLE_user_type" extension.
+            // For more search for "-fspv-reflect" here: https://github.com/microsoft/DirectXShaderCompiler/blob/main/docs/SPIR-V.rst#hlsl-types
+
+            arguments.emplace_back("-E"); arguments.emplace_back(GetEntryPoint());
+            arguments.emplace_back("-T"); arguments.emplace_back(GetTargetProfile());
+
+            // SPIR-V
+            arguments.emplace_back("-spirv");                     // Generate SPIR-V code
+            arguments.emplace_back("-fspv-target-env=vulkan1.3"); // Specify the target environment: vulkan1.0 (default), vulkan1.1, vulkan1.1spirv1.4, vulkan1.2, vulkan1.3, or universal1.5
+
+            // Shift registers to avoid conflicts
+            arguments.emplace_back("-fvk-u-shift"); arguments.emplace_back(to_string(rhi_shader_shift_register_u)); arguments.emplace_back("all"); // Specify Vulkan binding number shift for u-type (read/write buffer) register
+            arguments.emplace_back("-fvk-b-shift"); arguments.emplace_back(to_string(rhi_shader_shift_register_b)); arguments.emplace_back("all"); // Specify Vulkan binding number shift for b-type (buffer) register
+            arguments.emplace_back("-fvk-t-shift"); arguments.emplace_back(to_string(rhi_shader_shift_register_t)); arguments.emplace_back("all"); // Specify Vulkan binding number shift for t-type (texture) register
+            arguments.emplace_back("-fvk-s-shift"); arguments.emplace_back(to_string(rhi_shader_shift_register_s)); arguments.emplace_back("all"); // Specify Vulkan binding number shift for s-type (sampler) register
+
+            // Use DirectX conventions
+            arguments.emplace_back("-fvk-use-dx-layout");     // Use DirectX memory layout for Vulkan resources
+            arguments.emplace_back("-fvk-use-dx-position-w"); // Reciprocate SV_Position.w after reading from stage input in PS to accommodate the difference between Vulkan and DirectX
+
+            // Debug: Disable optimizations and embed HLSL source in the shaders
+            #ifdef DEBUG
+            arguments.emplace_back("-Od");           // Disable optimizations
+            arguments.emplace_back("-Zi");           // Enable debug information
+            arguments.emplace_back("-Qembed_debug"); // Embed PDB in shader container (must be used with /Zi)
+            #endif
+
+            // Negate SV_Position.y before writing to stage output in VS/DS/GS to accommodate Vulkan's coordinate system
+            if (m_shader_type == RHI_Shader_Vertex)
+            {
+                arguments.emplace_back("-fvk-invert-y");
+            }
+        }
+
+        // Defines
+        {
+            // Add standard defines
+            arguments.emplace_back("-D"); arguments.emplace_back("VS="+ to_string(static_cast<uint8_t>(m_shader_type == RHI_Shader_Vertex)));
+            arguments.emplace_back("-D"); arguments.emplace_back("PS="+ to_string(static_cast<uint8_t>(m_shader_type == RHI_Shader_Pixel)));
+            arguments.emplace_back("-D"); arguments.emplace_back("CS="+ to_string(static_cast<uint8_t>(m_shader_type == RHI_Shader_Compute)));
+
+            // Add the rest of the defines
+            for (const auto& define : m_defines)
+            {
+                arguments.emplace_back("-D"); arguments.emplace_back(define.first + "=" + define.second);
+            }
+        }
+
+        return arguments;
+    }
+
+    bool RHI_Shader::LoadOrCompile(vector<uint32_t>& bytecode)
+    {
+        vector<string> arguments = GetCompileArguments();
+
+        const uint64_t cache_key = ComputeCacheKey(arguments, DirecXShaderCompiler::GetVersion());
+        if (LoadFromCache(cache_key, bytecode))
+            return true;
+
+        IDxcResult* dxc_result = DirecXShaderCompiler::Compile(m_preprocessed_source, arguments);
+        if (!dxc_result)
+            return false;
+
+        // Get compiled shader buffer
+        IDxcBlob* shader_buffer = nullptr;
+        dxc_result->GetResult(&shader_buffer);
+        bytecode.resize(static_cast<size_t>(shader_buffer->GetBufferSize() / 4));
+        memcpy(bytecode.data(), shader_buffer->GetBufferPointer(), bytecode.size() * sizeof(uint32_t));
+
+        // Release
+        dxc_result->Release();
+
+        // Reflect shader resources (so that descriptor sets can be created later)
+        Reflect(m_shader_type, bytecode.data(), static_cast<uint32_t>(bytecode.size()));
+
+        SaveToCache(cache_key, bytecode);
+
+        return true;
+    }
+
+    void RHI_Shader::Reflect(const RHI_Shader_Type shader_type, const uint32_t* ptr, const uint32_t size)
+    {
+        SP_ASSERT(ptr != nullptr);
+        SP_ASSERT(size != 0);
+        
+        // Initialize compiler with SPIR-V data
+        const SPIRV_CROSS_NAMESPACE::CompilerHLSL compiler = SPIRV_CROSS_NAMESPACE::CompilerHLSL(ptr, size);
+
+        // The SPIR-V is now parsed, and we can perform reflection on it
+        SPIRV_CROSS_NAMESPACE::ShaderResources resources = compiler.get_shader_resources();
+
+        // Pre-allocate enough memory for the descriptor vector
+        uint32_t count = static_cast<uint32_t>
+        (
+            resources.storage_images.size()  +
+            resources.storage_buffers.size() +
+            resources.uniform_buffers.size() +
+            resources.separate_images.size() +
+            resources.separate_samplers.size()
+        );
+
+        m_descriptors.reserve(count);
+
+        // Get storage images
+        for (const SPIRV_CROSS_NAMESPACE::Resource& resource : resources.storage_images)
+        {
+            m_descriptors.emplace_back
+            (
+                resource.name,                                                // name
+                RHI_Descriptor_Type::TextureStorage,                          // type
+                RHI_Image_Layout::General,                                    // layout
+                compiler.get_decoration(resource.id, spv::DecorationBinding), // slot
+                compiler.get_type(resource.type_id).array[0],                 // array size
+                shader_type                                                   // stage
+            );
+        }
+
+        // Get storage buffers
+        for (const SPIRV_CROSS_NAMESPACE::Resource& resource : resources.storage_buffers)
+        {
+            m_descriptors.emplace_back
+            (
+                resource.name,                                                // name
+                RHI_Descriptor_Type::StructuredBuffer,                        // type
+                RHI_Image_Layout::Undefined,                                  // layout
+                compiler.get_decoration(resource.id, spv::DecorationBinding), // slot
+                compiler.get_type(resource.type_id).array[0],                 // array size
+                shader_type                                                   // stage
+            );
+        }
+
+        // Get constant buffers
+        for (const SPIRV_CROSS_NAMESPACE::Resource& resource : resources.uniform_buffers)
+        {
+            m_descriptors.emplace_back
+            (
+                resource.name,                                                // name
+                RHI_Descriptor_Type::ConstantBuffer,                          // type
+                RHI_Image_Layout::Undefined,                                  // layout
+                compiler.get_decoration(resource.id, spv::DecorationBinding), // slot
+                compiler.get_type(resource.type_id).array[0],                 // array size
+                shader_type                                                   // stage
+            );
+        }
+
+        // Get textures
+        for (const SPIRV_CROSS_NAMESPACE::Resource& resource : resources.separate_images)
+        {
+            m_descriptors.emplace_back
+            (
+                resource.name,                                                // name
+                RHI_Descriptor_Type::Texture,                                 // type
+                RHI_Image_Layout::Shader_Read_Only_Optimal,                   // layout
+                compiler.get_decoration(resource.id, spv::DecorationBinding), // slot
+                compiler.get_type(resource.type_id).array[0],                 // array size
+                shader_type                                                   // stage
+            );
+        }
+
+        // Get samplers
+        for (const SPIRV_CROSS_NAMESPACE::Resource& resource : resources.separate_samplers)
+        {
+            m_descriptors.emplace_back
+            (
+                resource.name,                                                // name
+                RHI_Descriptor_Type::Sampler,                                 // type
+                RHI_Image_Layout::Undefined,                                  // layout
+                compiler.get_decoration(resource.id, spv::DecorationBinding), // slot
+                compiler.get_type(resource.type_id).array[0],                 // array size
+                shader_type                                                   // stage
+            );
+        }
+    }
+
+    const char* RHI_Shader::GetTargetProfile() const
+    {
+        if (m_shader_type == RHI_Shader_Vertex)  return "vs_6_7";
+        if (m_shader_type == RHI_Shader_Pixel)   return "ps_6_7";
+        if (m_shader_type == RHI_Shader_Compute) return "cs_6_7";
+
+        return nullptr;
+    }
+#endif
+
+    uint32_t RHI_Shader::GetCacheHitCount()
+    {
+        return shader_cache_hits;
+    }
+
+    uint32_t RHI_Shader::GetCacheMissCount()
+    {
+        return shader_cache_misses;
+    }
+
     const char* RHI_Shader::GetEntryPoint() const
     {
         if (m_shader_type == RHI_Shader_Vertex)  return "mainVS";
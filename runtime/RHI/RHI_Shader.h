@@ -65,9 +65,15 @@ namespace Spartan
         const std::shared_ptr<RHI_InputLayout>& GetInputLayout() const { return m_input_layout; } // only valid for a vertex shader
         const auto& GetFilePath()                                const { return m_file_path; }
         RHI_Shader_Type GetShaderStage()                         const { return m_shader_type; }
+        RHI_Vertex_Type GetVertexType()                          const { return m_vertex_type; }
         uint64_t GetHash()                                       const { return m_hash; }
         const char* GetEntryPoint()                              const;
         const char* GetTargetProfile()                           const;
+        bool IsLoadedFromCache()                                 const { return m_loaded_from_cache; }
+
+        // Cache statistics (since startup)
+        static uint32_t GetCacheHitCount();
+        static uint32_t GetCacheMissCount();
 
         // Resource
         void* GetRhiResource() const;
@@ -80,6 +86,13 @@ namespace Spartan
         void* Compile2();
         void Reflect(const RHI_Shader_Type shader_type, const uint32_t* ptr, uint32_t size);
 
+        // Cache (bytecode and reflection, keyed on everything that affects compilation)
+        uint64_t ComputeCacheKey(const std::vector<std::string>& arguments, const std::string& compiler_version) const;
+        bool LoadFromCache(const uint64_t key, std::vector<uint32_t>& bytecode);
+        void SaveToCache(const uint64_t key, const std::vector<uint32_t>& bytecode) const;
+        std::vector<std::string> GetCompileArguments() const;
+        bool LoadOrCompile(std::vector<uint32_t>& bytecode);
+
         std::string m_file_path;
         std::string m_preprocessed_source;
         std::vector<std::string> m_names;               // The names of the files from the include directives in the shader
@@ -93,6 +106,7 @@ namespace Spartan
         RHI_Shader_Type m_shader_type                             = RHI_Shader_Unknown;
         RHI_Vertex_Type m_vertex_type                             = RHI_Vertex_Type::Undefined;
         uint64_t m_hash                                           = 0;
+        bool m_loaded_from_cache                                  = false;
 
         // RHI Resource
         void* m_rhi_resource = nullptr;
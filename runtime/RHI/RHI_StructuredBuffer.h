@@ -33,7 +33,8 @@ namespace Spartan
         RHI_StructuredBuffer(RHI_Device* rhi_device, const uint32_t stride, const uint32_t element_count, const char* name);
         ~RHI_StructuredBuffer();
 
-        void Update(void* data);
+        // Copies size bytes (a whole element if zero) into the next element
+        void Update(void* data, const uint32_t size = 0);
         void ResetOffset() { m_reset_offset = true; }
 
         uint32_t GetStride()   const { return m_stride; }
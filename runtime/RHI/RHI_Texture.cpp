@@ -522,4 +522,55 @@ namespace Spartan
             m_layout[i] = new_layout;
         }
     }
+
+    void RHI_Texture::SetLayouts(const vector<RHI_Texture*>& textures, const vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list)
+    {
+        SP_ASSERT(textures.size() == layouts.size());
+        SP_ASSERT(cmd_list != nullptr);
+
+        // Gather the textures which need a transition, those with mips in different
+        // layouts or which are still loading are left to SetLayout().
+        vector<RHI_Texture*> batch_textures;
+        vector<RHI_Image_Layout> batch_layouts;
+        for (uint32_t i = 0; i < textures.size(); i++)
+        {
+            RHI_Texture* texture = textures[i];
+            if (!texture)
+                continue;
+
+            bool same_layout = true;
+            for (uint32_t mip = 1; mip < texture->m_mip_count; mip++)
+            {
+                same_layout &= texture->m_layout[mip] == texture->m_layout[0];
+            }
+
+            if (same_layout && texture->m_layout[0] == layouts[i])
+                continue;
+
+            if (!same_layout || !texture->IsReadyForUse())
+            {
+                texture->SetLayout(layouts[i], cmd_list);
+                continue;
+            }
+
+            batch_textures.emplace_back(texture);
+            batch_layouts.emplace_back(layouts[i]);
+        }
+
+        if (batch_textures.empty())
+            return;
+
+        // Insert memory barrier
+        RHI_SetLayouts(batch_textures, batch_layouts, cmd_list);
+        batch_textures[0]->m_context->GetSystem<Profiler>()->m_rhi_pipeline_barriers++;
+
+        // Update layouts
+        for (uint32_t i = 0; i < batch_textures.size(); i++)
+        {
+            for (uint32_t mip = 0; mip < batch_textures[i]->m_mip_count; mip++)
+            {
+                batch_textures[i]->m_layout[mip] = batch_layouts[i];
+            }
+        }
+    }
 }
@@ -135,6 +135,7 @@ namespace Spartan
         void SetLayout(const RHI_Image_Layout layout, RHI_CommandList* cmd_list, uint32_t mip_index = rhi_all_mips,  uint32_t mip_range = 0);
         RHI_Image_Layout GetLayout(const uint32_t mip) const { return m_layout[mip]; }
         std::array<RHI_Image_Layout, rhi_max_mip_count> GetLayouts()  const { return m_layout; }
+        static void SetLayouts(const std::vector<RHI_Texture*>& textures, const std::vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list); // all mips, one barrier
 
         // Viewport
         const auto& GetViewport() const { return m_viewport; }
@@ -154,6 +155,7 @@ namespace Spartan
         bool Compress(const RHI_Format format);
         bool RHI_CreateResource();
         void RHI_SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* cmd_list, const uint32_t mip_index, const uint32_t mip_range);
+        static void RHI_SetLayouts(const std::vector<RHI_Texture*>& textures, const std::vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list);
 
         uint32_t m_bits_per_channel = 0;
         uint32_t m_width            = 0;
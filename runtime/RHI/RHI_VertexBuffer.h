@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <vector>
+#include "RHI_Definition.h"
 #include "../Core/Object.h"
 //================================
 
@@ -77,15 +78,32 @@ namespace Spartan
             _create(nullptr);
         }
 
+        // Copies the given ranges (first vertex, vertex count) of vertices, which mirror the whole buffer, to the buffer.
+        // Buffers which aren't mappable stage the ranges, the copies execute at the start of the renderer's next frame.
+        template<typename T>
+        void Update(const std::vector<T>& vertices, const std::vector<std::pair<uint32_t, uint32_t>>& ranges)
+        {
+            SP_ASSERT(static_cast<uint32_t>(sizeof(T)) == m_stride);
+            SP_ASSERT(static_cast<uint32_t>(vertices.size()) == m_vertex_count);
+
+            _update(static_cast<const void*>(vertices.data()), ranges);
+        }
+
         void* Map();
         void Unmap();
 
+        // Records the staged copies of all the buffers, before anything else in the command list reads them
+        static void RecordStagedCopies(RHI_CommandList* cmd_list);
+        // The frames which executed the recorded copies are done, so the staging memory they read from can be written again
+        static void ResetStaging();
+
         void* GetRhiResource()       const { return m_rhi_resource; }
         uint32_t GetStride()      const { return m_stride; }
         uint32_t GetVertexCount() const { return m_vertex_count; }
 
     private:
         void _create(const void* vertices);
+        void _update(const void* vertices, const std::vector<std::pair<uint32_t, uint32_t>>& ranges);
         void _destroy();
 
         void* m_mapped_data      = nullptr;
@@ -94,7 +112,21 @@ namespace Spartan
         uint32_t m_vertex_count  = 0;
         RHI_Device* m_rhi_device = nullptr;
 
+        // Staging ring, written by Update() and read by the copies RecordStagedCopies() records
+        struct StagedCopy
+        {
+            uint64_t offset_staging = 0;
+            uint64_t offset         = 0;
+            uint64_t size           = 0;
+        };
+        std::vector<StagedCopy> m_staged_copies; // not recorded yet
+        void* m_staging_mapped         = nullptr;
+        uint64_t m_staging_size        = 0;
+        uint64_t m_staging_offset      = 0; // bump pointer, everything before it is in use
+        uint64_t m_staging_reset_index = 0; // the copies recorded last are done once this changes
+
         // RHI Resources
         void* m_rhi_resource = nullptr;
+        void* m_rhi_staging  = nullptr;
     };
 }
@@ -46,8 +46,6 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
-    unordered_map<uint64_t, shared_ptr<RHI_Pipeline>> RHI_CommandList::m_pipelines;
-
     static VkAttachmentLoadOp get_color_load_op(const Color& color)
     {
         if (color == rhi_color_dont_care)
@@ -70,14 +68,15 @@ namespace Spartan
         return VK_ATTACHMENT_LOAD_OP_CLEAR;
     };
 
-    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name) : Object(context)
+    RHI_CommandList::RHI_CommandList(Context* context, const RHI_Queue_Type queue_type, const uint32_t index, void* cmd_pool, const char* name, const bool is_secondary) : Object(context)
     {
-        m_queue_type = queue_type;
-        m_renderer   = context->GetSystem<Renderer>();
-        m_profiler   = context->GetSystem<Profiler>();
-        m_rhi_device = m_renderer->GetRhiDevice().get();
-        m_name       = name;
-        m_index      = index;
+        m_queue_type   = queue_type;
+        m_renderer     = context->GetSystem<Renderer>();
+        m_profiler     = context->GetSystem<Profiler>();
+        m_rhi_device   = m_renderer->GetRhiDevice().get();
+        m_name         = name;
+        m_index        = index;
+        m_is_secondary = is_secondary;
 
         RHI_Context* rhi_context = m_rhi_device->GetRhiContext();
 
@@ -86,7 +85,7 @@ namespace Spartan
             VkCommandBufferAllocateInfo allocate_info = {};
             allocate_info.sType                       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
             allocate_info.commandPool                 = static_cast<VkCommandPool>(cmd_pool);
-            allocate_info.level                       = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocate_info.level                       = is_secondary ? VK_COMMAND_BUFFER_LEVEL_SECONDARY : VK_COMMAND_BUFFER_LEVEL_PRIMARY;
             allocate_info.commandBufferCount          = 1;
 
             // Allocate
@@ -99,6 +98,10 @@ namespace Spartan
             vulkan_utility::debug::set_object_name(static_cast<VkCommandBuffer>(m_rhi_resource), name);
         }
 
+        // Secondary command lists are executed by primary ones, so they don't need timestamps or sync objects
+        if (is_secondary)
+            return;
+
         // Query pool
         if (rhi_context->gpu_profiling)
         {
@@ -185,6 +188,63 @@ namespace Spartan
         m_pipeline_dirty = true;
     }
 
+    void RHI_CommandList::Begin(RHI_PipelineState& pso)
+    {
+        SP_ASSERT_MSG(m_is_secondary, "Only secondary command lists can continue a render pass");
+        SP_ASSERT(m_state == RHI_CommandListState::Idle);
+        SP_ASSERT_MSG(pso.IsGraphics(), "Secondary command lists can only continue graphics render passes");
+
+        // The formats of the render pass which will execute this command list
+        array<VkFormat, rhi_max_render_target_count> formats_color;
+        uint32_t format_color_count = 0;
+        if (RHI_SwapChain* swapchain = pso.render_target_swapchain)
+        {
+            formats_color[format_color_count++] = vulkan_format[swapchain->GetFormat()];
+        }
+        else
+        {
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                RHI_Texture* rt = pso.render_target_color_textures[i];
+
+                if (rt == nullptr)
+                    break;
+
+                formats_color[format_color_count++] = vulkan_format[rt->GetFormat()];
+            }
+        }
+
+        VkCommandBufferInheritanceRenderingInfoKHR inheritance_rendering_info = {};
+        inheritance_rendering_info.sType                                      = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+        inheritance_rendering_info.colorAttachmentCount                       = format_color_count;
+        inheritance_rendering_info.pColorAttachmentFormats                    = formats_color.data();
+        inheritance_rendering_info.rasterizationSamples                       = VK_SAMPLE_COUNT_1_BIT;
+        if (RHI_Texture* rt = pso.render_target_depth_texture)
+        {
+            inheritance_rendering_info.depthAttachmentFormat   = vulkan_format[rt->GetFormat()];
+            inheritance_rendering_info.stencilAttachmentFormat = rt->IsStencilFormat() ? vulkan_format[rt->GetFormat()] : VK_FORMAT_UNDEFINED;
+        }
+
+        VkCommandBufferInheritanceInfo inheritance_info = {};
+        inheritance_info.sType                          = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.pNext                          = &inheritance_rendering_info;
+
+        // Begin command buffer, the pool it comes from resets it implicitly
+        VkCommandBufferBeginInfo begin_info = {};
+        begin_info.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        begin_info.pInheritanceInfo         = &inheritance_info;
+        SP_ASSERT_MSG(vkBeginCommandBuffer(static_cast<VkCommandBuffer>(m_rhi_resource), &begin_info) == VK_SUCCESS, "Failed to begin command buffer");
+
+        // Update states
+        m_state          = RHI_CommandListState::Recording;
+        m_pipeline_dirty = true;
+        m_is_rendering   = true;
+
+        // Nothing is inherited from the primary command list, so bind the pipeline
+        SetPipelineState(pso);
+    }
+
     void RHI_CommandList::End()
     {
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
@@ -195,6 +255,12 @@ namespace Spartan
         );
 
         m_state = RHI_CommandListState::Ended;
+
+        // Secondary command lists continue a render pass which they don't end themselves
+        if (m_is_secondary)
+        {
+            m_is_rendering = false;
+        }
     }
 
     void RHI_CommandList::Submit()
@@ -225,24 +291,17 @@ namespace Spartan
         GetDescriptorSetLayoutFromPipelineState(pso);
 
         // If no pipeline exists for this state, create one
-        uint64_t hash_previous = m_pso.ComputeHash();
-        uint64_t hash = pso.ComputeHash();
-        auto it = m_pipelines.find(hash);
-        if (it == m_pipelines.end())
-        {
-            // Create a new pipeline
-            it = m_pipelines.emplace(make_pair(hash, move(make_shared<RHI_Pipeline>(m_rhi_device, pso, m_descriptor_layout_current)))).first;
-            SP_LOG_INFO("A new pipeline has been created.");
-        }
+        const uint64_t hash = pso.ComputeHash();
+        m_pipeline          = GetOrCreatePipeline(m_rhi_device, pso, m_descriptor_layout_current);
 
-        m_pipeline = it->second.get();
-        m_pso      = pso;
-
-        // Determine if the pipeline is dirty
+        // Determine if the pipeline is dirty.
+        // Begin() always dirties it, so the previous state is only hashed when it's from this recording, as
+        // by the next one, the shaders and render targets it points to might have been hot reloaded or resized.
         if (!m_pipeline_dirty)
         {
-            m_pipeline_dirty = hash_previous != hash;
+            m_pipeline_dirty = m_pso.ComputeHash() != hash;
         }
+        m_pso = pso;
 
         // Bind pipeline
         if (m_pipeline_dirty)
@@ -268,19 +327,24 @@ namespace Spartan
             m_vertex_buffer_id = 0;
             m_index_buffer_id  = 0;
         }
+
+        // The descriptor data was cleared, so bind the global resources (anything bound after this overrides them)
+        m_renderer->SetGlobalShaderResources(this);
     }
 
-    void RHI_CommandList::BeginRenderPass()
+    void RHI_CommandList::BeginRenderPass(const bool secondary_contents /*= false*/)
     {
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
         SP_ASSERT_MSG(m_pso.IsGraphics(), "You can't use a render pass with a compute pipeline");
         SP_ASSERT_MSG(!m_is_rendering, "The command list is already rendering");
+        SP_ASSERT_MSG(!m_is_secondary, "Secondary command lists continue the render pass of a primary one");
 
         if (!m_pso.IsGraphics())
             return;
 
         VkRenderingInfo rendering_info      = {};
         rendering_info.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        rendering_info.flags                = secondary_contents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
         rendering_info.renderArea           = { 0, 0, m_pso.GetWidth(), m_pso.GetHeight() };
         rendering_info.layerCount           = 1;
         rendering_info.colorAttachmentCount = 0;
@@ -396,6 +460,28 @@ namespace Spartan
         }
     }
 
+    void RHI_CommandList::ExecuteSecondary(const vector<RHI_CommandList*>& cmd_lists)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT_MSG(!m_is_secondary, "Only primary command lists can execute secondary ones");
+        SP_ASSERT_MSG(m_is_rendering, "Secondary command lists continue a render pass, begin one first");
+
+        if (cmd_lists.empty())
+            return;
+
+        vector<VkCommandBuffer> cmd_buffers(cmd_lists.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(cmd_lists.size()); i++)
+        {
+            SP_ASSERT(cmd_lists[i]->IsSecondary() && cmd_lists[i]->GetState() == RHI_CommandListState::Ended);
+            cmd_buffers[i] = static_cast<VkCommandBuffer>(cmd_lists[i]->GetRhiResource());
+
+            // From here on, the secondary command list lives as long as this one does on the gpu
+            cmd_lists[i]->m_state = RHI_CommandListState::Idle;
+        }
+
+        vkCmdExecuteCommands(static_cast<VkCommandBuffer>(m_rhi_resource), static_cast<uint32_t>(cmd_buffers.size()), cmd_buffers.data());
+    }
+
     void RHI_CommandList::ClearPipelineStateRenderTargets(RHI_PipelineState& pipeline_state)
     {
         // Validate state
@@ -529,7 +615,7 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
     {
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
 
@@ -540,7 +626,7 @@ namespace Spartan
         vkCmdDrawIndexed(
             static_cast<VkCommandBuffer>(m_rhi_resource), // commandBuffer
             index_count,                                  // indexCount
-            1,                                            // instanceCount
+            instance_count,                               // instanceCount
             index_offset,                                 // firstIndex
             vertex_offset,                                // vertexOffset
             0                                             // firstInstance
@@ -731,7 +817,7 @@ namespace Spartan
         }
     }
 
-    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer, const uint32_t offset) const
     {
         // Validate command list state
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
@@ -743,7 +829,7 @@ namespace Spartan
         }
 
         // Set (will only happen if it's not already set)
-        m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer);
+        m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer, offset);
     }
 
     void RHI_CommandList::SetSampler(const uint32_t slot, RHI_Sampler* sampler) const
@@ -850,7 +936,7 @@ namespace Spartan
         m_descriptor_layout_current->SetTexture(slot, texture, mip_index, mip_range);
     }
 
-    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer, const bool uav) const
     {
         // Validate command list state
         SP_ASSERT(m_state == RHI_CommandListState::Recording);
@@ -861,7 +947,7 @@ namespace Spartan
             return;
         }
 
-        m_descriptor_layout_current->SetStructuredBuffer(slot, structured_buffer);
+        m_descriptor_layout_current->SetStructuredBuffer(slot, structured_buffer, uav);
     }
 
     uint32_t RHI_CommandList::GetGpuMemoryUsed(RHI_Device* rhi_device)
@@ -991,8 +1077,6 @@ namespace Spartan
 
         // Bind descriptor sets
         {
-            m_renderer->SetGlobalShaderResources(this);
-
             // If the descriptor set is null, it means we don't need to bind anything.
             if (RHI_DescriptorSet* descriptor_set = m_descriptor_layout_current->GetDescriptorSet())
             {
@@ -1000,8 +1084,7 @@ namespace Spartan
                 array<void*, 1> descriptor_sets = { descriptor_set->GetResource() };
 
                 // Get dynamic offsets
-                static vector<uint32_t> dynamic_offsets;
-                m_descriptor_layout_current->GetDynamicOffsets(&dynamic_offsets);
+                m_descriptor_layout_current->GetDynamicOffsets(&m_dynamic_offsets);
 
                 // Bind descriptor set
                 vkCmdBindDescriptorSets
@@ -1014,8 +1097,8 @@ namespace Spartan
                     0,                                                                       // firstSet
                     static_cast<uint32_t>(descriptor_sets.size()),                           // descriptorSetCount
                     reinterpret_cast<VkDescriptorSet*>(descriptor_sets.data()),              // pDescriptorSets
-                    static_cast<uint32_t>(dynamic_offsets.size()),                           // dynamicOffsetCount
-                    dynamic_offsets.data()                                                   // pDynamicOffsets
+                    static_cast<uint32_t>(m_dynamic_offsets.size()),                         // dynamicOffsetCount
+                    m_dynamic_offsets.data()                                                 // pDynamicOffsets
                 );
 
                 if (m_profiler)
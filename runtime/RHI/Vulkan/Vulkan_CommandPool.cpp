@@ -80,27 +80,38 @@ namespace Spartan
             vkDestroyCommandPool(m_rhi_device->GetRhiContext()->device, static_cast<VkCommandPool>(m_rhi_resources[i]), nullptr);
             m_rhi_resources[i] = nullptr;
         }
+
+        // Destroy secondary pools, which also frees their command buffers
+        m_cmd_lists_secondary.clear();
+        for (void*& resource : m_rhi_resources_secondary)
+        {
+            vkDestroyCommandPool(m_rhi_device->GetRhiContext()->device, static_cast<VkCommandPool>(resource), nullptr);
+            resource = nullptr;
+        }
     }
 
-    void RHI_CommandPool::CreateCommandPool(const RHI_Queue_Type queue_type)
+    void* RHI_CommandPool::CreateCommandPool(const RHI_Queue_Type queue_type)
     {
         m_queue_type = queue_type;
 
         VkCommandPoolCreateInfo cmd_pool_info = {};
         cmd_pool_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         cmd_pool_info.queueFamilyIndex        = m_rhi_device->GetQueueIndex(queue_type);
-        cmd_pool_info.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // specifies that command buffers allocated from the pool will be short-lived
+        cmd_pool_info.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;             // specifies that command buffers allocated from the pool will be short-lived
+        cmd_pool_info.flags                  |= VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // secondary command buffers are reset when they begin, instead of with their pool
 
         // Create
-        m_rhi_resources.emplace_back(nullptr);
+        void* cmd_pool = nullptr;
         SP_ASSERT_MSG(
-            vkCreateCommandPool(m_rhi_device->GetRhiContext()->device, &cmd_pool_info, nullptr, reinterpret_cast<VkCommandPool*>(&m_rhi_resources.back())) == VK_SUCCESS,
+            vkCreateCommandPool(m_rhi_device->GetRhiContext()->device, &cmd_pool_info, nullptr, reinterpret_cast<VkCommandPool*>(&cmd_pool)) == VK_SUCCESS,
             "Failed to create command pool"
         );
 
         // Name
-        uint32_t cmd_pool_count = static_cast<uint32_t>(m_rhi_resources.size());
-        vulkan_utility::debug::set_object_name(static_cast<VkCommandPool>(m_rhi_resources.back()), (m_name + string("_") + to_string(cmd_pool_count)).c_str());
+        uint32_t cmd_pool_count = static_cast<uint32_t>(m_rhi_resources.size() + m_rhi_resources_secondary.size()) + 1;
+        vulkan_utility::debug::set_object_name(static_cast<VkCommandPool>(cmd_pool), (m_name + string("_") + to_string(cmd_pool_count)).c_str());
+
+        return cmd_pool;
     }
 
     void RHI_CommandPool::Reset(const uint32_t pool_index)
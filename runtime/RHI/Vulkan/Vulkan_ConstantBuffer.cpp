@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_Device.h"
 #include "../RHI_CommandList.h"
 #include "../../Rendering/Renderer.h"
+#include <cstring>
 //===================================
 
 //= NAMESPACES =====
@@ -75,22 +76,50 @@ namespace Spartan
         vulkan_utility::debug::set_object_name(static_cast<VkBuffer>(m_rhi_resource), (m_name + string("_size_") + to_string(m_object_size_gpu)).c_str());
     }
 
-    void RHI_ConstantBuffer::Update(void* data_cpu)
+    bool RHI_ConstantBuffer::Allocate(const uint32_t count, uint32_t& offset)
     {
-        SP_ASSERT_MSG(data_cpu != nullptr,                      "Invalid update data");
-        SP_ASSERT_MSG(m_mapped_data != nullptr,                 "Invalid mapped data");
-        SP_ASSERT_MSG(m_offset + m_stride <= m_object_size_gpu, "Out of memory");
-
-        // Advance offset
-        m_offset += m_stride;
         if (m_reset_offset)
         {
-            m_offset       = 0;
+            m_offset_free  = 0;
             m_reset_offset = false;
         }
 
+        if (m_offset_free + static_cast<uint64_t>(count) * m_stride > m_object_size_gpu)
+            return false;
+
+        offset         = m_offset_free;
+        m_offset_free += count * m_stride;
+
+        return true;
+    }
+
+    void RHI_ConstantBuffer::Update(void* data_cpu)
+    {
+        SP_ASSERT_MSG(data_cpu != nullptr,      "Invalid update data");
+        SP_ASSERT_MSG(m_mapped_data != nullptr, "Invalid mapped data");
+
+        // Advance offset
+        const bool allocated = Allocate(1, m_offset);
+        SP_ASSERT_MSG(allocated, "Out of memory");
+
         // Vulkan is using persistent mapping, so we only need to copy and flush
-        memcpy(reinterpret_cast<std::byte*>(m_mapped_data) + m_offset, reinterpret_cast<std::byte*>(data_cpu), m_stride);
+        memcpy(reinterpret_cast<std::byte*>(m_mapped_data) + m_offset, reinterpret_cast<std::byte*>(data_cpu), m_element_size);
         m_rhi_device->FlushAllocation(m_rhi_resource, m_offset, m_stride);
     }
+
+    void RHI_ConstantBuffer::Write(const uint32_t offset, const void* data, const uint32_t count)
+    {
+        SP_ASSERT_MSG(data != nullptr,                                "Invalid data");
+        SP_ASSERT_MSG(m_mapped_data != nullptr,                       "Invalid mapped data");
+        SP_ASSERT_MSG(offset + count * m_stride <= m_object_size_gpu, "Out of memory");
+
+        const std::byte* src = reinterpret_cast<const std::byte*>(data);
+        std::byte* dst       = reinterpret_cast<std::byte*>(m_mapped_data) + offset;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            memcpy(dst + i * m_stride, src + i * m_element_size, m_element_size);
+        }
+
+        m_rhi_device->FlushAllocation(m_rhi_resource, offset, count * m_stride);
+    }
 }
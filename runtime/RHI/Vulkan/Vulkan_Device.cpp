@@ -26,10 +26,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_Fence.h"
 #include "../../Core/Window.h"
 #include "../../Profiling/Profiler.h"
+#include "../../IO/FileStream.h"
+#include "../../Resource/ResourceCache.h"
 SP_WARNINGS_OFF
 #define VMA_IMPLEMENTATION
 #include "vk_mem_alloc.h"
 SP_WARNINGS_ON
+#include <cstring>
 //===================================
 
 //= NAMESPACES ===============
@@ -109,6 +112,88 @@ namespace Spartan
         return extensions_supported;
     }
 
+    static string get_pipeline_cache_file_path()
+    {
+        return ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache) + "\\pipelines.cache";
+    }
+
+    static VkPipelineCache create_pipeline_cache(VkDevice device, VkPhysicalDevice device_physical)
+    {
+        // Load the blob from the previous run
+        vector<unsigned char> data;
+        const string file_path = get_pipeline_cache_file_path();
+        if (FileSystem::IsFile(file_path))
+        {
+            FileStream file(file_path, FileStream_Read);
+            if (file.IsOpen())
+            {
+                file.Read(&data);
+            }
+        }
+
+        // Drivers should reject blobs from other devices or driver versions, but not all of them do, so check the header
+        if (!data.empty())
+        {
+            VkPhysicalDeviceProperties properties = {};
+            vkGetPhysicalDeviceProperties(device_physical, &properties);
+
+            VkPipelineCacheHeaderVersionOne header = {};
+            bool valid = data.size() >= sizeof(header);
+            if (valid)
+            {
+                memcpy(&header, data.data(), sizeof(header));
+                valid = header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                        header.vendorID      == properties.vendorID                  &&
+                        header.deviceID      == properties.deviceID                  &&
+                        memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+            }
+
+            if (valid)
+            {
+                SP_LOG_INFO("Loaded pipeline cache (%d KB)", static_cast<uint32_t>(data.size() / 1024));
+            }
+            else
+            {
+                SP_LOG_WARNING("The pipeline cache was created by a different device or driver, ignoring it");
+                data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo create_info = {};
+        create_info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        create_info.initialDataSize           = data.size();
+        create_info.pInitialData              = data.empty() ? nullptr : data.data();
+
+        VkPipelineCache pipeline_cache = nullptr;
+        SP_ASSERT_MSG(vkCreatePipelineCache(device, &create_info, nullptr, &pipeline_cache) == VK_SUCCESS, "Failed to create pipeline cache");
+
+        return pipeline_cache;
+    }
+
+    static void save_pipeline_cache(VkDevice device, VkPipelineCache pipeline_cache)
+    {
+        size_t size = 0;
+        if (vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+            return;
+
+        vector<unsigned char> data(size);
+        if (vkGetPipelineCacheData(device, pipeline_cache, &size, data.data()) != VK_SUCCESS)
+            return;
+        data.resize(size);
+
+        const string directory = ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache);
+        if (!FileSystem::Exists(directory))
+        {
+            FileSystem::CreateDirectory(directory);
+        }
+
+        FileStream file(get_pipeline_cache_file_path(), FileStream_Write);
+        if (file.IsOpen())
+        {
+            file.Write(data);
+        }
+    }
+
     static vector<const char*> get_supported_extensions(const vector<const char*>& extensions)
     {
         vector<const char*> extensions_supported;
@@ -428,6 +513,9 @@ namespace Spartan
             SP_ASSERT_MSG(vmaCreateAllocator(&allocator_info, reinterpret_cast<VmaAllocator*>(&m_allocator)) == VK_SUCCESS, "Failed to create memory allocator");
         }
 
+        // Create pipeline cache (persisted across runs, so pipelines seen before skip most of the driver compilation)
+        m_rhi_context->pipeline_cache = create_pipeline_cache(m_rhi_context->device, m_rhi_context->device_physical);
+
         // Set the descriptor set capacity to an initial value
         SetDescriptorSetCapacity(2048);
 
@@ -468,6 +556,11 @@ namespace Spartan
             m_allocator = nullptr;
         }
         
+        // Pipeline cache
+        save_pipeline_cache(m_rhi_context->device, m_rhi_context->pipeline_cache);
+        vkDestroyPipelineCache(m_rhi_context->device, m_rhi_context->pipeline_cache, nullptr);
+        m_rhi_context->pipeline_cache = nullptr;
+
         // Debug messenger
         if (m_rhi_context->validation)
         {
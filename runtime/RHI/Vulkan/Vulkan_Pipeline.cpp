@@ -369,7 +369,7 @@ namespace Spartan
                 pipeline_info.renderPass                   = nullptr;
         
                 // Create
-                SP_ASSERT_MSG(vkCreateGraphicsPipelines(m_rhi_device->GetRhiContext()->device, nullptr, 1, &pipeline_info, nullptr, pipeline) == VK_SUCCESS, "Failed to create graphics pipeline");
+                SP_ASSERT_MSG(vkCreateGraphicsPipelines(m_rhi_device->GetRhiContext()->device, m_rhi_device->GetRhiContext()->pipeline_cache, 1, &pipeline_info, nullptr, pipeline) == VK_SUCCESS, "Failed to create graphics pipeline");
 
                 // Disable naming until I can come up with a more meaningful name
                 //vulkan_utility::debug::set_name(*pipeline, m_state.pass_name);
@@ -383,7 +383,7 @@ namespace Spartan
                 pipeline_info.stage                       = shader_stages[0];
 
                 // Create
-                SP_ASSERT_MSG(vkCreateComputePipelines(m_rhi_device->GetRhiContext()->device, nullptr, 1, &pipeline_info, nullptr, pipeline) == VK_SUCCESS, "Failed to create compute pipeline");
+                SP_ASSERT_MSG(vkCreateComputePipelines(m_rhi_device->GetRhiContext()->device, m_rhi_device->GetRhiContext()->pipeline_cache, 1, &pipeline_info, nullptr, pipeline) == VK_SUCCESS, "Failed to create compute pipeline");
 
                 // Name the pipeline object
                 if (m_state.shader_vertex)
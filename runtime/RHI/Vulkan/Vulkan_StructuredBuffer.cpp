@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "../RHI_Implementation.h"
 #include "../RHI_StructuredBuffer.h"
+#include <cstring>
 //==================================
 
 //= NAMESPACES =====
@@ -68,10 +69,13 @@ namespace Spartan
         m_rhi_device->DestroyBuffer(m_rhi_resource);
     }
 
-    void RHI_StructuredBuffer::Update(void* data_cpu)
+    void RHI_StructuredBuffer::Update(void* data_cpu, const uint32_t size)
     {
+        const uint32_t size_copy = size != 0 ? size : m_stride;
+
         SP_ASSERT_MSG(data_cpu != nullptr,                      "Invalid update data");
         SP_ASSERT_MSG(m_mapped_data != nullptr,                 "Invalid mapped data");
+        SP_ASSERT_MSG(size_copy <= m_stride,                    "Size exceeds the stride");
         SP_ASSERT_MSG(m_offset + m_stride <= m_object_size_gpu, "Out of memory");
 
         // Advance offset
@@ -83,7 +87,7 @@ namespace Spartan
         }
 
         // Vulkan is using persistent mapping, so we only need to copy and flush
-        memcpy(reinterpret_cast<std::byte*>(m_mapped_data) + m_offset, reinterpret_cast<std::byte*>(data_cpu), m_stride);
-        m_rhi_device->FlushAllocation(m_rhi_resource, m_offset, m_stride);
+        memcpy(reinterpret_cast<std::byte*>(m_mapped_data) + m_offset, reinterpret_cast<std::byte*>(data_cpu), size_copy);
+        m_rhi_device->FlushAllocation(m_rhi_resource, m_offset, size_copy);
     }
 }
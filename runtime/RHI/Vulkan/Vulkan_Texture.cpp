@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_TextureCube.h"
 #include "../RHI_CommandList.h"
 #include "../../Rendering/Renderer.h"
+#include <cstring>
 //===================================
 
 //= NAMESPACES ===============
@@ -287,6 +288,32 @@ namespace Spartan
         vulkan_utility::image::set_layout(static_cast<VkCommandBuffer>(cmd_list->GetRhiResource()), this, mip_start, mip_range, m_array_length, m_layout[mip_start], new_layout);
     }
 
+    void RHI_Texture::RHI_SetLayouts(const vector<RHI_Texture*>& textures, const vector<RHI_Image_Layout>& layouts, RHI_CommandList* cmd_list)
+    {
+        vector<VkImageMemoryBarrier> image_barriers(textures.size());
+        VkPipelineStageFlags source_stage_mask      = 0;
+        VkPipelineStageFlags destination_stage_mask = 0;
+        for (uint32_t i = 0; i < textures.size(); i++)
+        {
+            RHI_Texture* texture = textures[i];
+            vulkan_utility::image::create_barrier(texture->GetRhiResource(), vulkan_utility::image::get_aspect_mask(texture), 0, texture->m_mip_count, texture->m_array_length, texture->m_layout[0], layouts[i], image_barriers[i], source_stage_mask, destination_stage_mask);
+        }
+
+        vkCmdPipelineBarrier
+        (
+            static_cast<VkCommandBuffer>(cmd_list->GetRhiResource()), // commandBuffer
+            source_stage_mask,                                         // srcStageMask
+            destination_stage_mask,                                    // dstStageMask
+            0,                                                         // dependencyFlags
+            0,                                                         // memoryBarrierCount
+            nullptr,                                                   // pMemoryBarriers
+            0,                                                         // bufferMemoryBarrierCount
+            nullptr,                                                   // pBufferMemoryBarriers
+            static_cast<uint32_t>(image_barriers.size()),              // imageMemoryBarrierCount
+            image_barriers.data()                                      // pImageMemoryBarriers
+        );
+    }
+
     bool RHI_Texture::RHI_CreateResource()
     {
         SP_ASSERT(m_rhi_device != nullptr);
@@ -323,12 +323,12 @@ namespace Spartan::vulkan_utility
             return stages;
         }
 
-        static void set_layout(void* cmd_buffer, void* image, const VkImageAspectFlags aspect_mask, const uint32_t mip_index, const uint32_t mip_range, const uint32_t array_length, const RHI_Image_Layout layout_old, const RHI_Image_Layout layout_new)
+        // Fills in a barrier and accumulates the pipeline stages it waits on and blocks
+        static void create_barrier(void* image, const VkImageAspectFlags aspect_mask, const uint32_t mip_index, const uint32_t mip_range, const uint32_t array_length, const RHI_Image_Layout layout_old, const RHI_Image_Layout layout_new, VkImageMemoryBarrier& image_barrier, VkPipelineStageFlags& source_stage_mask, VkPipelineStageFlags& destination_stage_mask)
         {
-            SP_ASSERT(cmd_buffer != nullptr);
             SP_ASSERT(image != nullptr);
 
-            VkImageMemoryBarrier image_barrier            = {};
+            image_barrier                                 = {};
             image_barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
             image_barrier.pNext                           = nullptr;
             image_barrier.oldLayout                       = vulkan_image_layout[static_cast<VkImageLayout>(layout_old)];
@@ -344,33 +344,37 @@ namespace Spartan::vulkan_utility
             image_barrier.srcAccessMask                   = layout_to_access_mask(image_barrier.oldLayout, false);
             image_barrier.dstAccessMask                   = layout_to_access_mask(image_barrier.newLayout, true);
 
-            VkPipelineStageFlags source_stage_mask = 0;
+            if (image_barrier.oldLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
             {
-                if (image_barrier.oldLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
-                {
-                    source_stage_mask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-                }
-                else if (image_barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED)
-                {
-                    source_stage_mask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-                }
-                else
-                {
-                    source_stage_mask = access_flags_to_pipeline_stage(image_barrier.srcAccessMask);
-                }
+                source_stage_mask |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            }
+            else if (image_barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+            {
+                source_stage_mask |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            }
+            else
+            {
+                source_stage_mask |= access_flags_to_pipeline_stage(image_barrier.srcAccessMask);
             }
 
-            VkPipelineStageFlags destination_stage_mask = 0;
+            if (image_barrier.newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
             {
-                if (image_barrier.newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
-                {
-                    destination_stage_mask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-                }
-                else
-                {
-                    destination_stage_mask = access_flags_to_pipeline_stage(image_barrier.dstAccessMask);
-                }
+                destination_stage_mask |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            }
+            else
+            {
+                destination_stage_mask |= access_flags_to_pipeline_stage(image_barrier.dstAccessMask);
             }
+        }
+
+        static void set_layout(void* cmd_buffer, void* image, const VkImageAspectFlags aspect_mask, const uint32_t mip_index, const uint32_t mip_range, const uint32_t array_length, const RHI_Image_Layout layout_old, const RHI_Image_Layout layout_new)
+        {
+            SP_ASSERT(cmd_buffer != nullptr);
+
+            VkImageMemoryBarrier image_barrier          = {};
+            VkPipelineStageFlags source_stage_mask      = 0;
+            VkPipelineStageFlags destination_stage_mask = 0;
+            create_barrier(image, aspect_mask, mip_index, mip_range, array_length, layout_old, layout_new, image_barrier, source_stage_mask, destination_stage_mask);
 
             vkCmdPipelineBarrier
             (
@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_VertexBuffer.h"
 #include "../RHI_Vertex.h"
 #include "../RHI_CommandList.h"
+#include <cstring>
 //================================
 
 //= NAMESPACES =====
@@ -34,6 +35,11 @@ using namespace std;
 
 namespace Spartan
 {
+    // Buffers with staged copies which haven't been recorded yet
+    static vector<RHI_VertexBuffer*> buffers_staged;
+    static uint64_t staging_reset_index = 0;
+    static mutex mutex_staging;
+
     void RHI_VertexBuffer::_destroy()
     {
         SP_ASSERT(m_rhi_resource != nullptr);
@@ -41,7 +47,21 @@ namespace Spartan
         // Wait
         m_rhi_device->QueueWaitAll();
 
+        // Drop the copies which were never recorded
+        {
+            lock_guard<mutex> lock(mutex_staging);
+            buffers_staged.erase(remove(buffers_staged.begin(), buffers_staged.end(), this), buffers_staged.end());
+            m_staged_copies.clear();
+        }
+
         // Destroy
+        if (m_rhi_staging)
+        {
+            m_rhi_device->UnmapMemory(m_rhi_staging, m_staging_mapped);
+            m_rhi_device->DestroyBuffer(m_rhi_staging);
+            m_staging_size   = 0;
+            m_staging_offset = 0;
+        }
         m_rhi_device->DestroyBuffer(m_rhi_resource);
     }
 
@@ -100,6 +120,91 @@ namespace Spartan
         vulkan_utility::debug::set_object_name(static_cast<VkBuffer>(m_rhi_resource), m_name.c_str());
     }
 
+    void RHI_VertexBuffer::_update(const void* vertices, const vector<pair<uint32_t, uint32_t>>& ranges)
+    {
+        SP_ASSERT(m_rhi_resource != nullptr);
+
+        const std::byte* source = static_cast<const std::byte*>(vertices);
+
+        if (m_is_mappable)
+        {
+            for (const auto& [vertex_offset, vertex_count] : ranges)
+            {
+                const uint64_t offset = static_cast<uint64_t>(vertex_offset) * m_stride;
+                memcpy(static_cast<std::byte*>(m_mapped_data) + offset, source + offset, static_cast<uint64_t>(vertex_count) * m_stride);
+            }
+
+            return;
+        }
+
+        lock_guard<mutex> lock(mutex_staging);
+
+        // Once the frames which executed the last recorded copies are done, the ring starts over
+        if (m_staged_copies.empty() && m_staging_reset_index != staging_reset_index)
+        {
+            m_staging_offset = 0;
+        }
+
+        uint64_t size = 0;
+        for (const auto& [vertex_offset, vertex_count] : ranges)
+        {
+            size += static_cast<uint64_t>(vertex_count) * m_stride;
+        }
+
+        if (size == 0)
+            return;
+
+        auto stage = [this, source](const uint64_t offset, const uint64_t byte_count)
+        {
+            memcpy(static_cast<std::byte*>(m_staging_mapped) + m_staging_offset, source + offset, byte_count);
+            m_staged_copies.push_back({ m_staging_offset, offset, byte_count });
+            m_staging_offset += byte_count;
+        };
+
+        // Grow, which only happens for the first few updates, as the size settles on the largest one
+        if (m_staging_offset + size > m_staging_size)
+        {
+            // Copies which haven't been recorded are staged again, the vertices are at least as recent as what they staged
+            vector<StagedCopy> staged_copies;
+            staged_copies.swap(m_staged_copies);
+            for (const StagedCopy& staged_copy : staged_copies)
+            {
+                size += staged_copy.size;
+            }
+
+            // Frames in flight might still be copying from the current staging buffer
+            m_rhi_device->QueueWaitAll();
+            if (m_rhi_staging)
+            {
+                m_rhi_device->UnmapMemory(m_rhi_staging, m_staging_mapped);
+                m_rhi_device->DestroyBuffer(m_rhi_staging);
+            }
+
+            // Room for a few updates until the ring can start over, but no more than the buffer, which a full update needs anyway
+            m_staging_size   = max(min(max(m_staging_size * 2, size * 4), m_object_size_gpu), size);
+            m_staging_offset = 0;
+            m_rhi_device->CreateBuffer(m_rhi_staging, m_staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            m_rhi_device->MapMemory(m_rhi_staging, m_staging_mapped);
+            vulkan_utility::debug::set_object_name(static_cast<VkBuffer>(m_rhi_staging), (m_name + "_staging").c_str());
+
+            for (const StagedCopy& staged_copy : staged_copies)
+            {
+                stage(staged_copy.offset, staged_copy.size);
+            }
+        }
+
+        // The copies are recorded by the renderer, so nothing waits for the frames in flight
+        for (const auto& [vertex_offset, vertex_count] : ranges)
+        {
+            stage(static_cast<uint64_t>(vertex_offset) * m_stride, static_cast<uint64_t>(vertex_count) * m_stride);
+        }
+
+        if (find(buffers_staged.begin(), buffers_staged.end(), this) == buffers_staged.end())
+        {
+            buffers_staged.emplace_back(this);
+        }
+    }
+
     void* RHI_VertexBuffer::Map()
     {
         return m_mapped_data;
@@ -109,4 +214,51 @@ namespace Spartan
     {
         // buffer is mapped on creation and unmapped during destruction
     }
+
+    void RHI_VertexBuffer::RecordStagedCopies(RHI_CommandList* cmd_list)
+    {
+        lock_guard<mutex> lock(mutex_staging);
+
+        if (buffers_staged.empty())
+            return;
+
+        VkCommandBuffer cmd_buffer = static_cast<VkCommandBuffer>(cmd_list->GetRhiResource());
+
+        // The frames in flight were submitted earlier to the same queue, so the copies wait for their vertex input to be done with the buffers
+        VkMemoryBarrier barrier = {};
+        barrier.sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask   = 0;
+        barrier.dstAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd_buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vector<VkBufferCopy> copy_regions;
+        for (RHI_VertexBuffer* buffer : buffers_staged)
+        {
+            copy_regions.clear();
+            for (const StagedCopy& staged_copy : buffer->m_staged_copies)
+            {
+                VkBufferCopy& copy_region = copy_regions.emplace_back();
+                copy_region.srcOffset     = staged_copy.offset_staging;
+                copy_region.dstOffset     = staged_copy.offset;
+                copy_region.size          = staged_copy.size;
+            }
+
+            vkCmdCopyBuffer(cmd_buffer, static_cast<VkBuffer>(buffer->m_rhi_staging), static_cast<VkBuffer>(buffer->m_rhi_resource), static_cast<uint32_t>(copy_regions.size()), copy_regions.data());
+
+            buffer->m_staged_copies.clear();
+            buffer->m_staging_reset_index = staging_reset_index;
+        }
+        buffers_staged.clear();
+
+        // And the draws which follow wait for the copies
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        vkCmdPipelineBarrier(cmd_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void RHI_VertexBuffer::ResetStaging()
+    {
+        lock_guard<mutex> lock(mutex_staging);
+        staging_reset_index++;
+    }
 }
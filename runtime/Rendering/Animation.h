@@ -72,7 +72,7 @@ namespace Spartan
         bool SaveToFile(const std::string& filePath) override;
         //======================================================
 
-        void SetName(const std::string& name)   { m_name = name; }
+        void SetName(const std::string& name) override { m_name = name; }
         void SetDuration(double duration)       { m_duration = duration; }
         void SetTicksPerSec(double ticksPerSec) { m_ticksPerSec = ticksPerSec; }
 
@@ -0,0 +1,229 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================
+#include "pch.h"
+#include "Culler.h"
+#include "../Core/ThreadPool.h"
+#include <xmmintrin.h>
+//===============================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    void Culler::ClearBoxes()
+    {
+        m_center_x.clear();
+        m_center_y.clear();
+        m_center_z.clear();
+        m_extent_x.clear();
+        m_extent_y.clear();
+        m_extent_z.clear();
+        m_box_count = 0;
+    }
+
+    void Culler::ReserveBoxes(uint32_t count)
+    {
+        count = (count + 3) & ~3u;
+
+        m_center_x.reserve(count);
+        m_center_y.reserve(count);
+        m_center_z.reserve(count);
+        m_extent_x.reserve(count);
+        m_extent_y.reserve(count);
+        m_extent_z.reserve(count);
+    }
+
+    uint32_t Culler::AddBox(const BoundingBox& box)
+    {
+        const Vector3 center = box.GetCenter();
+        const Vector3 extent = box.GetExtents();
+
+        // Overwrite the padding if there is any, otherwise grow by a whole simd register
+        if (m_box_count == m_center_x.size())
+        {
+            const size_t size = m_center_x.size() + 4;
+            m_center_x.resize(size, 0.0f);
+            m_center_y.resize(size, 0.0f);
+            m_center_z.resize(size, 0.0f);
+            m_extent_x.resize(size, 0.0f);
+            m_extent_y.resize(size, 0.0f);
+            m_extent_z.resize(size, 0.0f);
+        }
+
+        const uint32_t index = m_box_count++;
+        m_center_x[index]    = center.x;
+        m_center_y[index]    = center.y;
+        m_center_z[index]    = center.z;
+        m_extent_x[index]    = extent.x;
+        m_extent_y[index]    = extent.y;
+        m_extent_z[index]    = extent.z;
+
+        return index;
+    }
+
+    void Culler::ClearViews()
+    {
+        m_views.clear();
+    }
+
+    uint32_t Culler::AddView(const Frustum& frustum, const Matrix& view_matrix, bool ignore_near_plane /*= false*/)
+    {
+        View& view       = m_views.emplace_back();
+        view.plane_first = ignore_near_plane ? 1 : 0;
+        view.depth_x     = view_matrix.m02;
+        view.depth_y     = view_matrix.m12;
+        view.depth_z     = view_matrix.m22;
+        view.depth_w     = view_matrix.m32;
+
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            const Plane& plane   = frustum.GetPlane(i);
+            view.normal_x[i]     = plane.normal.x;
+            view.normal_y[i]     = plane.normal.y;
+            view.normal_z[i]     = plane.normal.z;
+            view.normal_abs_x[i] = Helper::Abs(plane.normal.x);
+            view.normal_abs_y[i] = Helper::Abs(plane.normal.y);
+            view.normal_abs_z[i] = Helper::Abs(plane.normal.z);
+            view.d[i]            = plane.d;
+        }
+
+        return static_cast<uint32_t>(m_views.size() - 1);
+    }
+
+    void Culler::Cull()
+    {
+        const uint32_t view_count  = GetViewCount();
+        const uint32_t chunk_count = (m_box_count + chunk_size - 1) / chunk_size;
+
+        m_visible.resize(view_count);
+        m_visible_chunks.resize(static_cast<size_t>(chunk_count) * view_count);
+
+        if (chunk_count == 0)
+        {
+            for (vector<VisibleBox>& visible : m_visible)
+            {
+                visible.clear();
+            }
+
+            return;
+        }
+
+        // Test, each chunk writes to its own lists
+        ThreadPool::ParallelLoop([this](uint32_t chunk_start, uint32_t chunk_end)
+        {
+            for (uint32_t chunk = chunk_start; chunk < chunk_end; chunk++)
+            {
+                CullChunk(chunk);
+            }
+        }, chunk_count, 1);
+
+        // Gather, chunks are concatenated in order so the lists stay sorted
+        ThreadPool::ParallelLoop([this, view_count, chunk_count](uint32_t view_start, uint32_t view_end)
+        {
+            for (uint32_t view_index = view_start; view_index < view_end; view_index++)
+            {
+                size_t count = 0;
+                for (uint32_t chunk = 0; chunk < chunk_count; chunk++)
+                {
+                    count += m_visible_chunks[chunk * view_count + view_index].size();
+                }
+
+                vector<VisibleBox>& visible = m_visible[view_index];
+                visible.clear();
+                visible.reserve(count);
+                for (uint32_t chunk = 0; chunk < chunk_count; chunk++)
+                {
+                    const vector<VisibleBox>& visible_chunk = m_visible_chunks[chunk * view_count + view_index];
+                    visible.insert(visible.end(), visible_chunk.begin(), visible_chunk.end());
+                }
+            }
+        }, view_count, 1);
+    }
+
+    void Culler::CullChunk(uint32_t chunk)
+    {
+        const uint32_t view_count  = GetViewCount();
+        const uint32_t index_start = chunk * chunk_size;
+        const uint32_t index_end   = Helper::Min(index_start + chunk_size, m_box_count);
+
+        for (uint32_t view_index = 0; view_index < view_count; view_index++)
+        {
+            m_visible_chunks[chunk * view_count + view_index].clear();
+        }
+
+        // Four boxes at a time, the tail reads padding which is discarded below
+        for (uint32_t i = index_start; i < index_end; i += 4)
+        {
+            const __m128 center_x = _mm_loadu_ps(&m_center_x[i]);
+            const __m128 center_y = _mm_loadu_ps(&m_center_y[i]);
+            const __m128 center_z = _mm_loadu_ps(&m_center_z[i]);
+            const __m128 extent_x = _mm_loadu_ps(&m_extent_x[i]);
+            const __m128 extent_y = _mm_loadu_ps(&m_extent_y[i]);
+            const __m128 extent_z = _mm_loadu_ps(&m_extent_z[i]);
+            const uint32_t lanes  = (1u << Helper::Min(index_end - i, 4u)) - 1;
+
+            for (uint32_t view_index = 0; view_index < view_count; view_index++)
+            {
+                const View& view = m_views[view_index];
+
+                // A box is outside if it's fully behind any plane: dot(n, c) + d + dot(|n|, e) < 0
+                __m128 outside = _mm_setzero_ps();
+                for (uint32_t p = view.plane_first; p < 6; p++)
+                {
+                    __m128 distance = _mm_set1_ps(view.d[p]);
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(center_x, _mm_set1_ps(view.normal_x[p])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(center_y, _mm_set1_ps(view.normal_y[p])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(center_z, _mm_set1_ps(view.normal_z[p])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_x, _mm_set1_ps(view.normal_abs_x[p])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_y, _mm_set1_ps(view.normal_abs_y[p])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_z, _mm_set1_ps(view.normal_abs_z[p])));
+                    outside         = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+                }
+
+                uint32_t visible = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & lanes;
+                if (visible == 0)
+                    continue;
+
+                // View space depth of the centers
+                __m128 depth = _mm_set1_ps(view.depth_w);
+                depth        = _mm_add_ps(depth, _mm_mul_ps(center_x, _mm_set1_ps(view.depth_x)));
+                depth        = _mm_add_ps(depth, _mm_mul_ps(center_y, _mm_set1_ps(view.depth_y)));
+                depth        = _mm_add_ps(depth, _mm_mul_ps(center_z, _mm_set1_ps(view.depth_z)));
+                float depths[4];
+                _mm_storeu_ps(depths, depth);
+
+                vector<VisibleBox>& visible_chunk = m_visible_chunks[chunk * view_count + view_index];
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    if (visible & (1u << lane))
+                    {
+                        visible_chunk.push_back({ i + lane, depths[lane] });
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include "../Core/Definitions.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Frustum.h"
+#include "../Math/Matrix.h"
+//================================
+
+namespace Spartan
+{
+    struct VisibleBox
+    {
+        uint32_t index;
+        float depth; // view space z of the box center
+    };
+
+    // Tests a set of world space bounding boxes against a set of views (frustums) in one go.
+    // Boxes are kept in structure of arrays form so that they can be tested four at a time,
+    // and the output is a compact list of visible boxes per view, in ascending index order.
+    class SP_CLASS Culler
+    {
+    public:
+        Culler() = default;
+        ~Culler() = default;
+
+        // Boxes
+        void ClearBoxes();
+        void ReserveBoxes(uint32_t count);
+        uint32_t AddBox(const Math::BoundingBox& box);
+        uint32_t GetBoxCount() const { return m_box_count; }
+
+        // Views, the near plane can be ignored so that shadow casters behind a light are not rejected
+        void ClearViews();
+        uint32_t AddView(const Math::Frustum& frustum, const Math::Matrix& view, bool ignore_near_plane = false);
+        uint32_t GetViewCount() const { return static_cast<uint32_t>(m_views.size()); }
+
+        // Tests every box against every view
+        void Cull();
+
+        // The boxes which are visible from a view, valid until the next Cull()
+        const std::vector<VisibleBox>& GetVisible(uint32_t view_index) const { return m_visible[view_index]; }
+
+    private:
+        static const uint32_t chunk_size = 1024; // boxes per job, a multiple of the simd width
+
+        struct View
+        {
+            // Per plane: normal, absolute normal and distance
+            float normal_x[6];
+            float normal_y[6];
+            float normal_z[6];
+            float normal_abs_x[6];
+            float normal_abs_y[6];
+            float normal_abs_z[6];
+            float d[6];
+            uint32_t plane_first = 0;
+
+            // Third column of the view matrix, it yields view space z
+            float depth_x;
+            float depth_y;
+            float depth_z;
+            float depth_w;
+        };
+
+        void CullChunk(uint32_t chunk);
+
+        // Boxes, padded to a multiple of the simd width
+        std::vector<float> m_center_x;
+        std::vector<float> m_center_y;
+        std::vector<float> m_center_z;
+        std::vector<float> m_extent_x;
+        std::vector<float> m_extent_y;
+        std::vector<float> m_extent_z;
+        uint32_t m_box_count = 0;
+
+        std::vector<View> m_views;
+
+        // Output per chunk (chunk major) and per view, they are kept around so that their memory is reused
+        std::vector<std::vector<VisibleBox>> m_visible_chunks;
+        std::vector<std::vector<VisibleBox>> m_visible;
+    };
+}
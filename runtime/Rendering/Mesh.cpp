@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Mesh.h"
 #include "Context.h"
 #include "Renderer.h"
+#include "../Core/ThreadPool.h"
 #include "../RHI/RHI_Vertex.h"
 #include "../RHI/RHI_Texture.h"
 #include "../RHI/RHI_VertexBuffer.h"
@@ -60,6 +61,12 @@ namespace Spartan
 
         m_vertices.clear();
         m_vertices.shrink_to_fit();
+
+        m_clusters.clear();
+        m_clusters.shrink_to_fit();
+
+        m_lods.clear();
+        m_lods.shrink_to_fit();
     }
 
     bool Mesh::LoadFromFile(const string& file_path)
@@ -85,6 +92,33 @@ namespace Spartan
             file->Read(&m_indices);
             file->Read(&m_vertices);
 
+            // Clusters, files which were saved before they existed end here and read a count of zero
+            uint32_t cluster_count = 0;
+            file->Read(&cluster_count);
+            m_clusters.resize(cluster_count);
+            for (MeshCluster& cluster : m_clusters)
+            {
+                file->Read(&cluster.index_offset);
+                file->Read(&cluster.index_count);
+                file->Read(&cluster.center);
+                file->Read(&cluster.radius);
+                file->Read(&cluster.cone_apex);
+                file->Read(&cluster.cone_axis);
+                file->Read(&cluster.cone_cutoff);
+            }
+
+            // Levels of detail, same as above
+            uint32_t lod_count = 0;
+            file->Read(&lod_count);
+            m_lods.resize(lod_count);
+            for (MeshLod& lod : m_lods)
+            {
+                file->Read(&lod.source_index_offset);
+                file->Read(&lod.index_offset);
+                file->Read(&lod.index_count);
+                file->Read(&lod.error);
+            }
+
             //Optimize();
             ComputeAabb();
             ComputeNormalizedScale();
@@ -135,6 +169,25 @@ namespace Spartan
         file->Write(m_normalized_scale);
         file->Write(m_indices);
         file->Write(m_vertices);
+        file->Write(static_cast<uint32_t>(m_clusters.size()));
+        for (const MeshCluster& cluster : m_clusters)
+        {
+            file->Write(cluster.index_offset);
+            file->Write(cluster.index_count);
+            file->Write(cluster.center);
+            file->Write(cluster.radius);
+            file->Write(cluster.cone_apex);
+            file->Write(cluster.cone_axis);
+            file->Write(cluster.cone_cutoff);
+        }
+        file->Write(static_cast<uint32_t>(m_lods.size()));
+        for (const MeshLod& lod : m_lods)
+        {
+            file->Write(lod.source_index_offset);
+            file->Write(lod.index_offset);
+            file->Write(lod.index_count);
+            file->Write(lod.error);
+        }
 
         file->Close();
 
@@ -146,6 +199,8 @@ namespace Spartan
         uint32_t size = 0;
         size += uint32_t(m_indices.size()  * sizeof(uint32_t));
         size += uint32_t(m_vertices.size() * sizeof(RHI_Vertex_PosTexNorTan));
+        size += uint32_t(m_clusters.size() * sizeof(MeshCluster));
+        size += uint32_t(m_lods.size()     * sizeof(MeshLod));
 
         return size;
     }
@@ -197,6 +252,170 @@ namespace Spartan
         m_indices.insert(m_indices.end(), indices.begin(), indices.end());
     }
 
+    void Mesh::ComputeClusters(vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, vector<MeshCluster>* clusters)
+    {
+        SP_ASSERT(clusters != nullptr);
+        SP_ASSERT_MSG(!indices.empty() && !vertices.empty(), "Invalid data");
+
+        // The sizes meshoptimizer recommends, a cone weight above zero favours clusters with tight normal cones
+        const size_t max_vertices  = 64;
+        const size_t max_triangles = 124;
+        const float cone_weight    = 0.25f;
+
+        const float* positions    = &vertices[0].pos[0];
+        const size_t vertex_count = vertices.size();
+        const size_t vertex_size  = sizeof(RHI_Vertex_PosTexNorTan);
+
+        const size_t max_meshlets = meshopt_buildMeshletsBound(indices.size(), max_vertices, max_triangles);
+        vector<meshopt_Meshlet> meshlets(max_meshlets);
+        vector<uint32_t> meshlet_vertices(max_meshlets * max_vertices);
+        vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+        const size_t meshlet_count = meshopt_buildMeshlets(
+            meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+            indices.data(), indices.size(),
+            positions, vertex_count, vertex_size,
+            max_vertices, max_triangles, cone_weight
+        );
+
+        // Write the triangles back in cluster order, the meshlets hold their own copy so this can happen in place
+        clusters->resize(meshlet_count);
+        uint32_t index = 0;
+        for (size_t i = 0; i < meshlet_count; i++)
+        {
+            const meshopt_Meshlet& meshlet = meshlets[i];
+            const meshopt_Bounds bounds    = meshopt_computeMeshletBounds(
+                &meshlet_vertices[meshlet.vertex_offset], &meshlet_triangles[meshlet.triangle_offset], meshlet.triangle_count,
+                positions, vertex_count, vertex_size
+            );
+
+            MeshCluster& cluster = (*clusters)[i];
+            cluster.index_offset = index;
+            cluster.index_count  = meshlet.triangle_count * 3;
+            cluster.center       = Vector3(bounds.center[0], bounds.center[1], bounds.center[2]);
+            cluster.radius       = bounds.radius;
+            cluster.cone_apex    = Vector3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+            cluster.cone_axis    = Vector3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+            cluster.cone_cutoff  = bounds.cone_cutoff;
+
+            for (uint32_t j = 0; j < cluster.index_count; j++)
+            {
+                indices[index++] = meshlet_vertices[meshlet.vertex_offset + meshlet_triangles[meshlet.triangle_offset + j]];
+            }
+        }
+
+        SP_ASSERT_MSG(index == indices.size(), "The clusters don't cover every triangle");
+    }
+
+    void Mesh::AddClusters(const vector<MeshCluster>& clusters, const uint32_t index_offset)
+    {
+        lock_guard lock(m_mutex_add_clusters);
+
+        // Sub-meshes are added from several threads, so keep the clusters sorted as they arrive
+        auto it = upper_bound(m_clusters.begin(), m_clusters.end(), index_offset, [](const uint32_t offset, const MeshCluster& cluster) { return offset < cluster.index_offset; });
+        it      = m_clusters.insert(it, clusters.begin(), clusters.end());
+        for (auto end = it + clusters.size(); it != end; it++)
+        {
+            it->index_offset += index_offset;
+        }
+    }
+
+    const MeshCluster* Mesh::GetClusters(const uint32_t index_offset, const uint32_t index_count, uint32_t* cluster_count) const
+    {
+        SP_ASSERT(cluster_count != nullptr);
+
+        auto first = lower_bound(m_clusters.begin(), m_clusters.end(), index_offset, [](const MeshCluster& cluster, const uint32_t offset) { return cluster.index_offset < offset; });
+        auto last  = lower_bound(first, m_clusters.end(), index_offset + index_count, [](const MeshCluster& cluster, const uint32_t offset) { return cluster.index_offset < offset; });
+
+        *cluster_count = static_cast<uint32_t>(last - first);
+        return *cluster_count != 0 ? &(*first) : nullptr;
+    }
+
+    void Mesh::ComputeLods(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>* lod_indices, vector<MeshLod>* lods)
+    {
+        SP_ASSERT(lod_indices != nullptr && lods != nullptr);
+        SP_ASSERT_MSG(!indices.empty() && !vertices.empty(), "Invalid data");
+
+        // Every level halves the triangles, as long as the surface moves less than the error bound
+        const uint32_t lod_count_max = 8;
+        const float reduction        = 0.5f;
+        const float error_max        = 0.05f;  // relative to the extents
+        const size_t index_count_min = 64 * 3; // below this, another level saves too little to matter
+
+        const float* positions    = &vertices[0].pos[0];
+        const size_t vertex_count = vertices.size();
+        const size_t vertex_size  = sizeof(RHI_Vertex_PosTexNorTan);
+
+        lod_indices->clear();
+        lods->clear();
+
+        // Every level starts from the one before it, which keeps the cost close to a single pass, so their errors add up
+        vector<uint32_t> source = indices;
+        vector<uint32_t> lod(indices.size());
+        float error_previous    = 0.0f;
+        for (uint32_t level = 1; level <= lod_count_max; level++)
+        {
+            const size_t index_count_target = static_cast<size_t>(source.size() * reduction) / 3 * 3;
+            if (index_count_target < index_count_min)
+                break;
+
+            float error        = 0.0f;
+            size_t index_count = meshopt_simplify(lod.data(), source.data(), source.size(), positions, vertex_count, vertex_size, index_count_target, error_max, 0, &error);
+
+            // Seams and borders can stop the simplifier well above the target while still under the error bound,
+            // in that case collapse the triangles without regard for the topology, which is still bound by the error
+            if (index_count > index_count_target + index_count_target / 2 && error < error_max)
+            {
+                index_count = meshopt_simplifySloppy(lod.data(), source.data(), source.size(), positions, vertex_count, vertex_size, index_count_target, error_max, &error);
+            }
+
+            // Stop once a level saves too little to be worth drawing, coarser levels would be bound by the same error
+            if (index_count == 0 || index_count > source.size() * 9 / 10)
+                break;
+
+            meshopt_optimizeVertexCache(lod.data(), lod.data(), index_count, vertex_count);
+
+            MeshLod& mesh_lod     = lods->emplace_back();
+            mesh_lod.index_offset = static_cast<uint32_t>(lod_indices->size());
+            mesh_lod.index_count  = static_cast<uint32_t>(index_count);
+            mesh_lod.error        = error_previous + error;
+            lod_indices->insert(lod_indices->end(), lod.begin(), lod.begin() + index_count);
+
+            source.assign(lod.begin(), lod.begin() + index_count);
+            error_previous = mesh_lod.error;
+        }
+    }
+
+    void Mesh::AddLods(const vector<MeshLod>& lods, const vector<uint32_t>& lod_indices, const uint32_t source_index_offset)
+    {
+        if (lods.empty())
+            return;
+
+        uint32_t index_offset = 0;
+        AddIndices(lod_indices, &index_offset);
+
+        lock_guard lock(m_mutex_add_lods);
+
+        // Sub-meshes are added from several threads, so keep the levels sorted as they arrive
+        auto it = upper_bound(m_lods.begin(), m_lods.end(), source_index_offset, [](const uint32_t offset, const MeshLod& lod) { return offset < lod.source_index_offset; });
+        it      = m_lods.insert(it, lods.begin(), lods.end());
+        for (auto end = it + lods.size(); it != end; it++)
+        {
+            it->source_index_offset = source_index_offset;
+            it->index_offset       += index_offset;
+        }
+    }
+
+    const MeshLod* Mesh::GetLods(const uint32_t source_index_offset, uint32_t* lod_count) const
+    {
+        SP_ASSERT(lod_count != nullptr);
+
+        auto first = lower_bound(m_lods.begin(), m_lods.end(), source_index_offset, [](const MeshLod& lod, const uint32_t offset) { return lod.source_index_offset < offset; });
+        auto last  = upper_bound(first, m_lods.end(), source_index_offset, [](const uint32_t offset, const MeshLod& lod) { return offset < lod.source_index_offset; });
+
+        *lod_count = static_cast<uint32_t>(last - first);
+        return *lod_count != 0 ? &(*first) : nullptr;
+    }
+
     uint32_t Mesh::GetVertexCount() const
     {
         return static_cast<uint32_t>(m_vertices.size());
@@ -211,7 +430,13 @@ namespace Spartan
     {
         SP_ASSERT_MSG(m_vertices.size() != 0, "There are no vertices");
 
-        m_aabb = BoundingBox(m_vertices.data(), static_cast<uint32_t>(m_vertices.size()));
+        const RHI_Vertex_PosTexNorTan* vertices = m_vertices.data();
+        m_aabb = ThreadPool::ParallelReduce<BoundingBox>(
+            [vertices](uint32_t work_index_start, uint32_t work_index_end) { return BoundingBox(vertices + work_index_start, work_index_end - work_index_start); },
+            [](const BoundingBox& a, const BoundingBox& b) { BoundingBox merged = a; merged.Merge(b); return merged; },
+            BoundingBox(),
+            static_cast<uint32_t>(m_vertices.size())
+        );
     }
 
     uint32_t Mesh::GetDefaultFlags()
@@ -271,6 +496,12 @@ namespace Spartan
         m_vertex_buffer->Create(m_vertices);
     }
 
+    void Mesh::UpdateGpuVertices(const vector<pair<uint32_t, uint32_t>>& ranges)
+    {
+        SP_ASSERT_MSG(m_vertex_buffer != nullptr, "The GPU buffers have not been created");
+        m_vertex_buffer->Update(m_vertices, ranges);
+    }
+
     void Mesh::AddMaterial(shared_ptr<Material>& material, const shared_ptr<Entity>& entity) const
     {
         SP_ASSERT(material != nullptr);
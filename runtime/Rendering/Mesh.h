@@ -39,6 +39,28 @@ namespace Spartan
         NormalizeScale
     };
 
+    // Up to a hundred or so triangles which occupy a contiguous range of the mesh's indices, in mesh space.
+    // The bounding sphere and normal cone let the renderer reject the cluster when it's off-screen or back-facing.
+    struct MeshCluster
+    {
+        uint32_t index_offset = 0;
+        uint32_t index_count  = 0;
+        Math::Vector3 center;
+        float radius          = 0.0f;
+        Math::Vector3 cone_apex;
+        Math::Vector3 cone_axis;
+        float cone_cutoff     = 1.0f; // back-facing when dot(normalize(cone_apex - eye), cone_axis) >= cone_cutoff, 1 disables the test
+    };
+
+    // A simplified version of a sub-mesh, its indices live further down the mesh's indices and reuse the sub-mesh's vertices
+    struct MeshLod
+    {
+        uint32_t source_index_offset = 0; // the full detail sub-mesh
+        uint32_t index_offset        = 0;
+        uint32_t index_count         = 0;
+        float error                  = 0.0f; // how far the surface moved, relative to the sub-mesh's extents
+    };
+
     class Mesh : public IResource
     {
     public:
@@ -73,12 +95,23 @@ namespace Spartan
         uint32_t GetVertexCount() const;
         uint32_t GetIndexCount() const;
 
+        // Clusters, computing them reorders the indices so that every cluster is a contiguous range
+        static void ComputeClusters(std::vector<uint32_t>& indices, const std::vector<RHI_Vertex_PosTexNorTan>& vertices, std::vector<MeshCluster>* clusters);
+        void AddClusters(const std::vector<MeshCluster>& clusters, uint32_t index_offset);
+        const MeshCluster* GetClusters(uint32_t index_offset, uint32_t index_count, uint32_t* cluster_count) const;
+
+        // Levels of detail, from the most detailed to the least
+        static void ComputeLods(const std::vector<uint32_t>& indices, const std::vector<RHI_Vertex_PosTexNorTan>& vertices, std::vector<uint32_t>* lod_indices, std::vector<MeshLod>* lods);
+        void AddLods(const std::vector<MeshLod>& lods, const std::vector<uint32_t>& lod_indices, uint32_t source_index_offset);
+        const MeshLod* GetLods(uint32_t source_index_offset, uint32_t* lod_count) const;
+
         // AABB
         const Math::BoundingBox& GetAabb() const { return m_aabb; }
         void ComputeAabb();
 
         // GPU buffers
         void CreateGpuBuffers();
+        void UpdateGpuVertices(const std::vector<std::pair<uint32_t, uint32_t>>& ranges); // ranges of m_vertices, as first vertex and vertex count
         RHI_IndexBuffer* GetIndexBuffer()   { return m_index_buffer.get(); }
         RHI_VertexBuffer* GetVertexBuffer() { return m_vertex_buffer.get(); }
 
@@ -97,6 +130,8 @@ namespace Spartan
         // Geometry
         std::vector<RHI_Vertex_PosTexNorTan> m_vertices;
         std::vector<uint32_t> m_indices;
+        std::vector<MeshCluster> m_clusters; // sorted by index offset
+        std::vector<MeshLod> m_lods;         // sorted by source index offset, then detail
 
         // GPU buffers
         std::shared_ptr<RHI_VertexBuffer> m_vertex_buffer;
@@ -108,6 +143,8 @@ namespace Spartan
         // Sync primitives
         std::mutex m_mutex_add_indices;
         std::mutex m_mutex_add_verices;
+        std::mutex m_mutex_add_clusters;
+        std::mutex m_mutex_add_lods;
 
         // Misc
         std::weak_ptr<Entity> m_root_entity;
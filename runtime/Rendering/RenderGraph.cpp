@@ -0,0 +1,281 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========
+#include "pch.h"
+#include "RenderGraph.h"
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    static bool is_depth_format(const RHI_Format format)
+    {
+        return format == RHI_Format_D16_Unorm || format == RHI_Format_D32_Float || format == RHI_Format_D32_Float_S8X24_Uint;
+    }
+
+    static bool can_alias(const RenderGraphTextureDesc& a, const RenderGraphTextureDesc& b)
+    {
+        return a.width == b.width && a.height == b.height && a.mips == b.mips && a.format == b.format;
+    }
+
+    void RenderGraph::Clear()
+    {
+        m_passes.clear();
+        m_textures.clear();
+        m_physical.clear();
+    }
+
+    uint32_t RenderGraph::AddTexture(const RenderGraphTextureDesc& desc)
+    {
+        Texture texture;
+        texture.desc = desc;
+        m_textures.emplace_back(texture);
+
+        return static_cast<uint32_t>(m_textures.size() - 1);
+    }
+
+    uint32_t RenderGraph::AddPass(const char* name, bool enabled /*= true*/, bool has_side_effects /*= false*/)
+    {
+        Pass pass;
+        pass.name             = name;
+        pass.enabled          = enabled;
+        pass.has_side_effects = has_side_effects;
+        m_passes.emplace_back(pass);
+
+        return static_cast<uint32_t>(m_passes.size() - 1);
+    }
+
+    void RenderGraph::Read(uint32_t pass, uint32_t texture, RenderGraphAccess access /*= RenderGraphAccess::Sample*/)
+    {
+        AddAccess(pass, texture, access, true, false);
+    }
+
+    void RenderGraph::Write(uint32_t pass, uint32_t texture, RenderGraphAccess access /*= RenderGraphAccess::Storage*/)
+    {
+        AddAccess(pass, texture, access, false, true);
+    }
+
+    void RenderGraph::ReadWrite(uint32_t pass, uint32_t texture, RenderGraphAccess access /*= RenderGraphAccess::Storage*/)
+    {
+        AddAccess(pass, texture, access, true, true);
+    }
+
+    void RenderGraph::AddAccess(uint32_t pass, uint32_t texture, RenderGraphAccess access, bool read, bool write)
+    {
+        SP_ASSERT(pass < m_passes.size());
+        SP_ASSERT(texture < m_textures.size());
+
+        m_passes[pass].accesses.push_back({ texture, access, read, write });
+    }
+
+    void RenderGraph::Compile()
+    {
+        Cull();
+        ComputeLifetimes();
+        Alias();
+        ComputeTransitions();
+    }
+
+    void RenderGraph::Cull()
+    {
+        // Walk the passes backwards, a texture is needed if a later pass reads it or if it has to outlive the frame
+        vector<bool> needed(m_textures.size());
+        for (uint32_t i = 0; i < m_textures.size(); i++)
+        {
+            needed[i] = m_textures[i].desc.persistent;
+        }
+
+        for (uint32_t pass_index = static_cast<uint32_t>(m_passes.size()); pass_index-- > 0;)
+        {
+            Pass& pass  = m_passes[pass_index];
+            pass.culled = !pass.enabled;
+
+            // A pass without side effects is only kept if something consumes what it writes
+            if (!pass.culled && !pass.has_side_effects)
+            {
+                bool consumed = false;
+                for (const Access& access : pass.accesses)
+                {
+                    consumed |= access.write && needed[access.texture];
+                }
+                pass.culled = !consumed;
+            }
+
+            if (pass.culled)
+                continue;
+
+            // A plain write replaces the contents, so what earlier passes wrote is no longer needed
+            for (const Access& access : pass.accesses)
+            {
+                if (access.write && !access.read && !m_textures[access.texture].desc.persistent)
+                {
+                    needed[access.texture] = false;
+                }
+            }
+
+            for (const Access& access : pass.accesses)
+            {
+                if (access.read)
+                {
+                    needed[access.texture] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::ComputeLifetimes()
+    {
+        for (Texture& texture : m_textures)
+        {
+            texture.pass_first = invalid_index;
+            texture.pass_last  = invalid_index;
+            texture.physical   = invalid_index;
+        }
+
+        for (uint32_t pass_index = 0; pass_index < m_passes.size(); pass_index++)
+        {
+            if (m_passes[pass_index].culled)
+                continue;
+
+            for (const Access& access : m_passes[pass_index].accesses)
+            {
+                Texture& texture = m_textures[access.texture];
+
+                if (texture.pass_first == invalid_index)
+                {
+                    texture.pass_first = pass_index;
+                }
+                texture.pass_last = pass_index;
+            }
+        }
+    }
+
+    void RenderGraph::Alias()
+    {
+        m_physical.clear();
+
+        // Visit the textures in the order they come alive, so that lifetimes can be packed greedily
+        vector<uint32_t> order;
+        for (uint32_t i = 0; i < m_textures.size(); i++)
+        {
+            if (m_textures[i].pass_first != invalid_index)
+            {
+                order.emplace_back(i);
+            }
+        }
+        stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_textures[a].pass_first < m_textures[b].pass_first; });
+
+        for (uint32_t texture_index : order)
+        {
+            Texture& texture = m_textures[texture_index];
+
+            // Find a physical texture which is no longer in use and has the same description
+            uint32_t physical_index = invalid_index;
+            if (!texture.desc.persistent)
+            {
+                for (uint32_t i = 0; i < m_physical.size(); i++)
+                {
+                    const Physical& physical = m_physical[i];
+                    if (!physical.desc.persistent && physical.pass_last < texture.pass_first && can_alias(physical.desc, texture.desc))
+                    {
+                        physical_index = i;
+                        break;
+                    }
+                }
+            }
+
+            if (physical_index == invalid_index)
+            {
+                Physical physical;
+                physical.desc      = texture.desc;
+                physical.pass_last = texture.pass_last;
+                m_physical.emplace_back(physical);
+
+                physical_index = static_cast<uint32_t>(m_physical.size() - 1);
+            }
+            else
+            {
+                Physical& physical   = m_physical[physical_index];
+                physical.desc.flags |= texture.desc.flags;
+                physical.desc.name  += "|" + texture.desc.name;
+                physical.pass_last   = texture.pass_last;
+            }
+
+            texture.physical = physical_index;
+        }
+    }
+
+    void RenderGraph::ComputeTransitions()
+    {
+        // The layout of each physical texture as the passes execute, it's unknown when the frame starts
+        vector<RHI_Image_Layout> layouts(m_physical.size(), RHI_Image_Layout::Undefined);
+        vector<uint32_t> touched;
+
+        for (Pass& pass : m_passes)
+        {
+            pass.transitions.clear();
+
+            if (pass.culled)
+                continue;
+
+            // Only the first access of a pass to a texture can be transitioned up front,
+            // when the pass moves the texture to other layouts along the way, it does so itself.
+            touched.clear();
+            for (const Access& access : pass.accesses)
+            {
+                const uint32_t physical = m_textures[access.texture].physical;
+                const RHI_Image_Layout layout = GetLayout(access.access, m_physical[physical].desc.format);
+
+                if (find(touched.begin(), touched.end(), physical) == touched.end())
+                {
+                    touched.emplace_back(physical);
+
+                    if (layouts[physical] != layout)
+                    {
+                        pass.transitions.push_back({ physical, layout });
+                    }
+                }
+
+                layouts[physical] = layout;
+            }
+        }
+    }
+
+    RHI_Image_Layout RenderGraph::GetLayout(RenderGraphAccess access, RHI_Format format)
+    {
+        switch (access)
+        {
+            case RenderGraphAccess::Sample:      return is_depth_format(format) ? RHI_Image_Layout::Depth_Stencil_Read_Only_Optimal : RHI_Image_Layout::Shader_Read_Only_Optimal;
+            case RenderGraphAccess::Storage:     return RHI_Image_Layout::General;
+            case RenderGraphAccess::ColorTarget: return RHI_Image_Layout::Color_Attachment_Optimal;
+            case RenderGraphAccess::DepthTarget: return format == RHI_Format_D32_Float_S8X24_Uint ? RHI_Image_Layout::Depth_Stencil_Attachment_Optimal : RHI_Image_Layout::Depth_Attachment_Optimal;
+            case RenderGraphAccess::DepthRead:   return RHI_Image_Layout::Depth_Stencil_Read_Only_Optimal;
+            case RenderGraphAccess::CopySrc:     return RHI_Image_Layout::Transfer_Src_Optimal;
+            case RenderGraphAccess::CopyDst:     return RHI_Image_Layout::Transfer_Dst_Optimal;
+        }
+
+        return RHI_Image_Layout::Undefined;
+    }
+}
@@ -0,0 +1,148 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <string>
+#include "../Core/Definitions.h"
+#include "../RHI/RHI_Definition.h"
+//================================
+
+namespace Spartan
+{
+    // How a pass accesses a texture, it determines the layout the texture has to be in
+    enum class RenderGraphAccess : uint8_t
+    {
+        Sample,      // shader resource
+        Storage,     // unordered access
+        ColorTarget,
+        DepthTarget,
+        DepthRead,   // read only depth attachment
+        CopySrc,
+        CopyDst      // blits and clears
+    };
+
+    struct RenderGraphTextureDesc
+    {
+        std::string name;
+        uint32_t width    = 0;
+        uint32_t height   = 0;
+        uint32_t mips     = 1;
+        RHI_Format format = RHI_Format_Undefined;
+        uint32_t flags    = 0;
+        bool persistent   = false; // the contents outlive the frame (history, output), so it's never aliased
+    };
+
+    struct RenderGraphTransition
+    {
+        uint32_t physical;
+        RHI_Image_Layout layout;
+    };
+
+    // A frame described as an ordered list of passes which read and write textures.
+    // Compiling it culls the passes whose output nothing consumes, gives every texture a physical texture
+    // (transient textures with identical descriptions and disjoint lifetimes share one), and works out which
+    // layout every physical texture has to be in before each pass. There is no GPU work involved, so all
+    // the decisions can be made (and inspected) on the CPU.
+    class SP_CLASS RenderGraph
+    {
+    public:
+        RenderGraph() = default;
+        ~RenderGraph() = default;
+
+        // Declaration, passes are executed in the order they are added
+        void Clear();
+        uint32_t AddTexture(const RenderGraphTextureDesc& desc);
+        uint32_t AddPass(const char* name, bool enabled = true, bool has_side_effects = false);
+        void Read(uint32_t pass, uint32_t texture, RenderGraphAccess access = RenderGraphAccess::Sample);
+        void Write(uint32_t pass, uint32_t texture, RenderGraphAccess access = RenderGraphAccess::Storage);
+        void ReadWrite(uint32_t pass, uint32_t texture, RenderGraphAccess access = RenderGraphAccess::Storage);
+
+        void Compile();
+
+        // Passes
+        uint32_t GetPassCount() const                                                 { return static_cast<uint32_t>(m_passes.size()); }
+        const std::string& GetPassName(uint32_t pass) const                           { return m_passes[pass].name; }
+        bool IsPassCulled(uint32_t pass) const                                        { return m_passes[pass].culled; }
+        const std::vector<RenderGraphTransition>& GetTransitions(uint32_t pass) const { return m_passes[pass].transitions; }
+
+        // Textures, the pass range is only valid for used textures
+        uint32_t GetTextureCount() const                                     { return static_cast<uint32_t>(m_textures.size()); }
+        const RenderGraphTextureDesc& GetTextureDesc(uint32_t texture) const { return m_textures[texture].desc; }
+        bool IsTextureUsed(uint32_t texture) const                           { return m_textures[texture].physical != invalid_index; }
+        uint32_t GetPhysicalIndex(uint32_t texture) const                    { return m_textures[texture].physical; }
+        uint32_t GetFirstPass(uint32_t texture) const                        { return m_textures[texture].pass_first; }
+        uint32_t GetLastPass(uint32_t texture) const                         { return m_textures[texture].pass_last; }
+
+        // Physical textures, their flags are the union of the flags of the textures they alias
+        uint32_t GetPhysicalCount() const                                      { return static_cast<uint32_t>(m_physical.size()); }
+        const RenderGraphTextureDesc& GetPhysicalDesc(uint32_t physical) const { return m_physical[physical].desc; }
+
+        static RHI_Image_Layout GetLayout(RenderGraphAccess access, RHI_Format format);
+
+        static constexpr uint32_t invalid_index = 0xFFFFFFFF;
+
+    private:
+        struct Access
+        {
+            uint32_t texture;
+            RenderGraphAccess access;
+            bool read;
+            bool write;
+        };
+
+        struct Pass
+        {
+            std::string name;
+            bool enabled          = true;
+            bool has_side_effects = false;
+            bool culled           = false;
+            std::vector<Access> accesses;
+            std::vector<RenderGraphTransition> transitions;
+        };
+
+        struct Texture
+        {
+            RenderGraphTextureDesc desc;
+            uint32_t pass_first = invalid_index;
+            uint32_t pass_last  = invalid_index;
+            uint32_t physical   = invalid_index;
+        };
+
+        struct Physical
+        {
+            RenderGraphTextureDesc desc;
+            uint32_t pass_last = invalid_index;
+        };
+
+        void AddAccess(uint32_t pass, uint32_t texture, RenderGraphAccess access, bool read, bool write);
+        void Cull();
+        void ComputeLifetimes();
+        void Alias();
+        void ComputeTransitions();
+
+        std::vector<Pass> m_passes;
+        std::vector<Texture> m_textures;
+        std::vector<Physical> m_physical;
+    };
+}
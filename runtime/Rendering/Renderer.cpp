@@ -23,6 +23,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"                                
 #include "Renderer.h"                           
 #include "Grid.h"                               
+#include "Culler.h"                             
+#include "Mesh.h"                               
+#include "../Core/RadixSort.h"                  
 #include "Font/Font.h"                          
 #include "../Profiling/Profiler.h"              
 #include "../Resource/ResourceCache.h"          
@@ -42,11 +45,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_Implementation.h"          
 #include "../RHI/RHI_Semaphore.h"
 #include "../RHI/RHI_CommandPool.h"
+#include "../RHI/RHI_PipelineState.h"
+#include "../RHI/RHI_Shader.h"
 #include "../Core/Window.h"                     
+#include "../Core/ThreadPool.h"                 
 #include "../Input/Input.h"                     
 #include "../World/Components/Environment.h"    
 #include "../RHI/RHI_FSR2.h"
 #include "../RHI/RHI_RenderDoc.h"
+#include <bit>
 //==============================================
 
 //= NAMESPACES ===============
@@ -58,6 +65,48 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // Draw order, from the most significant bits to the least:
+    // opaque:      pass (4) | pipeline (8) | material (16) | mesh and index range (16) | depth (20), state changes are minimised and each state is drawn front to back
+    // transparent: pass (4) | depth (20, inverted) | pipeline (8) | material (16) | mesh and index range (16), everything is drawn back to front
+    static uint64_t get_sort_key(Entity* entity, const float depth, const bool is_transparent)
+    {
+        Renderable* renderable = entity->GetRenderable();
+        Material* material     = renderable->GetMaterial();
+        Mesh* mesh             = renderable->GetMesh();
+
+        // Object ids are sequential so their low bits are unique enough, a collision only costs a redundant bind
+        const uint64_t pass        = is_transparent ? 1 : 0;
+        const uint64_t pipeline    = (material && material->HasTexture(MaterialTexture::AlphaMask)) ? 1 : 0; // alpha tested surfaces discard pixels
+        const uint64_t material_id = material ? (material->GetObjectId() & 0xFFFF) : 0;
+
+        // The sub-meshes of a model share its mesh, so the index range is hashed in as well, draws which can be instanced end up next to each other
+        const uint64_t mesh_key = mesh ? (((mesh->GetObjectId() << 32) ^ renderable->GetLodIndexOffset()) * 0x9E3779B97F4A7C15ull) >> 48 : 0;
+
+        // Positive floats order like their bits, the top 20 (after the sign) keep the order at logarithmic precision
+        const uint32_t depth_bits = bit_cast<uint32_t>(Helper::Max(depth, 0.0f));
+        const uint64_t depth_key  = depth_bits >> 11;
+
+        if (!is_transparent)
+            return (pass << 60) | (pipeline << 52) | (material_id << 36) | (mesh_key << 20) | depth_key;
+
+        return (pass << 60) | ((0xFFFFF - depth_key) << 40) | (pipeline << 32) | (material_id << 16) | mesh_key;
+    }
+
+    // Whether two draws differ only in their transform, so they can be one instanced draw
+    static bool can_instance(const Entity* a, const Entity* b)
+    {
+        const Renderable* renderable_a = a->GetRenderable();
+        const Renderable* renderable_b = b->GetRenderable();
+
+        return
+            renderable_a->GetMesh()           == renderable_b->GetMesh()           &&
+            renderable_a->GetMaterial()       == renderable_b->GetMaterial()       &&
+            renderable_a->GetLodIndexCount()  == renderable_b->GetLodIndexCount()  &&
+            renderable_a->GetLodIndexOffset() == renderable_b->GetLodIndexOffset() &&
+            renderable_a->GetVertexOffset()   == renderable_b->GetVertexOffset()   &&
+            renderable_a->GetCastShadows()    == renderable_b->GetCastShadows();
+    }
+
     Renderer::Renderer(Context* context) : ISystem(context)
     {
         // Default options
@@ -89,7 +138,9 @@ namespace Spartan
         //SetOption(RendererOption::VolumetricFog,       1.0f); // Disable by default because it's not that great, I need to do it with a voxelised approach.
 
         // Subscribe to events.
-        SP_SUBSCRIBE_TO_EVENT(EventType::WorldResolved,             SP_EVENT_HANDLER_VARIANT(OnAddRenderables));
+        SP_SUBSCRIBE_TO_EVENT(EventType::WorldResolved,             SP_EVENT_HANDLER_VARIANT(OnWorldResolved));
+        SP_SUBSCRIBE_TO_EVENT(EventType::WorldEntitiesAdded,        SP_EVENT_HANDLER_VARIANT(OnEntitiesAdded));
+        SP_SUBSCRIBE_TO_EVENT(EventType::WorldEntitiesRemoved,      SP_EVENT_HANDLER_VARIANT(OnEntitiesRemoved));
         SP_SUBSCRIBE_TO_EVENT(EventType::WorldClear,                SP_EVENT_HANDLER(OnClear));
         SP_SUBSCRIBE_TO_EVENT(EventType::WindowOnFullScreenToggled, SP_EVENT_HANDLER(OnFullScreenToggled));
 
@@ -97,12 +148,18 @@ namespace Spartan
         m_render_thread_id = this_thread::get_id();
 
         m_material_instances.fill(nullptr);
+
+        m_culler = make_unique<Culler>();
     }
 
     Renderer::~Renderer()
     {
         SP_FIRE_EVENT(EventType::RendererOnShutdown);
 
+        // Remember which pipelines this run needed, the next one will create them before its first frame
+        SavePipelineManifest();
+        RHI_CommandList::DestroyPipelines();
+
         // Log to file as the renderer is no more
         Log::SetLogToFile(true);
 
@@ -188,6 +245,42 @@ namespace Spartan
             Flush();
         }
 
+        // Re-compile the render graph after an option changed which passes run, render targets might be created or freed
+        if (m_render_graph_dirty)
+        {
+            CompileRenderGraph();
+        }
+
+        // The first frame which has all the shaders is the one that creates most of the pipelines, report how much
+        // of a hitch that was, prewarmed pipelines and a warm pipeline cache should make it drop considerably.
+        if (m_shaders_ready && m_frame_num == m_shaders_ready_frame + 1)
+        {
+            SP_LOG_INFO("The first complete frame took %.2f ms, %d pipelines have been created so far, taking %.2f ms",
+                delta_time * 1000.0, RHI_CommandList::GetPipelineCreationCount(), RHI_CommandList::GetPipelineCreationTimeMs());
+        }
+
+        // Report how long it took for all the shaders to become ready, which depends on how much of the shader cache was hit
+        if (!m_shaders_ready)
+        {
+            m_shaders_ready = all_of(m_shaders.begin(), m_shaders.end(), [](const shared_ptr<RHI_Shader>& shader)
+            {
+                return !shader || shader->IsCompiled() || shader->GetCompilationState() == Shader_Compilation_State::Failed;
+            });
+
+            if (m_shaders_ready)
+            {
+                m_shaders_ready_frame = m_frame_num;
+                SP_LOG_INFO("Shaders are ready after %.2f ms, %d were loaded from the cache and %d were compiled",
+                    m_shaders_stopwatch.GetElapsedTimeMs(), RHI_Shader::GetCacheHitCount(), RHI_Shader::GetCacheMissCount());
+
+                // Create the pipelines of the previous run on the worker threads, instead of one by one while recording the first frame
+                PrewarmPipelines();
+            }
+        }
+
+        // Recompile the shaders whose source files (or includes) changed and swap them in once they are compiled
+        m_shader_watcher.Tick(m_shaders.data(), static_cast<uint32_t>(m_shaders.size()));
+
         // Resize swapchain to window size (if needed)
         {
             // Passing zero dimensions will cause the swapchain to not present at all
@@ -211,7 +304,8 @@ namespace Spartan
         bool reset = m_cmd_pool->Step() || (m_rhi_device->GetRhiApiType() == RHI_Api_Type::D3d11);
 
         // Begin
-        m_cmd_current = m_cmd_pool->GetCurrentCommandList();
+        m_cmd_current         = m_cmd_pool->GetCurrentCommandList();
+        m_cmd_secondary_index = 0;
         m_cmd_current->Begin();
 
         if (reset)
@@ -222,11 +316,32 @@ namespace Spartan
             m_cb_light_gpu->ResetOffset();
             m_cb_material_gpu->ResetOffset();
             m_sb_spd_counter->ResetOffset();
+            if (m_sb_instances)
+            {
+                m_sb_instances->ResetOffset();
+            }
+            RHI_VertexBuffer::ResetStaging();
+
+            if (m_cb_draws_gpu)
+            {
+                // Grow after an overflow, nothing is in flight at this point
+                if (m_cb_draws_required != 0)
+                {
+                    SP_LOG_INFO("Growing the draw constant buffer to %d elements", m_cb_draws_required);
+                    m_cb_draws_gpu->Create<Cb_Uber>(m_cb_draws_required);
+                    m_cb_draws_required = 0;
+                }
+
+                m_cb_draws_gpu->ResetOffset();
+            }
 
             // Perform operations which might modify, create or destroy resources
             OnResourceSafe(m_cmd_current);
         }
 
+        // Vertex buffer updates, before anything this frame draws
+        RHI_VertexBuffer::RecordStagedCopies(m_cmd_current);
+
         // Update frame buffer
         {
             // Matrices
@@ -308,6 +423,10 @@ namespace Spartan
             m_cb_frame_cpu.set_bit(GetOption<bool>(RendererOption::Ssao_Gi), 1 << 4);
         }
 
+        // Determine what every view can see, the passes only consume the results
+        Cull();
+        PrepareDraws();
+
         Lines_PreMain();
         Pass_Main(m_cmd_current);
         Lines_PostMain(delta_time);
@@ -417,6 +536,10 @@ namespace Spartan
         }
 
         m_cb_frame_gpu->Update(&m_cb_frame_cpu);
+        if (m_profiler)
+        {
+            m_profiler->m_renderer_bytes_uploaded += sizeof(Cb_Frame);
+        }
 
         // Bind because the offset just changed
         cmd_list->SetConstantBuffer(RendererBindingsCb::frame, RHI_Shader_Vertex | RHI_Shader_Pixel | RHI_Shader_Compute, m_cb_frame_gpu);
@@ -425,6 +548,10 @@ namespace Spartan
     void Renderer::Update_Cb_Uber(RHI_CommandList* cmd_list)
     {
         m_cb_uber_gpu->Update(&m_cb_uber_cpu);
+        if (m_profiler)
+        {
+            m_profiler->m_renderer_bytes_uploaded += sizeof(Cb_Uber);
+        }
 
         // Bind because the offset just changed
         cmd_list->SetConstantBuffer(RendererBindingsCb::uber, RHI_Shader_Vertex | RHI_Shader_Pixel | RHI_Shader_Compute, m_cb_uber_gpu);
@@ -458,6 +585,10 @@ namespace Spartan
         m_cb_light_cpu.options                    |= light->GetVolumetricEnabled()                   ? (1 << 6) : 0;
 
         m_cb_light_gpu->Update(&m_cb_light_cpu);
+        if (m_profiler)
+        {
+            m_profiler->m_renderer_bytes_uploaded += sizeof(Cb_Light);
+        }
 
         // Bind because the offset just changed
         cmd_list->SetConstantBuffer(RendererBindingsCb::light, scope, m_cb_light_gpu);
@@ -481,32 +612,683 @@ namespace Spartan
         }
 
         m_cb_material_gpu->Update(&m_cb_material_cpu);
+        if (m_profiler)
+        {
+            m_profiler->m_renderer_bytes_uploaded += sizeof(Cb_Material);
+        }
 
         // Bind because the offset just changed
         cmd_list->SetConstantBuffer(RendererBindingsCb::material, RHI_Shader_Pixel, m_cb_material_gpu);
     }
 
-    void Renderer::OnAddRenderables(const Variant& renderables)
+    void Renderer::Bind_Cb_Draw(RHI_CommandList* cmd_list, const uint32_t index)
     {
-        lock_guard lock(m_mutex_entity_addition);
+        if (m_cb_draws_uploaded)
+        {
+            // Already on the gpu, only the offset changes (nothing is written, so this is safe to call from any thread)
+            const uint32_t offset = m_cb_draws_offset + index * m_cb_draws_gpu->GetStride();
+            cmd_list->SetConstantBuffer(static_cast<uint32_t>(RendererBindingsCb::uber), RHI_Shader_Vertex | RHI_Shader_Pixel | RHI_Shader_Compute, m_cb_draws_gpu.get(), offset);
+        }
+        else
+        {
+            m_cb_uber_cpu = m_draw_constants[index];
+            Update_Cb_Uber(cmd_list);
+        }
+    }
+
+    void Renderer::DrawBatchIndexed(RHI_CommandList* cmd_list, const DrawList& list, const DrawBatch& batch, const Renderable* renderable) const
+    {
+        if (batch.range_count == 0)
+        {
+            cmd_list->DrawIndexed(renderable->GetLodIndexCount(), renderable->GetLodIndexOffset(), renderable->GetVertexOffset(), batch.count);
+            return;
+        }
+
+        for (uint32_t i = batch.range_first; i < batch.range_first + batch.range_count; i++)
+        {
+            const DrawRange& range = list.ranges[i];
+            cmd_list->DrawIndexed(range.index_count, range.index_offset, renderable->GetVertexOffset(), batch.count);
+        }
+    }
+
+    void Renderer::RecordRenderPasses(RHI_CommandList* cmd_list, vector<RHI_PipelineState>& psos, const vector<uint32_t>& batch_counts, const RecordFunction& record)
+    {
+        SP_ASSERT(psos.size() == batch_counts.size());
+        const uint32_t pass_count = static_cast<uint32_t>(psos.size());
+
+        uint32_t batch_count = 0;
+        for (const uint32_t count : batch_counts)
+        {
+            batch_count += count;
+        }
+
+        // Recording on other threads requires secondary command lists and draw constants which are only bound
+        const RHI_Api_Type api_type = RHI_Device::GetRhiApiType();
+        const bool secondary_support = api_type == RHI_Api_Type::Vulkan || api_type == RHI_Api_Type::Null;
+        const uint32_t thread_count  = ThreadPool::GetThreadCount() + 1; // the calling thread helps too
+        if (!secondary_support || !m_cb_draws_uploaded || thread_count == 1 || batch_count < m_record_parallel_batch_min * 2)
+        {
+            for (uint32_t pass_index = 0; pass_index < pass_count; pass_index++)
+            {
+                cmd_list->SetPipelineState(psos[pass_index]);
+                cmd_list->BeginRenderPass();
+                record(cmd_list, pass_index, 0, batch_counts[pass_index]);
+                cmd_list->EndRenderPass();
+            }
+
+            return;
+        }
+
+        // Split the batches into about one chunk per thread, each chunk gets a secondary command list
+        struct Chunk
+        {
+            uint32_t pass_index;
+            uint32_t batch_start;
+            uint32_t batch_end;
+            RHI_CommandList* cmd_list;
+        };
+        const uint32_t chunk_size = Helper::Max(m_record_parallel_batch_min, (batch_count + thread_count - 1) / thread_count);
+        vector<Chunk> chunks;
+        for (uint32_t pass_index = 0; pass_index < pass_count; pass_index++)
+        {
+            for (uint32_t batch_start = 0; batch_start < batch_counts[pass_index]; batch_start += chunk_size)
+            {
+                const uint32_t batch_end = Helper::Min(batch_start + chunk_size, batch_counts[pass_index]);
+                chunks.push_back({ pass_index, batch_start, batch_end, m_cmd_pool->GetSecondaryCommandList(m_cmd_secondary_index++) });
+            }
+        }
+
+        // Record
+        ThreadPool::ParallelLoop([&chunks, &psos, &record](uint32_t chunk_start, uint32_t chunk_end)
+        {
+            for (uint32_t chunk_index = chunk_start; chunk_index < chunk_end; chunk_index++)
+            {
+                const Chunk& chunk = chunks[chunk_index];
+
+                chunk.cmd_list->Begin(psos[chunk.pass_index]);
+                record(chunk.cmd_list, chunk.pass_index, chunk.batch_start, chunk.batch_end);
+                chunk.cmd_list->End();
+            }
+        }, static_cast<uint32_t>(chunks.size()), 1);
 
-        vector<shared_ptr<Entity>> entities = renderables.Get<vector<shared_ptr<Entity>>>();
-        for (const shared_ptr<Entity>& entity : entities)
+        // Execute, in order, the layout transitions happen here when the render passes begin
+        vector<RHI_CommandList*> cmd_lists;
+        uint32_t chunk_index = 0;
+        for (uint32_t pass_index = 0; pass_index < pass_count; pass_index++)
         {
-            SP_ASSERT_MSG(entity != nullptr, "Entity is null");
-            SP_ASSERT_MSG(entity->IsActive(), "Entity is inactive");
+            cmd_lists.clear();
+            for (; chunk_index < chunks.size() && chunks[chunk_index].pass_index == pass_index; chunk_index++)
+            {
+                cmd_lists.emplace_back(chunks[chunk_index].cmd_list);
+            }
 
-            m_entities_to_add.emplace_back(entity.get());
+            cmd_list->SetPipelineState(psos[pass_index]);
+            cmd_list->BeginRenderPass(true);
+            cmd_list->ExecuteSecondary(cmd_lists);
+            cmd_list->EndRenderPass();
         }
+    }
+
+    void Renderer::OnWorldResolved(const Variant& entities)
+    {
+        lock_guard lock(m_mutex_entity_addition);
+
+        // Everything is re-added, so anything added before this is redundant
+        m_entities_to_add  = entities.Get<vector<shared_ptr<Entity>>>();
+        m_entities_rebuild = true;
+        m_entities_dirty   = true;
+    }
+
+    void Renderer::OnEntitiesAdded(const Variant& entities)
+    {
+        lock_guard lock(m_mutex_entity_addition);
 
-        m_add_new_entities = true;
+        const vector<shared_ptr<Entity>>& entities_added = entities.Get<vector<shared_ptr<Entity>>>();
+        m_entities_to_add.insert(m_entities_to_add.end(), entities_added.begin(), entities_added.end());
+        m_entities_dirty = true;
+    }
+
+    void Renderer::OnEntitiesRemoved(const Variant& entities)
+    {
+        lock_guard lock(m_mutex_entity_addition);
+
+        const vector<shared_ptr<Entity>>& entities_removed = entities.Get<vector<shared_ptr<Entity>>>();
+        m_entities_to_remove.insert(m_entities_to_remove.end(), entities_removed.begin(), entities_removed.end());
+        m_entities_dirty = true;
     }
 
     void Renderer::OnClear()
     {
         // Flush to remove references to entity resources that will be deallocated
         Flush();
+
+        lock_guard lock(m_mutex_entity_addition);
         m_entities.clear();
+        m_entity_slots.clear();
+        m_entities_to_add.clear();
+        m_entities_to_remove.clear();
+        m_cull_entities.clear();
+        m_cull_views.clear();
+        m_visible.clear();
+        m_instances.clear();
+        m_camera = nullptr;
+    }
+
+    void Renderer::Cull()
+    {
+        SP_SCOPED_TIME_BLOCK(m_profiler);
+
+        m_culler->ClearBoxes();
+        m_culler->ClearViews();
+        m_cull_entities.clear();
+        m_cull_views.clear();
+
+        if (!m_camera)
+            return;
+
+        // Boxes, opaque followed by transparent, every view draws the level of detail that the camera picks
+        {
+            const vector<Entity*>& opaque      = m_entities[RendererEntityType::GeometryOpaque];
+            const vector<Entity*>& transparent = m_entities[RendererEntityType::GeometryTransparent];
+            m_culler->ReserveBoxes(static_cast<uint32_t>(opaque.size() + transparent.size()));
+
+            const Vector3 eye_position   = m_camera->GetTransform()->GetPosition();
+            const float projection_scale = m_camera->GetProjectionType() == Projection_Perspective ?
+                GetResolutionRender().y / (2.0f * tan(m_camera->GetFovVerticalRad() * 0.5f)) :
+                numeric_limits<float>::infinity();
+
+            for (Entity* entity : opaque)
+            {
+                if (Renderable* renderable = entity->GetRenderable())
+                {
+                    renderable->UpdateLod(eye_position, projection_scale);
+                    m_culler->AddBox(renderable->GetAabb());
+                    m_cull_entities.emplace_back(entity);
+                }
+            }
+
+            m_cull_transparent_start = m_culler->GetBoxCount();
+
+            for (Entity* entity : transparent)
+            {
+                if (Renderable* renderable = entity->GetRenderable())
+                {
+                    renderable->UpdateLod(eye_position, projection_scale);
+                    m_culler->AddBox(renderable->GetAabb());
+                    m_cull_entities.emplace_back(entity);
+                }
+            }
+        }
+
+        // Views
+        {
+            m_cull_views[m_camera.get()] = m_culler->AddView(m_camera->GetFrustum(), m_camera->GetViewMatrix());
+
+            // Only lights which will render shadows
+            for (Entity* entity : m_entities[RendererEntityType::Light])
+            {
+                const Light* light = entity->GetComponent<Light>();
+                if (!light || !light->GetShadowsEnabled() || light->GetIntensityForShader(m_camera.get()) == 0.0f)
+                    continue;
+
+                // Ensure that potential shadow casters from behind the near plane are not rejected
+                const bool ignore_near_plane = light->GetLightType() == LightType::Directional;
+
+                m_cull_views[light] = m_culler->GetViewCount();
+                for (uint32_t i = 0; i < light->GetShadowArraySize(); i++)
+                {
+                    m_culler->AddView(light->GetFrustum(i), light->GetViewMatrix(i), ignore_near_plane);
+                }
+            }
+
+            // Only probes which will update
+            for (Entity* entity : m_entities[RendererEntityType::ReflectionProbe])
+            {
+                ReflectionProbe* probe = entity->GetComponent<ReflectionProbe>();
+                if (!probe || !probe->GetNeedsToUpdate())
+                    continue;
+
+                m_cull_views[probe] = m_culler->GetViewCount();
+                for (uint32_t i = 0; i < 6; i++)
+                {
+                    m_culler->AddView(probe->GetFrustum(i), probe->GetViewMatrix(i));
+                }
+            }
+        }
+
+        m_culler->Cull();
+
+        // Resolve boxes to entities, split into opaque and transparent, sort them into draw order and batch them
+        const uint32_t view_count  = m_culler->GetViewCount();
+        const uint32_t camera_view = m_cull_views[m_camera.get()];
+        const bool instancing      = m_sb_instances != nullptr;
+        m_visible.resize(view_count);
+        ThreadPool::ParallelLoop([this, instancing, camera_view](uint32_t view_start, uint32_t view_end)
+        {
+            for (uint32_t view_index = view_start; view_index < view_end; view_index++)
+            {
+                array<DrawList, 2>& lists = m_visible[view_index];
+                for (DrawList& list : lists)
+                {
+                    list.items.clear();
+                }
+
+                for (const VisibleBox& box : m_culler->GetVisible(view_index))
+                {
+                    const bool is_transparent = box.index >= m_cull_transparent_start;
+                    Entity* entity            = m_cull_entities[box.index];
+                    lists[is_transparent ? 1 : 0].items.push_back({ get_sort_key(entity, box.depth, is_transparent), entity });
+                }
+
+                for (DrawList& list : lists)
+                {
+                    RadixSort(list.items, list.items_scratch);
+
+                    list.entities.clear();
+                    list.batches.clear();
+                    list.instance_count = 0;
+                    for (const DrawItem& item : list.items)
+                    {
+                        const uint32_t index = static_cast<uint32_t>(list.entities.size());
+                        list.entities.emplace_back(item.entity);
+
+                        // Equal draws are adjacent after sorting, so merging neighbours is enough
+                        if (instancing && !list.batches.empty() && can_instance(list.entities[list.batches.back().first], item.entity))
+                        {
+                            list.batches.back().count++;
+                        }
+                        else
+                        {
+                            list.batches.push_back({ index, 1, 0, 0, 0 });
+                        }
+                    }
+
+                    for (const DrawBatch& batch : list.batches)
+                    {
+                        list.instance_count += batch.count > 1 ? batch.count : 0;
+                    }
+                }
+
+                // Trim the camera's opaque draws down to the index ranges of their visible clusters
+                if (view_index == camera_view)
+                {
+                    CullClusters(lists[0]);
+                }
+            }
+        }, view_count, 1);
+
+        if (!instancing)
+            return;
+
+        // Give every list a range of the instance buffer, lists which don't fit fall back to one draw per entity
+        uint32_t instance_count = 0;
+        vector<uint32_t> instance_bases(view_count * 2, 0);
+        for (uint32_t view_index = 0; view_index < view_count; view_index++)
+        {
+            for (uint32_t list_index = 0; list_index < 2; list_index++)
+            {
+                DrawList& list = m_visible[view_index][list_index];
+                if (instance_count + list.instance_count > max_instances)
+                {
+                    // Single draws keep their cluster culled ranges, batches which were culled entirely stay out
+                    vector<DrawBatch> batches = move(list.batches);
+                    list.batches.clear();
+                    for (const DrawBatch& batch : batches)
+                    {
+                        if (batch.count == 1)
+                        {
+                            list.batches.push_back(batch);
+                            continue;
+                        }
+
+                        for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+                        {
+                            list.batches.push_back({ i, 1, 0, 0, 0 });
+                        }
+                    }
+                    list.instance_count = 0;
+                }
+
+                instance_bases[view_index * 2 + list_index] = instance_count;
+                instance_count += list.instance_count;
+            }
+        }
+
+        // Write the instance data
+        m_instances.resize(instance_count);
+        ThreadPool::ParallelLoop([this, &instance_bases](uint32_t view_start, uint32_t view_end)
+        {
+            for (uint32_t view_index = view_start; view_index < view_end; view_index++)
+            {
+                for (uint32_t list_index = 0; list_index < 2; list_index++)
+                {
+                    DrawList& list          = m_visible[view_index][list_index];
+                    uint32_t instance_index = instance_bases[view_index * 2 + list_index];
+
+                    for (DrawBatch& batch : list.batches)
+                    {
+                        if (batch.count < 2)
+                            continue;
+
+                        batch.instance_offset = instance_index;
+                        for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+                        {
+                            const Transform* transform  = list.entities[i]->GetTransform();
+                            m_instances[instance_index] = { transform->GetMatrix(), transform->GetMatrixPrevious() };
+                            instance_index++;
+                        }
+                    }
+                }
+            }
+        }, view_count, 1);
+
+        if (!m_instances.empty())
+        {
+            m_sb_instances->Update(m_instances.data(), static_cast<uint32_t>(m_instances.size() * sizeof(Sb_Instance)));
+            if (m_profiler)
+            {
+                m_profiler->m_renderer_bytes_uploaded += static_cast<uint32_t>(m_instances.size() * sizeof(Sb_Instance));
+            }
+        }
+    }
+
+    void Renderer::CullClusters(DrawList& list) const
+    {
+        // Meshes with fewer clusters than this are cheaper to draw whole
+        static const uint32_t cluster_count_min = 4;
+
+        list.ranges.clear();
+
+        const Frustum& frustum        = m_camera->GetFrustum();
+        const Vector3 camera_position = m_camera->GetTransform()->GetPosition();
+
+        uint32_t triangle_count   = 0;
+        uint32_t triangles_culled = 0;
+        uint32_t batch_count      = 0;
+        for (DrawBatch& batch : list.batches)
+        {
+            const Entity* entity         = list.entities[batch.first];
+            const Renderable* renderable = entity->GetRenderable();
+            const Mesh* mesh             = renderable ? renderable->GetMesh() : nullptr;
+            triangle_count += renderable ? (renderable->GetLodIndexCount() / 3) * batch.count : 0;
+
+            // Instances share one index range, so only single draws can trim theirs
+            uint32_t cluster_count      = 0;
+            const MeshCluster* clusters = (mesh && batch.count == 1) ? mesh->GetClusters(renderable->GetLodIndexOffset(), renderable->GetLodIndexCount(), &cluster_count) : nullptr;
+            if (cluster_count < cluster_count_min)
+            {
+                list.batches[batch_count++] = batch;
+                continue;
+            }
+
+            // The normal cones only hold under uniform scaling, and mirroring flips the winding anyway
+            const Matrix& transform   = entity->GetTransform()->GetMatrix();
+            const Vector3 scale       = transform.GetScale();
+            const float scale_max     = Helper::Max3(Helper::Abs(scale.x), Helper::Abs(scale.y), Helper::Abs(scale.z));
+            const bool cull_backfaces = scale.x > 0.0f && Helper::Abs(scale.x - scale.y) <= scale.x * 0.01f && Helper::Abs(scale.x - scale.z) <= scale.x * 0.01f;
+
+            batch.range_first = static_cast<uint32_t>(list.ranges.size());
+            for (uint32_t i = 0; i < cluster_count; i++)
+            {
+                const MeshCluster& cluster = clusters[i];
+
+                // Bounding sphere against the frustum
+                const Vector3 center = cluster.center * transform;
+                const float radius   = cluster.radius * scale_max;
+                bool visible         = true;
+                for (uint32_t plane_index = 0; plane_index < 6 && visible; plane_index++)
+                {
+                    const Plane& plane = frustum.GetPlane(plane_index);
+                    visible            = Vector3::Dot(plane.normal, center) + plane.d >= -radius;
+                }
+
+                // Normal cone against the camera
+                if (visible && cull_backfaces && cluster.cone_cutoff < 1.0f)
+                {
+                    const Vector3 apex = cluster.cone_apex * transform;
+                    const Vector3 axis = Vector3(
+                        cluster.cone_axis.x * transform.m00 + cluster.cone_axis.y * transform.m10 + cluster.cone_axis.z * transform.m20,
+                        cluster.cone_axis.x * transform.m01 + cluster.cone_axis.y * transform.m11 + cluster.cone_axis.z * transform.m21,
+                        cluster.cone_axis.x * transform.m02 + cluster.cone_axis.y * transform.m12 + cluster.cone_axis.z * transform.m22
+                    ) / scale.x;
+                    visible = Vector3::Dot((apex - camera_position).Normalized(), axis) < cluster.cone_cutoff;
+                }
+
+                if (!visible)
+                {
+                    triangles_culled += cluster.index_count / 3;
+                    continue;
+                }
+
+                // Clusters are laid out back to back in the index buffer, so visible neighbours merge into one draw
+                if (list.ranges.size() > batch.range_first && list.ranges.back().index_offset + list.ranges.back().index_count == cluster.index_offset)
+                {
+                    list.ranges.back().index_count += cluster.index_count;
+                }
+                else
+                {
+                    list.ranges.push_back({ cluster.index_offset, cluster.index_count });
+                }
+            }
+            batch.range_count = static_cast<uint32_t>(list.ranges.size()) - batch.range_first;
+
+            // Drop batches which have no visible clusters
+            if (batch.range_count != 0)
+            {
+                list.batches[batch_count++] = batch;
+            }
+        }
+        list.batches.resize(batch_count);
+
+        if (m_profiler)
+        {
+            m_profiler->m_renderer_triangles        += triangle_count;
+            m_profiler->m_renderer_triangles_culled += triangles_culled;
+        }
+    }
+
+    const Renderer::DrawList& Renderer::GetDrawList(const IComponent* view_owner, const uint32_t view_offset, const bool is_transparent)
+    {
+        static const DrawList empty;
+
+        auto it = m_cull_views.find(view_owner);
+        if (it == m_cull_views.end())
+            return empty;
+
+        const uint32_t view_index = it->second + view_offset;
+        SP_ASSERT(view_index < m_visible.size());
+
+        return m_visible[view_index][is_transparent ? 1 : 0];
+    }
+
+    void Renderer::PrepareDraws()
+    {
+        SP_SCOPED_TIME_BLOCK(m_profiler);
+
+        enum class DrawPass { Shadow, DepthPrepass, GBuffer };
+
+        struct DrawJob
+        {
+            DrawList* list;
+            DrawPass pass;
+            bool is_transparent;
+            Matrix view_projection; // shadow passes only
+        };
+
+        // Every list that a batched pass will draw, each gets a constant buffer element per batch
+        vector<DrawJob> jobs;
+        uint32_t constant_count = 0;
+        auto add_job = [&jobs, &constant_count](DrawList& list, const DrawPass pass, const bool is_transparent, const Matrix& view_projection)
+        {
+            (pass == DrawPass::GBuffer ? list.constants_gbuffer : list.constants_depth) = constant_count;
+            constant_count += static_cast<uint32_t>(list.batches.size());
+            jobs.push_back({ &list, pass, is_transparent, view_projection });
+        };
+
+        auto it = m_cull_views.find(m_camera.get());
+        if (it != m_cull_views.end())
+        {
+            array<DrawList, 2>& lists = m_visible[it->second];
+            add_job(lists[0], DrawPass::DepthPrepass, false, Matrix::Identity);
+            add_job(lists[0], DrawPass::GBuffer,      false, Matrix::Identity);
+            add_job(lists[1], DrawPass::GBuffer,      true,  Matrix::Identity);
+        }
+
+        for (Entity* entity : m_entities[RendererEntityType::Light])
+        {
+            const Light* light = entity->GetComponent<Light>();
+            auto it_light      = m_cull_views.find(light);
+            if (it_light == m_cull_views.end())
+                continue;
+
+            for (uint32_t i = 0; i < light->GetShadowArraySize(); i++)
+            {
+                const Matrix view_projection = light->GetViewMatrix(i) * light->GetProjectionMatrix(i);
+                add_job(m_visible[it_light->second + i][0], DrawPass::Shadow, false, view_projection);
+                add_job(m_visible[it_light->second + i][1], DrawPass::Shadow, true,  view_projection);
+            }
+        }
+
+        // Write the constants, each list is walked in order since the g-buffer's material ids depend on it
+        m_draw_constants.resize(constant_count);
+        ThreadPool::ParallelLoop([this, &jobs](uint32_t job_start, uint32_t job_end)
+        {
+            for (uint32_t job_index = job_start; job_index < job_end; job_index++)
+            {
+                const DrawJob& job = jobs[job_index];
+                const DrawList& list = *job.list;
+                const uint32_t constants_first = job.pass == DrawPass::GBuffer ? list.constants_gbuffer : list.constants_depth;
+
+                // Keep track of used material instances (they get mapped to shaders), 0 is reserved for the sky
+                array<Material*, m_max_material_instances>& material_instances = m_material_instances_gbuffer[job.is_transparent ? 1 : 0];
+                uint32_t material_index    = 0;
+                uint64_t material_bound_id = 0;
+                if (job.pass == DrawPass::GBuffer)
+                {
+                    material_instances.fill(nullptr);
+                }
+
+                for (uint32_t batch_index = 0; batch_index < static_cast<uint32_t>(list.batches.size()); batch_index++)
+                {
+                    const DrawBatch& batch = list.batches[batch_index];
+                    Cb_Uber& cb            = m_draw_constants[constants_first + batch_index];
+                    cb                     = Cb_Uber();
+
+                    // Skip what the passes skip
+                    Entity* entity         = list.entities[batch.first];
+                    Renderable* renderable = entity->GetRenderable();
+                    Material* material     = renderable ? renderable->GetMaterial() : nullptr;
+                    Mesh* mesh             = renderable ? renderable->GetMesh() : nullptr;
+                    Transform* transform   = entity->GetTransform();
+                    if (!material || !mesh || !mesh->GetVertexBuffer() || !mesh->GetIndexBuffer() || !transform)
+                        continue;
+
+                    const bool is_instanced = batch.count > 1;
+                    cb.is_instanced         = is_instanced;
+                    cb.instance_offset      = batch.instance_offset;
+
+                    if (job.pass == DrawPass::Shadow)
+                    {
+                        // Instances carry their world transform in the instance buffer
+                        cb.transform = is_instanced ? job.view_projection : transform->GetMatrix() * job.view_projection;
+
+                        // Material (only for transparents)
+                        if (job.is_transparent)
+                        {
+                            cb.mat_color.x     = material->GetProperty(MaterialProperty::ColorR);
+                            cb.mat_color.y     = material->GetProperty(MaterialProperty::ColorG);
+                            cb.mat_color.z     = material->GetProperty(MaterialProperty::ColorB);
+                            cb.mat_color.w     = material->GetProperty(MaterialProperty::ColorA);
+                            cb.mat_tiling_uv.x = material->GetProperty(MaterialProperty::UvTilingX);
+                            cb.mat_tiling_uv.y = material->GetProperty(MaterialProperty::UvTilingY);
+                            cb.mat_offset_uv.x = material->GetProperty(MaterialProperty::UvOffsetX);
+                            cb.mat_offset_uv.y = material->GetProperty(MaterialProperty::UvOffsetY);
+                        }
+                    }
+                    else if (job.pass == DrawPass::DepthPrepass)
+                    {
+                        // Alpha testing
+                        cb.transform           = transform->GetMatrix();
+                        cb.mat_color.w         = material->HasTexture(MaterialTexture::Color) ? 1.0f : 0.0f;
+                        cb.is_transparent_pass = material->HasTexture(MaterialTexture::AlphaMask);
+                    }
+                    else
+                    {
+                        if (material_index == 0 || material_bound_id != material->GetObjectId())
+                        {
+                            material_bound_id = material->GetObjectId();
+
+                            if (material_index + 1 < material_instances.size())
+                            {
+                                material_index++;
+                                material_instances[material_index] = material;
+                            }
+                            else
+                            {
+                                SP_LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
+                            }
+                        }
+
+                        cb.mat_id                                 = material_index;
+                        cb.mat_color.x                            = material->GetProperty(MaterialProperty::ColorR);
+                        cb.mat_color.y                            = material->GetProperty(MaterialProperty::ColorG);
+                        cb.mat_color.z                            = material->GetProperty(MaterialProperty::ColorB);
+                        cb.mat_color.w                            = material->GetProperty(MaterialProperty::ColorA);
+                        cb.mat_tiling_uv.x                        = material->GetProperty(MaterialProperty::UvTilingX);
+                        cb.mat_tiling_uv.y                        = material->GetProperty(MaterialProperty::UvTilingY);
+                        cb.mat_offset_uv.x                        = material->GetProperty(MaterialProperty::UvOffsetX);
+                        cb.mat_offset_uv.y                        = material->GetProperty(MaterialProperty::UvOffsetY);
+                        cb.mat_roughness_mul                      = material->GetProperty(MaterialProperty::RoughnessMultiplier);
+                        cb.mat_metallic_mul                       = material->GetProperty(MaterialProperty::MetallnessMultiplier);
+                        cb.mat_normal_mul                         = material->GetProperty(MaterialProperty::NormalMultiplier);
+                        cb.mat_height_mul                         = material->GetProperty(MaterialProperty::HeightMultiplier);
+                        cb.mat_single_texture_rougness_metalness  = material->GetProperty(MaterialProperty::SingleTextureRoughnessMetalness);
+                        cb.mat_textures                           = 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Height)     ? (1U << 0) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Normal)     ? (1U << 1) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Color)      ? (1U << 2) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Roughness)  ? (1U << 3) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Metallness) ? (1U << 4) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::AlphaMask)  ? (1U << 5) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Emission)   ? (1U << 6) : 0;
+                        cb.mat_textures                          |= material->HasTexture(MaterialTexture::Occlusion)  ? (1U << 7) : 0;
+
+                        // Instances read both transforms from the instance buffer, which was written before they are modified here
+                        cb.transform          = transform->GetMatrix();
+                        cb.transform_previous = transform->GetMatrixPrevious();
+
+                        // Save matrices for velocity computation
+                        for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+                        {
+                            Transform* batch_transform = list.entities[i]->GetTransform();
+                            batch_transform->SetMatrixPrevious(batch_transform->GetMatrix());
+                        }
+                    }
+                }
+            }
+        }, static_cast<uint32_t>(jobs.size()), 1);
+
+        // Upload everything at once, the passes only bind offsets into it
+        m_cb_draws_uploaded = false;
+        if (m_cb_draws_gpu && constant_count != 0)
+        {
+            if (m_cb_draws_gpu->Allocate(constant_count, m_cb_draws_offset))
+            {
+                m_cb_draws_gpu->Write(m_cb_draws_offset, m_draw_constants.data(), constant_count);
+                m_cb_draws_uploaded = true;
+
+                if (m_profiler)
+                {
+                    m_profiler->m_renderer_bytes_uploaded += constant_count * static_cast<uint32_t>(sizeof(Cb_Uber));
+                }
+            }
+            else if (m_cb_draws_required == 0)
+            {
+                // Out of memory, update per draw for now and grow when it's safe
+                m_cb_draws_required = Helper::Max(m_cb_draws_gpu->GetStrideCount() * 2, constant_count * 2);
+                SP_LOG_WARNING("Draw constant buffer overflow, %d constants don't fit", constant_count);
+            }
+        }
     }
 
     void Renderer::OnFullScreenToggled()
@@ -534,55 +1316,40 @@ namespace Spartan
 
     void Renderer::OnResourceSafe(RHI_CommandList* cmd_list)
     {
-        // Acquire renderables
-        if (m_add_new_entities)
+        // Acquire renderables, the world's events can set the flag from any thread
         {
-            // Clear previous state
-            m_entities.clear();
-            m_camera = nullptr;
+            lock_guard lock(m_mutex_entity_addition);
 
-            for (Entity* entity : m_entities_to_add)
+            if (m_entities_dirty)
             {
-                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                if (m_entities_rebuild)
                 {
-                    bool is_transparent = false;
-                    bool is_visible     = true;
-
-                    if (const Material* material = renderable->GetMaterial())
-                    {
-                        is_transparent = material->GetProperty(MaterialProperty::ColorA) < 1.0f;
-                        is_visible     = material->GetProperty(MaterialProperty::ColorA) != 0.0f;
-                    }
-
-                    if (is_visible)
-                    {
-                        m_entities[is_transparent ? RendererEntityType::GeometryTransparent : RendererEntityType::GeometryOpaque].emplace_back(entity);
-                    }
+                    m_entities.clear();
+                    m_entity_slots.clear();
+                    m_camera = nullptr;
                 }
 
-                if (Light* light = entity->GetComponent<Light>())
+                // Additions first, an entity can be added and then removed before we get to see it
+                for (const shared_ptr<Entity>& entity : m_entities_to_add)
                 {
-                    m_entities[RendererEntityType::Light].emplace_back(entity);
-                }
+                    SP_ASSERT_MSG(entity != nullptr, "Entity is null");
+                    SP_ASSERT_MSG(entity->IsActive(), "Entity is inactive");
 
-                if (Camera* camera = entity->GetComponent<Camera>())
-                {
-                    m_entities[RendererEntityType::Camera].emplace_back(entity);
-                    m_camera = camera->GetPtrShared<Camera>();
+                    // Changed entities are added again, so remove them first
+                    RemoveEntity(entity.get());
+                    AddEntity(entity.get());
                 }
 
-                if (ReflectionProbe* reflection_probe = entity->GetComponent<ReflectionProbe>())
+                for (const shared_ptr<Entity>& entity : m_entities_to_remove)
                 {
-                    m_entities[RendererEntityType::ReflectionProbe].emplace_back(entity);
+                    RemoveEntity(entity.get());
                 }
-            }
 
-            // Sort them by distance
-            SortRenderables(&m_entities[RendererEntityType::GeometryOpaque]);
-            SortRenderables(&m_entities[RendererEntityType::GeometryTransparent]);
-
-            m_entities_to_add.clear();
-            m_add_new_entities = false;
+                m_entities_to_add.clear();
+                m_entities_to_remove.clear();
+                m_entities_rebuild = false;
+                m_entities_dirty   = false;
+            }
         }
 
         // Handle environment texture assignment requests
@@ -641,25 +1408,90 @@ namespace Spartan
         }
     }
 
-    void Renderer::SortRenderables(vector<Entity*>* renderables)
+    void Renderer::AddEntity(Entity* entity)
     {
-        if (!m_camera || renderables->size() <= 2)
-            return;
+        array<uint32_t, renderer_entity_type_count> slots;
+        slots.fill(numeric_limits<uint32_t>::max());
+        bool is_tracked = false;
+        auto add = [this, entity, &slots, &is_tracked](const RendererEntityType type)
+        {
+            vector<Entity*>& entities = m_entities[type];
+            slots[static_cast<uint32_t>(type)] = static_cast<uint32_t>(entities.size());
+            entities.emplace_back(entity);
+            is_tracked = true;
+        };
 
-        auto comparison_op = [this](Entity* entity)
+        if (Renderable* renderable = entity->GetComponent<Renderable>())
         {
-            auto renderable = entity->GetRenderable();
-            if (!renderable)
-                return 0.0f;
+            bool is_transparent = false;
+            bool is_visible     = true;
 
-            return (renderable->GetAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-        };
+            if (const Material* material = renderable->GetMaterial())
+            {
+                is_transparent = material->GetProperty(MaterialProperty::ColorA) < 1.0f;
+                is_visible     = material->GetProperty(MaterialProperty::ColorA) != 0.0f;
+            }
 
-        // Sort by depth (front to back)
-        sort(renderables->begin(), renderables->end(), [&comparison_op](Entity* a, Entity* b)
+            if (is_visible)
             {
-                return comparison_op(a) < comparison_op(b);
-            });
+                add(is_transparent ? RendererEntityType::GeometryTransparent : RendererEntityType::GeometryOpaque);
+            }
+        }
+
+        if (entity->GetComponent<Light>())
+        {
+            add(RendererEntityType::Light);
+        }
+
+        if (Camera* camera = entity->GetComponent<Camera>())
+        {
+            add(RendererEntityType::Camera);
+            m_camera = camera->GetPtrShared<Camera>();
+        }
+
+        if (entity->GetComponent<ReflectionProbe>())
+        {
+            add(RendererEntityType::ReflectionProbe);
+        }
+
+        if (is_tracked)
+        {
+            m_entity_slots[entity] = slots;
+        }
+    }
+
+    void Renderer::RemoveEntity(Entity* entity)
+    {
+        // Entities which are not in any bucket are not tracked, this keeps additions O(1)
+        auto it = m_entity_slots.find(entity);
+        if (it == m_entity_slots.end())
+            return;
+
+        const array<uint32_t, renderer_entity_type_count> slots = it->second;
+        m_entity_slots.erase(it);
+
+        for (uint32_t type = 0; type < renderer_entity_type_count; type++)
+        {
+            const uint32_t slot = slots[type];
+            if (slot == numeric_limits<uint32_t>::max())
+                continue;
+
+            // The draw order comes from the sort keys, so the bucket order doesn't matter, move the last one into the gap
+            vector<Entity*>& entities = m_entities[static_cast<RendererEntityType>(type)];
+            if (slot != entities.size() - 1)
+            {
+                entities[slot] = entities.back();
+                m_entity_slots[entities[slot]][type] = slot;
+            }
+            entities.pop_back();
+        }
+
+        // If this was the active camera, fall back to any other camera
+        if (m_camera && m_camera->GetEntity() == entity)
+        {
+            const vector<Entity*>& cameras = m_entities[RendererEntityType::Camera];
+            m_camera = cameras.empty() ? nullptr : cameras.back()->GetComponent<Camera>()->GetPtrShared<Camera>();
+        }
     }
 
     bool Renderer::IsCallingFromOtherThread()
@@ -785,6 +1617,12 @@ namespace Spartan
                     }
                 }
             }
+            // Options which enable or disable passes of the render graph
+            else if (option == RendererOption::DepthPrepass || option == RendererOption::Ssao || option == RendererOption::ScreenSpaceReflections ||
+                     option == RendererOption::DepthOfField || option == RendererOption::Bloom || option == RendererOption::MotionBlur)
+            {
+                m_render_graph_dirty = true;
+            }
             // Shadow resolution
             else if (option == RendererOption::ShadowResolution)
             {
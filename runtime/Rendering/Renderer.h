@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <array>
 #include <atomic>
 #include <thread>
+#include <functional>
 #include "Renderer_ConstantBuffers.h"
 #include "Material.h"
 #include "../Core/ISystem.h"
@@ -35,6 +36,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Math/Rectangle.h"
 #include "../Math/Plane.h"
 #include "Renderer_Definitions.h"
+#include "RenderGraph.h"
+#include "ShaderWatcher.h"
 //===================================
 
 namespace Spartan
@@ -49,6 +52,9 @@ namespace Spartan
     class Grid;
     class Profiler;
     class Environment;
+    class Culler;
+    class IComponent;
+    class Renderable;
     //====================
 
     namespace Math
@@ -93,6 +99,7 @@ namespace Spartan
         // Render targets
         std::shared_ptr<RHI_Texture> GetRenderTarget(const RendererTexture rt_enum) { return m_render_targets[static_cast<uint8_t>(rt_enum)]; }
         const auto& GetRenderTargets()                                              { return m_render_targets; }
+        const RenderGraph& GetRenderGraph() const                                   { return m_render_graph; }
 
         // Clear depth value
         float GetClearDepth() { return GetOption<bool>(RendererOption::ReverseZ) ? 0.0f : 1.0f; }
@@ -142,11 +149,50 @@ namespace Spartan
         void Pass_CopyToBackbuffer();
 
     private:
+        struct DrawItem
+        {
+            uint64_t key;
+            Entity* entity;
+        };
+
+        // A run of entities which share mesh, material and geometry range and can be drawn as one instanced draw
+        struct DrawBatch
+        {
+            uint32_t first;           // index into DrawList::entities
+            uint32_t count;
+            uint32_t instance_offset; // index into the instance buffer, only valid when count > 1
+            uint32_t range_first;     // index into DrawList::ranges
+            uint32_t range_count;     // 0 draws the renderable's whole index range
+        };
+
+        // The part of a renderable's index range which survived cluster culling
+        struct DrawRange
+        {
+            uint32_t index_offset;
+            uint32_t index_count;
+        };
+
+        struct DrawList
+        {
+            std::vector<Entity*> entities; // sorted by key, this is what the passes iterate
+            std::vector<DrawBatch> batches;
+            std::vector<DrawRange> ranges;
+            std::vector<DrawItem> items;
+            std::vector<DrawItem> items_scratch;
+            uint32_t instance_count    = 0;
+            uint32_t constants_depth   = 0; // index of the first batch's constants in m_draw_constants, for the depth prepass and shadow passes
+            uint32_t constants_gbuffer = 0; // same, for the g-buffer pass
+        };
+
         // Constant buffers
         void Update_Cb_Frame(RHI_CommandList* cmd_list);
         void Update_Cb_Uber(RHI_CommandList* cmd_list);
         void Update_Cb_Light(RHI_CommandList* cmd_list, const Light* light, const RHI_Shader_Type scope);
         void Update_Cb_Material(RHI_CommandList* cmd_list);
+        void Bind_Cb_Draw(RHI_CommandList* cmd_list, const uint32_t index);
+
+        // Draws a batch's geometry, only its visible index ranges when it was cluster culled
+        void DrawBatchIndexed(RHI_CommandList* cmd_list, const DrawList& list, const DrawBatch& batch, const Renderable* renderable) const;
 
         // Resource creation
         void CreateConstantBuffers();
@@ -161,6 +207,28 @@ namespace Spartan
         void CreateSamplers(const bool create_only_anisotropic = false);
         void CreateRenderTextures(const bool create_render, const bool create_output, const bool create_fixed, const bool create_dynamic);
 
+        // Render graph, it decides which render targets exist, which of them share memory and the layouts they need before each pass
+        void CompileRenderGraph();
+        void SetGraphLayouts(RHI_CommandList* cmd_list, const RendererPass pass);
+
+        // Pipeline manifest, the pipeline states of a run, so that the next run can create them before its first frame
+        struct PipelineManifestObjects;
+        PipelineManifestObjects GetPipelineManifestObjects() const;
+        void SavePipelineManifest();
+        void PrewarmPipelines();
+
+        // Culling
+        void Cull();
+        void CullClusters(DrawList& list) const;
+        void PrepareDraws();
+        const DrawList& GetDrawList(const IComponent* view_owner, const uint32_t view_offset, const bool is_transparent);
+        const std::vector<Entity*>& GetVisibleEntities(const IComponent* view_owner, const uint32_t view_offset, const bool is_transparent) { return GetDrawList(view_owner, view_offset, is_transparent).entities; }
+
+        // Recording, the batches of render passes are split across threads (into secondary command lists) when there are enough of them.
+        // record() is called after the pipeline state is set, with a range of the pass's batches, and it can only bind what PrepareDraws() uploaded.
+        using RecordFunction = std::function<void(RHI_CommandList* cmd_list, uint32_t pass_index, uint32_t batch_start, uint32_t batch_end)>;
+        void RecordRenderPasses(RHI_CommandList* cmd_list, std::vector<RHI_PipelineState>& psos, const std::vector<uint32_t>& batch_counts, const RecordFunction& record);
+
         // Passes
         void Pass_Main(RHI_CommandList* cmd_list);
         void Pass_ShadowMaps(RHI_CommandList* cmd_list, const bool is_transparent_pass);
@@ -196,12 +264,15 @@ namespace Spartan
         void Pass_Ffx_Fsr2(RHI_CommandList* cmd_list, RHI_Texture* tex_in, RHI_Texture* tex_out);
 
         // Event handlers
-        void OnAddRenderables(const Variant& renderables);
+        void OnWorldResolved(const Variant& entities);
+        void OnEntitiesAdded(const Variant& entities);
+        void OnEntitiesRemoved(const Variant& entities);
         void OnClear();
         void OnFullScreenToggled();
 
         // Misc
-        void SortRenderables(std::vector<Entity*>* renderables);
+        void AddEntity(Entity* entity);
+        void RemoveEntity(Entity* entity);
         bool IsCallingFromOtherThread();
         void OnResourceSafe(RHI_CommandList* cmd_list);
 
@@ -211,9 +282,19 @@ namespace Spartan
 
         // Render targets
         std::array<std::shared_ptr<RHI_Texture>, 25> m_render_targets;
+        std::array<RenderGraphTextureDesc, 25> m_render_target_descs;
+
+        // Render graph
+        RenderGraph m_render_graph;
+        std::vector<std::shared_ptr<RHI_Texture>> m_render_graph_textures; // per physical texture
+        bool m_render_graph_dirty = false;
 
         // Shaders
         std::array<std::shared_ptr<RHI_Shader>, 47> m_shaders;
+        Stopwatch m_shaders_stopwatch; // time until every shader is ready, to compare cold and warm shader cache startups
+        bool m_shaders_ready = false;
+        uint64_t m_shaders_ready_frame = 0;
+        ShaderWatcher m_shader_watcher;
 
         // Standard textures
         std::shared_ptr<RHI_Texture> m_tex_default_noise_normal;
@@ -265,10 +346,18 @@ namespace Spartan
 
         Cb_Material m_cb_material_cpu;
         std::shared_ptr<RHI_ConstantBuffer> m_cb_material_gpu;
+
+        // Per draw constants, prepared before recording and bound by offset (null when the api can't bind offsets)
+        std::vector<Cb_Uber> m_draw_constants;
+        std::shared_ptr<RHI_ConstantBuffer> m_cb_draws_gpu;
+        uint32_t m_cb_draws_offset   = 0;     // offset of m_draw_constants[0] in m_cb_draws_gpu
+        uint32_t m_cb_draws_required = 0;     // element count to grow to at the next safe point, after an overflow
+        bool m_cb_draws_uploaded     = false; // when false, draws fall back to updating the uber buffer
         //====================================================
 
         // Structured buffers
         std::shared_ptr<RHI_StructuredBuffer> m_sb_spd_counter;
+        std::shared_ptr<RHI_StructuredBuffer> m_sb_instances; // null when the api can't instance
 
         // Line rendering
         std::shared_ptr<RHI_VertexBuffer> m_vertex_buffer_lines;
@@ -330,19 +419,33 @@ namespace Spartan
         std::shared_ptr<RHI_Device> m_rhi_device;
         RHI_CommandPool* m_cmd_pool    = nullptr;
         RHI_CommandList* m_cmd_current = nullptr;
+        uint32_t m_cmd_secondary_index = 0; // secondary command lists acquired from m_cmd_pool this frame
+        static const uint32_t m_record_parallel_batch_min = 64; // chunks of fewer batches aren't worth a secondary command list
 
         // Swapchain
         static const uint8_t m_swap_chain_buffer_count = 2;
         std::shared_ptr<RHI_SwapChain> m_swap_chain;
 
         // Entity references
-        std::vector<Entity*> m_entities_to_add;
-        bool m_add_new_entities = false;
+        std::vector<std::shared_ptr<Entity>> m_entities_to_add;
+        std::vector<std::shared_ptr<Entity>> m_entities_to_remove; // kept alive until they are out of m_entities
+        bool m_entities_rebuild = false;
+        bool m_entities_dirty   = false;
         std::unordered_map<RendererEntityType, std::vector<Entity*>> m_entities;
+        std::unordered_map<Entity*, std::array<uint32_t, renderer_entity_type_count>> m_entity_slots; // entity -> its index in each RendererEntityType bucket, max if it's not in it
         std::array<Material*, m_max_material_instances> m_material_instances;
+        std::array<std::array<Material*, m_max_material_instances>, 2> m_material_instances_gbuffer; // opaque and transparent, as prepared for the g-buffer passes
         std::shared_ptr<Camera> m_camera;
         Environment* m_environment = nullptr;
 
+        // Visibility, computed once per frame for every view (camera, light slices, probe faces)
+        std::unique_ptr<Culler> m_culler;
+        std::vector<Entity*> m_cull_entities;                         // box index -> entity
+        uint32_t m_cull_transparent_start = 0;                        // index of the first transparent box
+        std::unordered_map<const IComponent*, uint32_t> m_cull_views; // view owner -> index of its first view
+        std::vector<std::array<DrawList, 2>> m_visible;               // view index -> visible opaque and transparent entities
+        std::vector<Sb_Instance> m_instances;                         // instance data of every view, uploaded once per frame
+
         // Sync objects
         std::mutex m_mutex_entity_addition;
         std::mutex m_mutex_mip_generation;
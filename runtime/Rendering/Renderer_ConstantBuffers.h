@@ -158,7 +158,9 @@ namespace Spartan
         uint32_t work_group_count = 0;
 
         uint32_t reflection_proble_available = 0;
-        Math::Vector3 padding                = Math::Vector3::Zero;
+        uint32_t is_instanced                = 0;
+        uint32_t instance_offset             = 0;
+        float padding                        = 0.0f;
 
         bool operator==(const Cb_Uber& rhs) const
         {
@@ -182,6 +184,8 @@ namespace Spartan
                 mip_count                             == rhs.mip_count                   &&
                 work_group_count                      == rhs.work_group_count            &&
                 reflection_proble_available           == rhs.reflection_proble_available &&
+                is_instanced                          == rhs.is_instanced                &&
+                instance_offset                       == rhs.instance_offset             &&
                 radius                                == rhs.radius                      &&
                 extents                               == rhs.extents                     &&
                 mat_textures                          == rhs.mat_textures                &&
@@ -191,6 +195,14 @@ namespace Spartan
         bool operator!=(const Cb_Uber& rhs) const { return !(*this == rhs); }
     };
     
+    // Instance buffer element - read by the vertex shader via SV_InstanceID
+    static const uint32_t max_instances = 8192; // per frame
+    struct Sb_Instance
+    {
+        Math::Matrix transform;
+        Math::Matrix transform_previous;
+    };
+
     // Light buffer
     struct Cb_Light
     {
@@ -146,7 +146,8 @@ namespace Spartan
         tex              = 33,
         tex2             = 34,
         font_atlas       = 35,
-        reflection_probe = 36
+        reflection_probe = 36,
+        instances        = 37
     };
 
     enum class RendererBindingsUav
@@ -235,6 +236,29 @@ namespace Spartan
         Bloom,
         Blur
     };
+
+    // The passes of the render graph, in the order they execute
+    enum class RendererPass : uint8_t
+    {
+        BrdfSpecularLut,
+        Depth_Prepass,
+        GBuffer,
+        Ssao,
+        Ssr,
+        Light,
+        Light_Composition,
+        Light_ImageBased,
+        Frame_Copy, // what transparent surfaces refract
+        GBuffer_Transparent,
+        Light_Transparent,
+        Light_Composition_Transparent,
+        Light_ImageBased_Transparent,
+        DepthOfField,
+        Upsample,
+        Bloom,
+        PostProcess,
+        Editor
+    };
     
     enum class RendererEntityType
     {
@@ -244,4 +268,6 @@ namespace Spartan
         Camera,
         ReflectionProbe
     };
+
+    const uint32_t renderer_entity_type_count = static_cast<uint32_t>(RendererEntityType::ReflectionProbe) + 1;
 }
@@ -107,6 +107,7 @@ namespace Spartan
                 // Generate brdf specular lut
                 if (!m_brdf_specular_lut_rendered)
                 {
+                    SetGraphLayouts(cmd_list, RendererPass::BrdfSpecularLut);
                     Pass_BrdfSpecularLut(cmd_list);
                     m_brdf_specular_lut_rendered = true;
                 }
@@ -129,12 +130,19 @@ namespace Spartan
                 {
                     bool is_transparent_pass = false;
 
+                    SetGraphLayouts(cmd_list, RendererPass::Depth_Prepass);
                     Pass_Depth_Prepass(cmd_list);
+                    SetGraphLayouts(cmd_list, RendererPass::GBuffer);
                     Pass_GBuffer(cmd_list, is_transparent_pass);
+                    SetGraphLayouts(cmd_list, RendererPass::Ssao);
                     Pass_Ssao(cmd_list);
+                    SetGraphLayouts(cmd_list, RendererPass::Ssr);
                     Pass_Ssr(cmd_list, rt1);
+                    SetGraphLayouts(cmd_list, RendererPass::Light);
                     Pass_Light(cmd_list, is_transparent_pass); // compute diffuse and specular buffers
+                    SetGraphLayouts(cmd_list, RendererPass::Light_Composition);
                     Pass_Light_Composition(cmd_list, rt1, is_transparent_pass); // compose diffuse, specular, ssao, volumetric etc.
+                    SetGraphLayouts(cmd_list, RendererPass::Light_ImageBased);
                     Pass_Light_ImageBased(cmd_list, rt1, is_transparent_pass); // apply IBL and SSR
                 }
 
@@ -142,6 +150,7 @@ namespace Spartan
                 if (do_transparent_pass)
                 {
                     // Blit the frame so that refraction can sample from it
+                    SetGraphLayouts(cmd_list, RendererPass::Frame_Copy);
                     cmd_list->Blit(rt1, rt2, true);
 
                     // Generate frame mips so that the reflections can simulate roughness
@@ -158,9 +167,13 @@ namespace Spartan
 
                     bool is_transparent_pass = true;
 
+                    SetGraphLayouts(cmd_list, RendererPass::GBuffer_Transparent);
                     Pass_GBuffer(cmd_list, is_transparent_pass);
+                    SetGraphLayouts(cmd_list, RendererPass::Light_Transparent);
                     Pass_Light(cmd_list, is_transparent_pass);
+                    SetGraphLayouts(cmd_list, RendererPass::Light_Composition_Transparent);
                     Pass_Light_Composition(cmd_list, rt1, is_transparent_pass);
+                    SetGraphLayouts(cmd_list, RendererPass::Light_ImageBased_Transparent);
                     Pass_Light_ImageBased(cmd_list, rt1, is_transparent_pass);
                 }
 
@@ -168,6 +181,7 @@ namespace Spartan
             }
 
             // Editor related stuff - Passes that render on top of each other
+            SetGraphLayouts(cmd_list, RendererPass::Editor);
             Pass_DebugMeshes(cmd_list, rt_output);
             Pass_Outline(cmd_list, rt_output);
             Pass_Icons(cmd_list, rt_output);
@@ -185,6 +199,26 @@ namespace Spartan
         rt_output->SetLayout(RHI_Image_Layout::Shader_Read_Only_Optimal, cmd_list);
     }
 
+    void Renderer::SetGraphLayouts(RHI_CommandList* cmd_list, const RendererPass pass)
+    {
+        // Move every texture the pass is about to access to the layout it needs, with a single barrier
+        const vector<RenderGraphTransition>& transitions = m_render_graph.GetTransitions(static_cast<uint32_t>(pass));
+        if (transitions.empty())
+            return;
+
+        vector<RHI_Texture*> textures;
+        vector<RHI_Image_Layout> layouts;
+        textures.reserve(transitions.size());
+        layouts.reserve(transitions.size());
+        for (const RenderGraphTransition& transition : transitions)
+        {
+            textures.emplace_back(m_render_graph_textures[transition.physical].get());
+            layouts.emplace_back(transition.layout);
+        }
+
+        RHI_Texture::SetLayouts(textures, layouts, cmd_list);
+    }
+
     void Renderer::Pass_ShadowMaps(RHI_CommandList* cmd_list, const bool is_transparent_pass)
     {
         // All objects are rendered from the lights point of view.
@@ -204,7 +238,10 @@ namespace Spartan
 
         cmd_list->BeginTimeblock(is_transparent_pass ? "shadow_maps_color" : "shadow_maps_depth");
 
-        // Go through all of the lights
+        // Gather a render pass for every slice of every light
+        vector<RHI_PipelineState> psos;
+        vector<uint32_t> batch_counts;
+        vector<const DrawList*> draw_lists;
         const auto& entities_light = m_entities[RendererEntityType::Light];
         for (uint32_t light_index = 0; light_index < entities_light.size(); light_index++)
         {
@@ -229,7 +266,7 @@ namespace Spartan
                 continue;
 
             // Define pipeline state
-            static RHI_PipelineState pso;
+            RHI_PipelineState pso;
             pso.shader_vertex                   = shader_v;
             pso.shader_pixel                    = is_transparent_pass ? shader_p : nullptr;
             pso.blend_state                     = is_transparent_pass ? m_blend_alpha.get() : m_blend_disabled.get();
@@ -242,6 +279,11 @@ namespace Spartan
 
             for (uint32_t array_index = 0; array_index < tex_depth->GetArrayLength(); array_index++)
             {
+                // Skip slices with nothing to render
+                const DrawList& draw_list = GetDrawList(light, array_index, is_transparent_pass);
+                if (draw_list.batches.empty())
+                    continue;
+
                 // Set render target texture array index
                 pso.render_target_color_texture_array_index         = array_index;
                 pso.render_target_depth_stencil_texture_array_index = array_index;
@@ -250,8 +292,6 @@ namespace Spartan
                 pso.clear_color[0] = Color::standard_white;
                 pso.clear_depth    = is_transparent_pass ? rhi_depth_load : GetClearDepth();
 
-                const Matrix& view_projection = light->GetViewMatrix(array_index) * light->GetProjectionMatrix(array_index);
-
                 // Set appropriate rasterizer state
                 if (light->GetLightType() == LightType::Directional)
                 {
@@ -265,89 +305,69 @@ namespace Spartan
                     pso.rasterizer_state = m_rasterizer_light_point_spot.get();
                 }
 
-                // Set pipeline state
-                cmd_list->SetPipelineState(pso);
+                psos.emplace_back(pso);
+                batch_counts.emplace_back(static_cast<uint32_t>(draw_list.batches.size()));
+                draw_lists.emplace_back(&draw_list);
+            }
+        }
 
-                // State tracking
-                bool render_pass_active    = false;
-                uint64_t m_set_material_id = 0;
+        // The slices are independent, so they (and their batches) can be recorded on any thread
+        RecordRenderPasses(cmd_list, psos, batch_counts, [this, &draw_lists, is_transparent_pass](RHI_CommandList* cmd_list, uint32_t pass_index, uint32_t batch_start, uint32_t batch_end)
+        {
+            if (m_sb_instances)
+            {
+                cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_sb_instances);
+            }
 
-                for (Entity * entity : entities)
-                {
-                    // Acquire renderable component
-                    Renderable* renderable = entity->GetRenderable();
-                    if (!renderable)
-                        continue;
-
-                    // Skip meshes that don't cast shadows
-                    if (!renderable->GetCastShadows())
-                        continue;
-
-                    // Acquire geometry
-                    Mesh* mesh = renderable->GetMesh();
-                    if (!mesh || !mesh->GetVertexBuffer() || !mesh->GetIndexBuffer())
-                        continue;
-
-                    // Acquire material
-                    Material* material = renderable->GetMaterial();
-                    if (!material)
-                        continue;
-
-                    // Skip objects outside of the view frustum
-                    if (!light->IsInViewFrustum(renderable, array_index))
-                        continue;
-
-                    if (!render_pass_active)
-                    {
-                        cmd_list->BeginRenderPass();
-                        render_pass_active = true;
-                    }
+            // State tracking
+            uint64_t m_set_material_id = 0;
 
-                    // Bind material (only for transparents)
-                    if (is_transparent_pass && m_set_material_id != material->GetObjectId())
-                    {
-                        // Bind material textures
-                        RHI_Texture* tex_albedo = material->GetTexture(MaterialTexture::Color);
-                        cmd_list->SetTexture(RendererBindingsSrv::tex, tex_albedo ? tex_albedo : m_tex_default_white.get());
-
-                        // Set uber buffer with material properties
-                        m_cb_uber_cpu.mat_color = Vector4(
-                            material->GetProperty(MaterialProperty::ColorR),
-                            material->GetProperty(MaterialProperty::ColorG),
-                            material->GetProperty(MaterialProperty::ColorB),
-                            material->GetProperty(MaterialProperty::ColorA)
-                        );
-
-                        m_cb_uber_cpu.mat_tiling_uv = Vector2(
-                            material->GetProperty(MaterialProperty::UvTilingX),
-                            material->GetProperty(MaterialProperty::UvTilingY)
-                        );
-
-                        m_cb_uber_cpu.mat_offset_uv = Vector2(
-                            material->GetProperty(MaterialProperty::UvOffsetX),
-                            material->GetProperty(MaterialProperty::UvOffsetY)
-                        );
-
-                        m_set_material_id = material->GetObjectId();
-                    }
+            const DrawList& draw_list = *draw_lists[pass_index];
+            for (uint32_t batch_index = batch_start; batch_index < batch_end; batch_index++)
+            {
+                const DrawBatch& batch = draw_list.batches[batch_index];
+                Entity* entity         = draw_list.entities[batch.first];
 
-                    // Bind geometry
-                    cmd_list->SetBufferIndex(mesh->GetIndexBuffer());
-                    cmd_list->SetBufferVertex(mesh->GetVertexBuffer());
+                // Acquire renderable component
+                Renderable* renderable = entity->GetRenderable();
+                if (!renderable)
+                    continue;
 
-                    // Set uber buffer with cascade transform
-                    m_cb_uber_cpu.transform = entity->GetTransform()->GetMatrix() * view_projection;
-                    Update_Cb_Uber(cmd_list);
+                // Skip meshes that don't cast shadows
+                if (!renderable->GetCastShadows())
+                    continue;
 
-                    cmd_list->DrawIndexed(renderable->GetIndexCount(), renderable->GetIndexOffset(), renderable->GetVertexOffset());
-                }
+                // Acquire geometry
+                Mesh* mesh = renderable->GetMesh();
+                if (!mesh || !mesh->GetVertexBuffer() || !mesh->GetIndexBuffer())
+                    continue;
 
-                if (render_pass_active)
+                // Acquire material
+                Material* material = renderable->GetMaterial();
+                if (!material)
+                    continue;
+
+                // Bind material textures (only for transparents)
+                if (is_transparent_pass && m_set_material_id != material->GetObjectId())
                 {
-                    cmd_list->EndRenderPass();
+                    RHI_Texture* tex_albedo = material->GetTexture(MaterialTexture::Color);
+                    cmd_list->SetTexture(RendererBindingsSrv::tex, tex_albedo ? tex_albedo : m_tex_default_white.get());
+
+                    m_set_material_id = material->GetObjectId();
                 }
+
+                // Bind geometry
+                cmd_list->SetBufferIndex(mesh->GetIndexBuffer());
+                cmd_list->SetBufferVertex(mesh->GetVertexBuffer());
+
+                // Bind the cascade transform and material properties, prepared ahead
+                Bind_Cb_Draw(cmd_list, draw_list.constants_depth + batch_index);
+
+                DrawBatchIndexed(cmd_list, draw_list, batch, renderable);
             }
-        }
+        });
+
+        m_cb_uber_cpu.is_instanced = 0;
 
         cmd_list->EndTimeblock();
     }
@@ -416,10 +436,9 @@ namespace Spartan
                 // Compute view projection matrix
                 Matrix view_projection = probe->GetViewMatrix(face_index) * probe->GetProjectionMatrix();
 
-                // For each renderable entity
-                for (uint32_t index_renderable = 0; index_renderable < static_cast<uint32_t>(renderables.size()); index_renderable++)
+                // For each visible renderable entity
+                for (Entity* entity : GetVisibleEntities(probe, face_index, false))
                 {
-                    Entity* entity = renderables[index_renderable];
 
                     // For each light entity
                     for (uint32_t index_light = 0; index_light < static_cast<uint32_t>(lights.size()); index_light++)
@@ -443,10 +462,6 @@ namespace Spartan
                                 if (!mesh || !mesh->GetVertexBuffer() || !mesh->GetIndexBuffer())
                                     continue;
 
-                                // Skip objects outside of the view frustum
-                                if (!probe->IsInViewFrustum(renderable, face_index))
-                                    continue;
-
                                 // Set geometry (will only happen if not already set)
                                 cmd_list->SetBufferIndex(mesh->GetIndexBuffer());
                                 cmd_list->SetBufferVertex(mesh->GetVertexBuffer());
@@ -475,7 +490,7 @@ namespace Spartan
                                 // Update light buffer
                                 Update_Cb_Light(cmd_list, light, RHI_Shader_Pixel);
 
-                                cmd_list->DrawIndexed(renderable->GetIndexCount(), renderable->GetIndexOffset(), renderable->GetVertexOffset());
+                                cmd_list->DrawIndexed(renderable->GetLodIndexCount(), renderable->GetLodIndexOffset(), renderable->GetVertexOffset());
                             }
                         }
                     }
@@ -501,7 +516,7 @@ namespace Spartan
         cmd_list->BeginTimeblock("depth_prepass");
 
         RHI_Texture* tex_depth = render_target(RendererTexture::Gbuffer_Depth).get();
-        const vector<Entity*> entities = m_entities[RendererEntityType::GeometryOpaque];
+        const DrawList& draw_list = GetDrawList(m_camera.get(), 0, false);
 
         // Define pipeline state
         static RHI_PipelineState pso;
@@ -515,18 +530,24 @@ namespace Spartan
         pso.viewport                    = tex_depth->GetViewport();
         pso.primitive_topology          = RHI_PrimitiveTopology_Mode::TriangleList;
 
-        // Set pipeline state
-        cmd_list->SetPipelineState(pso);
+        // Render, the batches can be recorded on any thread
+        vector<RHI_PipelineState> psos = { pso };
+        RecordRenderPasses(cmd_list, psos, { static_cast<uint32_t>(draw_list.batches.size()) }, [this, &draw_list](RHI_CommandList* cmd_list, uint32_t pass_index, uint32_t batch_start, uint32_t batch_end)
+        {
+            if (m_sb_instances)
+            {
+                cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_sb_instances);
+            }
 
-        // Render
-        cmd_list->BeginRenderPass();
-        { 
             // Variables that help reduce state changes
             uint64_t currently_bound_geometry = 0;
-            
+
             // Draw opaque
-            for (const Entity* entity : entities)
+            for (uint32_t batch_index = batch_start; batch_index < batch_end; batch_index++)
             {
+                const DrawBatch& batch = draw_list.batches[batch_index];
+                const Entity* entity   = draw_list.entities[batch.first];
+
                 // Get renderable
                 Renderable* renderable = entity->GetRenderable();
                 if (!renderable)
@@ -547,10 +568,6 @@ namespace Spartan
                 if (!transform)
                     continue;
 
-                // Skip objects outside of the view frustum
-                if (!m_camera->IsInViewFrustum(renderable))
-                    continue;
-            
                 // Bind geometry
                 if (currently_bound_geometry != mesh->GetObjectId())
                 {
@@ -563,18 +580,15 @@ namespace Spartan
                 cmd_list->SetTexture(RendererBindingsSrv::material_albedo,  material->GetTexture(MaterialTexture::Color));
                 cmd_list->SetTexture(RendererBindingsSrv::material_mask,    material->GetTexture(MaterialTexture::AlphaMask));
 
-                // Set uber buffer
-                m_cb_uber_cpu.transform           = transform->GetMatrix();
-                m_cb_uber_cpu.mat_color.w         = material->HasTexture(MaterialTexture::Color) ? 1.0f : 0.0f;
-                m_cb_uber_cpu.is_transparent_pass = material->HasTexture(MaterialTexture::AlphaMask);
-                Update_Cb_Uber(cmd_list);
+                // Bind the transform and alpha testing properties, prepared ahead
+                Bind_Cb_Draw(cmd_list, draw_list.constants_depth + batch_index);
             
                 // Draw
-                cmd_list->DrawIndexed(renderable->GetIndexCount(), renderable->GetIndexOffset(), renderable->GetVertexOffset());
+                DrawBatchIndexed(cmd_list, draw_list, batch, renderable);
             }
+        });
 
-            cmd_list->EndRenderPass();
-        }
+        m_cb_uber_cpu.is_instanced = 0;
 
         cmd_list->EndTimeblock();
     }
@@ -622,19 +636,27 @@ namespace Spartan
         pso.viewport                        = tex_albedo->GetViewport();
         pso.primitive_topology              = RHI_PrimitiveTopology_Mode::TriangleList;
 
-        // Set pipeline state
-        cmd_list->SetPipelineState(pso);
+        // Material instances were tracked while the draws were prepared (they get mapped to shaders)
+        m_material_instances = m_material_instances_gbuffer[is_transparent_pass ? 1 : 0];
 
-        uint32_t material_index    = 0;
-        uint64_t material_bound_id = 0;
-        m_material_instances.fill(nullptr);
-        auto& entities = m_entities[is_transparent_pass ? RendererEntityType::GeometryTransparent : RendererEntityType::GeometryOpaque];
+        const DrawList& draw_list = GetDrawList(m_camera.get(), 0, is_transparent_pass);
 
-        // Render
-        cmd_list->BeginRenderPass();
+        // Render, the batches can be recorded on any thread
+        vector<RHI_PipelineState> psos = { pso };
+        RecordRenderPasses(cmd_list, psos, { static_cast<uint32_t>(draw_list.batches.size()) }, [this, &draw_list](RHI_CommandList* cmd_list, uint32_t pass_index, uint32_t batch_start, uint32_t batch_end)
         {
-            for (Entity* entity : entities)
+            if (m_sb_instances)
+            {
+                cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_sb_instances);
+            }
+
+            uint64_t material_bound_id = 0;
+            uint32_t meshes_rendered   = 0;
+            for (uint32_t batch_index = batch_start; batch_index < batch_end; batch_index++)
             {
+                const DrawBatch& batch = draw_list.batches[batch_index];
+                Entity* entity         = draw_list.entities[batch.first];
+
                 // Get renderable
                 Renderable* renderable = entity->GetRenderable();
                 if (!renderable)
@@ -650,36 +672,15 @@ namespace Spartan
                 if (!mesh || !mesh->GetVertexBuffer() || !mesh->GetIndexBuffer())
                     continue;
 
-                // Skip objects outside of the view frustum
-                if (!m_camera->IsInViewFrustum(renderable))
-                    continue;
-
                 // Set geometry (will only happen if not already set)
                 cmd_list->SetBufferIndex(mesh->GetIndexBuffer());
                 cmd_list->SetBufferVertex(mesh->GetVertexBuffer());
 
-                // Bind material
-                const bool firs_run = material_index == 0;
-                const bool new_material = material_bound_id != material->GetObjectId();
-                if (firs_run || new_material)
+                // Bind material textures
+                if (material_bound_id != material->GetObjectId())
                 {
                     material_bound_id = material->GetObjectId();
 
-                    // Keep track of used material instances (they get mapped to shaders)
-                    if (material_index + 1 < m_material_instances.size())
-                    {
-                        // Advance index (0 is reserved for the sky)
-                        material_index++;
-
-                        // Keep reference
-                        m_material_instances[material_index] = material;
-                    }
-                    else
-                    {
-                        SP_LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
-                    }
-
-                    // Bind material textures
                     cmd_list->SetTexture(RendererBindingsSrv::material_albedo,    material->GetTexture(MaterialTexture::Color));
                     cmd_list->SetTexture(RendererBindingsSrv::material_roughness, material->GetTexture(MaterialTexture::Roughness));
                     cmd_list->SetTexture(RendererBindingsSrv::material_metallic,  material->GetTexture(MaterialTexture::Metallness));
@@ -688,57 +689,23 @@ namespace Spartan
                     cmd_list->SetTexture(RendererBindingsSrv::material_occlusion, material->GetTexture(MaterialTexture::Occlusion));
                     cmd_list->SetTexture(RendererBindingsSrv::material_emission,  material->GetTexture(MaterialTexture::Emission));
                     cmd_list->SetTexture(RendererBindingsSrv::material_mask,      material->GetTexture(MaterialTexture::AlphaMask));
-
-                    // Set uber buffer with material properties
-                    m_cb_uber_cpu.mat_id                                 = material_index;
-                    m_cb_uber_cpu.mat_color.x                            = material->GetProperty(MaterialProperty::ColorR);
-                    m_cb_uber_cpu.mat_color.y                            = material->GetProperty(MaterialProperty::ColorG);
-                    m_cb_uber_cpu.mat_color.z                            = material->GetProperty(MaterialProperty::ColorB);
-                    m_cb_uber_cpu.mat_color.w                            = material->GetProperty(MaterialProperty::ColorA);
-                    m_cb_uber_cpu.mat_tiling_uv.x                        = material->GetProperty(MaterialProperty::UvTilingX);
-                    m_cb_uber_cpu.mat_tiling_uv.y                        = material->GetProperty(MaterialProperty::UvTilingY);
-                    m_cb_uber_cpu.mat_offset_uv.x                        = material->GetProperty(MaterialProperty::UvOffsetX);
-                    m_cb_uber_cpu.mat_offset_uv.y                        = material->GetProperty(MaterialProperty::UvOffsetY);
-                    m_cb_uber_cpu.mat_roughness_mul                      = material->GetProperty(MaterialProperty::RoughnessMultiplier);
-                    m_cb_uber_cpu.mat_metallic_mul                       = material->GetProperty(MaterialProperty::MetallnessMultiplier);
-                    m_cb_uber_cpu.mat_normal_mul                         = material->GetProperty(MaterialProperty::NormalMultiplier);
-                    m_cb_uber_cpu.mat_height_mul                         = material->GetProperty(MaterialProperty::HeightMultiplier);
-                    m_cb_uber_cpu.mat_single_texture_rougness_metalness  = material->GetProperty(MaterialProperty::SingleTextureRoughnessMetalness);
-                    m_cb_uber_cpu.mat_textures                           = 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Height)     ? (1U << 0) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Normal)     ? (1U << 1) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Color)      ? (1U << 2) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Roughness)  ? (1U << 3) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Metallness) ? (1U << 4) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::AlphaMask)  ? (1U << 5) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Emission)   ? (1U << 6) : 0;
-                    m_cb_uber_cpu.mat_textures                          |= material->HasTexture(MaterialTexture::Occlusion)  ? (1U << 7) : 0;
                 }
 
-                // Set uber buffer with entity transform
-                if (Transform* transform = entity->GetTransform())
-                {
-                    m_cb_uber_cpu.transform = transform->GetMatrix();
-                    m_cb_uber_cpu.transform_previous = transform->GetMatrixPrevious();
-
-                    // Save matrix for velocity computation
-                    transform->SetMatrixPrevious(m_cb_uber_cpu.transform);
-
-                    // Update object buffer
-                    Update_Cb_Uber(cmd_list);
-                }
+                // Bind the transforms and material properties, prepared ahead
+                Bind_Cb_Draw(cmd_list, draw_list.constants_gbuffer + batch_index);
 
                 // Render
-                cmd_list->DrawIndexed(renderable->GetIndexCount(), renderable->GetIndexOffset(), renderable->GetVertexOffset());
+                DrawBatchIndexed(cmd_list, draw_list, batch, renderable);
+                meshes_rendered += batch.count;
+            }
 
-                if (m_profiler)
-                {
-                    m_profiler->m_renderer_meshes_rendered++;
-                }
+            if (m_profiler)
+            {
+                m_profiler->m_renderer_meshes_rendered += meshes_rendered;
             }
+        });
 
-            cmd_list->EndRenderPass();
-        }
+        m_cb_uber_cpu.is_instanced = 0;
 
         cmd_list->EndTimeblock();
     }
@@ -1293,10 +1260,12 @@ namespace Spartan
             if (GetOption<bool>(RendererOption::DepthOfField))
             {
                 swap_render = !swap_render;
+                SetGraphLayouts(cmd_list, RendererPass::DepthOfField);
                 Pass_DepthOfField(cmd_list, get_render_in, get_render_out);
             }
 
             // Line rendering (world grid, vectors, debugging etc)
+            SetGraphLayouts(cmd_list, RendererPass::Upsample);
             Pass_Lines(cmd_list, get_render_out);
         }
 
@@ -1339,10 +1308,12 @@ namespace Spartan
             if (GetOption<bool>(RendererOption::Bloom))
             {
                 swap_output = !swap_output;
+                SetGraphLayouts(cmd_list, RendererPass::Bloom);
                 Pass_Bloom(cmd_list, get_output_in, get_output_out);
             }
 
             // Tone-Mapping & Gamma Correction
+            SetGraphLayouts(cmd_list, RendererPass::PostProcess);
             swap_output = !swap_output;
             Pass_ToneMappingGammaCorrection(cmd_list, get_output_in, get_output_out);
 
@@ -41,6 +41,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_TextureCube.h"
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_FSR2.h"
+#include "../RHI/RHI_CommandList.h"
+#include "../IO/FileStream.h"
 //=======================================
 
 //= NAMESPACES ===============
@@ -48,11 +50,84 @@ using namespace std;
 using namespace Spartan::Math;
 //============================
 
-#define render_target(rt_enum) m_render_targets[static_cast<uint8_t>(rt_enum)]
-#define shader(rt_enum)        m_shaders[static_cast<uint8_t>(rt_enum)]
+#define render_target(rt_enum)      m_render_targets[static_cast<uint8_t>(rt_enum)]
+#define render_target_desc(rt_enum) m_render_target_descs[static_cast<uint8_t>(rt_enum)]
+#define shader(rt_enum)             m_shaders[static_cast<uint8_t>(rt_enum)]
 
 namespace Spartan
 {
+    // Bump when the manifest layout changes, or when the renderer's shaders, states or render targets are reordered
+    static const uint32_t pipeline_manifest_version = 1;
+    static const uint32_t pipeline_manifest_magic   = 0x5350504D; // "SPPM"
+    static const uint8_t pipeline_manifest_none     = 0xFF;
+
+    // What every entry takes on disk (indices, then the plain state), it has to match the writes in SavePipelineManifest()
+    static const uint64_t pipeline_manifest_entry_size =
+        (3 + 3 + rhi_max_render_target_count + 1) * sizeof(uint8_t) + // shaders, states, render targets (color and depth)
+        3 * sizeof(bool)                                             + // swapchain, dynamic scissor, vertex and index buffers
+        3 * sizeof(uint32_t)                                         + // array indices and primitive topology
+        10 * sizeof(float);                                            // viewport and scissor
+
+    // The objects a pipeline state can point to, the manifest stores indices into them as they are created in the same order every run
+    struct Renderer::PipelineManifestObjects
+    {
+        vector<RHI_Shader*> shaders;
+        vector<RHI_RasterizerState*> rasterizer_states;
+        vector<RHI_BlendState*> blend_states;
+        vector<RHI_DepthStencilState*> depth_stencil_states;
+        vector<RHI_Texture*> render_targets;
+        RHI_SwapChain* swap_chain = nullptr;
+    };
+
+    static string get_pipeline_manifest_file_path()
+    {
+        return ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache) + "\\pipelines.manifest";
+    }
+
+    template <typename T>
+    static bool to_manifest_index(const T* object, const vector<T*>& objects, uint8_t& index)
+    {
+        index = pipeline_manifest_none;
+        if (!object)
+            return true;
+
+        // Objects which belong to something else (a light, a reflection probe, the editor) won't exist in the next run
+        auto it = find(objects.begin(), objects.end(), object);
+        if (it == objects.end())
+            return false;
+
+        index = static_cast<uint8_t>(distance(objects.begin(), it));
+        return true;
+    }
+
+    template <typename T>
+    static bool from_manifest_index(const uint8_t index, const vector<T*>& objects, T*& object)
+    {
+        object = nullptr;
+        if (index == pipeline_manifest_none)
+            return true;
+
+        if (index >= objects.size())
+            return false;
+
+        object = objects[index];
+        return object != nullptr;
+    }
+
+    static RenderGraphTextureDesc describe(const uint32_t width, const uint32_t height, const uint32_t mips, const RHI_Format format, const uint32_t flags, const char* name, const bool persistent = false)
+    {
+        RenderGraphTextureDesc desc;
+        desc.name       = name;
+        desc.width      = width;
+        desc.height     = height;
+        desc.mips       = mips;
+        desc.format     = format;
+        desc.flags      = flags;
+        desc.persistent = persistent;
+
+        return desc;
+    }
+
     void Renderer::CreateConstantBuffers()
     {
         SP_ASSERT(m_rhi_device != nullptr);
@@ -71,12 +146,28 @@ namespace Spartan
 
         m_cb_material_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device.get(), "material");
         m_cb_material_gpu->Create<Cb_Material>(4096); // Nvidia failed to allocate beyond this point
+
+        // Linear arena for per draw constants, it grows when it overflows, d3d11 can't bind at an offset so it updates per draw
+        const RHI_Api_Type api_type = m_rhi_device->GetRhiApiType();
+        if (api_type == RHI_Api_Type::Vulkan || api_type == RHI_Api_Type::Null)
+        {
+            m_cb_draws_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device.get(), "draws");
+            m_cb_draws_gpu->Create<Cb_Uber>(offset_count);
+        }
     }
 
     void Renderer::CreateStructuredBuffers()
     {
         const uint32_t offset_count = 32;
         m_sb_spd_counter = make_shared<RHI_StructuredBuffer>(m_rhi_device.get(), static_cast<uint32_t>(sizeof(uint32_t)), offset_count, "spd_counter");
+
+        // One element holds a frame's worth of instances, d3d11 can't have strides that large so it doesn't instance
+        const RHI_Api_Type api_type = m_rhi_device->GetRhiApiType();
+        if (api_type == RHI_Api_Type::Vulkan || api_type == RHI_Api_Type::Null)
+        {
+            const uint32_t frame_count = 8;
+            m_sb_instances = make_shared<RHI_StructuredBuffer>(m_rhi_device.get(), static_cast<uint32_t>(sizeof(Sb_Instance)) * max_instances, frame_count, "instances");
+        }
     }
 
     void Renderer::CreateDepthStencilStates()
@@ -172,56 +263,58 @@ namespace Spartan
 
         // Notes.
         // Gbuffer_Normal: Any format with or below 8 bits per channel, will produce banding.
+        // The textures are only described here, the render graph decides which of them get created and which share memory.
+        // Persistent textures are read before they are written in a frame (history, output), so their contents have to survive.
+        const bool persistent = true;
 
         // Render resolution
         if (create_render)
         {
             // Frame (HDR) - Mips are used to emulate roughness when blending with transparent surfaces
-            render_target(RendererTexture::Frame_Render)   = make_unique<RHI_Texture2D>(m_context, width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews | RHI_Texture_ClearOrBlit, "rt_frame_render");
-            render_target(RendererTexture::Frame_Render_2) = make_unique<RHI_Texture2D>(m_context, width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews | RHI_Texture_ClearOrBlit, "rt_frame_render_2");
+            render_target_desc(RendererTexture::Frame_Render)   = describe(width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews | RHI_Texture_ClearOrBlit, "rt_frame_render", persistent);
+            render_target_desc(RendererTexture::Frame_Render_2) = describe(width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews | RHI_Texture_ClearOrBlit, "rt_frame_render_2");
 
             // G-Buffer
-            render_target(RendererTexture::Gbuffer_Albedo)   = make_shared<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R8G8B8A8_Unorm,     RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_albedo");
-            render_target(RendererTexture::Gbuffer_Normal)   = make_shared<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_normal");
-            render_target(RendererTexture::Gbuffer_Material) = make_shared<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R8G8B8A8_Unorm,     RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_material");
-            render_target(RendererTexture::Gbuffer_Velocity) = make_shared<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R16G16_Float,       RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_velocity");
-            render_target(RendererTexture::Gbuffer_Depth)    = make_shared<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_D32_Float,          RHI_Texture_Rt_DepthStencil | RHI_Texture_Rt_DepthStencilReadOnly | RHI_Texture_Srv, "rt_gbuffer_depth");
-
-            // Light
-            render_target(RendererTexture::Light_Diffuse)              = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_diffuse");
-            render_target(RendererTexture::Light_Diffuse_Transparent)  = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_diffuse_transparent");
-            render_target(RendererTexture::Light_Specular)             = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_specular");
-            render_target(RendererTexture::Light_Specular_Transparent) = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_specular_transparent");
-            render_target(RendererTexture::Light_Volumetric)           = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_volumetric");
+            render_target_desc(RendererTexture::Gbuffer_Albedo)   = describe(width_render, height_render, 1, RHI_Format_R8G8B8A8_Unorm,     RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_albedo");
+            render_target_desc(RendererTexture::Gbuffer_Normal)   = describe(width_render, height_render, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_normal");
+            render_target_desc(RendererTexture::Gbuffer_Material) = describe(width_render, height_render, 1, RHI_Format_R8G8B8A8_Unorm,     RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_material");
+            render_target_desc(RendererTexture::Gbuffer_Velocity) = describe(width_render, height_render, 1, RHI_Format_R16G16_Float,       RHI_Texture_Rt_Color        | RHI_Texture_Srv,                                       "rt_gbuffer_velocity");
+            render_target_desc(RendererTexture::Gbuffer_Depth)    = describe(width_render, height_render, 1, RHI_Format_D32_Float,          RHI_Texture_Rt_DepthStencil | RHI_Texture_Rt_DepthStencilReadOnly | RHI_Texture_Srv, "rt_gbuffer_depth");
+
+            // Light - The diffuse light of the previous frame is used by ssao gi
+            render_target_desc(RendererTexture::Light_Diffuse)              = describe(width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_diffuse", persistent);
+            render_target_desc(RendererTexture::Light_Diffuse_Transparent)  = describe(width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_diffuse_transparent");
+            render_target_desc(RendererTexture::Light_Specular)             = describe(width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_specular");
+            render_target_desc(RendererTexture::Light_Specular_Transparent) = describe(width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_specular_transparent");
+            render_target_desc(RendererTexture::Light_Volumetric)           = describe(width_render, height_render, 1, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_light_volumetric");
 
             // SSR - Mips are used to emulate roughness for surfaces which require it
-            render_target(RendererTexture::Ssr) = make_shared<RHI_Texture2D>(m_context, width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews, "rt_ssr");
+            render_target_desc(RendererTexture::Ssr) = describe(width_render, height_render, mip_count, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews, "rt_ssr");
 
             // SSAO
-            render_target(RendererTexture::Ssao)    = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R16G16B16A16_Snorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_ssao");
-            render_target(RendererTexture::Ssao_Gi) = make_unique<RHI_Texture2D>(m_context, width_render, height_render, 1, RHI_Format_R16G16B16A16_Snorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_ssao_gi");
+            render_target_desc(RendererTexture::Ssao)    = describe(width_render, height_render, 1, RHI_Format_R16G16B16A16_Snorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_ssao");
+            render_target_desc(RendererTexture::Ssao_Gi) = describe(width_render, height_render, 1, RHI_Format_R16G16B16A16_Snorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_ssao_gi");
 
             // Dof
-            render_target(RendererTexture::Dof_Half)   = make_unique<RHI_Texture2D>(m_context, width_render / 2, height_render / 2, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_dof_half");
-            render_target(RendererTexture::Dof_Half_2) = make_unique<RHI_Texture2D>(m_context, width_render / 2, height_render / 2, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_dof_half_2");
+            render_target_desc(RendererTexture::Dof_Half)   = describe(width_render / 2, height_render / 2, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_dof_half");
+            render_target_desc(RendererTexture::Dof_Half_2) = describe(width_render / 2, height_render / 2, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_dof_half_2");
         }
 
         // Output resolution
         if (create_output)
         {
             // Frame (LDR)
-            render_target(RendererTexture::Frame_Output)   = make_unique<RHI_Texture2D>(m_context, width_output, height_output, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_frame_output");
-            render_target(RendererTexture::Frame_Output_2) = make_unique<RHI_Texture2D>(m_context, width_output, height_output, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_frame_output_2");
+            render_target_desc(RendererTexture::Frame_Output)   = describe(width_output, height_output, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_frame_output", persistent);
+            render_target_desc(RendererTexture::Frame_Output_2) = describe(width_output, height_output, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Rt_Color | RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_ClearOrBlit, "rt_frame_output_2");
 
             // Bloom
-            render_target(RendererTexture::Bloom) = make_shared<RHI_Texture2D>(m_context, width_output, height_output, mip_count, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews, "rt_bloom");
+            render_target_desc(RendererTexture::Bloom) = describe(width_output, height_output, mip_count, RHI_Format_R11G11B10_Float, RHI_Texture_Uav | RHI_Texture_Srv | RHI_Texture_PerMipViews, "rt_bloom");
         }
 
         // Fixed resolution
         if (create_fixed)
         {
-            render_target(RendererTexture::Brdf_Specular_Lut) = make_unique<RHI_Texture2D>(m_context, 400, 400, 1, RHI_Format_R8G8_Unorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_brdf_specular_lut");
-            m_brdf_specular_lut_rendered = false;
+            render_target_desc(RendererTexture::Brdf_Specular_Lut) = describe(400, 400, 1, RHI_Format_R8G8_Unorm, RHI_Texture_Uav | RHI_Texture_Srv, "rt_brdf_specular_lut", persistent);
         }
 
         // Dynamic resolution
@@ -231,16 +324,263 @@ namespace Spartan
             bool is_output_larger = width_output > width_render && height_output > height_render;
             uint32_t width        = is_output_larger ? width_output : width_render;
             uint32_t height       = is_output_larger ? height_output : height_render;
-            render_target(RendererTexture::Blur) = make_unique<RHI_Texture2D>(m_context, width, height, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_blur");
+            render_target_desc(RendererTexture::Blur) = describe(width, height, 1, RHI_Format_R16G16B16A16_Float, RHI_Texture_Uav | RHI_Texture_Srv, "rt_blur");
         }
 
+        CompileRenderGraph();
+
         RHI_FSR2::OnResolutionChange(m_rhi_device.get(), m_resolution_render, m_resolution_output);
     }
 
+    void Renderer::CompileRenderGraph()
+    {
+        m_render_graph_dirty = false;
+
+        RenderGraph& graph = m_render_graph;
+        graph.Clear();
+
+        // Textures
+        array<uint32_t, 25> textures;
+        textures.fill(RenderGraph::invalid_index);
+        for (uint32_t i = 0; i < m_render_target_descs.size(); i++)
+        {
+            if (m_render_target_descs[i].width != 0)
+            {
+                textures[i] = graph.AddTexture(m_render_target_descs[i]);
+            }
+        }
+        auto texture = [&textures](const RendererTexture rt) { return textures[static_cast<uint8_t>(rt)]; };
+
+        const bool depth_prepass = GetOption<bool>(RendererOption::DepthPrepass);
+        const bool ssao          = GetOption<bool>(RendererOption::Ssao);
+        const bool ssr           = GetOption<bool>(RendererOption::ScreenSpaceReflections);
+        const bool dof           = GetOption<bool>(RendererOption::DepthOfField);
+        const bool bloom         = GetOption<bool>(RendererOption::Bloom);
+        const bool motion_blur   = GetOption<bool>(RendererOption::MotionBlur);
+
+        // The g-buffer, as sampled by the lighting passes
+        auto read_gbuffer = [&graph, &texture](const uint32_t pass)
+        {
+            graph.Read(pass, texture(RendererTexture::Gbuffer_Albedo));
+            graph.Read(pass, texture(RendererTexture::Gbuffer_Normal));
+            graph.Read(pass, texture(RendererTexture::Gbuffer_Material));
+            graph.Read(pass, texture(RendererTexture::Gbuffer_Depth));
+        };
+
+        // Passes, they have to be added in the order of RendererPass
+        uint32_t pass = graph.AddPass("brdf_specular_lut");
+        graph.Write(pass, texture(RendererTexture::Brdf_Specular_Lut));
+
+        pass = graph.AddPass("depth_prepass", depth_prepass);
+        graph.Write(pass, texture(RendererTexture::Gbuffer_Depth), RenderGraphAccess::DepthTarget);
+
+        pass = graph.AddPass("g_buffer");
+        graph.Write(pass, texture(RendererTexture::Gbuffer_Albedo),   RenderGraphAccess::ColorTarget);
+        graph.Write(pass, texture(RendererTexture::Gbuffer_Normal),   RenderGraphAccess::ColorTarget);
+        graph.Write(pass, texture(RendererTexture::Gbuffer_Material), RenderGraphAccess::ColorTarget);
+        graph.Write(pass, texture(RendererTexture::Gbuffer_Velocity), RenderGraphAccess::ColorTarget);
+        if (depth_prepass)
+        {
+            graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Depth), RenderGraphAccess::DepthTarget);
+        }
+        else
+        {
+            graph.Write(pass, texture(RendererTexture::Gbuffer_Depth), RenderGraphAccess::DepthTarget);
+        }
+
+        pass = graph.AddPass("ssao", ssao);
+        graph.Write(pass, texture(RendererTexture::Ssao));
+        graph.Write(pass, texture(RendererTexture::Ssao_Gi));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Albedo));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Normal));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Depth));
+        graph.Read(pass, texture(RendererTexture::Light_Diffuse)); // previous frame
+        graph.Write(pass, texture(RendererTexture::Blur));
+
+        pass = graph.AddPass("ssr", ssr);
+        graph.Write(pass, texture(RendererTexture::Ssr));
+        graph.Read(pass, texture(RendererTexture::Frame_Render)); // previous frame
+        read_gbuffer(pass);
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Velocity));
+        graph.Write(pass, texture(RendererTexture::Blur));
+
+        for (const bool is_transparent_pass : { false, true })
+        {
+            const RendererTexture light_diffuse  = is_transparent_pass ? RendererTexture::Light_Diffuse_Transparent  : RendererTexture::Light_Diffuse;
+            const RendererTexture light_specular = is_transparent_pass ? RendererTexture::Light_Specular_Transparent : RendererTexture::Light_Specular;
+
+            if (is_transparent_pass)
+            {
+                pass = graph.AddPass("frame_copy");
+                graph.Read(pass, texture(RendererTexture::Frame_Render), RenderGraphAccess::CopySrc);
+                graph.Write(pass, texture(RendererTexture::Frame_Render_2), RenderGraphAccess::CopyDst);
+                graph.Write(pass, texture(RendererTexture::Blur));
+
+                pass = graph.AddPass("g_buffer_transparent");
+                graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Albedo),   RenderGraphAccess::ColorTarget);
+                graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Normal),   RenderGraphAccess::ColorTarget);
+                graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Material), RenderGraphAccess::ColorTarget);
+                graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Velocity), RenderGraphAccess::ColorTarget);
+                graph.ReadWrite(pass, texture(RendererTexture::Gbuffer_Depth),    RenderGraphAccess::DepthTarget);
+            }
+
+            // The light buffers are cleared before they are written
+            pass = graph.AddPass(is_transparent_pass ? "light_transparent" : "light");
+            graph.Write(pass, texture(light_diffuse),                      RenderGraphAccess::CopyDst);
+            graph.Write(pass, texture(light_specular),                     RenderGraphAccess::CopyDst);
+            graph.Write(pass, texture(RendererTexture::Light_Volumetric), RenderGraphAccess::CopyDst);
+            read_gbuffer(pass);
+            if (ssao)
+            {
+                graph.Read(pass, texture(RendererTexture::Ssao));
+                graph.Read(pass, texture(RendererTexture::Ssao_Gi));
+            }
+
+            // Each pass only writes the pixels of its own surfaces
+            pass = graph.AddPass(is_transparent_pass ? "light_composition_transparent" : "light_composition");
+            graph.ReadWrite(pass, texture(RendererTexture::Frame_Render));
+            read_gbuffer(pass);
+            graph.Read(pass, texture(light_diffuse));
+            graph.Read(pass, texture(light_specular));
+            graph.Read(pass, texture(RendererTexture::Light_Volumetric));
+            if (is_transparent_pass)
+            {
+                graph.Read(pass, texture(RendererTexture::Frame_Render_2)); // refraction
+            }
+            if (ssao)
+            {
+                graph.Read(pass, texture(RendererTexture::Ssao));
+            }
+
+            pass = graph.AddPass(is_transparent_pass ? "light_image_based_transparent" : "light_image_based");
+            graph.ReadWrite(pass, texture(RendererTexture::Frame_Render), RenderGraphAccess::ColorTarget);
+            read_gbuffer(pass);
+            graph.Read(pass, texture(RendererTexture::Brdf_Specular_Lut));
+            if (ssao)
+            {
+                graph.Read(pass, texture(RendererTexture::Ssao));
+            }
+            if (ssr && !is_transparent_pass)
+            {
+                graph.Read(pass, texture(RendererTexture::Ssr));
+            }
+        }
+
+        // Post-process, the frame ping-pongs between the two textures of each resolution
+        pass = graph.AddPass("depth_of_field", dof);
+        graph.Read(pass, texture(RendererTexture::Frame_Render));
+        graph.Write(pass, texture(RendererTexture::Frame_Render_2));
+        graph.Write(pass, texture(RendererTexture::Dof_Half));
+        graph.Write(pass, texture(RendererTexture::Dof_Half_2));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Depth));
+
+        // Lines, upsampling and motion blur
+        pass = graph.AddPass("upsample");
+        graph.ReadWrite(pass, texture(dof ? RendererTexture::Frame_Render_2 : RendererTexture::Frame_Render), RenderGraphAccess::ColorTarget);
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Depth));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Velocity));
+        graph.Write(pass, texture(RendererTexture::Frame_Output));
+        if (motion_blur)
+        {
+            graph.Write(pass, texture(RendererTexture::Frame_Output_2));
+        }
+
+        pass = graph.AddPass("bloom", bloom);
+        graph.ReadWrite(pass, texture(RendererTexture::Frame_Output));
+        graph.ReadWrite(pass, texture(RendererTexture::Frame_Output_2));
+        graph.Write(pass, texture(RendererTexture::Bloom));
+
+        pass = graph.AddPass("post_process");
+        graph.ReadWrite(pass, texture(RendererTexture::Frame_Output));
+        graph.ReadWrite(pass, texture(RendererTexture::Frame_Output_2));
+
+        // Debug meshes, outline, icons and performance metrics
+        pass = graph.AddPass("editor");
+        graph.ReadWrite(pass, texture(RendererTexture::Frame_Output), RenderGraphAccess::ColorTarget);
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Depth));
+        graph.Read(pass, texture(RendererTexture::Gbuffer_Normal));
+
+        SP_ASSERT(graph.GetPassCount() == static_cast<uint32_t>(RendererPass::Editor) + 1);
+
+        graph.Compile();
+
+        // Create a texture for every physical texture, keeping the existing ones which still match
+        vector<RHI_Texture*> claimed;
+        auto can_reuse = [&claimed](const shared_ptr<RHI_Texture>& candidate, const RenderGraphTextureDesc& desc)
+        {
+            return candidate &&
+                find(claimed.begin(), claimed.end(), candidate.get()) == claimed.end() &&
+                candidate->GetWidth()    == desc.width  &&
+                candidate->GetHeight()   == desc.height &&
+                candidate->GetMipCount() == desc.mips   &&
+                candidate->GetFormat()   == desc.format &&
+                candidate->GetFlags()    == desc.flags;
+        };
+
+        m_render_graph_textures.assign(graph.GetPhysicalCount(), nullptr);
+        for (uint32_t physical = 0; physical < graph.GetPhysicalCount(); physical++)
+        {
+            const RenderGraphTextureDesc& desc = graph.GetPhysicalDesc(physical);
+
+            for (uint32_t i = 0; i < textures.size(); i++)
+            {
+                if (textures[i] != RenderGraph::invalid_index && graph.GetPhysicalIndex(textures[i]) == physical && can_reuse(m_render_targets[i], desc))
+                {
+                    m_render_graph_textures[physical] = m_render_targets[i];
+                    break;
+                }
+            }
+
+            if (!m_render_graph_textures[physical])
+            {
+                m_render_graph_textures[physical] = make_shared<RHI_Texture2D>(m_context, desc.width, desc.height, desc.mips, desc.format, desc.flags, desc.name.c_str());
+            }
+
+            claimed.emplace_back(m_render_graph_textures[physical].get());
+        }
+
+        // Point the render targets to their physical textures. The ones no pass uses get a 1x1 stand-in,
+        // since the uber shaders expect every slot to be bound, even when they don't sample it.
+        shared_ptr<RHI_Texture> brdf_specular_lut = render_target(RendererTexture::Brdf_Specular_Lut);
+        for (uint32_t i = 0; i < textures.size(); i++)
+        {
+            if (textures[i] == RenderGraph::invalid_index)
+                continue;
+
+            if (graph.IsTextureUsed(textures[i]))
+            {
+                m_render_targets[i] = m_render_graph_textures[graph.GetPhysicalIndex(textures[i])];
+            }
+            else
+            {
+                RenderGraphTextureDesc desc = m_render_target_descs[i];
+                desc.width  = 1;
+                desc.height = 1;
+                desc.mips   = 1;
+
+                if (!can_reuse(m_render_targets[i], desc))
+                {
+                    m_render_targets[i] = make_shared<RHI_Texture2D>(m_context, desc.width, desc.height, desc.mips, desc.format, desc.flags, desc.name.c_str());
+                }
+                claimed.emplace_back(m_render_targets[i].get());
+            }
+        }
+
+        if (render_target(RendererTexture::Brdf_Specular_Lut) != brdf_specular_lut)
+        {
+            m_brdf_specular_lut_rendered = false;
+        }
+
+        const uint32_t texture_count = static_cast<uint32_t>(count_if(textures.begin(), textures.end(), [](const uint32_t t) { return t != RenderGraph::invalid_index; }));
+        SP_LOG_INFO("Render graph compiled, %d render targets are backed by %d textures", texture_count, graph.GetPhysicalCount());
+    }
+
     void Renderer::CreateShaders()
     {
         const bool async        = true;
         const string shader_dir = ResourceCache::GetResourceDirectory(ResourceDirectory::Shaders) + "\\";
+        m_shaders_stopwatch.Start();
+        m_shader_watcher = ShaderWatcher(m_context);
 
         // G-Buffer
         shader(RendererShader::Gbuffer_V) = make_shared<RHI_Shader>(m_context);
@@ -530,4 +870,216 @@ namespace Spartan
             m_tex_gizmo_light_spot->LoadFromFile(dir_texture + "flashlight.png");
         }
     }
+
+    Renderer::PipelineManifestObjects Renderer::GetPipelineManifestObjects() const
+    {
+        PipelineManifestObjects objects;
+
+        for (const shared_ptr<RHI_Shader>& shader : m_shaders)
+        {
+            objects.shaders.emplace_back(shader.get());
+        }
+
+        for (const shared_ptr<RHI_Texture>& render_target : m_render_targets)
+        {
+            objects.render_targets.emplace_back(render_target.get());
+        }
+
+        objects.rasterizer_states    = { m_rasterizer_cull_back_solid.get(), m_rasterizer_cull_back_wireframe.get(), m_rasterizer_cull_none_solid.get(), m_rasterizer_light_point_spot.get(), m_rasterizer_light_directional.get() };
+        objects.blend_states         = { m_blend_disabled.get(), m_blend_alpha.get(), m_blend_additive.get() };
+        objects.depth_stencil_states = { m_depth_stencil_off_off.get(), m_depth_stencil_off_r.get(), m_depth_stencil_rw_off.get(), m_depth_stencil_r_off.get(), m_depth_stencil_rw_w.get() };
+        objects.swap_chain           = m_swap_chain.get();
+
+        return objects;
+    }
+
+    void Renderer::SavePipelineManifest()
+    {
+        const PipelineManifestObjects objects = GetPipelineManifestObjects();
+
+        // Describe every pipeline state in terms of the renderer's objects, the pointers are only compared, never dereferenced,
+        // as the render targets and shaders which older pipelines point to might have been resized or hot reloaded since.
+        struct Entry
+        {
+            array<uint8_t, 3> shaders; // compute, vertex, pixel
+            array<uint8_t, 3> states;  // rasterizer, blend, depth-stencil
+            array<uint8_t, rhi_max_render_target_count> render_target_color;
+            uint8_t render_target_depth = pipeline_manifest_none;
+            RHI_PipelineState pso;
+        };
+        vector<Entry> entries;
+
+        for (const RHI_PipelineState& pso : RHI_CommandList::GetPipelineStates())
+        {
+            Entry entry;
+            entry.pso = pso;
+
+            bool resolved =
+                (!pso.render_target_swapchain || pso.render_target_swapchain == objects.swap_chain)                     &&
+                to_manifest_index<RHI_Shader>(pso.shader_compute, objects.shaders, entry.shaders[0])                    &&
+                to_manifest_index<RHI_Shader>(pso.shader_vertex, objects.shaders, entry.shaders[1])                     &&
+                to_manifest_index<RHI_Shader>(pso.shader_pixel, objects.shaders, entry.shaders[2])                      &&
+                to_manifest_index<RHI_RasterizerState>(pso.rasterizer_state, objects.rasterizer_states, entry.states[0]) &&
+                to_manifest_index<RHI_BlendState>(pso.blend_state, objects.blend_states, entry.states[1])               &&
+                to_manifest_index<RHI_DepthStencilState>(pso.depth_stencil_state, objects.depth_stencil_states, entry.states[2]) &&
+                to_manifest_index<RHI_Texture>(pso.render_target_depth_texture, objects.render_targets, entry.render_target_depth);
+
+            for (uint32_t i = 0; i < rhi_max_render_target_count && resolved; i++)
+            {
+                resolved = to_manifest_index<RHI_Texture>(pso.render_target_color_textures[i], objects.render_targets, entry.render_target_color[i]);
+            }
+
+            if (resolved)
+            {
+                entries.emplace_back(entry);
+            }
+        }
+
+        const string directory = ResourceCache::GetResourceDirectory(ResourceDirectory::ShaderCache);
+        if (!FileSystem::Exists(directory))
+        {
+            FileSystem::CreateDirectory(directory);
+        }
+
+        // Written next to the final file and renamed once complete, so a crash while saving can't leave a torn manifest behind
+        const string file_path      = get_pipeline_manifest_file_path();
+        const string file_path_temp = file_path + ".tmp";
+
+        FileStream file(file_path_temp, FileStream_Write);
+        if (!file.IsOpen())
+            return;
+
+        file.Write(pipeline_manifest_magic);
+        file.Write(pipeline_manifest_version);
+        file.Write(static_cast<uint32_t>(entries.size()));
+        for (const Entry& entry : entries)
+        {
+            const RHI_PipelineState& pso = entry.pso;
+
+            for (const uint8_t index : entry.shaders)             file.Write(index);
+            for (const uint8_t index : entry.states)              file.Write(index);
+            for (const uint8_t index : entry.render_target_color) file.Write(index);
+            file.Write(entry.render_target_depth);
+            file.Write(pso.render_target_swapchain != nullptr);
+            file.Write(pso.render_target_color_texture_array_index);
+            file.Write(pso.render_target_depth_stencil_texture_array_index);
+            file.Write(static_cast<uint32_t>(pso.primitive_topology));
+            file.Write(pso.viewport.x);
+            file.Write(pso.viewport.y);
+            file.Write(pso.viewport.width);
+            file.Write(pso.viewport.height);
+            file.Write(pso.viewport.depth_min);
+            file.Write(pso.viewport.depth_max);
+            file.Write(pso.scissor.left);
+            file.Write(pso.scissor.top);
+            file.Write(pso.scissor.right);
+            file.Write(pso.scissor.bottom);
+            file.Write(pso.dynamic_scissor);
+            file.Write(pso.can_use_vertex_index_buffers);
+        }
+        file.Write(pipeline_manifest_magic);
+
+        const bool written = file.IsGood();
+        file.Close();
+
+        if (!written || !FileSystem::Rename(file_path_temp, file_path))
+        {
+            FileSystem::Delete(file_path_temp);
+            return;
+        }
+
+        SP_LOG_INFO("Saved %d pipeline states to the pipeline manifest", static_cast<uint32_t>(entries.size()));
+    }
+
+    void Renderer::PrewarmPipelines()
+    {
+        const string file_path = get_pipeline_manifest_file_path();
+        if (!FileSystem::IsFile(file_path))
+            return;
+
+        FileStream file(file_path, FileStream_Read);
+        if (!file.IsOpen())
+            return;
+
+        if (file.ReadAs<uint32_t>() != pipeline_manifest_magic || file.ReadAs<uint32_t>() != pipeline_manifest_version || !file.IsGood())
+            return;
+
+        // The entries and the trailing magic have to account for the rest of the file exactly, before the count is trusted
+        const uint32_t entry_count = file.ReadAs<uint32_t>();
+        if (!file.IsGood() || static_cast<uint64_t>(entry_count) * pipeline_manifest_entry_size + sizeof(uint32_t) != file.GetRemainingSize())
+        {
+            SP_LOG_WARNING("The pipeline manifest is corrupt, ignoring it");
+            return;
+        }
+
+        const PipelineManifestObjects objects = GetPipelineManifestObjects();
+
+        vector<RHI_PipelineState> pipeline_states;
+        pipeline_states.reserve(entry_count);
+        for (uint32_t i = 0; i < entry_count; i++)
+        {
+            array<uint8_t, 3> shaders;
+            array<uint8_t, 3> states;
+            array<uint8_t, rhi_max_render_target_count> render_target_color;
+            for (uint8_t& index : shaders)             file.Read(&index);
+            for (uint8_t& index : states)              file.Read(&index);
+            for (uint8_t& index : render_target_color) file.Read(&index);
+            const uint8_t render_target_depth = file.ReadAs<uint8_t>();
+
+            RHI_PipelineState pso;
+            pso.render_target_swapchain                         = file.ReadAs<bool>() ? objects.swap_chain : nullptr;
+            pso.render_target_color_texture_array_index         = file.ReadAs<uint32_t>();
+            pso.render_target_depth_stencil_texture_array_index = file.ReadAs<uint32_t>();
+            const uint32_t primitive_topology                   = file.ReadAs<uint32_t>();
+            pso.viewport.x                                      = file.ReadAs<float>();
+            pso.viewport.y                                      = file.ReadAs<float>();
+            pso.viewport.width                                  = file.ReadAs<float>();
+            pso.viewport.height                                 = file.ReadAs<float>();
+            pso.viewport.depth_min                              = file.ReadAs<float>();
+            pso.viewport.depth_max                              = file.ReadAs<float>();
+            pso.scissor.left                                    = file.ReadAs<float>();
+            pso.scissor.top                                     = file.ReadAs<float>();
+            pso.scissor.right                                   = file.ReadAs<float>();
+            pso.scissor.bottom                                  = file.ReadAs<float>();
+            pso.dynamic_scissor                                 = file.ReadAs<bool>();
+            pso.can_use_vertex_index_buffers                    = file.ReadAs<bool>();
+
+            if (!file.IsGood())
+                return;
+
+            bool resolved =
+                primitive_topology <= static_cast<uint32_t>(RHI_PrimitiveTopology_Mode::Undefined)                         &&
+                from_manifest_index<RHI_Shader>(shaders[0], objects.shaders, pso.shader_compute)                           &&
+                from_manifest_index<RHI_Shader>(shaders[1], objects.shaders, pso.shader_vertex)                            &&
+                from_manifest_index<RHI_Shader>(shaders[2], objects.shaders, pso.shader_pixel)                             &&
+                from_manifest_index<RHI_RasterizerState>(states[0], objects.rasterizer_states, pso.rasterizer_state)       &&
+                from_manifest_index<RHI_BlendState>(states[1], objects.blend_states, pso.blend_state)                      &&
+                from_manifest_index<RHI_DepthStencilState>(states[2], objects.depth_stencil_states, pso.depth_stencil_state) &&
+                from_manifest_index<RHI_Texture>(render_target_depth, objects.render_targets, pso.render_target_depth_texture);
+
+            for (uint32_t j = 0; j < rhi_max_render_target_count && resolved; j++)
+            {
+                resolved = from_manifest_index<RHI_Texture>(render_target_color[j], objects.render_targets, pso.render_target_color_textures[j]);
+            }
+
+            pso.primitive_topology = static_cast<RHI_PrimitiveTopology_Mode>(primitive_topology);
+
+            // Render targets which an option disabled or shaders which failed to compile, are skipped
+            if (resolved && pso.IsValid())
+            {
+                pipeline_states.emplace_back(pso);
+            }
+        }
+
+        // A file which was cut short won't end with the magic
+        if (file.ReadAs<uint32_t>() != pipeline_manifest_magic || !file.IsGood())
+            return;
+
+        const Stopwatch timer;
+        const uint32_t creation_count = RHI_CommandList::GetPipelineCreationCount();
+        RHI_CommandList::PrewarmPipelines(m_rhi_device.get(), pipeline_states);
+
+        SP_LOG_INFO("Prewarmed %d pipelines from the manifest (%d were created) in %.2f ms",
+            static_cast<uint32_t>(pipeline_states.size()), RHI_CommandList::GetPipelineCreationCount() - creation_count, timer.GetElapsedTimeMs());
+    }
 }
@@ -0,0 +1,179 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "pch.h"
+#include "ShaderWatcher.h"
+#include "../RHI/RHI_Shader.h"
+#include "../RHI/RHI_CommandList.h"
+#include "../Core/ThreadPool.h"
+//=================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    // How often the source files are checked for changes
+    static const float poll_interval_ms = 500.0f;
+
+    ShaderWatcher::ShaderWatcher(Context* context)
+    {
+        m_context = context;
+    }
+
+    void ShaderWatcher::Tick(shared_ptr<RHI_Shader>* shaders, const uint32_t shader_count)
+    {
+        // Swap in the shaders which are done compiling
+        for (auto it = m_compiling.begin(); it != m_compiling.end();)
+        {
+            const Shader_Compilation_State state = it->shader->GetCompilationState();
+            if (state != Shader_Compilation_State::Succeeded && state != Shader_Compilation_State::Failed)
+            {
+                it++;
+                continue;
+            }
+
+            if (state == Shader_Compilation_State::Succeeded)
+            {
+                // Pipelines are looked up by shader hashes, which cover the source, so the new shader gets its own pipelines,
+                // and the ones of the previous shader are removed, as nothing can look them up once it's gone
+                RHI_CommandList::RemovePipelines(shaders[it->index].get());
+                shaders[it->index] = it->shader;
+                m_graph_dirty      = true; // the include directives might have changed
+            }
+            else
+            {
+                SP_LOG_ERROR("Failed to recompile \"%s\", the previous version will keep being used", it->shader->GetName().c_str());
+            }
+
+            // The source changed again while compiling, so compile once more
+            if (it->outdated)
+            {
+                m_queued.emplace_back(it->index);
+            }
+
+            it = m_compiling.erase(it);
+        }
+
+        if (m_graph_dirty)
+        {
+            BuildIncludeGraph(shaders, shader_count);
+        }
+
+        if (m_poll_timer.GetElapsedTimeMs() >= poll_interval_ms)
+        {
+            DetectChanges();
+            m_poll_timer.Start();
+        }
+
+        StartCompilations(shaders);
+    }
+
+    void ShaderWatcher::BuildIncludeGraph(shared_ptr<RHI_Shader>* shaders, const uint32_t shader_count)
+    {
+        m_dependents.clear();
+
+        for (uint32_t i = 0; i < shader_count; i++)
+        {
+            if (!shaders[i])
+                continue;
+
+            // The file paths are collected while processing the include directives, so they include the shader's own file
+            for (const string& file_path : shaders[i]->GetFilePaths())
+            {
+                m_dependents[file_path].emplace_back(i);
+
+                // Files which are already known keep their time stamp, so that changes which happened while compiling aren't lost
+                if (m_timestamps.find(file_path) == m_timestamps.end())
+                {
+                    m_timestamps[file_path] = FileSystem::GetLastWriteTime(file_path);
+                }
+            }
+        }
+
+        m_graph_dirty = false;
+    }
+
+    void ShaderWatcher::DetectChanges()
+    {
+        for (auto& it : m_timestamps)
+        {
+            // A time stamp of 0 means that the file can't be accessed, which can happen while a text editor is saving it
+            const uint64_t timestamp = FileSystem::GetLastWriteTime(it.first);
+            if (timestamp == it.second || timestamp == 0)
+                continue;
+
+            it.second = timestamp;
+
+            auto dependents = m_dependents.find(it.first);
+            if (dependents == m_dependents.end())
+                continue;
+
+            SP_LOG_INFO("\"%s\" has changed, recompiling %d shader(s)", it.first.c_str(), static_cast<uint32_t>(dependents->second.size()));
+
+            for (const uint32_t index : dependents->second)
+            {
+                // A compilation which is in flight might have read the previous source
+                auto compilation = find_if(m_compiling.begin(), m_compiling.end(), [index](const Compilation& c) { return c.index == index; });
+                if (compilation != m_compiling.end())
+                {
+                    compilation->outdated = true;
+                }
+                else if (find(m_queued.begin(), m_queued.end(), index) == m_queued.end())
+                {
+                    m_queued.emplace_back(index);
+                }
+            }
+        }
+    }
+
+    void ShaderWatcher::StartCompilations(shared_ptr<RHI_Shader>* shaders)
+    {
+        // A compilation occupies a thread pool thread until it's done, so leave some threads for everything else
+        const uint32_t compilation_count_max = max(1u, ThreadPool::GetThreadCount() / 2);
+
+        while (!m_queued.empty() && m_compiling.size() < compilation_count_max)
+        {
+            const uint32_t index = m_queued.front();
+            m_queued.erase(m_queued.begin());
+
+            const RHI_Shader* shader = shaders[index].get();
+            if (!shader || !FileSystem::IsFile(shader->GetFilePath()))
+                continue;
+
+            // Create the replacement, with the same stage, defines and vertex type
+            Compilation compilation;
+            compilation.index  = index;
+            compilation.shader = make_shared<RHI_Shader>(m_context);
+            for (const auto& define : shader->GetDefines())
+            {
+                compilation.shader->AddDefine(define.first, define.second);
+            }
+
+            const bool async = true;
+            compilation.shader->Compile(shader->GetShaderStage(), shader->GetFilePath(), async, shader->GetVertexType());
+
+            m_compiling.emplace_back(compilation);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Core/Definitions.h"
+#include "../Core/Stopwatch.h"
+//================================
+
+namespace Spartan
+{
+    // Forward declarations
+    class Context;
+    class RHI_Shader;
+
+    // Watches the source files of a set of shaders, including every file they include. When a file changes,
+    // the shaders which depend on it are recompiled in the background (a limited number at a time) and once
+    // a recompiled shader succeeds, it replaces the previous one.
+    class SP_CLASS ShaderWatcher
+    {
+    public:
+        ShaderWatcher() = default;
+        ShaderWatcher(Context* context);
+
+        // Has to be called from the thread which uses the shaders, at a point where none of them are being recorded
+        void Tick(std::shared_ptr<RHI_Shader>* shaders, const uint32_t shader_count);
+
+        uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_queued.size() + m_compiling.size()); }
+
+    private:
+        void BuildIncludeGraph(std::shared_ptr<RHI_Shader>* shaders, const uint32_t shader_count);
+        void DetectChanges();
+        void StartCompilations(std::shared_ptr<RHI_Shader>* shaders);
+
+        struct Compilation
+        {
+            uint32_t index = 0;                 // index of the shader which is being replaced
+            std::shared_ptr<RHI_Shader> shader; // the replacement
+            bool outdated  = false;             // a file changed again while compiling
+        };
+
+        Context* m_context = nullptr;
+        std::unordered_map<std::string, uint64_t> m_timestamps;              // per source file
+        std::unordered_map<std::string, std::vector<uint32_t>> m_dependents; // per source file, the shaders which include it
+        std::vector<uint32_t> m_queued;                                      // shaders which have to be recompiled
+        std::vector<Compilation> m_compiling;
+        Stopwatch m_poll_timer;
+        bool m_graph_dirty = true;
+    };
+}
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <memory>
+#include <atomic>
 #include "../Core/Context.h"
 #include "../Core/FileSystem.h"
 #include "../Core/Object.h"
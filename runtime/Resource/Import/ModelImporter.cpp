@@ -319,6 +319,18 @@ namespace Spartan
         return material;
     }
 
+    struct ModelImporter::Geometry
+    {
+        Renderable* renderable = nullptr;
+        string name;
+        vector<RHI_Vertex_PosTexNorTan> vertices;
+        vector<uint32_t> indices;
+        vector<uint32_t> lod_indices;
+        vector<MeshLod> lods;
+        vector<MeshCluster> clusters;
+        BoundingBox aabb;
+    };
+
     ModelImporter::ModelImporter(Context* context)
     {
         m_context = context;
@@ -422,11 +434,10 @@ namespace Spartan
 
             // Update model geometry
             {
-                while (ProgressTracker::GetProgress(ProgressType::ModelImporter).GetFraction() != 1.0f)
-                {
-                    SP_LOG_INFO("Waiting for node processing threads to finish before creating GPU buffers...");
-                    this_thread::sleep_for(std::chrono::milliseconds(16));
-                }
+                // Wait for the geometry tasks (this thread helps out instead of sleeping)
+                ThreadPool::Wait(m_geometry_tasks);
+                m_geometry_tasks.clear();
+                AddGeometry();
 
                 //mesh->Optimize();
                 mesh->ComputeAabb();
@@ -584,88 +595,88 @@ namespace Spartan
         SP_ASSERT(assimp_mesh != nullptr);
         SP_ASSERT(entity_parent != nullptr);
 
-        const uint32_t vertex_count = assimp_mesh->mNumVertices;
-        const uint32_t index_count  = assimp_mesh->mNumFaces * 3;
-
-        // Vertices
-        vector<RHI_Vertex_PosTexNorTan> vertices = vector<RHI_Vertex_PosTexNorTan>(vertex_count);
-        {
-            for (uint32_t i = 0; i < vertex_count; i++)
-            {
-                RHI_Vertex_PosTexNorTan& vertex = vertices[i];
-
-                // Position
-                const aiVector3D& pos = assimp_mesh->mVertices[i];
-                vertex.pos[0] = pos.x;
-                vertex.pos[1] = pos.y;
-                vertex.pos[2] = pos.z;
+        // Add a renderable component to this entity
+        Renderable* renderable = entity_parent->AddComponent<Renderable>();
 
-                // Normal
-                if (assimp_mesh->mNormals)
-                {
-                    const aiVector3D& normal = assimp_mesh->mNormals[i];
-                    vertex.nor[0] = normal.x;
-                    vertex.nor[1] = normal.y;
-                    vertex.nor[2] = normal.z;
-                }
+        // Converting the geometry doesn't touch the entity or the model, so it's done in parallel while the rest of the nodes are parsed
+        shared_ptr<Geometry> geometry = make_shared<Geometry>();
+        geometry->renderable          = renderable;
+        geometry->name                = entity_parent->GetName();
+        m_geometry.emplace_back(geometry);
 
-                // Tangent
-                if (assimp_mesh->mTangents)
-                {
-                    const aiVector3D& tangent = assimp_mesh->mTangents[i];
-                    vertex.tan[0] = tangent.x;
-                    vertex.tan[1] = tangent.y;
-                    vertex.tan[2] = tangent.z;
-                }
+        m_geometry_tasks.emplace_back(ThreadPool::AddTask([assimp_mesh, geometry]()
+        {
+            const uint32_t vertex_count = assimp_mesh->mNumVertices;
+            const uint32_t index_count  = assimp_mesh->mNumFaces * 3;
 
-                // Texture coordinates
-                const uint32_t uv_channel = 0;
-                if (assimp_mesh->HasTextureCoords(uv_channel))
+            // Vertices
+            vector<RHI_Vertex_PosTexNorTan>& vertices = geometry->vertices;
+            vertices.resize(vertex_count);
+            {
+                for (uint32_t i = 0; i < vertex_count; i++)
                 {
-                    const auto& tex_coords = assimp_mesh->mTextureCoords[uv_channel][i];
-                    vertex.tex[0] = tex_coords.x;
-                    vertex.tex[1] = tex_coords.y;
+                    RHI_Vertex_PosTexNorTan& vertex = vertices[i];
+
+                    // Position
+                    const aiVector3D& pos = assimp_mesh->mVertices[i];
+                    vertex.pos[0] = pos.x;
+                    vertex.pos[1] = pos.y;
+                    vertex.pos[2] = pos.z;
+
+                    // Normal
+                    if (assimp_mesh->mNormals)
+                    {
+                        const aiVector3D& normal = assimp_mesh->mNormals[i];
+                        vertex.nor[0] = normal.x;
+                        vertex.nor[1] = normal.y;
+                        vertex.nor[2] = normal.z;
+                    }
+
+                    // Tangent
+                    if (assimp_mesh->mTangents)
+                    {
+                        const aiVector3D& tangent = assimp_mesh->mTangents[i];
+                        vertex.tan[0] = tangent.x;
+                        vertex.tan[1] = tangent.y;
+                        vertex.tan[2] = tangent.z;
+                    }
+
+                    // Texture coordinates
+                    const uint32_t uv_channel = 0;
+                    if (assimp_mesh->HasTextureCoords(uv_channel))
+                    {
+                        const auto& tex_coords = assimp_mesh->mTextureCoords[uv_channel][i];
+                        vertex.tex[0] = tex_coords.x;
+                        vertex.tex[1] = tex_coords.y;
+                    }
                 }
             }
-        }
 
-        // Indices
-        vector<uint32_t> indices = vector<uint32_t>(index_count);
-        {
-            // Get indices by iterating through each face of the mesh.
-            for (uint32_t face_index = 0; face_index < assimp_mesh->mNumFaces; face_index++)
+            // Indices
+            vector<uint32_t>& indices = geometry->indices;
+            indices.resize(index_count);
             {
-                // if (aiPrimitiveType_LINE | aiPrimitiveType_POINT) && aiProcess_Triangulate) then (face.mNumIndices == 3)
-                const aiFace& face           = assimp_mesh->mFaces[face_index];
-                const uint32_t indices_index = (face_index * 3);
-                indices[indices_index + 0]   = face.mIndices[0];
-                indices[indices_index + 1]   = face.mIndices[1];
-                indices[indices_index + 2]   = face.mIndices[2];
+                // Get indices by iterating through each face of the mesh.
+                for (uint32_t face_index = 0; face_index < assimp_mesh->mNumFaces; face_index++)
+                {
+                    // if (aiPrimitiveType_LINE | aiPrimitiveType_POINT) && aiProcess_Triangulate) then (face.mNumIndices == 3)
+                    const aiFace& face           = assimp_mesh->mFaces[face_index];
+                    const uint32_t indices_index = (face_index * 3);
+                    indices[indices_index + 0]   = face.mIndices[0];
+                    indices[indices_index + 1]   = face.mIndices[1];
+                    indices[indices_index + 2]   = face.mIndices[2];
+                }
             }
-        }
 
-        // Compute AABB (before doing move operation on vertices)
-        const BoundingBox aabb = BoundingBox(vertices.data(), static_cast<uint32_t>(vertices.size()));
+            // Compute AABB
+            geometry->aabb = BoundingBox(vertices.data(), static_cast<uint32_t>(vertices.size()));
 
-        // Add the mesh to the model
-        uint32_t index_offset  = 0;
-        uint32_t vertex_offset = 0;
-        m_mesh->AddIndices(indices, &index_offset);
-        m_mesh->AddVertices(vertices, &vertex_offset);
-
-        // Add a renderable component to this entity
-        Renderable* renderable = entity_parent->AddComponent<Renderable>();
+            // Simplified versions of the triangles, for when the mesh covers few pixels
+            Mesh::ComputeLods(indices, vertices, &geometry->lod_indices, &geometry->lods);
 
-        // Set the geometry
-        renderable->SetGeometry(
-            entity_parent->GetName(),
-            index_offset,
-            static_cast<uint32_t>(indices.size()),
-            vertex_offset,
-            static_cast<uint32_t>(vertices.size()),
-            aabb,
-            m_mesh
-        );
+            // Split the triangles into clusters that the renderer can cull, this reorders the indices
+            Mesh::ComputeClusters(indices, vertices, &geometry->clusters);
+        }));
 
         // Material
         if (m_scene->HasMaterials())
@@ -683,6 +694,33 @@ namespace Spartan
         ParseNodes(assimp_mesh);
     }
 
+    void ModelImporter::AddGeometry()
+    {
+        // Appended on the calling thread, in the order the meshes were parsed, so the
+        // layout of the model's buffers is the same on every import
+        for (const shared_ptr<Geometry>& geometry : m_geometry)
+        {
+            uint32_t index_offset  = 0;
+            uint32_t vertex_offset = 0;
+            m_mesh->AddIndices(geometry->indices, &index_offset);
+            m_mesh->AddVertices(geometry->vertices, &vertex_offset);
+            m_mesh->AddClusters(geometry->clusters, index_offset);
+            m_mesh->AddLods(geometry->lods, geometry->lod_indices, index_offset);
+
+            geometry->renderable->SetGeometry(
+                geometry->name,
+                index_offset,
+                static_cast<uint32_t>(geometry->indices.size()),
+                vertex_offset,
+                static_cast<uint32_t>(geometry->vertices.size()),
+                geometry->aabb,
+                m_mesh
+            );
+        }
+
+        m_geometry.clear();
+    }
+
     void ModelImporter::ParseAnimations()
     {
         for (uint32_t i = 0; i < m_scene->mNumAnimations; i++)
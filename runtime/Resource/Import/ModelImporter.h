@@ -24,7 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ======================
 #include <memory>
 #include <string>
-#include "../../Core/Definitions.h"
+#include <vector>
+#include "../../Core/ThreadPool.h"
 //=================================
 
 struct aiNode;
@@ -55,6 +56,7 @@ namespace Spartan
         void ParseAnimations();
         void ParseMesh(aiMesh* mesh, Entity* entity_parent);
         void ParseNodes(const aiMesh* mesh);
+        void AddGeometry();
 
         // Model
         std::string m_file_path;
@@ -63,6 +65,9 @@ namespace Spartan
         bool m_is_gltf         = false;
         Mesh* m_mesh           = nullptr;
         const aiScene* m_scene = nullptr;
+        struct Geometry;
+        std::vector<std::shared_ptr<Geometry>> m_geometry;
+        std::vector<TaskHandle> m_geometry_tasks;
 
         // Dependencies
         Context* m_context = nullptr;
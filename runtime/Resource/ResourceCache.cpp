@@ -42,7 +42,7 @@ using namespace Spartan::Math;
 namespace Spartan
 {
     // Directories
-    static std::array<std::string, 6> m_standard_resource_directories;
+    static std::array<std::string, 7> m_standard_resource_directories;
     static std::string m_project_directory;
 
     std::vector<std::shared_ptr<IResource>> ResourceCache::m_resources;
@@ -64,6 +64,7 @@ namespace Spartan
         AddResourceDirectory(ResourceDirectory::Environment,    m_project_directory + "environment");
         AddResourceDirectory(ResourceDirectory::Fonts,          data_dir + "fonts");
         AddResourceDirectory(ResourceDirectory::Icons,          data_dir + "icons");
+        AddResourceDirectory(ResourceDirectory::ShaderCache,    data_dir + "shader_cache");
         AddResourceDirectory(ResourceDirectory::ShaderCompiler, data_dir + "shader_compiler");
         AddResourceDirectory(ResourceDirectory::Shaders,        data_dir + "shaders");
         AddResourceDirectory(ResourceDirectory::Textures,       data_dir + "textures");
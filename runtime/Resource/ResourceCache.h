@@ -38,6 +38,7 @@ namespace Spartan
         Environment,
         Fonts,
         Icons,
+        ShaderCache,
         ShaderCompiler,
         Shaders,
         Textures
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Transform.h"
 #include "RigidBody.h"
 #include "Renderable.h"
+#include "Terrain.h"
 #include "../Entity.h"
 #include "../../IO/FileStream.h"
 #include "../../Physics/BulletPhysicsHelper.h"
@@ -37,6 +38,7 @@ SP_WARNINGS_OFF
 #include "BulletCollision/CollisionShapes/btCapsuleShape.h"
 #include "BulletCollision/CollisionShapes/btConeShape.h"
 #include "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
 SP_WARNINGS_ON
 //=============================================================
 
@@ -47,6 +49,53 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    namespace
+    {
+        // Raycasts skip whole chunks of the heightfield using the min and max height of each chunk (the accelerator).
+        // Bullet can only build all of it, so this refreshes just the chunks an edit touches.
+        class HeightfieldShape : public btHeightfieldTerrainShape
+        {
+        public:
+            using btHeightfieldTerrainShape::btHeightfieldTerrainShape;
+
+            void UpdateAccelerator(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
+            {
+                if (m_vboundsGrid.size() == 0)
+                    return;
+
+                // A chunk also covers the first row and column of the next chunk, so an edit can reach back one chunk
+                const int chunk_x0 = Helper::Max(static_cast<int>(x) - 1, 0) / m_vboundsChunkSize;
+                const int chunk_z0 = Helper::Max(static_cast<int>(y) - 1, 0) / m_vboundsChunkSize;
+                const int chunk_x1 = Helper::Min(static_cast<int>(x + width - 1) / m_vboundsChunkSize, m_vboundsGridWidth - 1);
+                const int chunk_z1 = Helper::Min(static_cast<int>(y + height - 1) / m_vboundsChunkSize, m_vboundsGridLength - 1);
+
+                for (int cz = chunk_z0; cz <= chunk_z1; cz++)
+                {
+                    for (int cx = chunk_x0; cx <= chunk_x1; cx++)
+                    {
+                        const int x0 = cx * m_vboundsChunkSize;
+                        const int z0 = cz * m_vboundsChunkSize;
+                        const int x1 = Helper::Min(x0 + m_vboundsChunkSize + 1, m_heightStickWidth);
+                        const int z1 = Helper::Min(z0 + m_vboundsChunkSize + 1, m_heightStickLength);
+
+                        Range range(getRawHeightFieldValue(x0, z0), getRawHeightFieldValue(x0, z0));
+                        for (int j = z0; j < z1; j++)
+                        {
+                            for (int i = x0; i < x1; i++)
+                            {
+                                const btScalar value = getRawHeightFieldValue(i, j);
+                                range.min            = Helper::Min(range.min, value);
+                                range.max            = Helper::Max(range.max, value);
+                            }
+                        }
+
+                        m_vboundsGrid[cx + cz * m_vboundsGridWidth] = range;
+                    }
+                }
+            }
+        };
+    }
+
     Collider::Collider(Context* context, Entity* entity, uint64_t id /*= 0*/) : IComponent(context, entity, id)
     {
         m_shapeType = ColliderShape::Box;
@@ -134,6 +183,22 @@ namespace Spartan
         Shape_Update();
     }
 
+    void Collider::OnTerrainChanged()
+    {
+        if (m_shapeType == ColliderShape::Terrain)
+        {
+            Shape_Update();
+        }
+    }
+
+    void Collider::OnTerrainHeightsChanged(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
+    {
+        if (m_shapeType == ColliderShape::Terrain && m_shape && width != 0 && height != 0)
+        {
+            static_cast<HeightfieldShape*>(m_shape)->UpdateAccelerator(x, y, width, height);
+        }
+    }
+
     void Collider::Shape_Update()
     {
         Shape_Release();
@@ -164,6 +229,42 @@ namespace Spartan
             m_shape = new btConeShape(m_size.x * 0.5f, m_size.y);
             break;
 
+        case ColliderShape::Terrain:
+        {
+            Terrain* terrain = GetEntity()->GetComponent<Terrain>();
+            if (!terrain)
+            {
+                SP_LOG_WARNING("Can't construct terrain shape, there is no Terrain component attached.");
+                return;
+            }
+
+            // The terrain will call OnTerrainChanged() once it has heights
+            if (terrain->IsGenerating() || terrain->GetHeights().empty())
+                return;
+
+            // Zero-copy, the shape samples the terrain's [0, 1] heights directly. Same triangulation as the terrain (no flipped quad edges).
+            HeightfieldShape* heightfield = new HeightfieldShape(
+                static_cast<int>(terrain->GetHeightsWidth()),
+                static_cast<int>(terrain->GetHeightsHeight()),
+                terrain->GetHeights().data(),
+                0.0f,  // min height
+                1.0f,  // max height
+                1,     // up axis
+                false  // flip quad edges
+            );
+            heightfield->buildAccelerator();
+            m_shape = heightfield;
+
+            // Scale the heights to the terrain's height range
+            const float range_y = Helper::Max(terrain->GetMaxY() - terrain->GetMinY(), Helper::EPSILON);
+            m_shape->setLocalScaling(btVector3(1.0f, range_y, 1.0f));
+
+            // Bullet centers the shape on its bounding box, the terrain is centered on the
+            // vertex at half its size and starts at its min height, so it's offset to match.
+            m_center = Vector3(-0.5f, (terrain->GetMinY() + terrain->GetMaxY()) * 0.5f, -0.5f);
+            break;
+        }
+
         case ColliderShape::Mesh:
             // Get Renderable
             Renderable* renderable = GetEntity()->GetComponent<Renderable>();
@@ -217,6 +318,7 @@ namespace Spartan
     {
         RigidBody_SetShape(nullptr);
         delete m_shape;
+        m_shape = nullptr;
     }
 
     void Collider::RigidBody_SetShape(btCollisionShape* shape) const
@@ -41,6 +41,7 @@ namespace Spartan
         Capsule,
         Cone,
         Mesh,
+        Terrain
     };
 
     class SP_CLASS Collider : public IComponent
@@ -74,6 +75,10 @@ namespace Spartan
         bool GetOptimize() const { return m_optimize; }
         void SetOptimize(bool optimize);
 
+        // The terrain shape reads the terrain's heights in place, so only a new height range or a re-generation has to re-create it
+        void OnTerrainChanged();
+        void OnTerrainHeightsChanged(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
     private:
         void Shape_Update();
         void Shape_Release();
@@ -75,4 +75,44 @@ namespace Spartan
     REGISTER_COMPONENT(Terrain,         ComponentType::Terrain)
     REGISTER_COMPONENT(Transform,       ComponentType::Transform)
     REGISTER_COMPONENT(ReflectionProbe, ComponentType::ReflectionProbe)
+
+    template<typename T>
+    void register_type_info(array<ComponentTypeInfo, component_type_count>& type_infos)
+    {
+        ComponentTypeInfo& type_info = type_infos[static_cast<uint32_t>(IComponent::TypeToEnum<T>())];
+
+        // If T doesn't override OnTick(), &T::OnTick is a pointer to a member of IComponent
+        type_info.ticks = !is_same<decltype(&T::OnTick), decltype(&IComponent::OnTick)>::value;
+
+        if constexpr (requires { T::tick_thread_safe; })
+        {
+            type_info.tick_thread_safe = T::tick_thread_safe;
+        }
+    }
+
+    const ComponentTypeInfo& IComponent::GetTypeInfo(const ComponentType type)
+    {
+        static const array<ComponentTypeInfo, component_type_count> type_infos = []()
+        {
+            array<ComponentTypeInfo, component_type_count> type_infos;
+
+            register_type_info<AudioListener>(type_infos);
+            register_type_info<AudioSource>(type_infos);
+            register_type_info<Camera>(type_infos);
+            register_type_info<Collider>(type_infos);
+            register_type_info<Constraint>(type_infos);
+            register_type_info<Light>(type_infos);
+            register_type_info<Renderable>(type_infos);
+            register_type_info<RigidBody>(type_infos);
+            register_type_info<SoftBody>(type_infos);
+            register_type_info<Environment>(type_infos);
+            register_type_info<Terrain>(type_infos);
+            register_type_info<Transform>(type_infos);
+            register_type_info<ReflectionProbe>(type_infos);
+
+            return type_infos;
+        }();
+
+        return type_infos[static_cast<uint32_t>(type)];
+    }
 }
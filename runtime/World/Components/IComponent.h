@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <any>
 #include <vector>
 #include <functional>
+#include <limits>
 #include "../../Core/Object.h"
 //===================================
 
@@ -55,6 +56,15 @@ namespace Spartan
         Undefined
     };
 
+    const uint32_t component_type_count = static_cast<uint32_t>(ComponentType::Undefined);
+
+    // What the world needs to know about a component type in order to tick it
+    struct ComponentTypeInfo
+    {
+        bool ticks            = false; // overrides OnTick()
+        bool tick_thread_safe = false; // declares "static constexpr bool tick_thread_safe = true;", so instances can tick in parallel
+    };
+
     struct Attribute
     {
         std::function<std::any()> getter;
@@ -88,10 +98,11 @@ namespace Spartan
         // Runs when the entity is being loaded
         virtual void Deserialize(FileStream* stream) {}
 
-        //= TYPE ===================================
+        //= TYPE =====================================================
         template <typename T>
         static constexpr ComponentType TypeToEnum();
-        //==========================================
+        static const ComponentTypeInfo& GetTypeInfo(ComponentType type);
+        //============================================================
 
         //= PROPERTIES ===============================================================================
         Transform* GetTransform()        const { return m_transform; }
@@ -147,7 +158,11 @@ namespace Spartan
         Transform* m_transform = nullptr;
 
     private:
+        friend class World;
+
         // The attributes of the component
         std::vector<Attribute> m_attributes;
+        // The position of the component in the world's tick list
+        uint32_t m_tick_index = std::numeric_limits<uint32_t>::max();
     };
 }
@@ -38,6 +38,9 @@ namespace Spartan
         ReflectionProbe(Context* context, Entity* entity, uint64_t id = 0);
         ~ReflectionProbe() = default;
 
+        // OnTick() only touches the probe itself, so probes can tick in parallel
+        static constexpr bool tick_thread_safe = true;
+
         //= COMPONENT ================================
         void OnTick(double delta_time) override;
         void Serialize(FileStream* stream) override;
@@ -46,6 +49,7 @@ namespace Spartan
 
         // Returns true if the entity (renderable) is within the view frustum of a particular face (index) of the probe.
         bool IsInViewFrustum(Renderable* renderable, uint32_t index) const;
+        const Math::Frustum& GetFrustum(const uint32_t index) const { return m_frustum[index]; }
 
         // Properties
         RHI_Texture* GetColorTexture()                    { return m_texture_color.get(); }
@@ -136,6 +136,9 @@ namespace Spartan
         m_geometry_index_count   = stream->ReadAs<uint32_t>();
         m_geometry_vertex_offset = stream->ReadAs<uint32_t>();
         m_geometry_vertex_count  = stream->ReadAs<uint32_t>();
+        m_lod                    = 0;
+        m_lod_index_offset       = m_geometry_index_offset;
+        m_lod_index_count        = m_geometry_index_count;
         stream->Read(&m_bounding_box);
         string model_name;
         stream->Read(&model_name);
@@ -175,8 +178,12 @@ namespace Spartan
         m_geometry_index_count   = index_count;
         m_geometry_vertex_offset = vertex_offset;
         m_geometry_vertex_count  = vertex_count;
+        m_lod                    = 0;
+        m_lod_index_offset       = index_offset;
+        m_lod_index_count        = index_count;
         m_bounding_box           = bounding_box;
         m_mesh                   = mesh;
+        m_aabb                   = BoundingBox(); // transformed again on the next GetAabb()
     }
 
     void Renderable::SetGeometry(const DefaultGeometry type)
@@ -212,6 +219,38 @@ namespace Spartan
         return m_aabb;
     }
 
+    void Renderable::UpdateLod(const Vector3& eye_position, const float projection_scale)
+    {
+        // The pixels a level's error covers before a coarser level is drawn
+        static const float lod_error_pixels = 1.0f;
+
+        m_lod              = 0;
+        m_lod_index_offset = m_geometry_index_offset;
+        m_lod_index_count  = m_geometry_index_count;
+
+        uint32_t lod_count  = 0;
+        const MeshLod* lods = m_mesh ? m_mesh->GetLods(m_geometry_index_offset, &lod_count) : nullptr;
+        if (lod_count == 0)
+            return;
+
+        // The errors are relative to the extents, so scale them by the pixels that the extents cover
+        const BoundingBox& aabb = GetAabb();
+        const Vector3 size      = aabb.GetSize();
+        const float distance    = Helper::Max(Vector3::Distance(eye_position, aabb.GetCenter()) - size.Length() * 0.5f, Helper::EPSILON);
+        const float size_pixels = Helper::Max3(size.x, size.y, size.z) * projection_scale / distance;
+
+        // Coarser levels have fewer triangles, so the last one that fits wins
+        for (uint32_t i = 0; i < lod_count; i++)
+        {
+            if (lods[i].error * size_pixels <= lod_error_pixels)
+            {
+                m_lod              = i + 1;
+                m_lod_index_offset = lods[i].index_offset;
+                m_lod_index_count  = lods[i].index_count;
+            }
+        }
+    }
+
     // All functions (set/load) resolve to this
     shared_ptr<Material> Renderable::SetMaterial(const shared_ptr<Material>& material)
     {
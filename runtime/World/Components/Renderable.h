@@ -86,6 +86,13 @@ namespace Spartan
         const Math::BoundingBox& GetAabb();
         void Clear();
 
+        // Level of detail, picks the coarsest level whose error covers less than a pixel on screen.
+        // The projection scale is the pixels that one unit covers at a distance of one, infinity keeps full detail.
+        void UpdateLod(const Math::Vector3& eye_position, float projection_scale);
+        uint32_t GetLod()            const { return m_lod; }
+        uint32_t GetLodIndexOffset() const { return m_lod_index_offset; }
+        uint32_t GetLodIndexCount()  const { return m_lod_index_count; }
+
         //= MATERIAL ====================================================================
         // Sets a material from memory (adds it to the resource cache by default)
         std::shared_ptr<Material> SetMaterial(const std::shared_ptr<Material>& material);
@@ -108,6 +115,9 @@ namespace Spartan
         uint32_t m_geometry_index_count   = 0;
         uint32_t m_geometry_vertex_offset = 0;
         uint32_t m_geometry_vertex_count  = 0;
+        uint32_t m_lod                    = 0;
+        uint32_t m_lod_index_offset       = 0;
+        uint32_t m_lod_index_count        = 0;
         DefaultGeometry m_geometry_type   = DefaultGeometry::Undefined;
         Math::Matrix m_last_transform     = Math::Matrix::Identity;
         bool m_cast_shadows               = true;
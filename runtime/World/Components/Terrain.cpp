@@ -23,7 +23,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "Terrain.h"
 #include "Renderable.h"
+#include "Camera.h"
+#include "Collider.h"
+#include "Transform.h"
 #include "../Entity.h"
+#include "../World.h"
+#include "../../Rendering/Renderer.h"
 #include "../../RHI/RHI_Texture2D.h"
 #include "../../RHI/RHI_Vertex.h"
 #include "../../IO/FileStream.h"
@@ -31,6 +36,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Rendering/Mesh.h"
 #include "../../Core/ThreadPool.h"
 #include "ProgressTracker.h"
+#include <charconv>
 //=======================================
 
 //= NAMESPACES ===============
@@ -40,27 +46,44 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
-    static void generate_positions(vector<Vector3>& positions, const vector<std::byte>& height_map, const uint32_t width, const uint32_t height, float min_x, float max_y)
+    static vector<float> load_heights(const vector<std::byte>& height_map, const uint32_t sample_count)
     {
         SP_ASSERT_MSG(!height_map.empty(), "Height map is empty");
 
-        uint32_t index = 0;
-        uint32_t k     = 0;
+        // Read the first channel of every texel and scale it to a [0, 1] range
+        vector<float> heights(sample_count);
+        for (uint32_t i = 0; i < sample_count; i++)
+        {
+            heights[i] = static_cast<float>(height_map[i * 4]) / 255.0f;
+        }
+
+        return heights;
+    }
+
+    static Vector3 get_position(const vector<float>& heights, const uint32_t width, const uint32_t height, const float min_y, const float max_y, const uint32_t x, const uint32_t y)
+    {
+        return Vector3(
+            static_cast<float>(x) - width * 0.5f,  // center on the X axis
+            Helper::Lerp(min_y, max_y, heights[y * width + x]),
+            static_cast<float>(y) - height * 0.5f  // center on the Z axis
+        );
+    }
+
+    // The texture coordinates generate_vertices_and_indices() ends up with, the last write to a vertex wins
+    static Vector2 get_uv(const uint32_t height, const uint32_t x, const uint32_t y)
+    {
+        return Vector2(static_cast<float>(x), static_cast<float>(y < height - 1 ? y + 1 : y - 1));
+    }
+
+    static void generate_positions(vector<Vector3>& positions, const vector<float>& heights, const uint32_t width, const uint32_t height, const float min_y, const float max_y)
+    {
+        SP_ASSERT_MSG(!heights.empty(), "Heights are empty");
 
         for (uint32_t y = 0; y < height; y++)
         {
             for (uint32_t x = 0; x < width; x++)
             {
-                // Read height and scale it to a [0, 1] range
-                const float height = (static_cast<float>(height_map[k]) / 255.0f);
-
-                // Construct position
-                const uint32_t index = y * width + x;
-                positions[index].x = static_cast<float>(x) - width * 0.5f;  // center on the X axis
-                positions[index].z = static_cast<float>(y) - height * 0.5f; // center on the Z axis
-                positions[index].y = Helper::Lerp(min_x, max_y, height);
-
-                k += 4;
+                positions[y * width + x] = get_position(heights, width, height, min_y, max_y, x, y);
             }
         }
     }
@@ -123,115 +146,441 @@ namespace Spartan
         }
     }
 
-    static void generate_normals_and_tangents(const vector<uint32_t>& indices, vector<RHI_Vertex_PosTexNorTan>& vertices)
+    static void compute_face(const RHI_Vertex_PosTexNorTan& vertex_0, const RHI_Vertex_PosTexNorTan& vertex_1, const RHI_Vertex_PosTexNorTan& vertex_2, Vector3* normal, Vector3* tangent)
+    {
+        // Normal, the unnormalized cross product of two edges, so larger faces contribute more
+        const Vector3 edge_a = Vector3(vertex_0.pos[0] - vertex_1.pos[0], vertex_0.pos[1] - vertex_1.pos[1], vertex_0.pos[2] - vertex_1.pos[2]);
+        const Vector3 edge_b = Vector3(vertex_1.pos[0] - vertex_2.pos[0], vertex_1.pos[1] - vertex_2.pos[1], vertex_1.pos[2] - vertex_2.pos[2]);
+        *normal              = Vector3::Cross(edge_a, edge_b);
+
+        // Tangent, from the same edges and their texture coordinate edges
+        const float tc_u1 = vertex_0.tex[0] - vertex_1.tex[0];
+        const float tc_v1 = vertex_0.tex[1] - vertex_1.tex[1];
+        const float tc_u2 = vertex_1.tex[0] - vertex_2.tex[0];
+        const float tc_v2 = vertex_1.tex[1] - vertex_2.tex[1];
+        const float r     = 1.0f / (tc_u1 * tc_v2 - tc_u2 * tc_v1);
+        *tangent          = tc_v1 * edge_a - tc_v2 * edge_b * r;
+    }
+
+    void Terrain::GenerateNormalsAndTangents(const vector<uint32_t>& indices, vector<RHI_Vertex_PosTexNorTan>& vertices, const uint32_t width, const uint32_t height)
     {
         SP_ASSERT_MSG(!indices.empty(),  "Indices are empty");
         SP_ASSERT_MSG(!vertices.empty(), "Vertices are empty");
 
-        // Pre-allocate everything needed by the loop
-        uint32_t triangle_count = static_cast<uint32_t>(indices.size()) / 3;
+        // The triangles are laid out by generate_vertices_and_indices(), two per quad and one row of quads after the other
+        const uint32_t triangles_per_row = (width - 1) * 2;
+        const uint32_t row_count         = height - 1;
+        const uint32_t triangle_count    = triangles_per_row * row_count;
+
+        // 1. Compute the normal and tangent of each face
         vector<Vector3> face_normals(triangle_count);
-        face_normals.reserve(triangle_count);
         vector<Vector3> face_tangents(triangle_count);
-        face_tangents.reserve(triangle_count);
-        Vector3 edge_a;
-        Vector3 edge_b;
+        ThreadPool::ParallelLoop([&vertices, &indices, &face_normals, &face_tangents](uint32_t start_index, uint32_t end_index)
+        {
+            for (uint32_t i = start_index; i < end_index; i++)
+            {
+                compute_face(vertices[indices[(i * 3)]], vertices[indices[(i * 3) + 1]], vertices[indices[(i * 3) + 2]], &face_normals[i], &face_tangents[i]);
+            }
+        }, triangle_count);
+
+        // 2. Accumulate the faces into the vertices they use.
+        // A row of quads only touches two rows of vertices, so all the even rows and then all the odd rows
+        // can be accumulated in parallel, without two threads ever writing to the same vertex.
+        vector<Vector3> normals(vertices.size(), Vector3::Zero);
+        vector<Vector3> tangents(vertices.size(), Vector3::Zero);
+        for (uint32_t parity = 0; parity < 2; parity++)
+        {
+            ThreadPool::ParallelLoop([&indices, &face_normals, &face_tangents, &normals, &tangents, triangles_per_row, parity](uint32_t start_index, uint32_t end_index)
+            {
+                for (uint32_t i = start_index; i < end_index; i++)
+                {
+                    const uint32_t triangle_start = (i * 2 + parity) * triangles_per_row;
+                    const uint32_t triangle_end   = triangle_start + triangles_per_row;
+                    for (uint32_t triangle = triangle_start; triangle < triangle_end; triangle++)
+                    {
+                        for (uint32_t corner = 0; corner < 3; corner++)
+                        {
+                            const uint32_t index = indices[triangle * 3 + corner];
+                            normals[index]      += face_normals[triangle];
+                            tangents[index]     += face_tangents[triangle];
+                        }
+                    }
+                }
+            }, (row_count + 1 - parity) / 2);
+        }
 
-        // Compute the normal and tangent for each face
-        for (uint32_t i = 0; i < triangle_count; ++i)
+        // 3. Normalize (averaging first would only scale the sums) and write them to the vertices
+        ThreadPool::ParallelLoop([&vertices, &normals, &tangents, width](uint32_t start_index, uint32_t end_index)
         {
-            // Normal
+            for (uint32_t y = start_index; y < end_index; y++)
             {
-                // Get the vector describing one edge of our triangle (edge 0, 1)
-                edge_a.x = vertices[indices[(i * 3)]].pos[0] - vertices[indices[(i * 3) + 1]].pos[0];
-                edge_a.y = vertices[indices[(i * 3)]].pos[1] - vertices[indices[(i * 3) + 1]].pos[1];
-                edge_a.z = vertices[indices[(i * 3)]].pos[2] - vertices[indices[(i * 3) + 1]].pos[2];
-
-                // Get the vector describing another edge of our triangle (edge 2,1)
-                edge_b.x = vertices[indices[(i * 3) + 1]].pos[0] - vertices[indices[(i * 3) + 2]].pos[0];
-                edge_b.y = vertices[indices[(i * 3) + 1]].pos[1] - vertices[indices[(i * 3) + 2]].pos[1];
-                edge_b.z = vertices[indices[(i * 3) + 1]].pos[2] - vertices[indices[(i * 3) + 2]].pos[2];
-
-                // Cross multiply the two edge vectors to get the unnormalized face normal
-                face_normals[i] = Vector3::Cross(edge_a, edge_b);
+                for (uint32_t i = y * width; i < (y + 1) * width; i++)
+                {
+                    normals[i].Normalize();
+                    vertices[i].nor[0] = normals[i].x;
+                    vertices[i].nor[1] = normals[i].y;
+                    vertices[i].nor[2] = normals[i].z;
+
+                    tangents[i].Normalize();
+                    vertices[i].tan[0] = tangents[i].x;
+                    vertices[i].tan[1] = tangents[i].y;
+                    vertices[i].tan[2] = tangents[i].z;
+                }
+
+                ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
             }
+        }, height);
+    }
+
+    // Quads along the side of a chunk, a power of two so that every lod stride divides it
+    static constexpr uint32_t chunk_quads = 64;
+
+    // Distance at which lod 1 starts, every next lod starts at twice the distance of the previous one
+    static constexpr float lod_distance = static_cast<float>(chunk_quads);
+
+    static const string chunk_name_prefix = "terrain_chunk_";
+
+    // Enough for a 16k height map, chunk names beyond that aren't trusted
+    static constexpr uint32_t chunk_count_max = (16384 / chunk_quads) * (16384 / chunk_quads);
 
-            // Tangent
+    static uint32_t get_segment_count(const uint32_t quads, const uint32_t stride)
+    {
+        return (quads + stride - 1) / stride;
+    }
+
+    // Lays out the chunks in the mesh, a chunk's vertices are followed by those of the next chunk and so are its lods
+    static void compute_chunk_layout(vector<TerrainChunk>& chunks, const uint32_t width, const uint32_t height, uint32_t* vertex_count, uint32_t* index_count)
+    {
+        const uint32_t quads_x  = width - 1;
+        const uint32_t quads_y  = height - 1;
+        const uint32_t chunks_x = (quads_x + chunk_quads - 1) / chunk_quads;
+        const uint32_t chunks_y = (quads_y + chunk_quads - 1) / chunk_quads;
+
+        chunks.clear();
+        chunks.resize(chunks_x * chunks_y);
+        *vertex_count = 0;
+        *index_count  = 0;
+
+        for (uint32_t cy = 0; cy < chunks_y; cy++)
+        {
+            for (uint32_t cx = 0; cx < chunks_x; cx++)
             {
-                // find first texture coordinate edge 2d vector
-                const float tc_u1 = vertices[indices[(i * 3)]].tex[0] - vertices[indices[(i * 3) + 1]].tex[0];
-                const float tc_v1 = vertices[indices[(i * 3)]].tex[1] - vertices[indices[(i * 3) + 1]].tex[1];
-
-                // find second texture coordinate edge 2d vector
-                const float tc_u2 = vertices[indices[(i * 3) + 1]].tex[0] - vertices[indices[(i * 3) + 2]].tex[0];
-                const float tc_v2 = vertices[indices[(i * 3) + 1]].tex[1] - vertices[indices[(i * 3) + 2]].tex[1];
-
-                // find tangent using both tex coord edges and position edges
-                face_tangents[i].x = (tc_v1 * edge_a.x - tc_v2 * edge_b.x * (1.0f / (tc_u1 * tc_v2 - tc_u2 * tc_v1)));
-                face_tangents[i].y = (tc_v1 * edge_a.y - tc_v2 * edge_b.y * (1.0f / (tc_u1 * tc_v2 - tc_u2 * tc_v1)));
-                face_tangents[i].z = (tc_v1 * edge_a.z - tc_v2 * edge_b.z * (1.0f / (tc_u1 * tc_v2 - tc_u2 * tc_v1)));
+                TerrainChunk& chunk = chunks[cy * chunks_x + cx];
+                chunk.x             = cx * chunk_quads;
+                chunk.y             = cy * chunk_quads;
+                chunk.quads_x       = Helper::Min(chunk_quads, quads_x - chunk.x);
+                chunk.quads_y       = Helper::Min(chunk_quads, quads_y - chunk.y);
+
+                // A grid of vertices, followed by a skirt vertex below each edge vertex
+                const uint32_t row = chunk.quads_x + 1;
+                const uint32_t col = chunk.quads_y + 1;
+                chunk.vertex_offset = *vertex_count;
+                chunk.vertex_count  = row * col + 2 * row + 2 * col;
+                *vertex_count      += chunk.vertex_count;
+
+                // Two triangles per segment of the grid and per segment of the skirts
+                for (uint32_t lod = 0; lod < terrain_lod_count; lod++)
+                {
+                    const uint32_t segments_x = get_segment_count(chunk.quads_x, 1 << lod);
+                    const uint32_t segments_y = get_segment_count(chunk.quads_y, 1 << lod);
+                    chunk.index_offset[lod]   = *index_count;
+                    chunk.index_count[lod]    = (segments_x * segments_y + 2 * segments_x + 2 * segments_y) * 6;
+                    *index_count             += chunk.index_count[lod];
+                }
             }
         }
+    }
 
-        // Compute vertex normals and tangents (normals averaging) - This is very expensive show we split it into multiple threads below
-        const auto compute_vertex_normals_tangents = [&vertices, &indices, &face_normals , &face_tangents, triangle_count](uint32_t start_index, uint32_t range)
+    // Skirts, the edges lowered by the chunk's height range. A crack between two lods along an edge
+    // can't be deeper than that, so the skirts hide the cracks without having to stitch the neighbours.
+    static void generate_chunk_skirts(TerrainChunk& chunk, RHI_Vertex_PosTexNorTan* chunk_vertices)
+    {
+        const uint32_t row = chunk.quads_x + 1;
+        const uint32_t col = chunk.quads_y + 1;
+
+        float y_min = numeric_limits<float>::max();
+        float y_max = numeric_limits<float>::lowest();
+        for (uint32_t i = 0; i < row * col; i++)
+        {
+            y_min = Helper::Min(y_min, chunk_vertices[i].pos[1]);
+            y_max = Helper::Max(y_max, chunk_vertices[i].pos[1]);
+        }
+
+        const float skirt_depth     = y_max - y_min;
+        const uint32_t skirt_bottom = row * col;
+        const uint32_t skirt_top    = skirt_bottom + row;
+        const uint32_t skirt_left   = skirt_top + row;
+        const uint32_t skirt_right  = skirt_left + col;
+        auto add_skirt_vertex = [chunk_vertices, skirt_depth](const uint32_t index_skirt, const uint32_t index_grid)
+        {
+            chunk_vertices[index_skirt]         = chunk_vertices[index_grid];
+            chunk_vertices[index_skirt].pos[1] -= skirt_depth;
+        };
+        for (uint32_t i = 0; i < row; i++)
+        {
+            add_skirt_vertex(skirt_bottom + i, i);
+            add_skirt_vertex(skirt_top + i, (col - 1) * row + i);
+        }
+        for (uint32_t j = 0; j < col; j++)
         {
-            uint32_t product = 0;
-            uint32_t index_0 = 0;
-            uint32_t index_1 = 0;
-            uint32_t index_2 = 0;
+            add_skirt_vertex(skirt_left + j, j * row);
+            add_skirt_vertex(skirt_right + j, j * row + row - 1);
+        }
+
+        chunk.aabb = BoundingBox(chunk_vertices, chunk.vertex_count);
+    }
+
+    static void generate_chunk(TerrainChunk& chunk, const vector<RHI_Vertex_PosTexNorTan>& grid_vertices, const uint32_t width, vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices)
+    {
+        const uint32_t row        = chunk.quads_x + 1;
+        const uint32_t col        = chunk.quads_y + 1;
+        const uint32_t grid_count = row * col;
+        RHI_Vertex_PosTexNorTan* chunk_vertices = &vertices[chunk.vertex_offset];
 
-            for (uint32_t i = start_index; i < range; i++)
+        // Grid, the chunk's part of the terrain
+        for (uint32_t j = 0; j < col; j++)
+        {
+            for (uint32_t i = 0; i < row; i++)
             {
-                Vector3 normal_average  = Vector3::Zero;
-                Vector3 tangent_average = Vector3::Zero;
-                float face_usage_count  = 0;
+                chunk_vertices[j * row + i] = grid_vertices[(chunk.y + j) * width + chunk.x + i];
+            }
+        }
 
-                // Check which triangles use this vertex
-                for (uint32_t j = 0; j < triangle_count; ++j)
-                {
-                    //= MOST EXPENSIVE PART ============
-                    // The cost comes mainly from misses
-                    product = (j << 1) + j; // j * 3;
-                    index_0 = indices[product];
-                    index_1 = indices[product + 1];
-                    index_2 = indices[product + 2];
-                    //==================================
-
-                    if (index_0 == i || index_1 == i || index_2 == i)
-                    {
-                        // If a face is using the vertex, accumulate the face normal/tangent
-                        normal_average  += face_normals[j];
-                        tangent_average += face_tangents[j];
+        generate_chunk_skirts(chunk, chunk_vertices);
+        const uint32_t skirt_bottom = grid_count;
+        const uint32_t skirt_top    = skirt_bottom + row;
+        const uint32_t skirt_left   = skirt_top + row;
+        const uint32_t skirt_right  = skirt_left + col;
 
-                        face_usage_count++;
-                    }
+        // Lods, indices are relative to the chunk's first vertex
+        for (uint32_t lod = 0; lod < terrain_lod_count; lod++)
+        {
+            const uint32_t stride     = 1 << lod;
+            const uint32_t segments_x = get_segment_count(chunk.quads_x, stride);
+            const uint32_t segments_y = get_segment_count(chunk.quads_y, stride);
+            uint32_t* index           = &indices[chunk.index_offset[lod]];
+
+            auto add_quad = [&index](const uint32_t a, const uint32_t b, const uint32_t c, const uint32_t d)
+            {
+                // Same winding as generate_vertices_and_indices()
+                index[0] = a; index[1] = b; index[2] = c;
+                index[3] = a; index[4] = c; index[5] = d;
+                index += 6;
+            };
+
+            // The last segment is shorter when the chunk is at the edge of the terrain and isn't a multiple of the stride
+            for (uint32_t b = 0; b < segments_y; b++)
+            {
+                const uint32_t y0 = Helper::Min(b * stride, chunk.quads_y);
+                const uint32_t y1 = Helper::Min((b + 1) * stride, chunk.quads_y);
+                for (uint32_t a = 0; a < segments_x; a++)
+                {
+                    const uint32_t x0 = Helper::Min(a * stride, chunk.quads_x);
+                    const uint32_t x1 = Helper::Min((a + 1) * stride, chunk.quads_x);
+                    add_quad(y0 * row + x1, y0 * row + x0, y1 * row + x0, y1 * row + x1);
                 }
+            }
+
+            // Skirts, facing outwards
+            for (uint32_t a = 0; a < segments_x; a++)
+            {
+                const uint32_t x0 = Helper::Min(a * stride, chunk.quads_x);
+                const uint32_t x1 = Helper::Min((a + 1) * stride, chunk.quads_x);
+                add_quad(x0, x1, skirt_bottom + x1, skirt_bottom + x0);
+                add_quad((col - 1) * row + x1, (col - 1) * row + x0, skirt_top + x0, skirt_top + x1);
+            }
+            for (uint32_t b = 0; b < segments_y; b++)
+            {
+                const uint32_t y0 = Helper::Min(b * stride, chunk.quads_y);
+                const uint32_t y1 = Helper::Min((b + 1) * stride, chunk.quads_y);
+                add_quad(y1 * row, y0 * row, skirt_left + y0, skirt_left + y1);
+                add_quad(y0 * row + row - 1, y1 * row + row - 1, skirt_right + y1, skirt_right + y0);
+            }
+        }
 
-                // Compute actual normal
-                normal_average /= face_usage_count;
-                normal_average.Normalize();
+        ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
+    }
 
-                // Compute actual tangent
-                tangent_average /= face_usage_count;
-                tangent_average.Normalize();
+    // Builds the quadtree node of the chunks [x0, x1) x [y0, y1) and returns its index
+    static uint32_t build_quadtree(vector<TerrainNode>& nodes, vector<uint32_t>& node_chunks, const vector<TerrainChunk>& chunks, const uint32_t chunks_x, const uint32_t x0, const uint32_t y0, const uint32_t x1, const uint32_t y1)
+    {
+        const uint32_t node_index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes[node_index].chunk_start = static_cast<uint32_t>(node_chunks.size());
 
-                // Write normal to vertex
-                vertices[i].nor[0] = normal_average.x;
-                vertices[i].nor[1] = normal_average.y;
-                vertices[i].nor[2] = normal_average.z;
+        if (x1 - x0 == 1 && y1 - y0 == 1)
+        {
+            const uint32_t chunk_index  = y0 * chunks_x + x0;
+            nodes[node_index].aabb      = chunks[chunk_index].aabb;
+            nodes[node_index].chunk_end = nodes[node_index].chunk_start + 1;
+            node_chunks.emplace_back(chunk_index);
+            return node_index;
+        }
 
-                // Write tangent to vertex
-                vertices[i].tan[0] = tangent_average.x;
-                vertices[i].tan[1] = tangent_average.y;
-                vertices[i].tan[2] = tangent_average.z;
+        // Split in four, a side of one chunk doesn't split
+        const uint32_t x_mid = x0 + (x1 - x0 + 1) / 2;
+        const uint32_t y_mid = y0 + (y1 - y0 + 1) / 2;
+        const array<array<uint32_t, 4>, 4> quadrants =
+        {{
+            { x0,    y0,    x_mid, y_mid },
+            { x_mid, y0,    x1,    y_mid },
+            { x0,    y_mid, x_mid, y1    },
+            { x_mid, y_mid, x1,    y1    }
+        }};
+
+        BoundingBox aabb;
+        bool aabb_set = false;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            const array<uint32_t, 4>& quadrant = quadrants[i];
+            if (quadrant[0] == quadrant[2] || quadrant[1] == quadrant[3])
+                continue;
 
-                ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
+            const uint32_t child_index = build_quadtree(nodes, node_chunks, chunks, chunks_x, quadrant[0], quadrant[1], quadrant[2], quadrant[3]);
+            nodes[node_index].children[i] = child_index;
+
+            if (aabb_set)
+            {
+                aabb.Merge(nodes[child_index].aabb);
             }
+            else
+            {
+                aabb     = nodes[child_index].aabb;
+                aabb_set = true;
+            }
+        }
+
+        nodes[node_index].aabb      = aabb;
+        nodes[node_index].chunk_end = static_cast<uint32_t>(node_chunks.size());
+
+        return node_index;
+    }
+
+    static uint32_t get_lod(const float distance)
+    {
+        if (distance < lod_distance)
+            return 0;
+
+        return Helper::Min(static_cast<uint32_t>(log2(distance / lod_distance)) + 1, terrain_lod_count - 1);
+    }
+
+    // Generates the grid vertices [x0, x1) x [y0, y1) straight from the heights, the same vertices the full generation would
+    static void generate_region_vertices(vector<RHI_Vertex_PosTexNorTan>& region_vertices, const vector<float>& heights, const uint32_t width, const uint32_t height, const float min_y, const float max_y, const uint32_t x0, const uint32_t y0, const uint32_t x1, const uint32_t y1)
+    {
+        auto get_vertex = [&heights, width, height, min_y, max_y](const uint32_t x, const uint32_t y)
+        {
+            return RHI_Vertex_PosTexNorTan(get_position(heights, width, height, min_y, max_y, x, y), get_uv(height, x, y));
         };
 
-        uint32_t vertex_count = static_cast<uint32_t>(vertices.size());
-        ThreadPool::ParallelLoop(compute_vertex_normals_tangents, vertex_count);
+        // 1. Compute the faces of the quads the region's vertices are corners of
+        const uint32_t quad_x0 = x0 > 0 ? x0 - 1 : 0;
+        const uint32_t quad_y0 = y0 > 0 ? y0 - 1 : 0;
+        const uint32_t quads_x = Helper::Min(x1, width - 1) - quad_x0;
+        const uint32_t quads_y = Helper::Min(y1, height - 1) - quad_y0;
+        vector<Vector3> face_normals(quads_x * quads_y * 2);
+        vector<Vector3> face_tangents(quads_x * quads_y * 2);
+        ThreadPool::ParallelLoop([&get_vertex, &face_normals, &face_tangents, quad_x0, quad_y0, quads_x](uint32_t start_index, uint32_t end_index)
+        {
+            for (uint32_t j = start_index; j < end_index; j++)
+            {
+                for (uint32_t i = 0; i < quads_x; i++)
+                {
+                    const uint32_t x                            = quad_x0 + i;
+                    const uint32_t y                            = quad_y0 + j;
+                    const RHI_Vertex_PosTexNorTan bottom_left   = get_vertex(x, y);
+                    const RHI_Vertex_PosTexNorTan bottom_right  = get_vertex(x + 1, y);
+                    const RHI_Vertex_PosTexNorTan top_left      = get_vertex(x, y + 1);
+                    const RHI_Vertex_PosTexNorTan top_right     = get_vertex(x + 1, y + 1);
+                    const uint32_t face                         = (j * quads_x + i) * 2;
+
+                    // Same triangles as generate_vertices_and_indices()
+                    compute_face(bottom_right, bottom_left, top_left, &face_normals[face], &face_tangents[face]);
+                    compute_face(bottom_right, top_left, top_right, &face_normals[face + 1], &face_tangents[face + 1]);
+                }
+            }
+        }, quads_y);
+
+        // 2. Gather the faces of each vertex, instead of scattering the faces to the vertices, so that rows are independent
+        const uint32_t region_width = x1 - x0;
+        region_vertices.resize(region_width * (y1 - y0));
+        ThreadPool::ParallelLoop([&](uint32_t start_index, uint32_t end_index)
+        {
+            for (uint32_t j = start_index; j < end_index; j++)
+            {
+                for (uint32_t i = 0; i < region_width; i++)
+                {
+                    const uint32_t x = x0 + i;
+                    const uint32_t y = y0 + j;
+
+                    Vector3 normal  = Vector3::Zero;
+                    Vector3 tangent = Vector3::Zero;
+                    auto add_face = [&](const uint32_t quad_x, const uint32_t quad_y, const uint32_t triangle)
+                    {
+                        const uint32_t face = ((quad_y - quad_y0) * quads_x + (quad_x - quad_x0)) * 2 + triangle;
+                        normal  += face_normals[face];
+                        tangent += face_tangents[face];
+                    };
+
+                    // The vertex is the bottom left corner of the first triangle of its quad, the bottom right of both
+                    // triangles of the quad to its left, the top left of both triangles of the quad below it and the
+                    // top right of the second triangle of the quad below and to its left.
+                    const bool has_left  = x > 0;
+                    const bool has_right = x < width - 1;
+                    const bool has_below = y > 0;
+                    const bool has_above = y < height - 1;
+                    if (has_right && has_above) { add_face(x, y, 0); }
+                    if (has_left  && has_above) { add_face(x - 1, y, 0);     add_face(x - 1, y, 1); }
+                    if (has_right && has_below) { add_face(x, y - 1, 0);     add_face(x, y - 1, 1); }
+                    if (has_left  && has_below) { add_face(x - 1, y - 1, 1); }
+
+                    normal.Normalize();
+                    tangent.Normalize();
+                    region_vertices[j * region_width + i] = RHI_Vertex_PosTexNorTan(get_position(heights, width, height, min_y, max_y, x, y), get_uv(height, x, y), normal, tangent);
+                }
+            }
+        }, y1 - y0);
+    }
+
+    // Re-computes the bounding boxes of the nodes, children are always after their parent
+    static void refit_quadtree(vector<TerrainNode>& nodes, const vector<uint32_t>& node_chunks, const vector<TerrainChunk>& chunks)
+    {
+        for (uint32_t i = static_cast<uint32_t>(nodes.size()); i-- > 0;)
+        {
+            TerrainNode& node = nodes[i];
+
+            if (node.chunk_end - node.chunk_start == 1)
+            {
+                node.aabb = chunks[node_chunks[node.chunk_start]].aabb;
+                continue;
+            }
+
+            bool aabb_set = false;
+            for (const uint32_t child : node.children)
+            {
+                if (child == 0)
+                    continue;
+
+                if (aabb_set)
+                {
+                    node.aabb.Merge(nodes[child].aabb);
+                }
+                else
+                {
+                    node.aabb = nodes[child].aabb;
+                    aabb_set  = true;
+                }
+            }
+        }
+    }
+
+    // Null if the user deleted the chunk's entity or its renderable
+    static Renderable* get_chunk_renderable(const TerrainChunk& chunk)
+    {
+        shared_ptr<Entity> entity = chunk.entity.lock();
+        if (!entity || entity->IsPendingDestruction())
+            return nullptr;
+
+        return entity->GetRenderable();
     }
 
     Terrain::Terrain(Context* context, Entity* entity, uint64_t id /*= 0*/) : IComponent(context, entity, id)
@@ -239,6 +588,40 @@ namespace Spartan
 
     }
 
+    void Terrain::OnTick(double delta_time)
+    {
+        if (m_is_generating)
+            return;
+
+        // The chunk entities are children, so they are deserialized after this component
+        if (m_chunks_restore_pending)
+        {
+            RestoreChunks();
+        }
+
+        // The heights were re-allocated by a generation or a restore
+        if (m_collider_update_pending)
+        {
+            m_collider_update_pending = false;
+            UpdateCollider();
+        }
+
+        // Entities are created, parented and removed here, on the main thread, and never by the generation task
+        if (m_chunk_entities_update_pending)
+        {
+            m_chunk_entities_update_pending = false;
+            UpdateChunkEntities();
+        }
+
+        if (m_chunks.empty())
+            return;
+
+        if (shared_ptr<Camera> camera = m_context->GetSystem<Renderer>()->GetCamera())
+        {
+            SelectLods(camera->GetTransform()->GetPosition());
+        }
+    }
+
     void Terrain::Serialize(FileStream* stream)
     {
         const string no_path;
@@ -256,7 +639,7 @@ namespace Spartan
         stream->Read(&m_min_y);
         stream->Read(&m_max_y);
 
-        UpdateFromMesh(m_mesh);
+        m_chunks_restore_pending = true;
     }
 
     void Terrain::SetHeightMap(const shared_ptr<RHI_Texture>& height_map)
@@ -264,6 +647,61 @@ namespace Spartan
         m_height_map = ResourceCache::Cache<RHI_Texture>(height_map);
     }
 
+    void Terrain::SetMinY(const float min_y)
+    {
+        if (min_y == m_min_y)
+            return;
+
+        // Every position moves, but the layout, the indices and the buffers stay the same
+        m_min_y = min_y;
+        UpdateRegion(0, 0, m_heights_width, m_heights_height);
+        UpdateCollider();
+    }
+
+    void Terrain::SetMaxY(const float max_y)
+    {
+        if (max_y == m_max_y)
+            return;
+
+        m_max_y = max_y;
+        UpdateRegion(0, 0, m_heights_width, m_heights_height);
+        UpdateCollider();
+    }
+
+    void Terrain::SetHeights(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height, const float* heights)
+    {
+        if (m_is_generating)
+        {
+            SP_LOG_WARNING("Terrain is being generated, please wait...");
+            return;
+        }
+
+        if (m_heights.empty())
+        {
+            SP_LOG_WARNING("The terrain has to be generated before its heights can be edited.");
+            return;
+        }
+
+        SP_ASSERT(heights != nullptr);
+        SP_ASSERT_MSG(x + width <= m_heights_width && y + height <= m_heights_height, "The rectangle is outside of the height map");
+
+        for (uint32_t j = 0; j < height; j++)
+        {
+            for (uint32_t i = 0; i < width; i++)
+            {
+                m_heights[(y + j) * m_heights_width + x + i] = Helper::Saturate(heights[j * width + i]);
+            }
+        }
+
+        // A terrain collider reads the heights in place, so it only refreshes its raycast accelerator
+        if (Collider* collider = m_entity->GetComponent<Collider>())
+        {
+            collider->OnTerrainHeightsChanged(x, y, width, height);
+        }
+
+        UpdateRegion(x, y, width, height);
+    }
+
     void Terrain::GenerateAsync()
     {
         if (m_is_generating)
@@ -278,18 +716,23 @@ namespace Spartan
 
             ResourceCache::Remove(m_mesh);
             m_mesh = nullptr;
-            if (Renderable* renderable = m_entity->AddComponent<Renderable>())
-            {
-                renderable->Clear();
-            }
+            m_chunks.clear();
+            m_quadtree.clear();
+            m_quadtree_chunks.clear();
+            m_chunk_entities_update_pending = true;
             
             return;
         }
 
+        // Set before the task starts, so that OnTick() doesn't touch the chunks while they are rebuilt
+        m_is_generating = true;
+
+        // The heights are about to be re-allocated, so release the collider's shape until they are ready
+        UpdateCollider();
+        m_collider_update_pending = true;
+
         ThreadPool::AddTask([this]()
         {
-            m_is_generating = true;
-
             // Get height map data
             vector<std::byte> height_data;
             {
@@ -316,67 +759,376 @@ namespace Spartan
             uint32_t width   = m_height_map->GetWidth();
             uint32_t height  = m_height_map->GetHeight();
             m_height_samples = width * height;
-            m_vertex_count   = m_height_samples;
-            m_index_count    = m_vertex_count * 6;
-            m_triangle_count = m_index_count / 3;
+            m_heights_width  = width;
+            m_heights_height = height;
+            m_heights        = load_heights(height_data, m_height_samples);
+            compute_chunk_layout(m_chunks, width, height, &m_vertex_count, &m_index_count);
+            const uint32_t chunk_count = static_cast<uint32_t>(m_chunks.size());
 
             uint32_t job_count =
-                1 +              // 1. generate_positions()
-                1 +              // 2. generate_vertices_and_indices()
-                m_vertex_count + // 3. generate_normals_and_tangents()
-                1;               // 4. create mesh
+                1 +           // 1. generate_positions()
+                1 +           // 2. generate_vertices_and_indices()
+                height +      // 3. GenerateNormalsAndTangents(), one job per row of vertices
+                chunk_count + // 4. generate_chunk(), one job per chunk
+                1;            // 5. create mesh
 
             // Star progress tracking
             ProgressTracker::GetProgress(ProgressType::Terrain).Start(job_count, "Generating terrain...");
 
-            // Pre-allocate memory for the calculations that follow
+            // Pre-allocate memory for the calculations that follow, the full resolution grid the chunks are cut from
             vector<Vector3> positions(m_height_samples);
-            positions.reserve(m_height_samples);
-            vector<RHI_Vertex_PosTexNorTan> vertices(m_vertex_count);
-            vertices.reserve(m_vertex_count);
-            vector<uint32_t> indices(m_index_count);
-            indices.reserve(m_index_count);
+            vector<RHI_Vertex_PosTexNorTan> grid_vertices(m_height_samples);
+            vector<uint32_t> grid_indices((width - 1) * (height - 1) * 6);
 
             // 1. Generate positions by reading the height map
             ProgressTracker::GetProgress(ProgressType::Terrain).SetText("Generating positions...");
-            generate_positions(positions, height_data, width, height, m_min_y, m_max_y);
+            generate_positions(positions, m_heights, width, height, m_min_y, m_max_y);
             ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
 
             // 2. Compute vertices and indices
             ProgressTracker::GetProgress(ProgressType::Terrain).SetText("Generating vertices and indices...");
-            generate_vertices_and_indices(vertices, indices, positions, width, height);
+            generate_vertices_and_indices(grid_vertices, grid_indices, positions, width, height);
             ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
 
             // 3. Compute normals and tangents
             ProgressTracker::GetProgress(ProgressType::Terrain).SetText("Generating normals and tangents...");
-            generate_normals_and_tangents(indices, vertices);
-            // Jobs done are tracked internally here because this is the most expensive function
+            GenerateNormalsAndTangents(grid_indices, grid_vertices, width, height);
+            // Jobs done are tracked internally, per row of vertices
 
-            // 4. Create mesh
+            // 4. Cut the grid into chunks and generate their lods, chunks don't share any memory so they are generated in parallel
+            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("Generating chunks and lods...");
+            vector<RHI_Vertex_PosTexNorTan> vertices(m_vertex_count);
+            vector<uint32_t> indices(m_index_count);
+            ThreadPool::ParallelLoop([this, &grid_vertices, &vertices, &indices, width](uint32_t start_index, uint32_t end_index)
+            {
+                for (uint32_t i = start_index; i < end_index; i++)
+                {
+                    generate_chunk(m_chunks[i], grid_vertices, width, vertices, indices);
+                }
+            }, chunk_count);
+
+            m_quadtree.clear();
+            m_quadtree_chunks.clear();
+            const uint32_t chunks_x = (width - 1 + chunk_quads - 1) / chunk_quads;
+            build_quadtree(m_quadtree, m_quadtree_chunks, m_chunks, chunks_x, 0, 0, chunks_x, chunk_count / chunks_x);
+
+            // 5. Create mesh
             ProgressTracker::GetProgress(ProgressType::Terrain).SetText("Creating mesh...");
             UpdateFromVertices(indices, vertices);
             ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
 
-            m_is_generating = false;
+            // The chunk entities are updated by OnTick(), once it sees that the generation is done
+            m_chunk_entities_update_pending = true;
+            m_is_generating                 = false;
         });
     }
 
-    void Terrain::UpdateFromMesh(const shared_ptr<Mesh>& mesh) const
+    void Terrain::UpdateRegion(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
     {
-        if (Renderable* renderable = m_entity->AddComponent<Renderable>())
+        if (m_is_generating || m_chunks.empty() || m_heights.empty() || width == 0 || height == 0)
+            return;
+
+        // The normals and tangents of the vertices around the region depend on the region's faces, so they are included
+        const uint32_t x0 = x > 0 ? x - 1 : 0;
+        const uint32_t y0 = y > 0 ? y - 1 : 0;
+        const uint32_t x1 = Helper::Min(x + width + 1, m_heights_width);
+        const uint32_t y1 = Helper::Min(y + height + 1, m_heights_height);
+        vector<RHI_Vertex_PosTexNorTan> region_vertices;
+        generate_region_vertices(region_vertices, m_heights, m_heights_width, m_heights_height, m_min_y, m_max_y, x0, y0, x1, y1);
+
+        // The chunks which share vertices with the region, neighbouring chunks share their edge vertices
+        vector<uint32_t> chunk_indices;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_chunks.size()); i++)
+        {
+            const TerrainChunk& chunk = m_chunks[i];
+            if (chunk.x <= x1 - 1 && x0 <= chunk.x + chunk.quads_x && chunk.y <= y1 - 1 && y0 <= chunk.y + chunk.quads_y)
+            {
+                chunk_indices.emplace_back(i);
+            }
+        }
+
+        // Copy the region into the chunks and re-generate their skirts, chunks don't share any memory so they are updated in parallel
+        vector<RHI_Vertex_PosTexNorTan>& vertices = m_mesh->GetVertices();
+        vector<pair<uint32_t, uint32_t>> ranges(chunk_indices.size() * 2);
+        ThreadPool::ParallelLoop([&](uint32_t start_index, uint32_t end_index)
+        {
+            for (uint32_t c = start_index; c < end_index; c++)
+            {
+                TerrainChunk& chunk = m_chunks[chunk_indices[c]];
+                const uint32_t row  = chunk.quads_x + 1;
+                const uint32_t col  = chunk.quads_y + 1;
+                const uint32_t i0   = Helper::Max(x0, chunk.x) - chunk.x;
+                const uint32_t i1   = Helper::Min(x1, chunk.x + row) - chunk.x;
+                const uint32_t j0   = Helper::Max(y0, chunk.y) - chunk.y;
+                const uint32_t j1   = Helper::Min(y1, chunk.y + col) - chunk.y;
+                RHI_Vertex_PosTexNorTan* chunk_vertices = &vertices[chunk.vertex_offset];
+
+                for (uint32_t j = j0; j < j1; j++)
+                {
+                    const RHI_Vertex_PosTexNorTan* source = &region_vertices[(chunk.y + j - y0) * (x1 - x0) + chunk.x + i0 - x0];
+                    copy(source, source + (i1 - i0), &chunk_vertices[j * row + i0]);
+                }
+
+                generate_chunk_skirts(chunk, chunk_vertices);
+
+                // The rows that changed and the skirts, which follow the grid
+                ranges[c * 2]     = { chunk.vertex_offset + j0 * row, (j1 - j0) * row };
+                ranges[c * 2 + 1] = { chunk.vertex_offset + row * col, chunk.vertex_count - row * col };
+            }
+        }, static_cast<uint32_t>(chunk_indices.size()));
+
+        m_mesh->UpdateGpuVertices(ranges);
+
+        // The chunks' bounding boxes might have grown or shrunk
+        refit_quadtree(m_quadtree, m_quadtree_chunks, m_chunks);
+        for (const uint32_t i : chunk_indices)
         {
+            const TerrainChunk& chunk = m_chunks[i];
+            Renderable* renderable    = get_chunk_renderable(chunk);
+            if (!renderable)
+            {
+                m_chunk_entities_update_pending = true;
+                continue;
+            }
+
             renderable->SetGeometry(
                 "Terrain",
-                0,                      // index offset
-                mesh->GetIndexCount(),  // index count
-                0,                      // vertex offset
-                mesh->GetVertexCount(), // vertex count
-                mesh->GetAabb(),
-                mesh.get()
+                chunk.index_offset[chunk.lod],
+                chunk.index_count[chunk.lod],
+                chunk.vertex_offset,
+                chunk.vertex_count,
+                chunk.aabb,
+                m_mesh.get()
             );
+        }
+    }
+
+    void Terrain::UpdateChunkEntities()
+    {
+        World* world = m_context->GetSystem<World>();
 
+        // Terrains generated before chunking was introduced were a single renderable on this entity
+        if (m_entity->GetComponent<Renderable>())
+        {
+            m_entity->RemoveComponent<Renderable>();
+        }
+
+        // Re-use the chunk entities of the previous generation, if any
+        vector<Entity*> chunk_entities = GetChunkEntities();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_chunks.size()); i++)
+        {
+            TerrainChunk& chunk = m_chunks[i];
+
+            shared_ptr<Entity> entity = i < chunk_entities.size() && chunk_entities[i] ? chunk_entities[i]->GetPtrShared() : nullptr;
+            if (!entity)
+            {
+                entity = world->CreateEntity();
+                entity->SetName(chunk_name_prefix + to_string(i));
+                entity->SetHierarchyVisibility(false);
+                entity->GetTransform()->SetParent(m_entity->GetTransform());
+            }
+
+            chunk.entity = entity;
+            chunk.lod    = 0;
+            Renderable* renderable = entity->AddComponent<Renderable>();
+            renderable->SetGeometry(
+                "Terrain",
+                chunk.index_offset[0],
+                chunk.index_count[0],
+                chunk.vertex_offset,
+                chunk.vertex_count,
+                chunk.aabb,
+                m_mesh.get()
+            );
             renderable->SetDefaultMaterial();
         }
+
+        // Remove the chunks the new layout doesn't have
+        for (uint32_t i = static_cast<uint32_t>(m_chunks.size()); i < static_cast<uint32_t>(chunk_entities.size()); i++)
+        {
+            if (chunk_entities[i])
+            {
+                world->RemoveEntity(chunk_entities[i]);
+            }
+        }
+    }
+
+    void Terrain::RestoreChunks()
+    {
+        m_chunks_restore_pending = false;
+
+        if (!m_mesh || !m_height_map)
+            return;
+
+        uint32_t vertex_count = 0;
+        uint32_t index_count  = 0;
+        compute_chunk_layout(m_chunks, m_height_map->GetWidth(), m_height_map->GetHeight(), &vertex_count, &index_count);
+        vector<Entity*> chunk_entities = GetChunkEntities();
+
+        // Older terrains were a single renderable, they keep working as is until they are re-generated
+        if (vertex_count != m_mesh->GetVertexCount() || index_count != m_mesh->GetIndexCount() || chunk_entities.size() != m_chunks.size())
+        {
+            m_chunks.clear();
+            return;
+        }
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_chunks.size()); i++)
+        {
+            Renderable* renderable = chunk_entities[i] ? chunk_entities[i]->GetRenderable() : nullptr;
+            if (!renderable)
+            {
+                SP_LOG_WARNING("Terrain chunk %d is missing, re-generate the terrain", i);
+                m_chunks.clear();
+                return;
+            }
+
+            m_chunks[i].entity = chunk_entities[i]->GetPtrShared();
+            m_chunks[i].aabb   = renderable->GetBoundingBox();
+            m_chunks[i].lod    = 0;
+            for (uint32_t lod = 0; lod < terrain_lod_count; lod++)
+            {
+                if (renderable->GetIndexOffset() == m_chunks[i].index_offset[lod])
+                {
+                    m_chunks[i].lod = lod;
+                }
+            }
+        }
+
+        // The heights the mesh was generated from, edits included, read back from the grid vertices
+        const uint32_t width = m_height_map->GetWidth();
+        const float range_y  = m_max_y - m_min_y;
+        m_heights_width      = width;
+        m_heights_height     = m_height_map->GetHeight();
+        m_height_samples     = m_heights_width * m_heights_height;
+        m_heights.assign(m_height_samples, 0.0f);
+        const vector<RHI_Vertex_PosTexNorTan>& vertices = m_mesh->GetVertices();
+        for (const TerrainChunk& chunk : m_chunks)
+        {
+            const uint32_t row = chunk.quads_x + 1;
+            for (uint32_t j = 0; j <= chunk.quads_y; j++)
+            {
+                for (uint32_t i = 0; i < row; i++)
+                {
+                    const float y = vertices[chunk.vertex_offset + j * row + i].pos[1];
+                    m_heights[(chunk.y + j) * width + chunk.x + i] = range_y != 0.0f ? (y - m_min_y) / range_y : 0.0f;
+                }
+            }
+        }
+
+        m_collider_update_pending = true;
+
+        m_vertex_count = vertex_count;
+        m_index_count  = index_count;
+        m_quadtree.clear();
+        m_quadtree_chunks.clear();
+        const uint32_t chunks_x = (m_height_map->GetWidth() - 1 + chunk_quads - 1) / chunk_quads;
+        build_quadtree(m_quadtree, m_quadtree_chunks, m_chunks, chunks_x, 0, 0, chunks_x, static_cast<uint32_t>(m_chunks.size()) / chunks_x);
+    }
+
+    void Terrain::SelectLods(const Vector3& camera_position)
+    {
+        const Matrix& transform = m_entity->GetTransform()->GetMatrix();
+        m_triangle_count        = 0;
+
+        // Descend until all the chunks of a node fall within the same lod, which for distant nodes happens early
+        vector<uint32_t> stack = { 0 };
+        while (!stack.empty())
+        {
+            const TerrainNode& node = m_quadtree[stack.back()];
+            stack.pop_back();
+
+            // Nearest and farthest distance from the camera to the node
+            const BoundingBox aabb = node.aabb.Transform(transform);
+            const Vector3 nearest  = Vector3(
+                Helper::Clamp(camera_position.x, aabb.GetMin().x, aabb.GetMax().x),
+                Helper::Clamp(camera_position.y, aabb.GetMin().y, aabb.GetMax().y),
+                Helper::Clamp(camera_position.z, aabb.GetMin().z, aabb.GetMax().z)
+            );
+            const Vector3 to_min   = (camera_position - aabb.GetMin()).Abs();
+            const Vector3 to_max   = (camera_position - aabb.GetMax()).Abs();
+            const Vector3 farthest = Vector3(Helper::Max(to_min.x, to_max.x), Helper::Max(to_min.y, to_max.y), Helper::Max(to_min.z, to_max.z));
+            const uint32_t lod     = get_lod(Vector3::Distance(camera_position, nearest));
+            const bool is_leaf     = node.chunk_end - node.chunk_start == 1;
+
+            if (!is_leaf && lod != get_lod(farthest.Length()))
+            {
+                for (const uint32_t child : node.children)
+                {
+                    if (child != 0)
+                    {
+                        stack.emplace_back(child);
+                    }
+                }
+
+                continue;
+            }
+
+            for (uint32_t i = node.chunk_start; i < node.chunk_end; i++)
+            {
+                TerrainChunk& chunk = m_chunks[m_quadtree_chunks[i]];
+                m_triangle_count   += chunk.index_count[lod] / 3;
+
+                if (chunk.lod == lod)
+                    continue;
+
+                // Deleted by the user, the next tick re-creates it
+                Renderable* renderable = get_chunk_renderable(chunk);
+                if (!renderable)
+                {
+                    m_chunk_entities_update_pending = true;
+                    continue;
+                }
+
+                chunk.lod = lod;
+                renderable->SetGeometry(
+                    "Terrain",
+                    chunk.index_offset[lod],
+                    chunk.index_count[lod],
+                    chunk.vertex_offset,
+                    chunk.vertex_count,
+                    chunk.aabb,
+                    m_mesh.get()
+                );
+            }
+        }
+    }
+
+    void Terrain::UpdateCollider()
+    {
+        if (Collider* collider = m_entity->GetComponent<Collider>())
+        {
+            collider->OnTerrainChanged();
+        }
+    }
+
+    vector<Entity*> Terrain::GetChunkEntities() const
+    {
+        // Indexed by chunk, children which aren't chunks (or are about to be destroyed) are left alone
+        vector<Entity*> chunk_entities;
+        for (Transform* child : m_entity->GetTransform()->GetChildren())
+        {
+            if (child->GetEntity()->IsPendingDestruction())
+                continue;
+
+            const string& name = child->GetEntity()->GetName();
+            if (name.size() <= chunk_name_prefix.size() || name.compare(0, chunk_name_prefix.size(), chunk_name_prefix) != 0)
+                continue;
+
+            // The name can be edited by the user, so anything but a plain index is ignored
+            uint32_t index                 = 0;
+            const char* index_end          = name.data() + name.size();
+            const from_chars_result result = from_chars(name.data() + chunk_name_prefix.size(), index_end, index);
+            if (result.ec != errc() || result.ptr != index_end || index >= chunk_count_max)
+                continue;
+
+            if (index >= chunk_entities.size())
+            {
+                chunk_entities.resize(index + 1, nullptr);
+            }
+            chunk_entities[index] = child->GetEntity();
+        }
+
+        return chunk_entities;
     }
 
     void Terrain::UpdateFromVertices(const vector<uint32_t>& indices, vector<RHI_Vertex_PosTexNorTan>& vertices)
@@ -408,7 +1160,5 @@ namespace Spartan
             m_mesh->ComputeNormalizedScale();
             m_mesh->ComputeAabb();
         }
-
-        UpdateFromMesh(m_mesh);
     }
 }
@@ -24,17 +24,48 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ========================
 #include "IComponent.h"
 #include <atomic>
+#include <array>
 #include "../../RHI/RHI_Definition.h"
+#include "../../Math/BoundingBox.h"
 //===================================
 
 namespace Spartan
 {
     class Mesh;
+    class Entity;
     namespace Math
     {
         class Vector3;
     }
 
+    // Lod i skips every 2^i - 1 vertices of the chunk
+    static constexpr uint32_t terrain_lod_count = 6;
+
+    // A fixed size piece of the terrain, with its own vertices and an index range per lod
+    struct TerrainChunk
+    {
+        uint32_t x       = 0; // first quad
+        uint32_t y       = 0;
+        uint32_t quads_x = 0;
+        uint32_t quads_y = 0;
+        uint32_t vertex_offset = 0;
+        uint32_t vertex_count  = 0;
+        std::array<uint32_t, terrain_lod_count> index_offset = {};
+        std::array<uint32_t, terrain_lod_count> index_count  = {};
+        Math::BoundingBox aabb;
+        uint32_t lod = 0;
+        std::weak_ptr<Entity> entity; // a child of the terrain's entity, which the user can delete
+    };
+
+    // Quadtree node, covering the chunks [chunk_start, chunk_end) of the quadtree order
+    struct TerrainNode
+    {
+        Math::BoundingBox aabb;
+        uint32_t chunk_start = 0;
+        uint32_t chunk_end   = 0;
+        std::array<uint32_t, 4> children = { 0, 0, 0, 0 }; // 0 means none, the root is never a child
+    };
+
     class SP_CLASS Terrain : public IComponent
     {
     public:
@@ -42,6 +73,7 @@ namespace Spartan
         ~Terrain() = default;
 
         //= IComponent ===============================
+        void OnTick(double delta_time) override;
         void Serialize(FileStream* stream) override;
         void Deserialize(FileStream* stream) override;
         //============================================
@@ -49,31 +81,60 @@ namespace Spartan
         const std::shared_ptr<RHI_Texture>& GetHeightMap() const { return m_height_map; }
         void SetHeightMap(const std::shared_ptr<RHI_Texture>& height_map);
 
-        float GetMinY()     const { return m_min_y; }
-        void SetMinY(float min_z) { m_min_y = min_z; }
+        float GetMinY() const { return m_min_y; }
+        void SetMinY(float min_y); // moves and uploads every vertex, so set it once the value is final
+
+        float GetMaxY() const { return m_max_y; }
+        void SetMaxY(float max_y); // moves and uploads every vertex, so set it once the value is final
 
-        float GetMaxY()     const { return m_max_y; }
-        void SetMaxY(float max_z) { m_max_y = max_z; }
+        // Heights in a [0, 1] range, one per height map texel, row after row
+        const std::vector<float>& GetHeights() const { return m_heights; }
+        uint32_t GetHeightsWidth()             const { return m_heights_width; }
+        uint32_t GetHeightsHeight()            const { return m_heights_height; }
+
+        // Writes a rectangle of heights (clamped to [0, 1]) and only regenerates the vertices it affects
+        void SetHeights(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const float* heights);
 
         uint64_t GetHeightsamples() const { return m_height_samples; }
         uint32_t GetVertexCount()   const { return m_vertex_count; }
         uint32_t GetIndexCount()    const { return m_index_count; }
+        uint32_t GetChunkCount()    const { return static_cast<uint32_t>(m_chunks.size()); }
+        uint32_t GetTriangleCount() const { return m_triangle_count; } // at the selected lods
 
         void GenerateAsync();
+        bool IsGenerating() const { return m_is_generating; }
+
+        // Smooth normals and tangents for a grid of width x height vertices, two triangles per quad and one row of quads after the other.
+        // Each row of vertices is reported as a job of the terrain's progress.
+        static void GenerateNormalsAndTangents(const std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t width, uint32_t height);
 
     private:
-        void UpdateFromMesh(const std::shared_ptr<Mesh>& mesh) const;
         void UpdateFromVertices(const std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices);
+        void UpdateRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+        void UpdateChunkEntities();
+        void RestoreChunks();
+        void SelectLods(const Math::Vector3& camera_position);
+        void UpdateCollider();
+        std::vector<Entity*> GetChunkEntities() const;
 
-        float m_min_y                     = 0.0f;
-        float m_max_y                     = 30.0f;
-        float m_vertex_density            = 1.0f;
-        std::atomic<bool> m_is_generating = false;
-        uint32_t m_height_samples         = 0;
-        uint32_t m_vertex_count           = 0;
-        uint32_t m_index_count            = 0;
-        uint32_t m_triangle_count         = 0;
+        float m_min_y                        = 0.0f;
+        float m_max_y                        = 30.0f;
+        float m_vertex_density               = 1.0f;
+        std::atomic<bool> m_is_generating    = false;
+        bool m_chunks_restore_pending        = false;
+        bool m_collider_update_pending       = false;
+        bool m_chunk_entities_update_pending = false;
+        uint32_t m_height_samples            = 0;
+        uint32_t m_vertex_count              = 0;
+        uint32_t m_index_count               = 0;
+        uint32_t m_triangle_count            = 0;
+        uint32_t m_heights_width             = 0;
+        uint32_t m_heights_height            = 0;
+        std::vector<float> m_heights;
         std::shared_ptr<RHI_Texture> m_height_map;
         std::shared_ptr<Mesh> m_mesh;
+        std::vector<TerrainChunk> m_chunks;
+        std::vector<TerrainNode> m_quadtree;
+        std::vector<uint32_t> m_quadtree_chunks; // chunk indices in quadtree order
     };
 }
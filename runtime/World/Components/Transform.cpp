@@ -36,46 +36,27 @@ namespace Spartan
 {
     Transform::Transform(Context* context, Entity* entity, uint64_t id /*= 0*/) : IComponent(context, entity, id, this)
     {
-        m_position_local  = Vector3::Zero;
-        m_rotation_local  = Quaternion(0, 0, 0, 1);
-        m_scale_local     = Vector3::One;
-        m_matrix          = Matrix::Identity;
-        m_matrix_local    = Matrix::Identity;
+        m_store           = context->GetSystem<World>()->GetTransformStore();
+        m_slot            = m_store->Allocate(this);
         m_matrix_previous = Matrix::Identity;
         m_parent          = nullptr;
-        m_is_dirty        = true;
 
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_position_local, Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation_local, Quaternion);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_scale_local,    Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix,         Matrix);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix_local,   Matrix);
+        SP_REGISTER_ATTRIBUTE_GET_SET(GetPositionLocal, SetPositionLocal, Vector3);
+        SP_REGISTER_ATTRIBUTE_GET_SET(GetRotationLocal, SetRotationLocal, Quaternion);
+        SP_REGISTER_ATTRIBUTE_GET_SET(GetScaleLocal,    SetScaleLocal,    Vector3);
     }
 
-    void Transform::OnInitialize()
+    Transform::~Transform()
     {
-        m_is_dirty = true;
-    }
-
-    void Transform::OnTick(double delta_time)
-    {
-        if (!m_is_dirty)
-            return;
-
-        UpdateTransform();
-
-        m_is_dirty                    = false;
-        m_position_changed_this_frame = false;
-        m_rotation_changed_this_frame = true;
-        m_scale_changed_this_frame    = true;
+        m_store->Free(m_slot);
     }
 
     void Transform::Serialize(FileStream* stream)
     {
         // Properties
-        stream->Write(m_position_local);
-        stream->Write(m_rotation_local);
-        stream->Write(m_scale_local);
+        stream->Write(GetPositionLocal());
+        stream->Write(GetRotationLocal());
+        stream->Write(GetScaleLocal());
 
         // Hierarchy
         stream->Write(m_parent ? m_parent->GetEntity()->GetObjectId() : 0);
@@ -84,9 +65,9 @@ namespace Spartan
     void Transform::Deserialize(FileStream* stream)
     {
         // Properties
-        stream->Read(&m_position_local);
-        stream->Read(&m_rotation_local);
-        stream->Read(&m_scale_local);
+        stream->Read(&m_store->GetPositionLocal(m_slot));
+        stream->Read(&m_store->GetRotationLocal(m_slot));
+        stream->Read(&m_store->GetScaleLocal(m_slot));
 
         // Hierarchy
         uint64_t parent_entity_id = 0;
@@ -104,20 +85,8 @@ namespace Spartan
 
     void Transform::UpdateTransform()
     {
-        // Compute local transform
-        m_matrix_local = Matrix(m_position_local, m_rotation_local, m_scale_local);
-
-        // Compute world transform
-        if (m_parent)
-        {
-            m_matrix = m_matrix_local * m_parent->GetMatrix();
-        }
-        else
-        {
-            m_matrix = m_matrix_local;
-        }
-
-        // Update children
+        // Mark this transform and its descendants, reading any of them recomputes it and the store's Update() propagates the change
+        m_store->MakeDirty(m_slot);
         for (Transform* child : m_children)
         {
             child->UpdateTransform();
@@ -134,13 +103,14 @@ namespace Spartan
 
     void Transform::SetPositionLocal(const Vector3& position)
     {
-        if (m_position_local == position)
+        Vector3& position_local = m_store->GetPositionLocal(m_slot);
+        if (position_local == position)
             return;
 
-        m_position_local = position;
+        position_local = position;
         UpdateTransform();
 
-        m_position_changed_this_frame = true;
+        m_position_changed_frame = m_store->GetFrame();
     }
 
     void Transform::SetRotation(const Quaternion& rotation)
@@ -153,13 +123,14 @@ namespace Spartan
 
     void Transform::SetRotationLocal(const Quaternion& rotation)
     {
-        if (m_rotation_local == rotation)
+        Quaternion& rotation_local = m_store->GetRotationLocal(m_slot);
+        if (rotation_local == rotation)
             return;
 
-        m_rotation_local = rotation;
+        rotation_local = rotation;
         UpdateTransform();
 
-        m_rotation_changed_this_frame = true;
+        m_rotation_changed_frame = m_store->GetFrame();
     }
 
     void Transform::SetScale(const Vector3& scale)
@@ -172,30 +143,31 @@ namespace Spartan
 
     void Transform::SetScaleLocal(const Vector3& scale)
     {
-        if (m_scale_local == scale)
+        Vector3& scale_local = m_store->GetScaleLocal(m_slot);
+        if (scale_local == scale)
             return;
 
-        m_scale_local = scale;
+        scale_local = scale;
 
         // A scale of 0 will cause a division by zero when decomposing the world transform matrix.
-        m_scale_local.x = (m_scale_local.x == 0.0f) ? Helper::EPSILON : m_scale_local.x;
-        m_scale_local.y = (m_scale_local.y == 0.0f) ? Helper::EPSILON : m_scale_local.y;
-        m_scale_local.z = (m_scale_local.z == 0.0f) ? Helper::EPSILON : m_scale_local.z;
+        scale_local.x = (scale_local.x == 0.0f) ? Helper::EPSILON : scale_local.x;
+        scale_local.y = (scale_local.y == 0.0f) ? Helper::EPSILON : scale_local.y;
+        scale_local.z = (scale_local.z == 0.0f) ? Helper::EPSILON : scale_local.z;
 
         UpdateTransform();
 
-        m_scale_changed_this_frame = true;
+        m_scale_changed_frame = m_store->GetFrame();
     }
 
     void Transform::Translate(const Vector3& delta)
     {
         if (!HasParent())
         {
-            SetPositionLocal(m_position_local + delta);
+            SetPositionLocal(GetPositionLocal() + delta);
         }
         else
         {
-            SetPositionLocal(m_position_local + GetParent()->GetMatrix().Inverted() * delta);
+            SetPositionLocal(GetPositionLocal() + GetParent()->GetMatrix().Inverted() * delta);
         }
     }
 
@@ -203,11 +175,11 @@ namespace Spartan
     {
         if (!HasParent())
         {
-            SetRotationLocal((m_rotation_local * delta).Normalized());
+            SetRotationLocal((GetRotationLocal() * delta).Normalized());
         }
         else
         {
-            SetRotationLocal(m_rotation_local * GetRotation().Inverse() * delta * GetRotation());
+            SetRotationLocal(GetRotationLocal() * GetRotation().Inverse() * delta * GetRotation());
         }
     }
 
@@ -309,12 +281,12 @@ namespace Spartan
         if (new_parent)
         {
             new_parent->AddChild_Internal(this);
-            new_parent->MakeDirty();
         }
 
-        // Assign the new parent.
-        m_parent   = new_parent;
-        m_is_dirty = true;
+        // Assign the new parent, the store will update the world matrix
+        m_parent = new_parent;
+        m_store->SetParent(m_slot, new_parent ? new_parent->m_slot : TransformStore::slot_invalid);
+        UpdateTransform();
     }
 
     void Transform::AddChild(Transform* child)
@@ -352,14 +324,10 @@ namespace Spartan
                 return;
         }
 
-        // Mark as dirty if the parent is about to really change.
-        if ((m_parent && !new_parent) || (!m_parent && new_parent))
-        {
-            m_is_dirty = true;
-        }
-
-        // Assign the new parent.
+        // Assign the new parent, the store will update the world matrix
         m_parent = new_parent;
+        m_store->SetParent(m_slot, new_parent ? new_parent->m_slot : TransformStore::slot_invalid);
+        UpdateTransform();
     }
 
     void Transform::AddChild_Internal(Transform* child)
@@ -400,7 +368,7 @@ namespace Spartan
         m_children.clear();
         m_children.shrink_to_fit();
 
-        auto entities = GetContext()->GetSystem<World>()->GetAllEntities();
+        const auto& entities = GetContext()->GetSystem<World>()->GetAllEntities();
         for (const auto& entity : entities)
         {
             if (!entity)
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include "IComponent.h"
 #include <vector>
+#include "../TransformStore.h"
 #include "../../Math/Vector3.h"
 #include "../../Math/Quaternion.h"
 #include "../../Math/Matrix.h"
@@ -38,32 +39,30 @@ namespace Spartan
     {
     public:
         Transform(Context* context, Entity* entity, uint64_t id = 0);
-        ~Transform() = default;
+        ~Transform();
 
         //= ICOMPONENT ===============================
-        void OnInitialize() override;
-        void OnTick(double delta_time) override;
         void Serialize(FileStream* stream) override;
         void Deserialize(FileStream* stream) override;
         //============================================
 
         //= POSITION ======================================================================
-        Math::Vector3 GetPosition()             const { return m_matrix.GetTranslation(); }
-        const Math::Vector3& GetPositionLocal() const { return m_position_local; }
+        Math::Vector3 GetPosition()             const { return GetMatrix().GetTranslation(); }
+        const Math::Vector3& GetPositionLocal() const { return m_store->GetPositionLocal(m_slot); }
         void SetPosition(const Math::Vector3& position);
         void SetPositionLocal(const Math::Vector3& position);
         //=================================================================================
 
         //= ROTATION ======================================================================
-        Math::Quaternion GetRotation()             const { return m_matrix.GetRotation(); }
-        const Math::Quaternion& GetRotationLocal() const { return m_rotation_local; }
+        Math::Quaternion GetRotation()             const { return GetMatrix().GetRotation(); }
+        const Math::Quaternion& GetRotationLocal() const { return m_store->GetRotationLocal(m_slot); }
         void SetRotation(const Math::Quaternion& rotation);
         void SetRotationLocal(const Math::Quaternion& rotation);
         //=================================================================================
 
         //= SCALE ================================================================
-        Math::Vector3 GetScale()             const { return m_matrix.GetScale(); }
-        const Math::Vector3& GetScaleLocal() const { return m_scale_local; }
+        Math::Vector3 GetScale()             const { return GetMatrix().GetScale(); }
+        const Math::Vector3& GetScaleLocal() const { return m_store->GetScaleLocal(m_slot); }
         void SetScale(const Math::Vector3& scale);
         void SetScaleLocal(const Math::Vector3& scale);
         //========================================================================
@@ -82,11 +81,12 @@ namespace Spartan
         Math::Vector3 GetLeft()     const;
         //================================
 
-        //= DIRTY CHECKS =================================================================
-        bool HasPositionChangedThisFrame() const { return m_position_changed_this_frame; }
-        bool HasRotationChangedThisFrame() const { return m_rotation_changed_this_frame; }
-        bool HasScaleChangedThisFrame()    const { return m_scale_changed_this_frame; }
-        //================================================================================
+        //= DIRTY CHECKS =========================================================================================
+        // True from the moment of the change until the end of the next frame, so that every component sees it
+        bool HasPositionChangedThisFrame() const { return m_position_changed_frame + 1 >= m_store->GetFrame(); }
+        bool HasRotationChangedThisFrame() const { return m_rotation_changed_frame + 1 >= m_store->GetFrame(); }
+        bool HasScaleChangedThisFrame()    const { return m_scale_changed_frame + 1 >= m_store->GetFrame(); }
+        //========================================================================================================
 
         //= HIERARCHY ======================================================================================
         void SetParent(Transform* new_parent);
@@ -105,14 +105,17 @@ namespace Spartan
         Transform* GetRoot()                         { return HasParent() ? GetParent()->GetRoot() : this; }
         Transform* GetParent()                 const { return m_parent; }
         std::vector<Transform*>& GetChildren()       { return m_children; }
-        void MakeDirty()                             { m_is_dirty = true; }
+        void MakeDirty()                             { UpdateTransform(); }
         //==================================================================================================
 
-        const Math::Matrix& GetMatrix()                    const { return m_matrix; }
-        const Math::Matrix& GetLocalMatrix()               const { return m_matrix_local; }
+        const Math::Matrix& GetMatrix()                    const { return m_store->GetMatrix(m_slot); }
+        const Math::Matrix& GetLocalMatrix()               const { return m_store->GetMatrixLocal(m_slot); }
         const Math::Matrix& GetMatrixPrevious()            const { return m_matrix_previous; }
         void SetMatrixPrevious(const Math::Matrix& matrix)       { m_matrix_previous = matrix;}
 
+        // The slot which holds this transform's data in the world's TransformStore
+        uint32_t GetSlot() const { return m_slot; }
+
     private:
         // Internal functions don't propagate changes throughout the hierarchy.
         // They just make enough changes so that the hierarchy can be resolved later (in one go).
@@ -122,24 +125,19 @@ namespace Spartan
 
         void UpdateTransform();
         Math::Matrix GetParentTransformMatrix() const;
-        bool m_is_dirty = false;
-
-        // local
-        Math::Vector3 m_position_local;
-        Math::Quaternion m_rotation_local;
-        Math::Vector3 m_scale_local;
 
-        Math::Matrix m_matrix;
-        Math::Matrix m_matrix_local;
+        // The positions, rotations, scales and matrices live in the store, shared with the world
+        std::shared_ptr<TransformStore> m_store;
+        uint32_t m_slot = TransformStore::slot_invalid;
 
         Transform* m_parent; // the parent of this transform
         std::vector<Transform*> m_children; // the children of this transform
 
         Math::Matrix m_matrix_previous;
 
-        bool m_position_changed_this_frame = false;
-        bool m_rotation_changed_this_frame = false;
-        bool m_scale_changed_this_frame    = false;
+        uint32_t m_position_changed_frame = 0;
+        uint32_t m_rotation_changed_frame = 0;
+        uint32_t m_scale_changed_frame    = 0;
 
         // thread safety
         std::mutex m_child_add_remove_mutex;
@@ -112,7 +112,7 @@ namespace Spartan
 
     void Entity::OnStart()
     {
-        for (shared_ptr<IComponent> component : m_components)
+        for (const shared_ptr<IComponent>& component : m_components)
         {
             if (component)
             {
@@ -123,7 +123,7 @@ namespace Spartan
 
     void Entity::OnStop()
     {
-        for (shared_ptr<IComponent> component : m_components)
+        for (const shared_ptr<IComponent>& component : m_components)
         {
             if (component)
             {
@@ -142,7 +142,7 @@ namespace Spartan
         if (!m_is_active)
             return;
 
-        for (shared_ptr<IComponent> component : m_components)
+        for (const shared_ptr<IComponent>& component : m_components)
         {
             if (component)
             {
@@ -151,6 +151,37 @@ namespace Spartan
         }
     }
 
+    void Entity::ReleaseComponent(shared_ptr<IComponent>& component)
+    {
+        if (!component)
+            return;
+
+        m_context->GetSystem<World>()->OnComponentRemoved(component);
+        component = nullptr;
+    }
+
+    void Entity::SetName(const string& name)
+    {
+        if (name == m_name)
+            return;
+
+        const string name_old = m_name;
+        m_name = name;
+
+        m_context->GetSystem<World>()->OnEntityNameChanged(this, name_old);
+    }
+
+    void Entity::SetObjectId(const uint64_t id)
+    {
+        if (id == m_object_id)
+            return;
+
+        const uint64_t id_old = m_object_id;
+        m_object_id = id;
+
+        m_context->GetSystem<World>()->OnEntityIdChanged(this, id_old);
+    }
+
     void Entity::Serialize(FileStream* stream)
     {
         // BASIC DATA
@@ -215,8 +246,8 @@ namespace Spartan
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_object_id);
-            stream->Read(&m_name);
+            SetObjectId(stream->ReadAs<uint64_t>());
+            SetName(stream->ReadAs<string>());
         }
 
         // COMPONENTS
@@ -272,20 +303,15 @@ namespace Spartan
                 children.emplace_back(child);
             }
 
-            // Children
+            // Children, they attach themselves to this transform when they deserialize
             for (const auto& child : children)
             {
                 child.lock()->Deserialize(stream, GetTransform());
             }
-
-            if (m_transform)
-            {
-                m_transform->AcquireChildren();
-            }
         }
 
         // Make the scene resolve
-        SP_FIRE_EVENT(EventType::WorldResolve);
+        SP_FIRE_EVENT_DATA(EventType::WorldResolve, this);
     }
 
     IComponent* Entity::AddComponent(const ComponentType type, uint64_t id /*= 0*/)
@@ -328,13 +354,13 @@ namespace Spartan
                 if (id == component->GetObjectId())
                 {
                     component->OnRemove();
-                    component = nullptr;
+                    ReleaseComponent(component);
                     break;
                 }
             }
         }
 
         // Make the scene resolve
-        SP_FIRE_EVENT(EventType::WorldResolve);
+        SP_FIRE_EVENT_DATA(EventType::WorldResolve, this);
     }
 }
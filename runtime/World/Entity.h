@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <vector>
+#include <atomic>
 #include "../Core/Event.h"
 #include "Components/IComponent.h"
 //================================
@@ -56,6 +57,10 @@ namespace Spartan
         void Serialize(FileStream* stream);
         void Deserialize(FileStream* stream, Transform* parent);
 
+        // Name and id, these notify the world so that it can keep its lookup index valid
+        void SetName(const std::string& name) override;
+        void SetObjectId(uint64_t id) override;
+
         // Active
         bool IsActive() const             { return m_is_active; }
         void SetActive(const bool active) { m_is_active = active; }
@@ -91,7 +96,7 @@ namespace Spartan
             component->OnInitialize();
 
             // Make the scene resolve
-            SP_FIRE_EVENT(EventType::WorldResolve);
+            SP_FIRE_EVENT_DATA(EventType::WorldResolve, this);
 
             return component.get();
         }
@@ -112,9 +117,9 @@ namespace Spartan
         void RemoveComponent()
         {
             const ComponentType component_type = IComponent::TypeToEnum<T>();
-            m_components[static_cast<uint32_t>(component_type)] = nullptr;
+            ReleaseComponent(m_components[static_cast<uint32_t>(component_type)]);
 
-            SP_FIRE_EVENT(EventType::WorldResolve);
+            SP_FIRE_EVENT_DATA(EventType::WorldResolve, this);
         }
 
         void RemoveComponentById(uint64_t id);
@@ -129,6 +134,9 @@ namespace Spartan
         std::shared_ptr<Entity> GetPtrShared() { return shared_from_this(); }
 
     private:
+        // Hands the component over to the world, which might still have it in a tick list
+        void ReleaseComponent(std::shared_ptr<IComponent>& component);
+
         std::atomic<bool> m_is_active = true;
         bool m_hierarchy_visibility   = true;
         Transform* m_transform        = nullptr;
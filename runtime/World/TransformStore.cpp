@@ -0,0 +1,261 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================
+#include "pch.h"
+#include "TransformStore.h"
+#include "../Core/ThreadPool.h"
+//============================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+    namespace
+    {
+        // Levels smaller than this are not worth distributing
+        const uint32_t grain_size_min = 256;
+    }
+
+    uint32_t TransformStore::Allocate(Transform* owner)
+    {
+        lock_guard lock(m_mutex);
+
+        uint32_t slot = slot_invalid;
+        if (!m_slots_free.empty())
+        {
+            slot = m_slots_free.back();
+            m_slots_free.pop_back();
+        }
+        else
+        {
+            slot = m_slot_count++;
+
+            const uint32_t page_index = slot / page_size;
+            SP_ASSERT_MSG(page_index < page_count_max, "Transform limit reached");
+            if (!m_pages[page_index])
+            {
+                m_pages[page_index] = make_unique<Page>();
+            }
+        }
+
+        Page& page             = GetPage(slot);
+        const uint32_t i       = Offset(slot);
+        page.position_local[i] = Vector3::Zero;
+        page.rotation_local[i] = Quaternion::Identity;
+        page.scale_local[i]    = Vector3::One;
+        page.matrix_local[i]   = Matrix::Identity;
+        page.matrix[i]         = Matrix::Identity;
+        page.parent[i]         = slot_invalid;
+        page.frame_updated[i]  = m_frame - 1;
+        page.dirty[i]          = 1;
+        page.active[i]         = 0;
+        page.owner[i]          = owner;
+
+        // Not part of any level until it's activated
+        return slot;
+    }
+
+    void TransformStore::Free(const uint32_t slot)
+    {
+        lock_guard lock(m_mutex);
+
+        Page& page       = GetPage(slot);
+        const uint32_t i = Offset(slot);
+        page.owner[i]    = nullptr;
+        page.parent[i]   = slot_invalid;
+
+        m_slots_freed.emplace_back(slot);
+        m_levels_dirty = m_levels_dirty || page.active[i];
+        page.active[i] = 0;
+    }
+
+    void TransformStore::Activate(const uint32_t slot)
+    {
+        lock_guard lock(m_mutex);
+
+        Page& page       = GetPage(slot);
+        const uint32_t i = Offset(slot);
+        if (page.active[i])
+            return;
+
+        page.active[i] = 1;
+        page.dirty[i]  = 1;
+        m_levels_dirty = true;
+    }
+
+    void TransformStore::SetParent(const uint32_t slot, const uint32_t slot_parent)
+    {
+        lock_guard lock(m_mutex);
+
+        Page& page       = GetPage(slot);
+        const uint32_t i = Offset(slot);
+        page.parent[i]   = slot_parent;
+        page.dirty[i]    = 1;
+
+        m_levels_dirty = true;
+    }
+
+    void TransformStore::UpdateSlot(const uint32_t slot)
+    {
+        Page& page            = GetPage(slot);
+        const uint32_t i      = Offset(slot);
+        const uint32_t parent = page.parent[i];
+
+        page.matrix_local[i] = Matrix(page.position_local[i], page.rotation_local[i], page.scale_local[i]);
+        page.matrix[i]       = parent != slot_invalid ? page.matrix_local[i] * GetMatrix(parent) : page.matrix_local[i];
+    }
+
+    const Matrix& TransformStore::GetMatrixLocal(const uint32_t slot)
+    {
+        Page& page       = GetPage(slot);
+        const uint32_t i = Offset(slot);
+        if (page.dirty[i])
+        {
+            UpdateSlot(slot);
+        }
+
+        return page.matrix_local[i];
+    }
+
+    const Matrix& TransformStore::GetMatrix(const uint32_t slot)
+    {
+        // Changes mark the whole subtree dirty, so a read in between updates still sees the latest ancestors.
+        // The dirty bit stays set, Update() clears it once the change has been propagated.
+        Page& page       = GetPage(slot);
+        const uint32_t i = Offset(slot);
+        if (page.dirty[i])
+        {
+            UpdateSlot(slot);
+        }
+
+        return page.matrix[i];
+    }
+
+    void TransformStore::Update()
+    {
+        lock_guard lock(m_mutex);
+
+        if (m_levels_dirty)
+        {
+            UpdateLevels();
+            m_levels_dirty = false;
+        }
+
+        // Parents are done before their children, so a slot can tell if its parent was updated in this frame
+        const uint32_t frame = m_frame;
+        for (const vector<uint32_t>& level : m_levels)
+        {
+            const uint32_t count = static_cast<uint32_t>(level.size());
+            ThreadPool::ParallelLoop([this, &level, frame](uint32_t index_start, uint32_t index_end)
+            {
+                for (uint32_t index = index_start; index < index_end; index++)
+                {
+                    const uint32_t slot   = level[index];
+                    Page& page            = GetPage(slot);
+                    const uint32_t i      = Offset(slot);
+                    const uint32_t parent = page.parent[i];
+
+                    if (page.dirty[i] || (parent != slot_invalid && GetPage(parent).frame_updated[Offset(parent)] == frame))
+                    {
+                        UpdateSlot(slot);
+                        page.dirty[i]         = 0;
+                        page.frame_updated[i] = frame;
+                    }
+                }
+            }, count, Helper::Max(grain_size_min, ThreadPool::GetGrainSize(count)));
+        }
+
+        m_frame++;
+    }
+
+    void TransformStore::UpdateLevels()
+    {
+        // Detach the children of freed slots, after that the freed slots can be reused.
+        // Inactive slots are left alone, the entities they belong to are removed along with their parents.
+        for (uint32_t slot = 0; slot < m_slot_count; slot++)
+        {
+            Page& page            = GetPage(slot);
+            const uint32_t i      = Offset(slot);
+            const uint32_t parent = page.parent[i];
+
+            if (page.active[i] && parent != slot_invalid && !GetPage(parent).owner[Offset(parent)])
+            {
+                page.parent[i] = slot_invalid;
+                page.dirty[i]  = 1;
+            }
+        }
+        m_slots_free.insert(m_slots_free.end(), m_slots_freed.begin(), m_slots_freed.end());
+        m_slots_freed.clear();
+
+        // Compute the depth of every slot by walking up until a slot with a known depth, or a root, is found
+        m_levels.clear();
+        vector<uint32_t> depths(m_slot_count, slot_invalid);
+        vector<uint32_t> chain;
+        for (uint32_t slot = 0; slot < m_slot_count; slot++)
+        {
+            if (!GetPage(slot).active[Offset(slot)] || depths[slot] != slot_invalid)
+                continue;
+
+            uint32_t depth   = 0;
+            uint32_t current = slot;
+            while (true)
+            {
+                if (depths[current] != slot_invalid)
+                {
+                    depth = depths[current] + 1;
+                    break;
+                }
+
+                chain.emplace_back(current);
+
+                // An inactive parent is not updated here, so the chain starts below it
+                const uint32_t parent = GetPage(current).parent[Offset(current)];
+                if (parent == slot_invalid || !GetPage(parent).active[Offset(parent)])
+                    break;
+
+                current = parent;
+            }
+
+            // Assign from the top of the chain down
+            for (auto it = chain.rbegin(); it != chain.rend(); it++, depth++)
+            {
+                depths[*it] = depth;
+
+                if (m_levels.size() <= depth)
+                {
+                    m_levels.resize(depth + 1);
+                }
+                m_levels[depth].emplace_back(*it);
+            }
+            chain.clear();
+        }
+
+        // Walk each level in memory order
+        for (vector<uint32_t>& level : m_levels)
+        {
+            sort(level.begin(), level.end());
+        }
+    }
+}
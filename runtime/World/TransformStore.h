@@ -0,0 +1,114 @@
+/*
+Copyright(c) 2016-2022 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <array>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../Core/Definitions.h"
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Matrix.h"
+//================================
+
+namespace Spartan
+{
+    class Transform;
+
+    // Owns the data of every Transform in structure of arrays form. Transforms only keep the index of their slot.
+    // Changes are recorded as dirty bits and Update() resolves them once per frame, one hierarchy level at a time.
+    // Update() only touches the slots of entities which the world has resolved, the rest belong to whichever thread is building them.
+    class SP_CLASS TransformStore
+    {
+    public:
+        static const uint32_t slot_invalid = std::numeric_limits<uint32_t>::max();
+
+        TransformStore() = default;
+        ~TransformStore() = default;
+
+        // Slots never move, so their data can be referenced from any thread
+        uint32_t Allocate(Transform* owner);
+        void Free(uint32_t slot);
+
+        // Hands a slot over to Update(), called by the world once the slot's entity is resolved
+        void Activate(uint32_t slot);
+
+        // Hierarchy
+        void SetParent(uint32_t slot, uint32_t slot_parent);
+        uint32_t GetParent(uint32_t slot) const { return GetPage(slot).parent[Offset(slot)]; }
+
+        // Recomputes the local and world matrix of a single slot, its descendants are updated by Update()
+        void UpdateSlot(uint32_t slot);
+        void MakeDirty(uint32_t slot)       { GetPage(slot).dirty[Offset(slot)] = 1; }
+        bool IsDirty(uint32_t slot)   const { return GetPage(slot).dirty[Offset(slot)] != 0; }
+
+        // Propagates all the changes through the hierarchy
+        void Update();
+        uint32_t GetFrame() const { return m_frame; }
+        uint32_t GetCount() const { return m_slot_count - static_cast<uint32_t>(m_slots_free.size() + m_slots_freed.size()); }
+
+        // Data
+        Math::Vector3& GetPositionLocal(const uint32_t slot)    { return GetPage(slot).position_local[Offset(slot)]; }
+        Math::Quaternion& GetRotationLocal(const uint32_t slot) { return GetPage(slot).rotation_local[Offset(slot)]; }
+        Math::Vector3& GetScaleLocal(const uint32_t slot)       { return GetPage(slot).scale_local[Offset(slot)]; }
+        const Math::Matrix& GetMatrixLocal(uint32_t slot); // a dirty slot is recomputed first, along with any dirty ancestors
+        const Math::Matrix& GetMatrix(uint32_t slot);      // a dirty slot is recomputed first, along with any dirty ancestors
+
+    private:
+        static const uint32_t page_size      = 1024;
+        static const uint32_t page_count_max = 1024;
+
+        struct Page
+        {
+            std::array<Math::Vector3, page_size> position_local;
+            std::array<Math::Quaternion, page_size> rotation_local;
+            std::array<Math::Vector3, page_size> scale_local;
+            std::array<Math::Matrix, page_size> matrix_local;
+            std::array<Math::Matrix, page_size> matrix;
+            std::array<uint32_t, page_size> parent;
+            std::array<uint32_t, page_size> frame_updated; // the frame in which the world matrix was last updated
+            std::array<uint8_t, page_size> dirty;
+            std::array<uint8_t, page_size> active; // set once the world has resolved the owner's entity
+            std::array<Transform*, page_size> owner;
+        };
+
+        static uint32_t Offset(const uint32_t slot) { return slot % page_size; }
+        Page& GetPage(const uint32_t slot) const    { return *m_pages[slot / page_size]; }
+        void UpdateLevels();
+
+        // Pages are never reallocated, the table has a fixed size for the same reason
+        std::array<std::unique_ptr<Page>, page_count_max> m_pages;
+        uint32_t m_slot_count = 0;
+        std::vector<uint32_t> m_slots_free;
+        std::vector<uint32_t> m_slots_freed; // only reusable after UpdateLevels() has detached their children
+
+        // Slots grouped by hierarchy depth, parents are always in a lower level than their children
+        std::vector<std::vector<uint32_t>> m_levels;
+        bool m_levels_dirty = true;
+
+        uint32_t m_frame = 0;
+        std::mutex m_mutex;
+    };
+}
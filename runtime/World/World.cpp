@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "World.h"
 #include "Entity.h"
+#include "TransformStore.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
 #include "Components/Light.h"
@@ -53,9 +54,21 @@ namespace Spartan
 {
     World::World(Context* context) : ISystem(context)
     {
+        m_transform_store = make_shared<TransformStore>();
+
         SP_SUBSCRIBE_TO_EVENT(EventType::WorldResolve, SP_EVENT_HANDLER_EXPRESSION
         (
-            m_resolve = true;
+            // Entities pass themselves when their components change, anything else resolves the whole world
+            if (holds_alternative<Entity*>(var.GetVariantRaw()))
+            {
+                lock_guard lock(m_entity_delta_mutex);
+                m_entity_ids_changed.emplace_back(var.Get<Entity*>()->GetObjectId());
+                m_resolve = true;
+            }
+            else
+            {
+                m_resolve_all = true;
+            }
         ));
     }
 
@@ -110,44 +123,182 @@ namespace Spartan
                 }
             }
 
-            // Tick
-            for (shared_ptr<Entity>& entity : m_entities)
+            // Tick, in batches of the same component type, only components which override OnTick() are in the lists
+            for (uint32_t type = 0; type < component_type_count; type++)
             {
-                entity->Tick(delta_time);
+                const vector<shared_ptr<IComponent>>& components = m_tick_lists[type];
+                auto tick = [&components, type, delta_time](uint32_t index_start, uint32_t index_end)
+                {
+                    for (uint32_t i = index_start; i < index_end; i++)
+                    {
+                        IComponent* component = components[i].get();
+                        Entity* entity        = component->GetEntity();
+
+                        // Removed components leave the list when the world resolves, so make sure this one is still attached
+                        if (entity->IsActive() && entity->GetAllComponents()[type].get() == component)
+                        {
+                            component->OnTick(delta_time);
+                        }
+                    }
+                };
+
+                const uint32_t count = static_cast<uint32_t>(components.size());
+                if (IComponent::GetTypeInfo(static_cast<ComponentType>(type)).tick_thread_safe)
+                {
+                    ThreadPool::ParallelLoop(tick, count);
+                }
+                else
+                {
+                    tick(0, count);
+                }
             }
         }
 
-        if (m_resolve || !m_entities_to_add.empty())
+        // Anything recorded from now on will be picked up by the next resolve
+        const bool resolve     = m_resolve.exchange(false);
+        const bool resolve_all = m_resolve_all.exchange(false);
+        if (resolve || resolve_all)
         {
-            // Remove entities
-            vector<shared_ptr<Entity>> entities_copy = m_entities;
-            for (shared_ptr<Entity>& entity : entities_copy)
+
+            vector<uint64_t> ids_changed;
+            vector<shared_ptr<IComponent>> components_removed;
+            vector<shared_ptr<Entity>> entities_to_add;
             {
-                if (entity->IsPendingDestruction())
+                lock_guard lock(m_entity_delta_mutex);
+                ids_changed.swap(m_entity_ids_changed);
+                components_removed.swap(m_components_removed);
+                entities_to_add.swap(m_entities_to_add);
+            }
+
+            // Removed components
+            for (const shared_ptr<IComponent>& component : components_removed)
+            {
+                _TickListRemove(component.get());
+            }
+
+            vector<shared_ptr<Entity>> entities_added;
+            vector<shared_ptr<Entity>> entities_removed;
+
+            // Changed entities, only the ones which are already in the world, new ones are added below
+            sort(ids_changed.begin(), ids_changed.end());
+            ids_changed.erase(unique(ids_changed.begin(), ids_changed.end()), ids_changed.end());
+            for (const uint64_t id : ids_changed)
+            {
+                if (const shared_ptr<Entity>& entity = GetEntityById(id))
                 {
-                    _EntityRemove(entity.get());
+                    _TickListAdd(entity.get());
+                    entities_added.emplace_back(entity);
                 }
             }
 
             // Add entities
-            auto it = m_entities_to_add.begin();
-            while (it != m_entities_to_add.end())
             {
-                if ((*it)->IsActive())
+                uint32_t pending_count = 0;
+                for (shared_ptr<Entity>& entity : entities_to_add)
                 {
-                    m_entities.emplace_back(*it);
-                    it = m_entities_to_add.erase(it);
+                    if (entity->IsPendingDestruction())
+                    {
+                        // It never made it into the world, but its descendants might have
+                        for (Transform* child : entity->GetTransform()->GetChildren())
+                        {
+                            RemoveEntity(child->GetEntity());
+                        }
+                    }
+                    else if (entity->IsActive())
+                    {
+                        {
+                            lock_guard lock(m_entity_index_mutex);
+                            m_entities.emplace_back(entity);
+                            _EntityIndexAdd(static_cast<uint32_t>(m_entities.size() - 1));
+                        }
+                        m_transform_store->Activate(entity->GetTransform()->GetSlot());
+                        _TickListAdd(entity.get());
+                        entities_added.emplace_back(entity);
+                    }
+                    else
+                    {
+                        entities_to_add[pending_count++] = move(entity);
+                    }
                 }
-                else
+
+                // Inactive entities wait for activation, entities created while ticking follow them
+                if (pending_count != 0)
                 {
-                    ++it;
+                    lock_guard lock(m_entity_delta_mutex);
+                    m_entities_to_add.insert(m_entities_to_add.begin(), make_move_iterator(entities_to_add.begin()), make_move_iterator(entities_to_add.begin() + pending_count));
+                    m_resolve = true;
                 }
             }
 
-            // Notify Renderer
-            SP_FIRE_EVENT_DATA(EventType::WorldResolved, m_entities);
-            m_resolve = false;
+            // Remove entities, descendants are marked as they are found, so keep going until there are none left
+            {
+                uint32_t slot_first = numeric_limits<uint32_t>::max();
+                vector<uint64_t> ids_removed;
+                while (true)
+                {
+                    ids_removed.clear();
+                    {
+                        lock_guard lock(m_entity_delta_mutex);
+                        ids_removed.swap(m_entity_ids_removed);
+                    }
+
+                    if (ids_removed.empty())
+                        break;
+
+                    for (const uint64_t id : ids_removed)
+                    {
+                        uint32_t slot = numeric_limits<uint32_t>::max();
+                        {
+                            lock_guard lock(m_entity_index_mutex);
+                            auto it = m_entity_index_id.find(id);
+                            if (it != m_entity_index_id.end())
+                            {
+                                slot = it->second;
+                            }
+                        }
+
+                        if (slot == numeric_limits<uint32_t>::max())
+                            continue;
+
+                        entities_removed.emplace_back(m_entities[slot]);
+                        _EntityRemove(slot);
+                        slot_first = min(slot_first, slot);
+                    }
+                }
+
+                // Close the gaps in one go, the entities after the first gap have moved to a lower slot
+                if (slot_first != numeric_limits<uint32_t>::max())
+                {
+                    lock_guard lock(m_entity_index_mutex);
+                    m_entities.erase(remove(m_entities.begin() + slot_first, m_entities.end(), nullptr), m_entities.end());
+                    for (uint32_t i = slot_first; i < static_cast<uint32_t>(m_entities.size()); i++)
+                    {
+                        m_entity_index_id[m_entities[i]->GetObjectId()] = i;
+                    }
+                }
+            }
+
+            // Notify the Renderer, with everything or with what has changed since the last resolve
+            if (resolve_all)
+            {
+                SP_FIRE_EVENT_DATA(EventType::WorldResolved, m_entities);
+            }
+            else
+            {
+                if (!entities_added.empty())
+                {
+                    SP_FIRE_EVENT_DATA(EventType::WorldEntitiesAdded, entities_added);
+                }
+
+                if (!entities_removed.empty())
+                {
+                    SP_FIRE_EVENT_DATA(EventType::WorldEntitiesRemoved, entities_removed);
+                }
+            }
         }
+
+        // Propagate this tick's transform changes through the hierarchy, including the entities resolved above
+        m_transform_store->Update();
     }
 
     void World::New()
@@ -245,16 +396,18 @@ namespace Spartan
         const Stopwatch timer;
 
         // Load root entity IDs
+        vector<shared_ptr<Entity>> root_entities;
+        root_entities.reserve(root_entity_count);
         for (uint32_t i = 0; i < root_entity_count; i++)
         {
-            shared_ptr<Entity> entity = CreateEntity();
+            shared_ptr<Entity> entity = root_entities.emplace_back(CreateEntity());
             entity->SetObjectId(file->ReadAs<uint64_t>());
         }
 
         // Serialize root entities
         for (uint32_t i = 0; i < root_entity_count; i++)
         {
-            m_entities[i]->Deserialize(file.get(), nullptr);
+            root_entities[i]->Deserialize(file.get(), nullptr);
             ProgressTracker::GetProgress(ProgressType::World).JobDone();
         }
 
@@ -268,10 +421,12 @@ namespace Spartan
 
     shared_ptr<Entity> World::CreateEntity(bool is_active /*= true*/)
     {
-        lock_guard lock(m_entity_access_mutex);
+        // The delta mutex, not the access one, so that components can create entities while they tick
+        lock_guard lock(m_entity_delta_mutex);
 
         shared_ptr<Entity> entity = m_entities_to_add.emplace_back(make_shared<Entity>(m_context));
         entity->SetActive(is_active);
+        m_resolve = true;
 
         return entity;
     }
@@ -286,6 +441,9 @@ namespace Spartan
     {
         SP_ASSERT_MSG(entity != nullptr, "Entity is null");
         entity->MarkForDestruction(); // delayed destruction in case the Renderer is using it
+
+        lock_guard lock(m_entity_delta_mutex);
+        m_entity_ids_removed.emplace_back(entity->GetObjectId());
         m_resolve = true;
     }
 
@@ -303,33 +461,71 @@ namespace Spartan
         return root_entities;
     }
 
-    const shared_ptr<Entity>& World::GetEntityByName(const string& name)
+    shared_ptr<Entity> World::GetEntityByName(const string& name)
     {
-        for (shared_ptr<Entity>& entity : m_entities)
-        {
-            if (entity->GetName() == name)
-                return entity;
-        }
+        lock_guard lock(m_entity_index_mutex);
+
+        // If more than one entity has this name, the one that was added first is returned
+        auto it_name = m_entity_index_name.find(name);
+        if (it_name == m_entity_index_name.end() || it_name->second.empty())
+            return nullptr;
 
-        static shared_ptr<Entity> empty;
-        return empty;
+        auto it_id = m_entity_index_id.find(it_name->second.front());
+        if (it_id == m_entity_index_id.end())
+            return nullptr;
+
+        return m_entities[it_id->second];
+    }
+
+    shared_ptr<Entity> World::GetEntityById(const uint64_t id)
+    {
+        lock_guard lock(m_entity_index_mutex);
+
+        auto it = m_entity_index_id.find(id);
+        if (it == m_entity_index_id.end())
+            return nullptr;
+
+        return m_entities[it->second];
     }
 
-    const shared_ptr<Entity>& World::GetEntityById(const uint64_t id)
+    void World::OnEntityIdChanged(Entity* entity, const uint64_t id_old)
     {
-        for (const auto& entity : m_entities)
+        lock_guard lock(m_entity_index_mutex);
+
+        const uint32_t slot = _EntityIndexGetSlot(entity, id_old);
+        if (slot == numeric_limits<uint32_t>::max())
+            return;
+
+        const uint64_t id_new = entity->GetObjectId();
+
+        m_entity_index_id.erase(id_old);
+        m_entity_index_id[id_new] = slot;
+
+        for (uint64_t& id : m_entity_index_name[entity->GetName()])
         {
-            if (entity->GetObjectId() == id)
-                return entity;
+            if (id == id_old)
+            {
+                id = id_new;
+                break;
+            }
         }
+    }
+
+    void World::OnEntityNameChanged(Entity* entity, const string& name_old)
+    {
+        lock_guard lock(m_entity_index_mutex);
 
-        static shared_ptr<Entity> empty;
-        return empty;
+        const uint64_t id = entity->GetObjectId();
+        if (_EntityIndexGetSlot(entity, id) == numeric_limits<uint32_t>::max())
+            return;
+
+        _EntityIndexRemoveName(name_old, id);
+        m_entity_index_name[entity->GetName()].emplace_back(id);
     }
 
     void World::ActivateNewEntities()
     {
-        lock_guard lock(m_entity_access_mutex);
+        lock_guard lock(m_entity_delta_mutex);
 
         for (shared_ptr<Entity>& entity : m_entities_to_add)
         {
@@ -343,46 +539,151 @@ namespace Spartan
         SP_FIRE_EVENT(EventType::WorldClear);
 
         // Clear
-        m_entities.clear();
+        for (vector<shared_ptr<IComponent>>& components : m_tick_lists)
+        {
+            for (shared_ptr<IComponent>& component : components)
+            {
+                component->m_tick_index = numeric_limits<uint32_t>::max();
+            }
+            components.clear();
+        }
+        vector<shared_ptr<Entity>> entities;
+        {
+            // The entities are released after unlocking, in case their destruction touches the index
+            lock_guard lock(m_entity_index_mutex);
+            entities.swap(m_entities);
+            m_entity_index_id.clear();
+            m_entity_index_name.clear();
+        }
+        entities.clear();
         m_name.clear();
         m_file_path.clear();
+        {
+            lock_guard lock(m_entity_delta_mutex);
+            m_entity_ids_changed.clear();
+            m_entity_ids_removed.clear();
+            m_components_removed.clear();
+        }
 
         // Mark for resolve
-        m_resolve = true;
+        m_resolve_all = true;
     }
 
-    // Removes an entity and all of it's children
-    void World::_EntityRemove(Entity* entity)
+    // Removes the entity in a slot and marks its children for removal, the slot is left empty
+    void World::_EntityRemove(const uint32_t slot)
     {
+        Entity* entity       = m_entities[slot].get();
+        Transform* transform = entity->GetTransform();
+
         // Remove any descendants
-        auto children = entity->GetTransform()->GetChildren();
-        for (const auto& child : children)
+        for (Transform* child : transform->GetChildren())
         {
             RemoveEntity(child->GetEntity());
         }
 
-        // Keep a reference to it's parent (in case it has one)
-        auto parent = entity->GetTransform()->GetParent();
+        // If there is a parent, detach from it
+        if (Transform* parent = transform->GetParent())
+        {
+            parent->RemoveChild(transform);
+        }
 
-        // Remove this entity
-        for (auto it = m_entities.begin(); it < m_entities.end();)
+        // Stop ticking its components
+        for (const shared_ptr<IComponent>& component : entity->GetAllComponents())
         {
-            const auto temp = *it;
-            if (temp->GetObjectId() == entity->GetObjectId())
+            if (component)
             {
-                it = m_entities.erase(it);
-                break;
+                _TickListRemove(component.get());
             }
-            ++it;
         }
 
-        // If there was a parent, update it
-        if (parent)
+        // Remove this entity
+        lock_guard lock(m_entity_index_mutex);
+        const uint64_t id = entity->GetObjectId();
+        _EntityIndexRemoveName(entity->GetName(), id);
+        m_entity_index_id.erase(id);
+        m_entities[slot] = nullptr;
+    }
+
+    void World::OnComponentRemoved(const shared_ptr<IComponent>& component)
+    {
+        if (!IComponent::GetTypeInfo(component->GetType()).ticks)
+            return;
+
+        // Keep it alive until it's out of its tick list
+        lock_guard lock(m_entity_delta_mutex);
+        m_components_removed.emplace_back(component);
+    }
+
+    void World::_TickListAdd(Entity* entity)
+    {
+        for (const shared_ptr<IComponent>& component : entity->GetAllComponents())
+        {
+            if (!component || component->m_tick_index != numeric_limits<uint32_t>::max())
+                continue;
+
+            if (!IComponent::GetTypeInfo(component->GetType()).ticks)
+                continue;
+
+            vector<shared_ptr<IComponent>>& components = m_tick_lists[static_cast<uint32_t>(component->GetType())];
+            component->m_tick_index = static_cast<uint32_t>(components.size());
+            components.emplace_back(component);
+        }
+    }
+
+    void World::_TickListRemove(IComponent* component)
+    {
+        const uint32_t index = component->m_tick_index;
+        if (index == numeric_limits<uint32_t>::max())
+            return;
+
+        // The list might hold the last reference, so don't touch the component after the pop
+        component->m_tick_index = numeric_limits<uint32_t>::max();
+
+        // The order doesn't matter, so move the last one into the gap
+        vector<shared_ptr<IComponent>>& components = m_tick_lists[static_cast<uint32_t>(component->GetType())];
+        if (index != components.size() - 1)
+        {
+            components[index]               = move(components.back());
+            components[index]->m_tick_index = index;
+        }
+        components.pop_back();
+    }
+
+    void World::_EntityIndexAdd(const uint32_t slot)
+    {
+        Entity* entity    = m_entities[slot].get();
+        const uint64_t id = entity->GetObjectId();
+
+        m_entity_index_id[id] = slot;
+        m_entity_index_name[entity->GetName()].emplace_back(id);
+    }
+
+    void World::_EntityIndexRemoveName(const string& name, const uint64_t id)
+    {
+        auto it = m_entity_index_name.find(name);
+        if (it == m_entity_index_name.end())
+            return;
+
+        vector<uint64_t>& ids = it->second;
+        ids.erase(remove(ids.begin(), ids.end(), id), ids.end());
+
+        // Don't keep empty lists around, GetEntityByName() relies on that
+        if (ids.empty())
         {
-            parent->AcquireChildren();
+            m_entity_index_name.erase(it);
         }
     }
 
+    uint32_t World::_EntityIndexGetSlot(Entity* entity, const uint64_t id) const
+    {
+        // Only entities which have been added to the world are indexed
+        auto it = m_entity_index_id.find(id);
+        if (it != m_entity_index_id.end() && m_entities[it->second].get() == entity)
+            return it->second;
+
+        return numeric_limits<uint32_t>::max();
+    }
+
     void World::CreateDefaultWorldCameraLightEnvironment()
     {
         // Environment
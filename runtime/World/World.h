@@ -24,11 +24,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <string>
+#include <unordered_map>
 #include "../Core/ISystem.h"
 #include "../Core/Definitions.h"
 #include "../Math/Vector3.h"
 #include "../Rendering/Mesh.h"
+#include "Components/IComponent.h"
 //==============================
 
 namespace Spartan
@@ -39,6 +42,7 @@ namespace Spartan
     class Input;
     class Profiler;
     class TransformHandle;
+    class TransformStore;
     //====================
 
     class SP_CLASS World : public ISystem
@@ -56,7 +60,7 @@ namespace Spartan
         void New();
         bool SaveToFile(const std::string& filePath);
         bool LoadFromFile(const std::string& file_path);
-        void Resolve() { m_resolve = true; }
+        void Resolve() { m_resolve_all = true; }
         void CreateDefaultWorldCameraLightEnvironment();
         void CreateDefaultWorldCube();
         void CreateDefaultWorldCar();
@@ -70,29 +74,59 @@ namespace Spartan
         bool EntityExists(Entity* entity);
         void RemoveEntity(Entity* entity);
         std::vector<std::shared_ptr<Entity>> GetRootEntities();
-        const std::shared_ptr<Entity>& GetEntityByName(const std::string& name);
-        const std::shared_ptr<Entity>& GetEntityById(uint64_t id);
+        // Copies, so that they stay valid while other threads add or remove entities
+        std::shared_ptr<Entity> GetEntityByName(const std::string& name);
+        std::shared_ptr<Entity> GetEntityById(uint64_t id);
         const auto& GetAllEntities() const { return m_entities; }
         void ActivateNewEntities();
         //======================================================================
 
+        // Shared by all the transforms, updated once per tick
+        const std::shared_ptr<TransformStore>& GetTransformStore() const { return m_transform_store; }
+
+        //= Entity index =======================================================
+        // Called by entities so that id and name lookups remain valid after a change
+        void OnEntityIdChanged(Entity* entity, uint64_t id_old);
+        void OnEntityNameChanged(Entity* entity, const std::string& name_old);
+        void OnComponentRemoved(const std::shared_ptr<IComponent>& component);
+        //======================================================================
+
     private:
         void Clear();
-        void _EntityRemove(Entity* entity);
+        void _EntityRemove(uint32_t slot);
+        void _EntityIndexAdd(uint32_t slot);
+        void _EntityIndexRemoveName(const std::string& name, uint64_t id);
+        uint32_t _EntityIndexGetSlot(Entity* entity, uint64_t id) const;
+        void _TickListAdd(Entity* entity);
+        void _TickListRemove(IComponent* component);
 
+        std::shared_ptr<TransformStore> m_transform_store;
         std::vector<std::shared_ptr<Entity>> m_entities_to_add;
         std::vector<std::shared_ptr<Entity>> m_entities;
+        std::unordered_map<uint64_t, uint32_t> m_entity_index_id;                   // id -> slot in m_entities
+        std::unordered_map<std::string, std::vector<uint64_t>> m_entity_index_name; // name -> ids, in the order they were added
         std::string m_name;
         std::string m_file_path;
         bool m_was_in_editor_mode                             = false;
-        bool m_resolve                                        = true;
+        std::atomic<bool> m_resolve                           = true; // set from any thread, cleared by OnTick()
+        std::atomic<bool> m_resolve_all                       = true;
         std::shared_ptr<Mesh> m_default_model_sponza          = nullptr;
         std::shared_ptr<Mesh> m_default_model_sponza_curtains = nullptr;
         std::shared_ptr<Mesh> m_default_model_car             = nullptr;
         Input* m_input                                        = nullptr;
         Profiler* m_profiler                                  = nullptr;
 
+        // Components which tick, grouped by type so that they tick in batches
+        std::array<std::vector<std::shared_ptr<IComponent>>, component_type_count> m_tick_lists;
+
+        // Entities which changed or were removed since the last resolve
+        std::vector<uint64_t> m_entity_ids_changed;
+        std::vector<uint64_t> m_entity_ids_removed;
+        std::vector<std::shared_ptr<IComponent>> m_components_removed;
+
         // Sync primitives
         std::mutex m_entity_access_mutex;
+        std::mutex m_entity_delta_mutex;
+        std::mutex m_entity_index_mutex; // guards the lookup indices and the slots of m_entities, which entities update from any thread
     };
 }